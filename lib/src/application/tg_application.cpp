@@ -46,6 +46,7 @@ int TgApplication::exec()
  * get texture index for filename
  * if texture doesn't already exists, then this
  * generates texture index for filename (texture)
+ * texture contains only this image, it's never shared atlas texture
  *
  * \return texture index for filename (texture)
  * and if return 0, then generating texture is failed
@@ -123,4 +124,145 @@ size_t TgApplication::setFont(const std::string &fullFilePathFont, size_t positi
 std::string TgApplication::getFont(size_t i)
 {
     return m_private->getFont(i);
-}
\ No newline at end of file
+}
+
+/*!
+ * \brief TgApplication::setGlyphDiskCacheDirectory
+ *
+ * set directory where rasterized font glyphs are cached, so next
+ * application start does not need to rasterize the glyphs again
+ * default is $PRJ_TG_UI_LIB_GLYPH_CACHE_DIR if it is set (empty value disables the disk cache),
+ * otherwise $XDG_CACHE_HOME/prj-tg-ui-lib/glyphs (or $HOME/.cache/prj-tg-ui-lib/glyphs),
+ * functional test build does not use the disk cache unless $PRJ_TG_UI_LIB_GLYPH_CACHE_DIR is set
+ * this should be called before any text is created
+ *
+ * \param directory full path of the directory, empty string (or nullptr) disables the disk cache
+ */
+void TgApplication::setGlyphDiskCacheDirectory(const char *directory)
+{
+    m_private->setGlyphDiskCacheDirectory(directory);
+}
+
+/*!
+ * \brief TgApplication::getGlyphDiskCacheDirectory
+ *
+ * \return directory where rasterized font glyphs are cached, empty if disk cache is disabled
+ */
+std::string TgApplication::getGlyphDiskCacheDirectory()
+{
+    return m_private->getGlyphDiskCacheDirectory();
+}
+
+/*!
+ * \brief TgApplication::setGlyphDiskCacheMaxSize
+ *
+ * set max size of the glyph disk cache, least recently used
+ * cache files are removed when the size is exceeded
+ * default value: 64 MB
+ *
+ * \param maxSize max size in bytes
+ */
+void TgApplication::setGlyphDiskCacheMaxSize(uint64_t maxSize)
+{
+    m_private->setGlyphDiskCacheMaxSize(maxSize);
+}
+
+/*!
+ * \brief TgApplication::getGlyphDiskCacheMaxSize
+ *
+ * \return max size of the glyph disk cache in bytes
+ */
+uint64_t TgApplication::getGlyphDiskCacheMaxSize()
+{
+    return m_private->getGlyphDiskCacheMaxSize();
+}
+
+/*!
+ * \brief TgApplication::preloadFont
+ *
+ * preloads (rasterizes) glyphs of the font in the background, so texts
+ * using these font sizes and characters are faster to show first time,
+ * for example during the splash screen
+ *
+ * \param fullFilePathFont full file path of the font
+ * \param listFontSize list of font sizes to preload
+ * \param listCharacterRange list of character (unicode) ranges (first, last) to preload,
+ * for example {0x20, 0x7E} for basic latin
+ * \param progress called each time one font size is preloaded,
+ * preloading is completed when preloadedCount is totalCount.
+ * NOTE: progress is called on the worker thread, not on the render thread
+ * (if listFontSize is empty, it's called once on the calling thread), calls
+ * are not concurrent, but progress must not block, and it must not change
+ * items directly without locking, for example use TgTextfield::setText()
+ * or other setters that are safe to call from any thread
+ */
+void TgApplication::preloadFont(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                                const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                                const std::function<void(size_t preloadedCount, size_t totalCount)> &progress)
+{
+    m_private->preloadFont(fullFilePathFont, listFontSize, listCharacterRange, progress);
+}
+
+/*!
+ * \brief TgApplication::measureTexts
+ *
+ * measures width, height and line count of several texts at once
+ * without OpenGL, texts are measured in parallel by worker threads
+ * this is thread safe, so it can be called from any thread, for example
+ * to calculate grid column, menu or combo box size before items are created
+ *
+ * \param listRequest list of texts to measure
+ * \return result for each request (same index)
+ */
+std::vector<TgTextMeasureResult> TgApplication::measureTexts(const std::vector<TgTextMeasureRequest> &listRequest)
+{
+    return m_private->measureTexts(listRequest);
+}
+
+/*!
+ * \brief TgApplication::setImageCacheBudget
+ *
+ * set texture memory budget of the image cache, images that
+ * no item uses anymore are kept in the cache, so they are fast to show again,
+ * least recently used of them are deleted when textures take more memory than this.
+ * Small images are packed into atlas and they are not counted into the budget
+ * default value: 128MB
+ *
+ * \param byteCount budget in bytes, 0 deletes images as soon as they are not used
+ */
+void TgApplication::setImageCacheBudget(size_t byteCount)
+{
+    m_private->setImageCacheBudget(byteCount);
+}
+
+/*!
+ * \brief TgApplication::getImageCacheBudget
+ *
+ * \return texture memory budget of the image cache in bytes
+ */
+size_t TgApplication::getImageCacheBudget()
+{
+    return m_private->getImageCacheBudget();
+}
+
+/*!
+ * \brief TgApplication::getImageCacheStatistics
+ *
+ * \return texture memory use, hit, miss and eviction counters of the image cache
+ */
+TgImageCacheStatistics TgApplication::getImageCacheStatistics()
+{
+    return m_private->getImageCacheStatistics();
+}
+
+#ifdef FUNCIONAL_TEST
+/*!
+ * \brief TgApplication::getFontGlyphCacheCount
+ *
+ * \return count of fonts (glyph textures) in the glyph cache
+ */
+size_t TgApplication::getFontGlyphCacheCount()
+{
+    return m_private->getFontGlyphCacheCount();
+}
+#endif
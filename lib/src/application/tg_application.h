@@ -14,10 +14,57 @@
 
 #include <GL/glew.h>
 #include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
 #include "../global/tg_global_macros.h"
+#include "../item2d/tg_item2d.h"
 
 struct TgApplicationPrivate;
 
+/*!
+ * \brief TgTextMeasureRequest
+ * single text to measure with TgApplication::measureTexts
+ */
+struct TgTextMeasureRequest
+{
+    std::string m_text;                                     /*!< utf8 text */
+    std::string m_fontFile;                                 /*!< main font file, empty == default font */
+    float m_fontSize = 17;
+    uint32_t m_maxLineCount = 0;                            /*!< 0 == unlimited number of lines */
+    float m_maxLineWidth = 0;                               /*!< used with word wrap */
+    TgTextFieldWordWrap m_wordWrap = TgTextFieldWordWrap::WordWrapOff;
+    bool m_allowBreakLineGoOverMaxLine = false;
+};
+
+/*!
+ * \brief TgTextMeasureResult
+ * result of single TgTextMeasureRequest
+ */
+struct TgTextMeasureResult
+{
+    float m_textWidth = 0;
+    float m_textHeight = 0;                                 /*!< font height (height of single line) */
+    float m_allDrawTextHeight = 0;                          /*!< height containing all lines */
+    uint32_t m_lineCount = 0;
+    bool m_valid = false;                                   /*!< false if text could not be measured (for example invalid utf8) */
+};
+
+/*!
+ * \brief TgImageCacheStatistics
+ * counters of the image (texture) cache
+ */
+struct TgImageCacheStatistics
+{
+    size_t m_residentByteCount = 0;                         /*!< texture memory of cached images, including atlas pages */
+    size_t m_unusedByteCount = 0;                           /*!< texture memory of cached images that no item uses */
+    size_t m_budgetByteCount = 0;                           /*!< unused images are evicted when texture memory exceeds this */
+    size_t m_imageCount = 0;
+    uint64_t m_hitCount = 0;                                /*!< image was found from the cache */
+    uint64_t m_missCount = 0;                               /*!< image was loaded or generated */
+    uint64_t m_evictionCount = 0;                           /*!< unused image was deleted from the cache */
+};
+
 /*!
  * \brief TgApplication
  * This is application functionalities
@@ -37,6 +84,24 @@ public:
     size_t getFontCount();
     size_t setFont(const std::string &fullFilePathFont, size_t position);
     std::string getFont(size_t i);
+
+    void setGlyphDiskCacheDirectory(const char *directory);
+    std::string getGlyphDiskCacheDirectory();
+    void setGlyphDiskCacheMaxSize(uint64_t maxSize);
+    uint64_t getGlyphDiskCacheMaxSize();
+
+    void preloadFont(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                     const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                     const std::function<void(size_t preloadedCount, size_t totalCount)> &progress = nullptr);
+
+    std::vector<TgTextMeasureResult> measureTexts(const std::vector<TgTextMeasureRequest> &listRequest);
+
+    void setImageCacheBudget(size_t byteCount);
+    size_t getImageCacheBudget();
+    TgImageCacheStatistics getImageCacheStatistics();
+#ifdef FUNCIONAL_TEST
+    size_t getFontGlyphCacheCount();
+#endif
 private:
     TgApplicationPrivate *m_private;
 };
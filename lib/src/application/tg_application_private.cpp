@@ -17,6 +17,7 @@
 
 #endif
 #include "../image/tg_image_assets.h"
+#include "../font/tg_font_math.h"
 #include <string>
 
 TgApplicationPrivate::TgApplicationPrivate()
@@ -65,6 +66,8 @@ int TgApplicationPrivate::exec()
  * get texture index for filename
  * if texture doesn't already exists, then this
  * generates texture index for filename (texture)
+ * and texture is kept until the application ends
+ * texture contains only this image, it's never shared atlas texture
  *
  * \return texture index for filename (texture)
  * and if return 0, then generating texture is failed
@@ -76,6 +79,7 @@ GLuint TgApplicationPrivate::getTextureIndex(const char *filename)
     imageAsset.m_textureIndex = 0;
     imageAsset.m_type = TgImageType::LoadedImage;
     imageAsset.m_filename = filename;
+    imageAsset.m_atlasAllowed = false;
     TG_FUNCTION_END();
     return TgGlobalApplication::getInstance()->getImageAssets()->generateImage(imageAsset);
 }
@@ -148,4 +152,120 @@ size_t TgApplicationPrivate::setFont(const std::string &fullFilePathFont, size_t
 std::string TgApplicationPrivate::getFont(size_t i)
 {
     return TgGlobalApplication::getInstance()->getFontDefault()->getFont(i);
-}
\ No newline at end of file
+}
+
+/*!
+ * \brief TgApplicationPrivate::setGlyphDiskCacheDirectory
+ *
+ * set directory where rasterized font glyphs are cached
+ *
+ * \param directory full path of the directory, empty string (or nullptr) disables the disk cache
+ */
+void TgApplicationPrivate::setGlyphDiskCacheDirectory(const char *directory)
+{
+    TgGlobalApplication::getInstance()->getFontGlyphDiskCache()->setCacheDirectory(directory ? directory : "");
+}
+
+/*!
+ * \brief TgApplicationPrivate::getGlyphDiskCacheDirectory
+ *
+ * \return directory where rasterized font glyphs are cached, empty if disk cache is disabled
+ */
+std::string TgApplicationPrivate::getGlyphDiskCacheDirectory()
+{
+    return TgGlobalApplication::getInstance()->getFontGlyphDiskCache()->getCacheDirectory();
+}
+
+/*!
+ * \brief TgApplicationPrivate::getFontGlyphCacheCount
+ *
+ * \return count of fonts (glyph textures) in the glyph cache
+ */
+size_t TgApplicationPrivate::getFontGlyphCacheCount()
+{
+    return TgGlobalApplication::getInstance()->getFontGlyphCache()->getCachedFontCount();
+}
+
+/*!
+ * \brief TgApplicationPrivate::setGlyphDiskCacheMaxSize
+ *
+ * set max size of the glyph disk cache
+ *
+ * \param maxSize max size in bytes
+ */
+void TgApplicationPrivate::setGlyphDiskCacheMaxSize(uint64_t maxSize)
+{
+    TgGlobalApplication::getInstance()->getFontGlyphDiskCache()->setCacheMaxSize(maxSize);
+}
+
+/*!
+ * \brief TgApplicationPrivate::getGlyphDiskCacheMaxSize
+ *
+ * \return max size of the glyph disk cache in bytes
+ */
+uint64_t TgApplicationPrivate::getGlyphDiskCacheMaxSize()
+{
+    return TgGlobalApplication::getInstance()->getFontGlyphDiskCache()->getCacheMaxSize();
+}
+
+/*!
+ * \brief TgApplicationPrivate::preloadFont
+ *
+ * preloads glyphs of the font in the background
+ *
+ * \param fullFilePathFont full file path of the font
+ * \param listFontSize list of font sizes to preload
+ * \param listCharacterRange list of character (unicode) ranges (first, last) to preload
+ * \param progress called (from the worker thread) each time one font size is preloaded
+ */
+void TgApplicationPrivate::preloadFont(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                                       const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                                       const std::function<void(size_t preloadedCount, size_t totalCount)> &progress)
+{
+    TgGlobalApplication::getInstance()->getFontDefault()->preload(fullFilePathFont, listFontSize, listCharacterRange, progress);
+}
+
+/*!
+ * \brief TgApplicationPrivate::measureTexts
+ *
+ * measures width, height and line count of several texts
+ *
+ * \param listRequest list of texts to measure
+ * \return result for each request (same index)
+ */
+std::vector<TgTextMeasureResult> TgApplicationPrivate::measureTexts(const std::vector<TgTextMeasureRequest> &listRequest)
+{
+    return TgFontMath::measureTexts(listRequest);
+}
+
+/*!
+ * \brief TgApplicationPrivate::setImageCacheBudget
+ *
+ * \param byteCount texture memory budget of the image cache in bytes
+ */
+void TgApplicationPrivate::setImageCacheBudget(size_t byteCount)
+{
+    TgGlobalApplication::getInstance()->getImageAssets()->setCacheBudget(byteCount);
+}
+
+/*!
+ * \brief TgApplicationPrivate::getImageCacheBudget
+ *
+ * \return texture memory budget of the image cache in bytes
+ */
+size_t TgApplicationPrivate::getImageCacheBudget()
+{
+    return TgGlobalApplication::getInstance()->getImageAssets()->getCacheBudget();
+}
+
+/*!
+ * \brief TgApplicationPrivate::getImageCacheStatistics
+ *
+ * \return counters of the image cache
+ */
+TgImageCacheStatistics TgApplicationPrivate::getImageCacheStatistics()
+{
+    TgImageCacheStatistics ret;
+    TgGlobalApplication::getInstance()->getImageAssets()->getCacheStatistics(ret);
+    return ret;
+}
@@ -14,6 +14,10 @@
 
 #include <GL/glew.h>
 #include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "tg_application.h"
 
 class TgApplicationPrivate
 {
@@ -29,6 +33,22 @@ public:
     size_t getFontCount();
     size_t setFont(const std::string &fullFilePathFont, size_t position = UINT64_MAX);
     std::string getFont(size_t i);
+
+    void setGlyphDiskCacheDirectory(const char *directory);
+    std::string getGlyphDiskCacheDirectory();
+    size_t getFontGlyphCacheCount();
+    void setGlyphDiskCacheMaxSize(uint64_t maxSize);
+    uint64_t getGlyphDiskCacheMaxSize();
+
+    void preloadFont(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                     const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                     const std::function<void(size_t preloadedCount, size_t totalCount)> &progress = nullptr);
+
+    std::vector<TgTextMeasureResult> measureTexts(const std::vector<TgTextMeasureRequest> &listRequest);
+
+    void setImageCacheBudget(size_t byteCount);
+    size_t getImageCacheBudget();
+    TgImageCacheStatistics getImageCacheStatistics();
 private:
 };
 
@@ -0,0 +1,212 @@
+/*!
+ * \file
+ * \brief file tg_disk_cache_directory.cpp
+ *
+ * helper functions for the disk cache directories
+ * (glyph cache and tile cache)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_disk_cache_directory.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../global/tg_global_log.h"
+
+/*!
+ * \brief TgDiskCacheFile
+ * cache file found on cleanup
+ */
+struct TgDiskCacheFile
+{
+    std::string m_fileName;
+    uint64_t m_size;
+    time_t m_modifiedTime;
+};
+
+/*!
+ * \brief TgDiskCacheDirectory::getDefaultDirectory
+ *
+ * get default cache directory, if environment variable is set, then it's used
+ * (empty value or relative path disables the cache), otherwise
+ * $XDG_CACHE_HOME/prj-tg-ui-lib/<subDirectory> or $HOME/.cache/prj-tg-ui-lib/<subDirectory>
+ * functional tests do not use the cache by default, so they never write into home directory
+ *
+ * \param environmentVariable name of the environment variable to override the directory
+ * \param subDirectory sub directory under prj-tg-ui-lib
+ * \return default cache directory, empty if cache is disabled
+ */
+std::string TgDiskCacheDirectory::getDefaultDirectory(const char *environmentVariable, const char *subDirectory)
+{
+    const char *directory = getenv(environmentVariable);
+    if (directory) {
+        return directory[0] == '/' ? std::string(directory) : std::string("");
+    }
+#ifdef FUNCIONAL_TEST
+    (void)subDirectory;
+    return "";
+#else
+    const char *xdgCacheHome = getenv("XDG_CACHE_HOME");
+    if (xdgCacheHome && xdgCacheHome[0] == '/') {
+        return std::string(xdgCacheHome) + "/prj-tg-ui-lib/" + subDirectory;
+    }
+    const char *home = getenv("HOME");
+    if (home && home[0] == '/') {
+        return std::string(home) + "/.cache/prj-tg-ui-lib/" + subDirectory;
+    }
+    return "";
+#endif
+}
+
+/*!
+ * \brief TgDiskCacheDirectory::createDirectory
+ *
+ * creates the directory (and it's parents) if required
+ *
+ * \param directory full path of directory
+ * \return true if directory exists
+ */
+bool TgDiskCacheDirectory::createDirectory(const std::string &directory)
+{
+    size_t i;
+    std::string path;
+    for (i=1;i<=directory.size();i++) {
+        if (i != directory.size() && directory.at(i) != '/') {
+            continue;
+        }
+        path = directory.substr(0, i);
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+            TG_WARNING_LOG("Could not create cache directory: ", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief TgDiskCacheDirectory::touchFile
+ *
+ * updates modified time of the cache file, so cleanDirectory()
+ * removes least recently used files first
+ *
+ * \param fd file descriptor of the cache file
+ */
+void TgDiskCacheDirectory::touchFile(int fd)
+{
+    futimens(fd, nullptr);
+}
+
+/*!
+ * \brief TgDiskCacheDirectory::cleanDirectory
+ *
+ * removes temporary files left by crashed processes, and least recently
+ * used cache files until the size of the cache files is below maxSize,
+ * keepFileName is never removed (even if it alone is larger than maxSize),
+ * because it's the file that is just created or opened
+ *
+ * \param directory full path of the cache directory
+ * \param fileSuffix suffix of the cache files, for example ".tgglyph"
+ * \param maxSize max size (bytes) of the cache files in the directory
+ * \param keepFileName file name (without directory) that is not removed
+ */
+void TgDiskCacheDirectory::cleanDirectory(const std::string &directory, const char *fileSuffix, uint64_t maxSize, const std::string &keepFileName)
+{
+    TG_FUNCTION_BEGIN();
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) {
+        TG_FUNCTION_END();
+        return;
+    }
+    std::vector<TgDiskCacheFile> listFile;
+    uint64_t totalSize = 0;
+    size_t suffixLength = strlen(fileSuffix);
+    time_t currentTime = time(nullptr);
+    struct dirent *entry;
+    struct stat st;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        std::string fileName = directory + "/" + name;
+        if (stat(fileName.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            if (currentTime - st.st_mtime > TG_DISK_CACHE_TMP_FILE_MAX_AGE) {
+                unlink(fileName.c_str());
+            }
+            continue;
+        }
+        if (name.size() <= suffixLength || name.compare(name.size() - suffixLength, suffixLength, fileSuffix) != 0) {
+            continue;
+        }
+        if (name == keepFileName) {
+            // counted into total size, but it's not on the list of removable files
+            totalSize += static_cast<uint64_t>(st.st_size);
+            continue;
+        }
+        TgDiskCacheFile file;
+        file.m_fileName = fileName;
+        file.m_size = static_cast<uint64_t>(st.st_size);
+        file.m_modifiedTime = st.st_mtime;
+        totalSize += file.m_size;
+        listFile.push_back(file);
+    }
+    closedir(dir);
+
+    if (totalSize <= maxSize) {
+        TG_FUNCTION_END();
+        return;
+    }
+    std::sort(listFile.begin(), listFile.end(), [](const TgDiskCacheFile &a, const TgDiskCacheFile &b) {
+        return a.m_modifiedTime < b.m_modifiedTime;
+    });
+    for (size_t i=0;i<listFile.size() && totalSize > maxSize;i++) {
+        if (unlink(listFile[i].m_fileName.c_str()) == 0) {
+            totalSize -= listFile[i].m_size;
+        }
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgDiskCacheDirectory::removeOtherFiles
+ *
+ * removes cache files that have same prefix and suffix than keepFileName,
+ * for example old versions of the cache file of the same source file
+ *
+ * \param directory full path of the cache directory
+ * \param filePrefix prefix of the cache files to remove
+ * \param fileSuffix suffix of the cache files, for example ".tgtiles"
+ * \param keepFileName file name (without directory) that is not removed
+ */
+void TgDiskCacheDirectory::removeOtherFiles(const std::string &directory, const std::string &filePrefix, const char *fileSuffix, const std::string &keepFileName)
+{
+    TG_FUNCTION_BEGIN();
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) {
+        TG_FUNCTION_END();
+        return;
+    }
+    size_t suffixLength = strlen(fileSuffix);
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == keepFileName
+            || name.size() <= filePrefix.size() + suffixLength
+            || name.compare(0, filePrefix.size(), filePrefix) != 0
+            || name.compare(name.size() - suffixLength, suffixLength, fileSuffix) != 0) {
+            continue;
+        }
+        unlink((directory + "/" + name).c_str());
+    }
+    closedir(dir);
+    TG_FUNCTION_END();
+}
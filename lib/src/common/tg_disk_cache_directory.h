@@ -0,0 +1,35 @@
+/*!
+ * \file
+ * \brief file tg_disk_cache_directory.h
+ *
+ * helper functions for the disk cache directories
+ * (glyph cache and tile cache)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+#ifndef TG_DISK_CACHE_DIRECTORY_H
+#define TG_DISK_CACHE_DIRECTORY_H
+
+#include <string>
+#include <cstdint>
+
+/*!
+ * \brief TG_DISK_CACHE_TMP_FILE_MAX_AGE
+ * temporary (.tmp) file older than this (seconds) is left by
+ * crashed process, and it's removed on cleanup
+ */
+#define TG_DISK_CACHE_TMP_FILE_MAX_AGE      3600
+
+class TgDiskCacheDirectory
+{
+public:
+    static std::string getDefaultDirectory(const char *environmentVariable, const char *subDirectory);
+    static bool createDirectory(const std::string &directory);
+    static void touchFile(int fd);
+    static void cleanDirectory(const std::string &directory, const char *fileSuffix, uint64_t maxSize, const std::string &keepFileName);
+    static void removeOtherFiles(const std::string &directory, const std::string &filePrefix, const char *fileSuffix, const std::string &keepFileName);
+};
+
+#endif // TG_DISK_CACHE_DIRECTORY_H
@@ -10,7 +10,9 @@
  */
 
 #include "tg_font_characters_cache.h"
+#include <algorithm>
 #include "../../global/tg_global_log.h"
+#include "../tg_font_default.h"
 
 TgFontCharactersCache::TgFontCharactersCache()
 {
@@ -38,17 +40,30 @@ TgFontCharactersCache::~TgFontCharactersCache()
  * if font is already in the list, it's not going to be added
  *
  * \param filename [in]
- * \return true, if the font was added (or it's already in the list)
+ * \return characters of the font, nullptr if font could not be added
  */
-
-bool TgFontCharactersCache::addFont(const std::string &filename)
+const TgFontCharacterCache *TgFontCharactersCache::addFont(const std::string &filename)
 {
     m_mutex.lock();
+    const TgFontCharacterCache *ret = addFontWithoutLock(filename);
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgFontCharactersCache::addFontWithoutLock
+ *
+ * same as addFont(), but m_mutex must be locked before calling this
+ *
+ * \param filename [in]
+ * \return characters of the font, nullptr if font could not be added
+ */
+TgFontCharacterCache *TgFontCharactersCache::addFontWithoutLock(const std::string &filename)
+{
     std::vector<TgFontCharacterCache *>::iterator it;
     for (it=m_listCharacters.begin();it!=m_listCharacters.end();it++) {
         if ((*it)->m_filename == filename) {
-            m_mutex.unlock();
-            return true;
+            return (*it);
         }
     }
 
@@ -58,19 +73,19 @@ bool TgFontCharactersCache::addFont(const std::string &filename)
     if (!cache->m_supported_characters) {
         TG_ERROR_LOG("Failed to init supported characters");
         delete cache;
-        m_mutex.unlock();
-        return false;
+        return nullptr;
     }
     if (prj_ttf_reader_get_supported_characters(filename.c_str(), cache->m_supported_characters)) {
         TG_ERROR_LOG("Could not get supported characters from font: ", filename);
         prj_ttf_reader_clear_supported_character(&cache->m_supported_characters);
         delete cache;
-        m_mutex.unlock();
-        return false;
+        return nullptr;
     }
+    cache->m_listCharacter.assign(cache->m_supported_characters->list_character,
+                                  cache->m_supported_characters->list_character + cache->m_supported_characters->character_list_count);
+    std::sort(cache->m_listCharacter.begin(), cache->m_listCharacter.end());
     m_listCharacters.push_back(cache);
-    m_mutex.unlock();
-    return true;
+    return cache;
 }
 
 /*!
@@ -125,59 +140,82 @@ std::vector<int> TgFontCharactersCache::getSupportedFontsForCharacters(const uin
 }
 
 /*!
- * \brief TgFontCharactersCache::isCharacterForThisFont
+ * \brief TgFontCharactersCache::isCharacterForFont
  *
  * \param character [in]
- * \param fontFileName [in]
+ * \param fontCharacters [in] characters of the font (getFontCharacters()), can be nullptr
  * \return true if character exists in the font
  */
-bool TgFontCharactersCache::isCharacterForThisFont(const uint32_t character, const std::string &fontFileName)
+bool TgFontCharactersCache::isCharacterForFont(const uint32_t character, const TgFontCharacterCache *fontCharacters)
+{
+    return fontCharacters
+        && std::binary_search(fontCharacters->m_listCharacter.begin(), fontCharacters->m_listCharacter.end(), character);
+}
+
+/*!
+ * \brief TgFontCharactersCache::getFontCharacters
+ *
+ * get characters of the fonts in the font chain, so characters of the text
+ * can be searched from the fonts (getFontIndexForCharacter()), characters are
+ * read from the font entries of the chain, so this does not lock
+ *
+ * \param fontChain [in] font chain (TgFontDefault::getFontChain())
+ * \return characters of each font (same index as fontChain's fonts),
+ * nullptr if characters of the font could not be read
+ */
+std::vector<const TgFontCharacterCache *> TgFontCharactersCache::getFontCharacters(const TgFontChain &fontChain)
 {
-    uint32_t i;
-    std::vector<TgFontCharacterCache *>::const_iterator it;
-    if (fontFileName.empty()) {
-        return false;
+    size_t i;
+    std::vector<const TgFontCharacterCache *> ret(fontChain.m_listFont.size(), nullptr);
+    for (i=0;i<fontChain.m_listFont.size();i++) {
+        ret[i] = fontChain.m_listFont[i]->m_characters.load(std::memory_order_acquire);
     }
-    for (it=m_listCharacters.begin();it!=m_listCharacters.end();it++) {
-        if ((*it)->m_filename == fontFileName) {
-            for (i=0;i<(*it)->m_supported_characters->character_list_count;i++) {
-                if (character == (*it)->m_supported_characters->list_character[i]) {
-                    return true;
-                }
-            }
-        }
+    return ret;
+}
+
+/*!
+ * \brief TgFontCharactersCache::getCharactersForFont
+ *
+ * \param fontCharacters [in] characters of the font (TgFontDefault::getFontCharacters())
+ * \param firstCharacter [in] first character of the range
+ * \param lastCharacter [in] last character of the range
+ * \return characters in range [firstCharacter, lastCharacter] that exist in the font
+ */
+std::vector<uint32_t> TgFontCharactersCache::getCharactersForFont(const TgFontCharacterCache *fontCharacters, uint32_t firstCharacter, uint32_t lastCharacter)
+{
+    if (!fontCharacters || firstCharacter > lastCharacter) {
+        return std::vector<uint32_t>();
     }
-    return false;
+    return std::vector<uint32_t>(std::lower_bound(fontCharacters->m_listCharacter.begin(), fontCharacters->m_listCharacter.end(), firstCharacter),
+                                 std::upper_bound(fontCharacters->m_listCharacter.begin(), fontCharacters->m_listCharacter.end(), lastCharacter));
 }
 
 /*!
  * \brief TgFontCharactersCache::getFontIndexForCharacter
  *
+ * fonts are got with getFontCharacters(), so this does not lock
+ * or compare file names
+ *
  * \param character [in]
- * \param fontFileName [in] first (main) font to use search character, fontFileName must be in listFontFiles
- * \param listFontFiles [in] list of fonts in files
- * \return index of font
+ * \param previousFontIndex [in] font (index of listFontCharacters) to use first, -1 if none
+ * \param listFontCharacters [in] characters of the fonts, main font first
+ * \return index of font, -1 if character is not in any font
  */
-int TgFontCharactersCache::getFontIndexForCharacter(const uint32_t character, const std::string &fontFileName,
-                                                    const std::vector<std::string>&listFontFiles)
+int TgFontCharactersCache::getFontIndexForCharacter(const uint32_t character, int previousFontIndex,
+                                                    const std::vector<const TgFontCharacterCache *>&listFontCharacters)
 {
     size_t i;
-    if (isCharacterForThisFont(character, fontFileName)) {
-        for (i=0;i<listFontFiles.size();i++) {
-            if (listFontFiles.at(i) == fontFileName) {
-                return static_cast<int>(i);
-            }
-        }
+    if (previousFontIndex >= 0
+        && static_cast<size_t>(previousFontIndex) < listFontCharacters.size()
+        && isCharacterForFont(character, listFontCharacters[static_cast<size_t>(previousFontIndex)])) {
+        return previousFontIndex;
     }
-
-    for (i=0;i<listFontFiles.size();i++) {
-        if (listFontFiles.at(i) != fontFileName) {
-            if (isCharacterForThisFont(character, listFontFiles.at(i))) {
-                return static_cast<int>(i);
-            }
+    for (i=0;i<listFontCharacters.size();i++) {
+        if (static_cast<int>(i) != previousFontIndex
+            && isCharacterForFont(character, listFontCharacters[i])) {
+            return static_cast<int>(i);
         }
     }
-
     return -1;
 }
 
@@ -199,6 +237,7 @@ std::vector<int> TgFontCharactersCache::getSupportedFontsForCharacters(const uin
     size_t i, listCharactersIndex;
     std::vector<TgFontCharacterCache *> listCharacters;
 
+    m_mutex.lock();
     for (i=0;i<listFontFiles.size();i++) {
         for (listCharactersIndex=0;listCharactersIndex<m_listCharacters.size();listCharactersIndex++) {
             if (listFontFiles.at(i) == m_listCharacters.at(listCharactersIndex)->m_filename) {
@@ -207,10 +246,12 @@ std::vector<int> TgFontCharactersCache::getSupportedFontsForCharacters(const uin
                 break;
             }
         }
-        if (!found && addFont(listFontFiles.at(i))) {
+        if (!found && addFontWithoutLock(listFontFiles.at(i))) {
             listCharacters.push_back(m_listCharacters.back());
         }
     }
+    // font characters are not removed before destructor, so they can be used without lock
+    m_mutex.unlock();
 
     return getSupportedFontsForCharacters(list_characters, list_characters_size, listCharacters);
 }
@@ -17,10 +17,18 @@
 #include <mutex>
 #include <prj-ttf-reader.h>
 
+struct TgFontChain;
+
+/*!
+ * \brief TgFontCharacterCache
+ * supported characters of the font, it's not changed or removed
+ * before TgFontCharactersCache is destroyed, so it can be read without lock
+ */
 struct TgFontCharacterCache
 {
     prj_ttf_reader_supported_characters_t *m_supported_characters;
     std::string m_filename;
+    std::vector<uint32_t> m_listCharacter;      /*!< sorted supported characters */
 };
 
 class TgFontCharactersCache
@@ -29,15 +37,18 @@ public:
     TgFontCharactersCache();
     ~TgFontCharactersCache();
 
-    bool addFont(const std::string &filename);
+    const TgFontCharacterCache *addFont(const std::string &filename);
     std::vector<int> getSupportedFontsForCharacters(const uint32_t *list_characters, const uint32_t list_characters_size, const std::vector<std::string>&listFontFiles);
 
-    bool isCharacterForThisFont(const uint32_t character, const std::string &fontFileName);
-    int getFontIndexForCharacter(const uint32_t character, const std::string &fontFileName, const std::vector<std::string>&listFontFiles);
+    static std::vector<uint32_t> getCharactersForFont(const TgFontCharacterCache *fontCharacters, uint32_t firstCharacter, uint32_t lastCharacter);
+    static std::vector<const TgFontCharacterCache *> getFontCharacters(const TgFontChain &fontChain);
+    static int getFontIndexForCharacter(const uint32_t character, int previousFontIndex, const std::vector<const TgFontCharacterCache *>&listFontCharacters);
+    static bool isCharacterForFont(const uint32_t character, const TgFontCharacterCache *fontCharacters);
 private:
     std::vector<TgFontCharacterCache *>m_listCharacters;
     std::mutex m_mutex;
 
+    TgFontCharacterCache *addFontWithoutLock(const std::string &filename);
     static std::vector<int> getSupportedFontsForCharacters(const uint32_t *list_characters, const uint32_t list_characters_size, const std::vector<TgFontCharacterCache *>&listCharacters);
 
 };
@@ -18,7 +18,6 @@
 #include "../tg_character_positions.h"
 #include "../tg_font_text.h"
 #include "../../global/tg_global_application.h"
-#define FONT_ACCURACY_VALUE 5
 
 TgFontGlyphCache::TgFontGlyphCache()
 {
@@ -27,16 +26,16 @@ TgFontGlyphCache::TgFontGlyphCache()
 TgFontGlyphCache::~TgFontGlyphCache()
 {
     std::vector<TgFontInfo *>::iterator it;
-    std::vector<TgRender *>::iterator itRender;
     for (it=m_listCachedFont.begin();it!=m_listCachedFont.end();it++) {
-        prj_ttf_reader_clear_data(&(*it)->m_data);
-        for (itRender=(*it)->m_listRender.begin();itRender!=(*it)->m_listRender.end();itRender++) {
-            delete (*itRender);
-        }
-        (*it)->m_listRender.clear();
+        clearFontInfoData(*it);
         delete (*it);
     }
     m_listCachedFont.clear();
+    for (it=m_listPendingUpload.begin();it!=m_listPendingUpload.end();it++) {
+        clearFontInfoData(*it);
+        delete (*it);
+    }
+    m_listPendingUpload.clear();
 }
 
 /*!
@@ -46,19 +45,20 @@ TgFontGlyphCache::~TgFontGlyphCache()
  * and texture
  *
  * \param listCharacters contains all charactes to make vertices and texture
- * \param fontFile full file path of the font file
+ * \param fontId font id (TgFontDefault::getFontId())
  * \param fontSize font size
  * \return nullptr if not, otherwise cached TgFontInfo
  */
-TgFontInfo *TgFontGlyphCache::isFontCached(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize)
+TgFontInfo *TgFontGlyphCache::isFontCached(const std::vector<uint32_t> &listCharacters, uint32_t fontId, float fontSize)
 {
     TG_FUNCTION_BEGIN();
     bool notFound;
     std::vector<TgFontInfo *>::iterator it;
     std::vector<uint32_t>::const_iterator itListCharacters;
+    m_mutex.lock();
     for (it=m_listCachedFont.begin();it!=m_listCachedFont.end();it++) {
         if (memcmp(&(*it)->m_fontSize, &fontSize, sizeof(float)) == 0
-            && (*it)->m_fontFile.compare(fontFile) == 0) {
+            && (*it)->m_fontId == fontId) {
             notFound = false;
             for (itListCharacters=listCharacters.begin();itListCharacters!=listCharacters.end();itListCharacters++) {
                 if (std::find((*it)->m_listCharacter.begin(), (*it)->m_listCharacter.end(), (*itListCharacters)) == (*it)->m_listCharacter.end()) {
@@ -67,15 +67,53 @@ TgFontInfo *TgFontGlyphCache::isFontCached(const std::vector<uint32_t> &listChar
                 }
             }
             if (!notFound) {
+                m_mutex.unlock();
                 TG_FUNCTION_END();
                 return (*it);
             }
         }
     }
+    m_mutex.unlock();
     TG_FUNCTION_END();
     return nullptr;
 }
 
+/*!
+ * \brief TgFontGlyphCache::getCachedFontCount
+ *
+ * \return count of fonts in the cache
+ */
+size_t TgFontGlyphCache::getCachedFontCount()
+{
+    m_mutex.lock();
+    size_t ret = m_listCachedFont.size();
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphCache::findSameFont
+ *
+ * searches font from the cache that has exactly same glyphs as info,
+ * two worker threads can prepare the same font at the same time,
+ * m_mutex must be locked before calling this
+ *
+ * \param info
+ * \return nullptr if not found, otherwise cached TgFontInfo
+ */
+TgFontInfo *TgFontGlyphCache::findSameFont(const TgFontInfo *info)
+{
+    std::vector<TgFontInfo *>::iterator it;
+    for (it=m_listCachedFont.begin();it!=m_listCachedFont.end();it++) {
+        if (memcmp(&(*it)->m_fontSize, &info->m_fontSize, sizeof(float)) == 0
+            && (*it)->m_fontId == info->m_fontId
+            && (*it)->m_listCharacter == info->m_listCharacter) {
+            return (*it);
+        }
+    }
+    return nullptr;
+}
+
 /*!
  * \brief TgFontGlyphCache::generateCacheForText
  *
@@ -91,136 +129,346 @@ TgFontInfo *TgFontGlyphCache::isFontCached(const std::vector<uint32_t> &listChar
 TgFontInfo *TgFontGlyphCache::generateCacheForText(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, bool onlyForCalculation)
 {
     TG_FUNCTION_BEGIN();
-    TgFontInfo *ret = isFontCached(listCharacters, fontFile, fontSize);
-    if (ret) {
-        return ret;
-    }
+    std::vector<TgFontGlyphCacheRequest> listRequest(1);
+    listRequest[0].m_listCharacters = listCharacters;
+    listRequest[0].m_fontFile = fontFile;
+    listRequest[0].m_fontId = TgGlobalApplication::getInstance()->getFontDefault()->getFontId(fontFile);
+    TgFontInfo *ret = generateCacheForTexts(listRequest, fontSize, onlyForCalculation)[0];
+    TG_FUNCTION_END();
+    return ret;
+}
 
-    std::string additionalCharactersToGlyph = "ABCQWERTYUIOPÅSDFGHJKLÖÄZXVNMqwertyuiopasdfgjhklöäzxcvbnm<>|;:,.-_€'*~^1234567890+'!\"#¤%&/()=?½@£$‰‚{[]}— ";
-    uint32_t *list_additonal_characters = nullptr, list_additonal_characters_size;
-    if (prj_ttf_reader_get_characters(additionalCharactersToGlyph.c_str(), &list_additonal_characters, &list_additonal_characters_size)
-            || !list_additonal_characters_size) {
-        TG_FUNCTION_END();
-        return nullptr;
+/*!
+ * \brief TgFontGlyphCache::generateCacheForTexts
+ *
+ * generates image's vertices and texture for several font files at once,
+ * glyphs that are not yet cached are rasterized in parallel on the
+ * worker threads, and only the texture upload is done on this (OpenGL) thread
+ *
+ * \param listRequest [in/out] list of characters and font file for each font
+ * \param fontSize font size
+ * \param onlyForCalculation if true, then these TgFontInfos are not set into cache
+ * \return generated TgFontInfo for each listRequest (nullptr if fails)
+ */
+std::vector<TgFontInfo *> TgFontGlyphCache::generateCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize, bool onlyForCalculation)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<TgFontInfo *> ret(listRequest.size(), nullptr);
+    for (i=0;i<listRequest.size();i++) {
+        ret[i] = isFontCached(listRequest[i].m_listCharacters, listRequest[i].m_fontId, fontSize);
+        listRequest[i].m_generate = !ret[i] && TgFontGlyphCacheData::getCharactersForCache(listRequest[i].m_listCharacters, listRequest[i].m_fontId,
+                                                                                           listRequest[i].m_listGlyphCharacters);
     }
-
-    std::vector<uint32_t> newListCharacters = listCharacters;
-    for (uint32_t i=0;i<list_additonal_characters_size;i++) {
-        if (std::find(newListCharacters.begin(), newListCharacters.end(), list_additonal_characters[i]) == newListCharacters.end()
-            && TgGlobalApplication::getInstance()->getFontCharactersCache()->isCharacterForThisFont(list_additonal_characters[i], fontFile) ) {
-            newListCharacters.push_back(list_additonal_characters[i]);
+    TgFontGlyphCacheData::generateGlyphs(listRequest, fontSize);
+    for (i=0;i<listRequest.size();i++) {
+        if (listRequest[i].m_generate) {
+            ret[i] = generateCache(listRequest[i], fontSize, onlyForCalculation);
         }
     }
-    std::vector<uint32_t>::iterator it;
-    it = std::find(newListCharacters.begin(), newListCharacters.end(), 'A');
-    if (it != newListCharacters.end()) {
-        newListCharacters.erase(it);
-        // we set 'A' as a first character, because it's good for font height calculation
-        newListCharacters.insert(newListCharacters.begin(), 'A');
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphCache::prepareCacheForTexts
+ *
+ * same as generateCacheForTexts(), but this does not use OpenGL, so
+ * this can be called from the worker thread. Font infos that are not
+ * yet cached have m_uploadPending set, and they can be used for
+ * calculations, but uploadPreparedCache() must be called on OpenGL thread
+ * before rendering them
+ *
+ * \param listRequest [in/out] list of characters and font file for each font
+ * \param fontSize font size
+ * \return TgFontInfo for each listRequest (nullptr if fails)
+ */
+std::vector<TgFontInfo *> TgFontGlyphCache::prepareCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<TgFontInfo *> ret(listRequest.size(), nullptr);
+    for (i=0;i<listRequest.size();i++) {
+        ret[i] = isFontCached(listRequest[i].m_listCharacters, listRequest[i].m_fontId, fontSize);
+        listRequest[i].m_generate = !ret[i] && TgFontGlyphCacheData::getCharactersForCache(listRequest[i].m_listCharacters, listRequest[i].m_fontId,
+                                                                                           listRequest[i].m_listGlyphCharacters);
+    }
+    TgFontGlyphCacheData::generateGlyphs(listRequest, fontSize);
+    for (i=0;i<listRequest.size();i++) {
+        if (listRequest[i].m_generate) {
+            ret[i] = prepareCache(listRequest[i], fontSize);
+            if (ret[i]) {
+                ret[i]->m_uploadPending = true;
+            }
+        }
     }
+    TG_FUNCTION_END();
+    return ret;
+}
 
-    ret = generateCache(newListCharacters, fontFile, fontSize, onlyForCalculation);
-    free(list_additonal_characters);
+/*!
+ * \brief TgFontGlyphCache::uploadPreparedCache
+ *
+ * uploads textures and vertices of the font infos (of the fontText)
+ * that were prepared with prepareCacheForTexts(), and adds them into cache
+ * must be called on OpenGL thread
+ *
+ * \param fontText
+ * \return false if any upload fails
+ */
+bool TgFontGlyphCache::uploadPreparedCache(TgFontText *fontText)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    bool ret = true;
+    for (i=0;i<fontText->getCharacterCount();i++) {
+        TgFontInfo *info = fontText->getFontInfo(i);
+        if (!info || !info->m_uploadPending) {
+            continue;
+        }
+        info->m_uploadPending = false;
+        TgFontInfo *cachedInfo = uploadCache(info);
+        if (!cachedInfo) {
+            ret = false;
+        } else if (cachedInfo != info) {
+            // other text prepared the same glyphs and it's already in cache
+            fontText->replaceFontInfo(info, cachedInfo);
+            clearFontInfoData(info);
+            delete info;
+        }
+    }
     TG_FUNCTION_END();
     return ret;
 }
 
+/*!
+ * \brief TgFontGlyphCache::addPreparedCache
+ *
+ * adds font info prepared with prepareCacheForTexts() to be
+ * uploaded (and added into cache) on next uploadPendingCache()
+ * this can be called from the worker thread
+ *
+ * \param info
+ */
+void TgFontGlyphCache::addPreparedCache(TgFontInfo *info)
+{
+    m_mutex.lock();
+    info->m_uploadPending = false;
+    m_listPendingUpload.push_back(info);
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgFontGlyphCache::uploadPendingCache
+ *
+ * uploads font infos added with addPreparedCache() into cache,
+ * must be called on OpenGL thread
+ */
+void TgFontGlyphCache::uploadPendingCache()
+{
+    size_t i;
+    std::vector<TgFontInfo *> listUpload;
+    m_mutex.lock();
+    listUpload.swap(m_listPendingUpload);
+    m_mutex.unlock();
+    for (i=0;i<listUpload.size();i++) {
+        if (uploadCache(listUpload[i]) != listUpload[i]) {
+            clearFontInfoData(listUpload[i]);
+            delete listUpload[i];
+        }
+    }
+}
+
 /*!
  * \brief TgFontGlyphCache::generateCache
  *
- * generates image's vertices and texture
+ * generates image's vertices and texture from generated glyphs
  *
- * \param listCharacters list of characters
- * \param fontFile full file path of the font file
+ * \param request [in/out] generated glyphs, ownership of the glyphs moves into returned font info
  * \param fontSize font size
+ * \param onlyForCalculation if true, then this TgFontInfo is not set into cache
  * \return nullptr if fails, generated TgFontInfo otherwise
  */
-TgFontInfo *TgFontGlyphCache::generateCache(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, bool onlyForCalculation)
+TgFontInfo *TgFontGlyphCache::generateCache(TgFontGlyphCacheRequest &request, float fontSize, bool onlyForCalculation)
 {
     TG_FUNCTION_BEGIN();
-    prj_ttf_reader_data_t *data;
-    data = prj_ttf_reader_init_data();
-    if (!data) {
-        TG_ERROR_LOG("prj_ttf_reader_init_data return failed");
+    TgFontInfo *newInfo = prepareCache(request, fontSize);
+    if (!newInfo) {
         TG_FUNCTION_END();
         return nullptr;
     }
-    if (prj_ttf_reader_generate_glyphs_list_characters(listCharacters.data(), static_cast<uint32_t>(listCharacters.size()), fontFile, fontSize, FONT_ACCURACY_VALUE, data)
-        || !data->image.width
-        || !data->image.height) {
-        prj_ttf_reader_clear_data(&data);
-        TG_ERROR_LOG("generating glyphs failed");
+    if (onlyForCalculation) {
+        TgFontGlyphDiskCache::releaseImage(newInfo->m_diskData);
         TG_FUNCTION_END();
-        return nullptr;
+        return newInfo;
     }
-
-    TgFontInfo *newInfo = new TgFontInfo;
-    newInfo->m_data = data;
-    if (!onlyForCalculation && !addImage(newInfo)) {
-        TG_ERROR_LOG("creating the texture failed");
-        prj_ttf_reader_clear_data(&data);
+    TgFontInfo *cachedInfo = uploadCache(newInfo);
+    if (cachedInfo != newInfo) {
+        clearFontInfoData(newInfo);
         delete newInfo;
-        TG_FUNCTION_END();
-        return nullptr;
     }
+    TG_FUNCTION_END();
+    return cachedInfo;
+}
 
-    if (!generateTextVertices(newInfo, listCharacters, onlyForCalculation)) {
+/*!
+ * \brief TgFontGlyphCache::prepareCache
+ *
+ * generates font info from generated glyphs, without OpenGL
+ * (no texture or vertex buffers)
+ *
+ * \param request [in/out] generated glyphs, ownership of the glyphs moves into returned font info
+ * \param fontSize font size
+ * \return nullptr if fails, generated TgFontInfo otherwise
+ */
+TgFontInfo *TgFontGlyphCache::prepareCache(TgFontGlyphCacheRequest &request, float fontSize)
+{
+    TG_FUNCTION_BEGIN();
+    TgFontInfo *newInfo = new TgFontInfo;
+    int imageWidth, imageHeight;
+    const unsigned char *image;
+
+    newInfo->m_data = request.m_data;
+    newInfo->m_diskData = request.m_diskData;
+    request.m_data = nullptr;
+    request.m_diskData = nullptr;
+    getImage(newInfo, imageWidth, imageHeight, image);
+
+    if (!generateTextVertices(newInfo, request.m_listGlyphCharacters, imageWidth, imageHeight)) {
         TG_ERROR_LOG("creating the text vertices failed");
-        prj_ttf_reader_clear_data(&data);
+        clearFontInfoData(newInfo);
         delete newInfo;
         TG_FUNCTION_END();
         return nullptr;
     }
 
-    newInfo->m_fontFile = fontFile;
+    newInfo->m_fontId = request.m_fontId;
     newInfo->m_fontSize = fontSize;
-    if (!onlyForCalculation) {
-        newInfo->m_addedToCache = true;
-        m_listCachedFont.push_back(newInfo);
-    }
     TG_FUNCTION_END();
     return newInfo;
 }
 
 /*!
- * \brief TgFontGlyphCache::render
+ * \brief TgFontGlyphCache::uploadCache
+ *
+ * creates texture for prepared font info
+ * and adds it into cache, if same font is already in the cache
+ * (prepared by other worker thread), then it's not added again.
+ * Fonts are added into the cache only on OpenGL thread, so same font
+ * can't be added between the check and the insert
+ *
+ * \param info [in/out]
+ * \return nullptr if fails, otherwise font info in the cache (info or
+ * already cached font, then caller must delete the info)
+ */
+TgFontInfo *TgFontGlyphCache::uploadCache(TgFontInfo *info)
+{
+    TG_FUNCTION_BEGIN();
+    int imageWidth, imageHeight;
+    const unsigned char *image;
+    m_mutex.lock();
+    TgFontInfo *cachedInfo = findSameFont(info);
+    m_mutex.unlock();
+    if (cachedInfo) {
+        TG_FUNCTION_END();
+        return cachedInfo;
+    }
+    getImage(info, imageWidth, imageHeight, image);
+
+    if (!addImage(info, imageWidth, imageHeight, image)) {
+        TG_ERROR_LOG("creating the texture failed");
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+    // glyph atlas is in the texture now, only glyph metrics are needed from disk cache
+    TgFontGlyphDiskCache::releaseImage(info->m_diskData);
+
+    m_mutex.lock();
+    info->m_addedToCache = true;
+    m_listCachedFont.push_back(info);
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return info;
+}
+
+/*!
+ * \brief TgFontGlyphCache::getImage
+ *
+ * get glyph atlas image of the font info
+ *
+ * \param info
+ * \param imageWidth [out] width of the glyph atlas image
+ * \param imageHeight [out] height of the glyph atlas image
+ * \param image [out] glyph atlas image (1 byte per pixel)
+ */
+void TgFontGlyphCache::getImage(const TgFontInfo *info, int &imageWidth, int &imageHeight, const unsigned char *&image)
+{
+    if (info->m_data) {
+        imageWidth = info->m_data->image.width;
+        imageHeight = info->m_data->image.height;
+        image = info->m_data->image.data;
+    } else {
+        imageWidth = info->m_diskData->m_imageWidth;
+        imageHeight = info->m_diskData->m_imageHeight;
+        image = info->m_diskData->m_image;
+    }
+}
+
+/*!
+ * \brief TgFontGlyphCache::clearFontInfoData
+ *
+ * clears the glyph data of the font info (either generated or loaded from disk cache)
+ *
+ * \param info [in/out]
+ */
+void TgFontGlyphCache::clearFontInfoData(TgFontInfo *info)
+{
+    if (info->m_data) {
+        prj_ttf_reader_clear_data(&info->m_data);
+    }
+    TgFontGlyphDiskCache::clearData(&info->m_diskData);
+}
+
+/*!
+ * \brief TgFontGlyphCache::getCharacterVertices
+ *
+ * get 6 vertices (2 triangles) of the character to draw,
+ * if the character is not drawn, vertices are set to zero
  *
- * Renders the text
  * \param fontText
- * \param vertexTransformIndex vertex tranform index in shader's uniform location
- * \param shaderColorIndex shader color index
- * \param listMatrix list of matrixes for each character to shader
+ * \param characterIndex character index in fontText
+ * \param x x position of the character on window
+ * \param y y position of the character (line) on window
+ * \param vertices [out] 6 vertices
+ * \return true if character is drawn
  */
-void TgFontGlyphCache::render(TgFontText *fontText, const int vertexTransformIndex, const int shaderColorIndex, const std::vector<TgMatrix4x4>&listMatrix)
+bool TgFontGlyphCache::getCharacterVertices(TgFontText *fontText, size_t characterIndex, float x, float y, VerticeColor *vertices)
 {
-    size_t i, c = fontText->getCharacterCount();
-    uint8_t r = 0, g = 0, b = 0;
-    bool colorFirstTime = true;
-    for (i=0;i<c;i++) {
-        if (!fontText->getFontInfo(i)
-            || fontText->getCharacter(i)->m_character == '\n'
-            || !fontText->getCharacter(i)->m_draw
-            || fontText->getCharacter(i)->m_fontFileNameIndex == -1) {
-            continue;
-        }
-        glUniformMatrix4fv(vertexTransformIndex, 1, 0, listMatrix[i].getMatrixTable()->data);
-        if (fontText->getCharacter(i)->m_textColorR != r
-            || fontText->getCharacter(i)->m_textColorG != g
-            || fontText->getCharacter(i)->m_textColorB != b
-            || colorFirstTime) {
-            glUniform4f(shaderColorIndex,
-                static_cast<float>(fontText->getCharacter(i)->m_textColorR )/255.0f,
-                static_cast<float>(fontText->getCharacter(i)->m_textColorG )/255.0f,
-                static_cast<float>(fontText->getCharacter(i)->m_textColorB )/255.0f, 1);
-            r = fontText->getCharacter(i)->m_textColorR;
-            g = fontText->getCharacter(i)->m_textColorG;
-            b = fontText->getCharacter(i)->m_textColorB;
-            colorFirstTime = false;
-        }
-        if (fontText->getCharacter(i)->m_characterInFontInfoIndex < fontText->getFontInfo(i)->m_listRender.size()) {
-            fontText->getFontInfo(i)->m_listRender[ fontText->getCharacter(i)->m_characterInFontInfoIndex ]->render( fontText->getFontInfo(i)->m_textureImage, 0, 4, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-        }
+    size_t i;
+    const TgFontTextCharacterInfo *character = fontText->getCharacter(characterIndex);
+    const TgFontInfo *info = fontText->getFontInfo(characterIndex);
+    if (!info
+        || character->m_character == '\n'
+        || !character->m_draw
+        || character->m_fontFileNameIndex == -1
+        || character->m_characterInFontInfoIndex*4+3 >= info->m_listVertice.size()) {
+        memset(vertices, 0, sizeof(VerticeColor)*6);
+        return false;
+    }
+    // triangle strip 0, 1, 2, 3 as triangles 0, 1, 2 and 2, 1, 3
+    static const size_t listQuadIndex[6] = { 0, 1, 2, 2, 1, 3 };
+    const Vertice *quad = &info->m_listVertice[character->m_characterInFontInfoIndex*4];
+    for (i=0;i<6;i++) {
+        vertices[i].x = quad[listQuadIndex[i]].x + x;
+        vertices[i].y = quad[listQuadIndex[i]].y + y;
+        vertices[i].s = quad[listQuadIndex[i]].s;
+        vertices[i].t = quad[listQuadIndex[i]].t;
+        vertices[i].r = character->m_textColorR;
+        vertices[i].g = character->m_textColorG;
+        vertices[i].b = character->m_textColorB;
+        vertices[i].a = 255;
     }
+    return true;
 }
 
 /*!
@@ -244,71 +492,56 @@ void TgFontGlyphCache::getTextPosition(TgFontText *fontText, size_t cursorPositi
     }
 }
 
-size_t TgFontGlyphCache::getTextCharacterIndex(TgFontText *fontText, const float x)
+/*!
+ * \brief TgFontGlyphCache::getTextCharacterIndex
+ *
+ * characters of the line are searched first, and then
+ * binary search over the x positions of the line
+ *
+ * \param fontText [in] text
+ * \param x x position in the text
+ * \param lineNumber line number (0 == first line)
+ * \return character index by the x, if x is after the line,
+ * then index after the last character of the line
+ */
+size_t TgFontGlyphCache::getTextCharacterIndex(TgFontText *fontText, const float x, const uint32_t lineNumber)
 {
     TG_FUNCTION_BEGIN();
+    size_t start, end;
+    TgFontTextLayout *layout = fontText->getLayout();
+    layout->getLineRange(lineNumber, start, end);
+    // line break that ended the previous line is at the start of this line
+    if (start < end && fontText->getCharacter(start)->m_character == '\n') {
+        start++;
+    }
     if (x <= 0) {
         TG_FUNCTION_END();
-        return 0;
+        return start;
     }
 
-    if (x >= fontText->getTextWidth()) {
+    if (x >= fontText->getTextLineWidth(lineNumber)) {
         TG_FUNCTION_END();
-        return fontText->getCharacterCount();
-    }
-
-    const size_t characterCount = fontText->getCharacterCount();
-    size_t ret = static_cast<size_t>(x*static_cast<float>(characterCount)/fontText->getTextWidth());
-    float characterPositionX;
-    int previousAdd = 0;
-    while (1) {
-        getTextPosition(fontText, ret, characterPositionX);
-        if (characterPositionX < x) {
-            if (ret == characterCount) {
-                TG_FUNCTION_END();
-                return ret;
-            }
-            if (previousAdd == -1) {
-                TG_FUNCTION_END();
-                return ret;
-            }
-            ret++;
-            previousAdd = 1;
-        } else if (characterPositionX > x) {
-            if (ret == 0) {
-                TG_FUNCTION_END();
-                return ret;
-            }
-            if (previousAdd == 1) {
-                if (ret > 0) {
-                    TG_FUNCTION_END();
-                    return ret - 1;
-                }
-                TG_FUNCTION_END();
-                return ret;
-            }
-            ret--;
-            previousAdd = -1;
-        } else {
-            TG_FUNCTION_END();
-            return ret;
-        }
+        return end;
     }
 
+    size_t ret = layout->getCharacterIndex(start, end, x);
     TG_FUNCTION_END();
+    return ret;
 }
 
 /*!
  * \brief TgFontGlyphCache::generateTextVertices
  *
- * generate text vertices for the text
+ * generates glyph quad vertices of the characters, this does not use OpenGL
  *
  * \param newInfo [in/out] info
  * \param listCharacters contains the text to render
- * \param onlyForCalculation if true, then this TgFontInfo is not set into cache
+ * \param imageWidth width of the glyph atlas image
+ * \param imageHeight height of the glyph atlas image
  * \return true on success
  */
-bool TgFontGlyphCache::generateTextVertices(TgFontInfo *newInfo, const std::vector<uint32_t> &listCharacters, bool onlyForCalculation)
+bool TgFontGlyphCache::generateTextVertices(TgFontInfo *newInfo, const std::vector<uint32_t> &listCharacters,
+                                            int imageWidth, int imageHeight)
 {
     TG_FUNCTION_BEGIN();
     size_t i, c = listCharacters.size();
@@ -317,14 +550,13 @@ bool TgFontGlyphCache::generateTextVertices(TgFontInfo *newInfo, const std::vect
     Vertice *vertices;
     const prj_ttf_reader_glyph_data_t *glyph;
 
-    vertices = new Vertice[4];
+    // characters without glyph are left as zero size quad
+    newInfo->m_listVertice.resize(newInfo->m_listVertice.size() + c*4, Vertice{0, 0, 0, 0});
     for (i=0;i<c;i++) {
-        if (!onlyForCalculation) {
-            newInfo->m_listRender.push_back(new TgRender());
-        }
+        vertices = &newInfo->m_listVertice[newInfo->m_listCharacter.size()*4];
         newInfo->m_listCharacter.push_back(listCharacters.at(i));
 
-        glyph = prj_ttf_reader_get_character_glyph_data(listCharacters.at(i), newInfo->m_data);
+        glyph = TgFontGlyphDiskCache::getCharacterGlyphData(listCharacters.at(i), newInfo->m_data, newInfo->m_diskData);
         if (!glyph) {
             continue;
         }
@@ -338,33 +570,28 @@ bool TgFontGlyphCache::generateTextVertices(TgFontInfo *newInfo, const std::vect
 
         vertices[0].x = 0;
         vertices[0].y = bottomY - static_cast<float>(glyph->image_pixel_bottom_y-glyph->image_pixel_top_y) - static_cast<float>(glyph->image_pixel_offset_line_y);
-        vertices[0].s = static_cast<float>(glyph->image_pixel_left_x)/static_cast<float>(newInfo->m_data->image.width);
-        vertices[0].t = static_cast<float>(glyph->image_pixel_top_y)/static_cast<float>(newInfo->m_data->image.height);
+        vertices[0].s = static_cast<float>(glyph->image_pixel_left_x)/static_cast<float>(imageWidth);
+        vertices[0].t = static_cast<float>(glyph->image_pixel_top_y)/static_cast<float>(imageHeight);
 
         vertices[1].x = static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x);
         vertices[1].y = bottomY - static_cast<float>(glyph->image_pixel_bottom_y-glyph->image_pixel_top_y) - static_cast<float>(glyph->image_pixel_offset_line_y);
-        vertices[1].s = static_cast<float>(glyph->image_pixel_right_x)/static_cast<float>(newInfo->m_data->image.width);
-        vertices[1].t = static_cast<float>(glyph->image_pixel_top_y)/static_cast<float>(newInfo->m_data->image.height);
+        vertices[1].s = static_cast<float>(glyph->image_pixel_right_x)/static_cast<float>(imageWidth);
+        vertices[1].t = static_cast<float>(glyph->image_pixel_top_y)/static_cast<float>(imageHeight);
 
         vertices[2].x = 0;
         vertices[2].y = bottomY - static_cast<float>(glyph->image_pixel_offset_line_y);
-        vertices[2].s = static_cast<float>(glyph->image_pixel_left_x)/static_cast<float>(newInfo->m_data->image.width);
-        vertices[2].t = static_cast<float>(glyph->image_pixel_bottom_y)/static_cast<float>(newInfo->m_data->image.height);
+        vertices[2].s = static_cast<float>(glyph->image_pixel_left_x)/static_cast<float>(imageWidth);
+        vertices[2].t = static_cast<float>(glyph->image_pixel_bottom_y)/static_cast<float>(imageHeight);
 
         vertices[3].x = static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x);
         vertices[3].y = bottomY - static_cast<float>(glyph->image_pixel_offset_line_y);
-        vertices[3].s = static_cast<float>(glyph->image_pixel_right_x)/static_cast<float>(newInfo->m_data->image.width);
-        vertices[3].t = static_cast<float>(glyph->image_pixel_bottom_y)/static_cast<float>(newInfo->m_data->image.height);
+        vertices[3].s = static_cast<float>(glyph->image_pixel_right_x)/static_cast<float>(imageWidth);
+        vertices[3].t = static_cast<float>(glyph->image_pixel_bottom_y)/static_cast<float>(imageHeight);
 
         newInfo->m_listTopPositionY.push_back(vertices[0].y);
         newInfo->m_listBottomPositionY.push_back(static_cast<float>(glyph->image_pixel_offset_line_y*-1));
-        if (!onlyForCalculation) {
-            newInfo->m_listRender.back()->init(vertices, 4, true);
-        }
     }
 
-
-    delete[]vertices;
     TG_FUNCTION_END();
     return true;
 }
@@ -375,9 +602,12 @@ bool TgFontGlyphCache::generateTextVertices(TgFontInfo *newInfo, const std::vect
  * Create image from data to 2D texture image in TgFontInfo
  *
  * \param newInfo [in/out] texture will be set here
+ * \param imageWidth width of the glyph atlas image
+ * \param imageHeight height of the glyph atlas image
+ * \param image glyph atlas image (1 byte per pixel)
  * \return true on success
  */
-bool TgFontGlyphCache::addImage(TgFontInfo *newInfo)
+bool TgFontGlyphCache::addImage(TgFontInfo *newInfo, int imageWidth, int imageHeight, const unsigned char *image)
 {
     TG_FUNCTION_BEGIN();
     int x, y, i;
@@ -392,12 +622,12 @@ bool TgFontGlyphCache::addImage(TgFontInfo *newInfo)
     }
 
     glBindTexture(GL_TEXTURE_2D, newInfo->m_textureImage);
-    imageData = new unsigned char[newInfo->m_data->image.width*newInfo->m_data->image.height*4];
+    imageData = new unsigned char[imageWidth*imageHeight*4];
 
-    for (x=0;x<newInfo->m_data->image.width;x++) {
-        for (y=0;y<newInfo->m_data->image.height;y++) {
+    for (x=0;x<imageWidth;x++) {
+        for (y=0;y<imageHeight;y++) {
             for (i=0;i<4;i++) {
-                imageData[(y*newInfo->m_data->image.width+x)*4+i] = newInfo->m_data->image.data[(y*newInfo->m_data->image.width+x)];
+                imageData[(y*imageWidth+x)*4+i] = image[(y*imageWidth+x)];
             }
         }
     }
@@ -407,7 +637,7 @@ bool TgFontGlyphCache::addImage(TgFontInfo *newInfo)
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, newInfo->m_data->image.width, newInfo->m_data->image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, imageWidth, imageHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
 
     delete[]imageData;
     TG_FUNCTION_END();
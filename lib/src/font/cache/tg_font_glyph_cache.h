@@ -14,25 +14,29 @@
 
 #include <vector>
 #include <string>
+#include <mutex>
 #include <GL/glew.h>
 #include <prj-ttf-reader.h>
-#include "../../math/tg_matrix4x4.h"
-#include "../../render/tg_render.h"
+#include "../../global/private/tg_global_defines.h"
+#include "tg_font_glyph_disk_cache.h"
+#include "tg_font_glyph_cache_data.h"
 
 struct TgFontText;
 
 struct TgFontInfo
 {
     prj_ttf_reader_data_t *m_data = nullptr;
+    TgFontGlyphDiskCacheData *m_diskData = nullptr;
     GLuint m_textureImage = 0;
-    std::vector<TgRender *>m_listRender;
+    std::vector<Vertice>m_listVertice;         /*!< glyph quad (4 vertices, triangle strip order) of each character in m_listCharacter */
     std::vector<uint32_t>m_listCharacter;
     std::vector<float>m_listTopPositionY;
     std::vector<float>m_listBottomPositionY;
-    std::string m_fontFile;
+    uint32_t m_fontId = 0;                      /*!< TgFontDefault::getFontId() */
     float m_fontSize = 0;
     float m_fontHeight = 0;
     bool m_addedToCache = false;
+    bool m_uploadPending = false;   /*!< glyphs are prepared without OpenGL, texture is not yet uploaded */
 };
 
 class TgFontGlyphCache
@@ -41,17 +45,32 @@ public:
     explicit TgFontGlyphCache();
     ~TgFontGlyphCache();
     TgFontInfo *generateCacheForText(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, bool onlyForCalculation);
-    void render(TgFontText *fontText, const int vertexTransformIndex, const int shaderColorIndex, const std::vector<TgMatrix4x4>&listMatrix);
+    std::vector<TgFontInfo *> generateCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize, bool onlyForCalculation);
+    std::vector<TgFontInfo *> prepareCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize);
+    bool uploadPreparedCache(TgFontText *fontText);
+    void addPreparedCache(TgFontInfo *info);
+    void uploadPendingCache();
+    static bool getCharacterVertices(TgFontText *fontText, size_t characterIndex, float x, float y, VerticeColor *vertices);
     void getTextPosition(TgFontText *fontText, size_t cursorPosition, float &positionX);
-    size_t getTextCharacterIndex(TgFontText *fontText, const float x);
+    size_t getTextCharacterIndex(TgFontText *fontText, const float x, const uint32_t lineNumber = 0);
+    static void clearFontInfoData(TgFontInfo *info);
+    size_t getCachedFontCount();
 
 private:
     std::vector<TgFontInfo *>m_listCachedFont;
-    TgFontInfo *isFontCached(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize);
-    TgFontInfo *generateCache(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, bool onlyForCalculation);
+    std::vector<TgFontInfo *>m_listPendingUpload;
+    std::mutex m_mutex;
+    TgFontInfo *isFontCached(const std::vector<uint32_t> &listCharacters, uint32_t fontId, float fontSize);
+    TgFontInfo *generateCache(TgFontGlyphCacheRequest &request, float fontSize, bool onlyForCalculation);
+    TgFontInfo *uploadCache(TgFontInfo *info);
+    TgFontInfo *findSameFont(const TgFontInfo *info);
 
-    static bool generateTextVertices(TgFontInfo *newInfo, const std::vector<uint32_t> &listCharacters, bool onlyForCalculation);
-    static bool addImage(TgFontInfo *newInfo);
+    static TgFontInfo *prepareCache(TgFontGlyphCacheRequest &request, float fontSize);
+    static void getImage(const TgFontInfo *info, int &imageWidth, int &imageHeight, const unsigned char *&image);
+
+    static bool generateTextVertices(TgFontInfo *newInfo, const std::vector<uint32_t> &listCharacters,
+                                     int imageWidth, int imageHeight);
+    static bool addImage(TgFontInfo *newInfo, int imageWidth, int imageHeight, const unsigned char *image);
 
 };
 
@@ -16,6 +16,8 @@
 #include <cmath>
 #include "../../global/tg_global_log.h"
 #include "../../global/tg_global_application.h"
+#include "../../global/private/tg_global_thread_pool.h"
+#include "../text/tg_text_transcode_utf8.h"
 #ifndef FONT_ACCURACY_VALUE
 #define FONT_ACCURACY_VALUE 5
 #endif
@@ -28,57 +30,176 @@ TgFontGlyphCacheData::TgFontGlyphCacheData()
 TgFontGlyphCacheData::~TgFontGlyphCacheData()
 {
     for (size_t i=0;i<m_listCachedData.size();i++) {
-        prj_ttf_reader_clear_data(&m_listCachedData[i]->m_data);
+        clearFontInfoData(m_listCachedData[i]);
         delete m_listCachedData[i];
     }
     m_listCachedData.clear();
 }
 
 /*!
- * \brief TgFontGlyphCache::generateCacheForText
+ * \brief TgFontGlyphCacheData::generateCacheForText
  *
- * generates image's vertices and texture for text (from list of characters)
- * if possible for using these vertices and textures in others
+ * generates glyph data for text (from list of characters)
+ * if possible for using these glyph data in others
  *
  * \param listCharacters list of characters
  * \param fontFile full file path of the font file
  * \param fontSize font size
- * \return nullptr if fails, generated TgFontInfo otherwise
+ * \return nullptr if fails, generated TgFontInfoData otherwise
  */
 TgFontInfoData *TgFontGlyphCacheData::generateCacheForText(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize)
 {
     TG_FUNCTION_BEGIN();
-    TgFontInfoData *ret = isFontCached(listCharacters, fontFile, fontSize);
-    if (ret) {
-        return ret;
+    std::vector<TgFontGlyphCacheRequest> listRequest(1);
+    listRequest[0].m_listCharacters = listCharacters;
+    listRequest[0].m_fontFile = fontFile;
+    listRequest[0].m_fontId = TgGlobalApplication::getInstance()->getFontDefault()->getFontId(fontFile);
+    TgFontInfoData *ret = generateCacheForTexts(listRequest, fontSize)[0];
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphCacheData::generateCacheForTexts
+ *
+ * generates glyph data for several font files at once,
+ * glyphs that are not yet cached are rasterized in parallel
+ *
+ * \param listRequest [in/out] list of characters and font file for each font
+ * \param fontSize font size
+ * \return generated TgFontInfoData for each listRequest (nullptr if fails)
+ */
+std::vector<TgFontInfoData *> TgFontGlyphCacheData::generateCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<TgFontInfoData *> ret(listRequest.size(), nullptr);
+    for (i=0;i<listRequest.size();i++) {
+        ret[i] = isFontCached(listRequest[i].m_listCharacters, listRequest[i].m_fontId, fontSize);
+        listRequest[i].m_generate = !ret[i] && getCharactersForCache(listRequest[i].m_listCharacters, listRequest[i].m_fontId,
+                                                                     listRequest[i].m_listGlyphCharacters);
     }
+    generateGlyphs(listRequest, fontSize);
+    for (i=0;i<listRequest.size();i++) {
+        if (listRequest[i].m_generate) {
+            ret[i] = generateCache(listRequest[i], fontSize);
+        }
+    }
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphCacheData::getCharactersForCache
+ *
+ * adds additional characters (that are in the font) into list of characters,
+ * so generated glyphs can be used also for other texts
+ *
+ * \param listCharacters list of characters
+ * \param fontId font id (TgFontDefault::getFontId())
+ * \param listGlyphCharacters [out] list of characters to generate glyphs
+ * \return true on success
+ */
+bool TgFontGlyphCacheData::getCharactersForCache(const std::vector<uint32_t> &listCharacters, uint32_t fontId, std::vector<uint32_t> &listGlyphCharacters)
+{
     std::string additionalCharactersToGlyph = "ABCQWERTYUIOPÅSDFGHJKLÖÄZXVNMqwertyuiopasdfgjhklöäzxcvbnm<>|;:,.-_€'*~^1234567890+'!\"#¤%&/()=?½@£$‰‚{[]}— ";
-    uint32_t *list_additonal_characters = nullptr, list_additonal_characters_size;
-    if (prj_ttf_reader_get_characters(additionalCharactersToGlyph.c_str(), &list_additonal_characters, &list_additonal_characters_size)
-            || !list_additonal_characters_size) {
-        TG_FUNCTION_END();
-        return nullptr;
+    std::vector<uint32_t> list_additonal_characters;
+    if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(additionalCharactersToGlyph, list_additonal_characters)
+            || list_additonal_characters.empty()) {
+        return false;
     }
 
-    std::vector<uint32_t> newListCharacters = listCharacters;
-    for (uint32_t i=0;i<list_additonal_characters_size;i++) {
-        if (std::find(newListCharacters.begin(), newListCharacters.end(), list_additonal_characters[i]) == newListCharacters.end()
-            && TgGlobalApplication::getInstance()->getFontCharactersCache()->isCharacterForThisFont(list_additonal_characters[i], fontFile) ) {
-            newListCharacters.push_back(list_additonal_characters[i]);
+    const TgFontCharacterCache *fontCharacters = TgGlobalApplication::getInstance()->getFontDefault()->getFontCharacters(fontId);
+    listGlyphCharacters = listCharacters;
+    for (size_t i=0;i<list_additonal_characters.size();i++) {
+        if (std::find(listGlyphCharacters.begin(), listGlyphCharacters.end(), list_additonal_characters[i]) == listGlyphCharacters.end()
+            && TgFontCharactersCache::isCharacterForFont(list_additonal_characters[i], fontCharacters) ) {
+            listGlyphCharacters.push_back(list_additonal_characters[i]);
         }
     }
     std::vector<uint32_t>::iterator it;
-    it = std::find(newListCharacters.begin(), newListCharacters.end(), 'A');
-    if (it != newListCharacters.end()) {
-        newListCharacters.erase(it);
+    it = std::find(listGlyphCharacters.begin(), listGlyphCharacters.end(), 'A');
+    if (it != listGlyphCharacters.end()) {
+        listGlyphCharacters.erase(it);
         // we set 'A' as a first character, because it's good for font height calculation
-        newListCharacters.insert(newListCharacters.begin(), 'A');
+        listGlyphCharacters.insert(listGlyphCharacters.begin(), 'A');
     }
+    return true;
+}
 
-    ret = generateCache(newListCharacters, fontFile, fontSize);
-    free(list_additonal_characters);
+/*!
+ * \brief TgFontGlyphCacheData::generateGlyphs
+ *
+ * generates (or loads from disk cache) glyphs of requests that have m_generate set,
+ * each font is rasterized on its own worker thread, this does not use OpenGL
+ *
+ * \param listRequest [in/out]
+ * \param fontSize font size
+ */
+void TgFontGlyphCacheData::generateGlyphs(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    TgFontGlyphCacheRequest *firstRequest = nullptr;
+    std::vector<std::future<void>> listJob;
+    TgGlobalThreadPool *threadPool = TgGlobalApplication::getInstance()->getThreadPool();
+    uint64_t jobGroup = threadPool->createJobGroup();
+    for (i=0;i<listRequest.size();i++) {
+        if (!listRequest[i].m_generate) {
+            continue;
+        }
+        if (!firstRequest) {
+            // calling thread rasterizes the first one, it would only wait otherwise
+            firstRequest = &listRequest[i];
+            continue;
+        }
+        TgFontGlyphCacheRequest *request = &listRequest[i];
+        listJob.push_back(threadPool->addJob([request, fontSize]() {
+            generateGlyphsForRequest(*request, fontSize);
+        }, jobGroup));
+    }
+    if (firstRequest) {
+        generateGlyphsForRequest(*firstRequest, fontSize);
+    }
+    threadPool->waitJobs(listJob, jobGroup);
     TG_FUNCTION_END();
-    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphCacheData::generateGlyphsForRequest
+ *
+ * loads glyphs from disk cache, or if they are not there
+ * rasterizes them and saves into disk cache
+ *
+ * \param request [in/out] m_data or m_diskData is set on success,
+ * m_generate is set false if fails
+ * \param fontSize font size
+ */
+void TgFontGlyphCacheData::generateGlyphsForRequest(TgFontGlyphCacheRequest &request, float fontSize)
+{
+    TgFontGlyphDiskCache *diskCache = TgGlobalApplication::getInstance()->getFontGlyphDiskCache();
+    request.m_diskData = diskCache->load(request.m_listGlyphCharacters, request.m_fontFile.c_str(), fontSize, FONT_ACCURACY_VALUE);
+    if (request.m_diskData) {
+        return;
+    }
+    request.m_data = prj_ttf_reader_init_data();
+    if (!request.m_data) {
+        TG_ERROR_LOG("prj_ttf_reader_init_data return failed");
+        request.m_generate = false;
+        return;
+    }
+    // each request has its own prj_ttf_reader_data_t, font file is read and glyphs are
+    // rasterized into it, so requests of different fonts are generated in parallel
+    if (prj_ttf_reader_generate_glyphs_list_characters(request.m_listGlyphCharacters.data(), static_cast<uint32_t>(request.m_listGlyphCharacters.size()),
+                                                       request.m_fontFile.c_str(), fontSize, FONT_ACCURACY_VALUE, request.m_data)
+        || !request.m_data->image.width
+        || !request.m_data->image.height) {
+        prj_ttf_reader_clear_data(&request.m_data);
+        TG_ERROR_LOG("generating glyphs failed");
+        request.m_generate = false;
+        return;
+    }
+    diskCache->save(request.m_listGlyphCharacters, request.m_fontFile.c_str(), fontSize, FONT_ACCURACY_VALUE, request.m_data);
 }
 
 /*!
@@ -88,19 +209,20 @@ TgFontInfoData *TgFontGlyphCacheData::generateCacheForText(const std::vector<uin
  * and texture
  *
  * \param listCharacters contains all charactes to make vertices and texture
- * \param fontFile full file path of the font file
+ * \param fontId font id (TgFontDefault::getFontId())
  * \param fontSize font size
  * \return nullptr if not, otherwise cached TgFontInfo
  */
-TgFontInfoData *TgFontGlyphCacheData::isFontCached(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize)
+TgFontInfoData *TgFontGlyphCacheData::isFontCached(const std::vector<uint32_t> &listCharacters, uint32_t fontId, float fontSize)
 {
     TG_FUNCTION_BEGIN();
     bool notFound;
     std::vector<TgFontInfoData *>::iterator it;
     std::vector<uint32_t>::const_iterator itListCharacters;
+    m_mutex.lock();
     for (it=m_listCachedData.begin();it!=m_listCachedData.end();it++) {
         if (memcmp(&(*it)->m_fontSize, &fontSize, sizeof(float)) == 0
-            && (*it)->m_fontFile.compare(fontFile) == 0) {
+            && (*it)->m_fontId == fontId) {
             notFound = false;
             for (itListCharacters=listCharacters.begin();itListCharacters!=listCharacters.end();itListCharacters++) {
                 if (std::find((*it)->m_listCharacter.begin(), (*it)->m_listCharacter.end(), (*itListCharacters)) == (*it)->m_listCharacter.end()) {
@@ -109,11 +231,13 @@ TgFontInfoData *TgFontGlyphCacheData::isFontCached(const std::vector<uint32_t> &
                 }
             }
             if (!notFound) {
+                m_mutex.unlock();
                 TG_FUNCTION_END();
                 return (*it);
             }
         }
     }
+    m_mutex.unlock();
     TG_FUNCTION_END();
     return nullptr;
 }
@@ -121,44 +245,32 @@ TgFontInfoData *TgFontGlyphCacheData::isFontCached(const std::vector<uint32_t> &
 /*!
  * \brief TgFontGlyphCacheData::generateCache
  *
- * generates image's vertices and texture
+ * generates font info from generated glyphs
  *
- * \param listCharacters list of characters
- * \param fontFile full file path of the font file
+ * \param request [in/out] generated glyphs, ownership of the glyphs moves into returned font info
  * \param fontSize font size
- * \return nullptr if fails, generated TgFontInfo otherwise
+ * \return nullptr if fails, generated TgFontInfoData otherwise
  */
-TgFontInfoData *TgFontGlyphCacheData::generateCache(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize)
+TgFontInfoData *TgFontGlyphCacheData::generateCache(TgFontGlyphCacheRequest &request, float fontSize)
 {
     TG_FUNCTION_BEGIN();
-    prj_ttf_reader_data_t *data;
-    data = prj_ttf_reader_init_data();
-    if (!data) {
-        TG_ERROR_LOG("prj_ttf_reader_init_data return failed");
-        TG_FUNCTION_END();
-        return nullptr;
-    }
-    if (prj_ttf_reader_generate_glyphs_list_characters(listCharacters.data(), static_cast<uint32_t>(listCharacters.size()), fontFile, fontSize, FONT_ACCURACY_VALUE, data)
-        || !data->image.width
-        || !data->image.height) {
-        prj_ttf_reader_clear_data(&data);
-        TG_ERROR_LOG("generating glyphs failed");
-        TG_FUNCTION_END();
-        return nullptr;
-    }
-
     TgFontInfoData *newInfo = new TgFontInfoData;
-    newInfo->m_data = data;
+    newInfo->m_data = request.m_data;
+    newInfo->m_diskData = request.m_diskData;
+    request.m_data = nullptr;
+    request.m_diskData = nullptr;
+    // glyph atlas image is not needed for the calculation
+    TgFontGlyphDiskCache::releaseImage(newInfo->m_diskData);
 
-    if (!calculateFontHeight(newInfo, listCharacters)) {
+    if (!calculateFontHeight(newInfo, request.m_listGlyphCharacters)) {
         TG_ERROR_LOG("creating the text vertices failed");
-        prj_ttf_reader_clear_data(&data);
+        clearFontInfoData(newInfo);
         delete newInfo;
         TG_FUNCTION_END();
         return nullptr;
     }
 
-    newInfo->m_fontFile = fontFile;
+    newInfo->m_fontId = request.m_fontId;
     newInfo->m_fontSize = fontSize;
     TG_FUNCTION_END();
     return newInfo;
@@ -183,7 +295,7 @@ bool TgFontGlyphCacheData::calculateFontHeight(TgFontInfoData *newInfo, const st
     for (i=0;i<c;i++) {
         newInfo->m_listCharacter.push_back(listCharacters.at(i));
 
-        glyph = prj_ttf_reader_get_character_glyph_data(listCharacters.at(i), newInfo->m_data);
+        glyph = TgFontGlyphDiskCache::getCharacterGlyphData(listCharacters.at(i), newInfo->m_data, newInfo->m_diskData);
         if (!glyph) {
             continue;
         }
@@ -208,11 +320,15 @@ bool TgFontGlyphCacheData::calculateFontHeight(TgFontInfoData *newInfo, const st
  */
 void TgFontGlyphCacheData::addCache(TgFontInfoData *data)
 {
-    if (!data || data->m_cached) {
+    if (!data) {
         return;
     }
-    data->m_cached = true;
-    m_listCachedData.push_back(data);
+    m_mutex.lock();
+    if (!data->m_cached) {
+        data->m_cached = true;
+        m_listCachedData.push_back(data);
+    }
+    m_mutex.unlock();
 }
 
 /*!
@@ -265,3 +381,18 @@ float TgFontGlyphCacheData::getAllDrawTextHeight(uint32_t allLineCount, std::vec
     }
     return static_cast<float>(std::ceil(fontHeight + static_cast<float>(allLineCount-1)*getLineHeight(listFontInfo)));
 }
+
+/*!
+ * \brief TgFontGlyphCacheData::clearFontInfoData
+ *
+ * clears the glyph data of the font info (either generated or loaded from disk cache)
+ *
+ * \param info [in/out]
+ */
+void TgFontGlyphCacheData::clearFontInfoData(TgFontInfoData *info)
+{
+    if (info->m_data) {
+        prj_ttf_reader_clear_data(&info->m_data);
+    }
+    TgFontGlyphDiskCache::clearData(&info->m_diskData);
+}
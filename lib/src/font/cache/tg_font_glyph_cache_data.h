@@ -15,19 +15,38 @@
 
 #include <vector>
 #include <string>
+#include <mutex>
 #include <prj-ttf-reader.h>
 #include "../../math/tg_matrix4x4.h"
+#include "tg_font_glyph_disk_cache.h"
 
 struct TgFontInfoData
 {
     prj_ttf_reader_data_t *m_data = nullptr;
-    std::string m_fontFile;
+    TgFontGlyphDiskCacheData *m_diskData = nullptr;
+    uint32_t m_fontId = 0;                                  /*!< TgFontDefault::getFontId() */
     float m_fontSize = 0;
     float m_fontHeight = 0;
     std::vector<uint32_t>m_listCharacter;
     bool m_cached = false;
 };
 
+/*!
+ * \brief TgFontGlyphCacheRequest
+ * glyphs of single font file to generate, glyphs of several
+ * requests are rasterized in parallel on the worker threads
+ */
+struct TgFontGlyphCacheRequest
+{
+    std::vector<uint32_t>m_listCharacters;                  /*!< characters of the text */
+    std::string m_fontFile;
+    uint32_t m_fontId = 0;                                  /*!< TgFontDefault::getFontId() of m_fontFile */
+    std::vector<uint32_t>m_listGlyphCharacters;             /*!< m_listCharacters with additional characters to glyph */
+    prj_ttf_reader_data_t *m_data = nullptr;                /*!< rasterized glyphs (or m_diskData) */
+    TgFontGlyphDiskCacheData *m_diskData = nullptr;         /*!< glyphs from disk cache (or m_data) */
+    bool m_generate = false;                                /*!< true if glyphs are not cached yet */
+};
+
 class TgFontGlyphCacheData
 {
 public:
@@ -35,17 +54,24 @@ public:
     ~TgFontGlyphCacheData();
 
     TgFontInfoData *generateCacheForText(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize);
-    TgFontInfoData *generateCache(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize);
+    std::vector<TgFontInfoData *> generateCacheForTexts(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize);
 
     bool calculateFontHeight(TgFontInfoData *newInfo, const std::vector<uint32_t> &listCharacters);
     void addCache(TgFontInfoData *data);
     static float getFontHeight(std::vector<TgFontInfoData *> &listFontInfo);
     static float getLineHeight(std::vector<TgFontInfoData *> &listFontInfo);
     static float getAllDrawTextHeight(uint32_t allLineCount, std::vector<TgFontInfoData *> &listFontInfo);
+    static void clearFontInfoData(TgFontInfoData *info);
+    static bool getCharactersForCache(const std::vector<uint32_t> &listCharacters, uint32_t fontId, std::vector<uint32_t> &listGlyphCharacters);
+    static void generateGlyphs(std::vector<TgFontGlyphCacheRequest> &listRequest, float fontSize);
 private:
     std::vector<TgFontInfoData *>m_listCachedData;
+    std::mutex m_mutex;
+
+    TgFontInfoData *isFontCached(const std::vector<uint32_t> &listCharacters, uint32_t fontId, float fontSize);
+    TgFontInfoData *generateCache(TgFontGlyphCacheRequest &request, float fontSize);
 
-    TgFontInfoData *isFontCached(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize);
+    static void generateGlyphsForRequest(TgFontGlyphCacheRequest &request, float fontSize);
 
 };
 
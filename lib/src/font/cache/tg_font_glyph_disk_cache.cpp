@@ -0,0 +1,523 @@
+/*!
+ * \file
+ * \brief file tg_font_glyph_disk_cache.cpp
+ *
+ * font glyph disk cache, stores rasterized glyph atlas
+ * and glyph metrics into memory-mappable file, so next application
+ * start can skip the glyph rasterization
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_font_glyph_disk_cache.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../global/tg_global_log.h"
+#include "../../common/tg_disk_cache_directory.h"
+
+#define TG_FONT_GLYPH_DISK_CACHE_MAGIC      "TGGC"
+#define TG_FONT_GLYPH_DISK_CACHE_FNV_OFFSET 14695981039346656037ULL
+#define TG_FONT_GLYPH_DISK_CACHE_FNV_PRIME  1099511628211ULL
+
+TgFontGlyphDiskCache::TgFontGlyphDiskCache() :
+    m_cacheDirectory(TgDiskCacheDirectory::getDefaultDirectory("PRJ_TG_UI_LIB_GLYPH_CACHE_DIR", "glyphs")),
+    m_cacheDirectoryCreated(false),
+    m_cacheMaxSize(TG_FONT_GLYPH_DISK_CACHE_DEFAULT_MAX_SIZE)
+{
+}
+
+TgFontGlyphDiskCache::~TgFontGlyphDiskCache()
+{
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::setCacheDirectory
+ *
+ * sets the directory where glyph cache files are stored
+ *
+ * \param directory full path of directory, if empty, then disk cache is disabled
+ */
+void TgFontGlyphDiskCache::setCacheDirectory(const std::string &directory)
+{
+    m_mutex.lock();
+    m_cacheDirectory = directory;
+    m_cacheDirectoryCreated = false;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getCacheDirectory
+ *
+ * \return directory where glyph cache files are stored, empty if disk cache is disabled
+ */
+std::string TgFontGlyphDiskCache::getCacheDirectory()
+{
+    m_mutex.lock();
+    std::string ret = m_cacheDirectory;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::setCacheMaxSize
+ *
+ * sets max size of the glyph cache files, least recently used files
+ * are removed when new file is saved and the size is exceeded
+ *
+ * \param maxSize max size in bytes
+ */
+void TgFontGlyphDiskCache::setCacheMaxSize(uint64_t maxSize)
+{
+    m_mutex.lock();
+    m_cacheMaxSize = maxSize;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getCacheMaxSize
+ *
+ * \return max size of the glyph cache files in bytes
+ */
+uint64_t TgFontGlyphDiskCache::getCacheMaxSize()
+{
+    m_mutex.lock();
+    uint64_t ret = m_cacheMaxSize;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::createCacheDirectory
+ *
+ * creates the cache directory (and it's parents) if required
+ *
+ * \return true if directory exists
+ */
+bool TgFontGlyphDiskCache::createCacheDirectory()
+{
+    if (m_cacheDirectoryCreated) {
+        return true;
+    }
+    m_cacheDirectoryCreated = TgDiskCacheDirectory::createDirectory(m_cacheDirectory);
+    return m_cacheDirectoryCreated;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::generateHash
+ *
+ * FNV-1a hash
+ *
+ * \param data data to hash
+ * \param size size of data
+ * \param hash previous hash value
+ * \return hash
+ */
+uint64_t TgFontGlyphDiskCache::generateHash(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (size_t i=0;i<size;i++) {
+        hash ^= p[i];
+        hash *= TG_FONT_GLYPH_DISK_CACHE_FNV_PRIME;
+    }
+    return hash;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getFontFileHash
+ *
+ * get hash of the font file content, hash is calculated only once per font file
+ *
+ * \param fontFile full file path of the font file
+ * \param hash [out] hash of the font file
+ * \return true on success
+ */
+bool TgFontGlyphDiskCache::getFontFileHash(const char *fontFile, uint64_t &hash)
+{
+    std::vector<std::pair<std::string, uint64_t>>::const_iterator it;
+    for (it=m_listFontFileHash.begin();it!=m_listFontFileHash.end();it++) {
+        if (it->first == fontFile) {
+            hash = it->second;
+            return true;
+        }
+    }
+
+    FILE *fp = fopen(fontFile, "rb");
+    if (!fp) {
+        return false;
+    }
+    unsigned char buffer[16384];
+    size_t readSize;
+    hash = TG_FONT_GLYPH_DISK_CACHE_FNV_OFFSET;
+    while ((readSize = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        hash = generateHash(buffer, readSize, hash);
+    }
+    fclose(fp);
+    m_listFontFileHash.push_back(std::make_pair(std::string(fontFile), hash));
+    return true;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getCacheFileName
+ *
+ * \param listCharacters list of characters in the glyph atlas
+ * \param fontFile full file path of the font file
+ * \param fontSize font size
+ * \param accuracy glyph generation accuracy
+ * \param fontFileHash [out] hash of font file
+ * \param characterListHash [out] hash of listCharacters
+ * \return full path of cache file, empty if fails
+ */
+std::string TgFontGlyphDiskCache::getCacheFileName(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy,
+                                                   uint64_t &fontFileHash, uint64_t &characterListHash)
+{
+    if (m_cacheDirectory.empty() || !getFontFileHash(fontFile, fontFileHash)) {
+        return "";
+    }
+    uint32_t fontSizeBits;
+    memcpy(&fontSizeBits, &fontSize, sizeof(fontSizeBits));
+    characterListHash = generateHash(listCharacters.data(), listCharacters.size()*sizeof(uint32_t), TG_FONT_GLYPH_DISK_CACHE_FNV_OFFSET);
+
+    char fileName[128];
+    snprintf(fileName, sizeof(fileName), "/%016llx_%08x_%d_%016llx.tgglyph",
+             static_cast<unsigned long long>(fontFileHash), fontSizeBits, accuracy,
+             static_cast<unsigned long long>(characterListHash));
+    return m_cacheDirectory + fileName;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::load
+ *
+ * loads (memory maps) glyph atlas and metrics from the disk cache
+ *
+ * \param listCharacters list of characters, must be exactly same (and in same order) as on save()
+ * \param fontFile full file path of the font file
+ * \param fontSize font size
+ * \param accuracy glyph generation accuracy
+ * \return nullptr if cache file does not exist or it's not valid,
+ * otherwise loaded data, that must be cleared with clearData()
+ */
+TgFontGlyphDiskCacheData *TgFontGlyphDiskCache::load(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy)
+{
+    TG_FUNCTION_BEGIN();
+    uint64_t fontFileHash, characterListHash;
+    m_mutex.lock();
+    std::string fileName = getCacheFileName(listCharacters, fontFile, fontSize, accuracy, fontFileHash, characterListHash);
+    m_mutex.unlock();
+    if (fileName.empty()) {
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TgFontGlyphDiskCacheHeader)) {
+        close(fd);
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+    size_t mapSize = static_cast<size_t>(st.st_size);
+    void *mapAddress = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // file is used now, so it's not removed first when cache size is exceeded
+    TgDiskCacheDirectory::touchFile(fd);
+    close(fd);
+    if (mapAddress == MAP_FAILED) {
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+
+    const unsigned char *p = static_cast<const unsigned char *>(mapAddress);
+    TgFontGlyphDiskCacheHeader header;
+    memcpy(&header, p, sizeof(header));
+    size_t characterOffset = sizeof(header);
+    size_t glyphOffset = characterOffset + static_cast<size_t>(header.m_characterCount)*sizeof(uint32_t);
+    size_t imageOffset = glyphOffset + static_cast<size_t>(header.m_glyphCount)*sizeof(TgFontGlyphDiskCacheGlyph);
+    size_t kerningOffset = imageOffset + static_cast<size_t>(header.m_imageWidth)*static_cast<size_t>(header.m_imageHeight);
+    if (memcmp(header.m_magic, TG_FONT_GLYPH_DISK_CACHE_MAGIC, sizeof(header.m_magic)) != 0
+        || header.m_version != TG_FONT_GLYPH_DISK_CACHE_VERSION
+        || header.m_fontFileHash != fontFileHash
+        || header.m_characterListHash != characterListHash
+        || memcmp(&header.m_fontSize, &fontSize, sizeof(float)) != 0
+        || header.m_accuracy != static_cast<uint32_t>(accuracy)
+        || header.m_characterCount != listCharacters.size()
+        || !header.m_imageWidth
+        || !header.m_imageHeight
+        || kerningOffset + static_cast<size_t>(header.m_kerningCount)*sizeof(TgFontGlyphDiskCacheKerning) != mapSize
+        || memcmp(p + characterOffset, listCharacters.data(), listCharacters.size()*sizeof(uint32_t)) != 0) {
+        TG_WARNING_LOG("Ignoring invalid glyph cache file: ", fileName);
+        munmap(mapAddress, mapSize);
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+
+    TgFontGlyphDiskCacheData *ret = new TgFontGlyphDiskCacheData;
+    TgFontGlyphDiskCacheGlyph glyph;
+    uint32_t i;
+    ret->m_listGlyphCharacter.reserve(header.m_glyphCount);
+    ret->m_listGlyph.reserve(header.m_glyphCount);
+    for (i=0;i<header.m_glyphCount;i++) {
+        memcpy(&glyph, p + glyphOffset + i*sizeof(TgFontGlyphDiskCacheGlyph), sizeof(glyph));
+        prj_ttf_reader_glyph_data_t glyphData {};
+        glyphData.image_pixel_left_x = static_cast<decltype(glyphData.image_pixel_left_x)>(glyph.m_pixelLeftX);
+        glyphData.image_pixel_right_x = static_cast<decltype(glyphData.image_pixel_right_x)>(glyph.m_pixelRightX);
+        glyphData.image_pixel_top_y = static_cast<decltype(glyphData.image_pixel_top_y)>(glyph.m_pixelTopY);
+        glyphData.image_pixel_bottom_y = static_cast<decltype(glyphData.image_pixel_bottom_y)>(glyph.m_pixelBottomY);
+        glyphData.image_pixel_offset_line_y = static_cast<decltype(glyphData.image_pixel_offset_line_y)>(glyph.m_pixelOffsetLineY);
+        glyphData.image_pixel_advance_x = static_cast<decltype(glyphData.image_pixel_advance_x)>(glyph.m_pixelAdvanceX);
+        glyphData.image_pixel_bearing = static_cast<decltype(glyphData.image_pixel_bearing)>(glyph.m_pixelBearing);
+        ret->m_listGlyphCharacter.push_back(glyph.m_character);
+        ret->m_listGlyph.push_back(glyphData);
+    }
+    ret->m_listKerning.resize(header.m_kerningCount);
+    if (header.m_kerningCount) {
+        memcpy(ret->m_listKerning.data(), p + kerningOffset, header.m_kerningCount*sizeof(TgFontGlyphDiskCacheKerning));
+    }
+    if (!std::is_sorted(ret->m_listGlyphCharacter.begin(), ret->m_listGlyphCharacter.end())
+        || !std::is_sorted(ret->m_listKerning.begin(), ret->m_listKerning.end(), isKerningLess)) {
+        TG_WARNING_LOG("Ignoring invalid glyph cache file: ", fileName);
+        munmap(mapAddress, mapSize);
+        delete ret;
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+    ret->m_image = p + imageOffset;
+    ret->m_imageWidth = static_cast<int>(header.m_imageWidth);
+    ret->m_imageHeight = static_cast<int>(header.m_imageHeight);
+    ret->m_mapAddress = mapAddress;
+    ret->m_mapSize = mapSize;
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::save
+ *
+ * saves glyph atlas, metrics and all non-zero kerning pairs between
+ * the generated glyphs into disk cache, so loaded file never needs
+ * to rasterize glyphs again for kerning of new texts
+ *
+ * \param listCharacters list of characters that data was generated for
+ * \param fontFile full file path of the font file
+ * \param fontSize font size
+ * \param accuracy glyph generation accuracy
+ * \param data generated glyphs
+ * \return true on success
+ */
+bool TgFontGlyphDiskCache::save(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy, prj_ttf_reader_data_t *data)
+{
+    TG_FUNCTION_BEGIN();
+    uint64_t fontFileHash, characterListHash;
+    m_mutex.lock();
+    std::string fileName = getCacheFileName(listCharacters, fontFile, fontSize, accuracy, fontFileHash, characterListHash);
+    if (fileName.empty() || !data || !createCacheDirectory()) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return false;
+    }
+    std::string cacheDirectory = m_cacheDirectory;
+    uint64_t cacheMaxSize = m_cacheMaxSize;
+    m_mutex.unlock();
+
+    std::vector<uint32_t> listGlyphCharacter = listCharacters;
+    std::sort(listGlyphCharacter.begin(), listGlyphCharacter.end());
+    listGlyphCharacter.erase(std::unique(listGlyphCharacter.begin(), listGlyphCharacter.end()), listGlyphCharacter.end());
+
+    std::vector<TgFontGlyphDiskCacheGlyph> listGlyph;
+    const prj_ttf_reader_glyph_data_t *glyphData;
+    size_t i;
+    for (i=0;i<listGlyphCharacter.size();i++) {
+        glyphData = prj_ttf_reader_get_character_glyph_data(listGlyphCharacter[i], data);
+        if (!glyphData) {
+            continue;
+        }
+        TgFontGlyphDiskCacheGlyph glyph;
+        glyph.m_character = listGlyphCharacter[i];
+        glyph.m_pixelLeftX = static_cast<int32_t>(glyphData->image_pixel_left_x);
+        glyph.m_pixelRightX = static_cast<int32_t>(glyphData->image_pixel_right_x);
+        glyph.m_pixelTopY = static_cast<int32_t>(glyphData->image_pixel_top_y);
+        glyph.m_pixelBottomY = static_cast<int32_t>(glyphData->image_pixel_bottom_y);
+        glyph.m_pixelOffsetLineY = static_cast<int32_t>(glyphData->image_pixel_offset_line_y);
+        glyph.m_pixelAdvanceX = static_cast<float>(glyphData->image_pixel_advance_x);
+        glyph.m_pixelBearing = static_cast<float>(glyphData->image_pixel_bearing);
+        listGlyph.push_back(glyph);
+    }
+
+    std::vector<TgFontGlyphDiskCacheKerning> listKerning;
+    size_t i2;
+    for (i=0;i<listGlyph.size();i++) {
+        for (i2=0;i2<listGlyph.size();i2++) {
+            TgFontGlyphDiskCacheKerning kerning;
+            kerning.m_leftCharacter = listGlyph[i].m_character;
+            kerning.m_rightCharacter = listGlyph[i2].m_character;
+            kerning.m_kerning = prj_ttf_reader_get_kerning(kerning.m_leftCharacter, kerning.m_rightCharacter, data);
+            if (std::fabs(kerning.m_kerning) > std::numeric_limits<float>::epsilon()) {
+                listKerning.push_back(kerning);
+            }
+        }
+    }
+
+    TgFontGlyphDiskCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, TG_FONT_GLYPH_DISK_CACHE_MAGIC, sizeof(header.m_magic));
+    header.m_version = TG_FONT_GLYPH_DISK_CACHE_VERSION;
+    header.m_fontFileHash = fontFileHash;
+    header.m_characterListHash = characterListHash;
+    header.m_fontSize = fontSize;
+    header.m_accuracy = static_cast<uint32_t>(accuracy);
+    header.m_characterCount = static_cast<uint32_t>(listCharacters.size());
+    header.m_glyphCount = static_cast<uint32_t>(listGlyph.size());
+    header.m_kerningCount = static_cast<uint32_t>(listKerning.size());
+    header.m_imageWidth = static_cast<uint32_t>(data->image.width);
+    header.m_imageHeight = static_cast<uint32_t>(data->image.height);
+
+    // write into temporary file first, so other process never maps half written file
+    std::string tmpFileName = fileName + "." + std::to_string(getpid()) + ".tmp";
+    FILE *fp = fopen(tmpFileName.c_str(), "wb");
+    if (!fp) {
+        TG_WARNING_LOG("Could not write glyph cache file: ", tmpFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    size_t imageSize = static_cast<size_t>(header.m_imageWidth)*static_cast<size_t>(header.m_imageHeight);
+    bool ret = fwrite(&header, sizeof(header), 1, fp) == 1
+            && fwrite(listCharacters.data(), sizeof(uint32_t), listCharacters.size(), fp) == listCharacters.size()
+            && fwrite(listGlyph.data(), sizeof(TgFontGlyphDiskCacheGlyph), listGlyph.size(), fp) == listGlyph.size()
+            && fwrite(data->image.data, 1, imageSize, fp) == imageSize
+            && fwrite(listKerning.data(), sizeof(TgFontGlyphDiskCacheKerning), listKerning.size(), fp) == listKerning.size();
+    if (fclose(fp) != 0) {
+        ret = false;
+    }
+    if (!ret || rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        TG_WARNING_LOG("Could not write glyph cache file: ", fileName);
+        unlink(tmpFileName.c_str());
+        TG_FUNCTION_END();
+        return false;
+    }
+    TgDiskCacheDirectory::cleanDirectory(cacheDirectory, ".tgglyph", cacheMaxSize, fileName.substr(fileName.rfind('/') + 1));
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::isKerningLess
+ *
+ * \param a
+ * \param b
+ * \return true if kerning pair a is before b (sorted by left and right character)
+ */
+bool TgFontGlyphDiskCache::isKerningLess(const TgFontGlyphDiskCacheKerning &a, const TgFontGlyphDiskCacheKerning &b)
+{
+    return a.m_leftCharacter < b.m_leftCharacter
+        || (a.m_leftCharacter == b.m_leftCharacter && a.m_rightCharacter < b.m_rightCharacter);
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::releaseImage
+ *
+ * releases (unmaps) the glyph atlas image, glyph metrics
+ * are still usable after this
+ *
+ * \param diskData [in/out]
+ */
+void TgFontGlyphDiskCache::releaseImage(TgFontGlyphDiskCacheData *diskData)
+{
+    if (!diskData || !diskData->m_mapAddress) {
+        return;
+    }
+    munmap(diskData->m_mapAddress, diskData->m_mapSize);
+    diskData->m_mapAddress = nullptr;
+    diskData->m_mapSize = 0;
+    diskData->m_image = nullptr;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::clearData
+ *
+ * clears data returned by load()
+ *
+ * \param diskData [in/out] data to clear, set as nullptr
+ */
+void TgFontGlyphDiskCache::clearData(TgFontGlyphDiskCacheData **diskData)
+{
+    if (!diskData || !(*diskData)) {
+        return;
+    }
+    releaseImage(*diskData);
+    delete (*diskData);
+    *diskData = nullptr;
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getCharacterGlyphData
+ *
+ * get glyph of the character, either from prj_ttf_reader data
+ * or from data loaded from the disk cache
+ *
+ * \param character character
+ * \param data generated glyph data (can be nullptr)
+ * \param diskData glyph data from disk cache (can be nullptr)
+ * \return glyph, nullptr if not found
+ */
+const prj_ttf_reader_glyph_data_t *TgFontGlyphDiskCache::getCharacterGlyphData(uint32_t character, prj_ttf_reader_data_t *data,
+                                                                                const TgFontGlyphDiskCacheData *diskData)
+{
+    if (data) {
+        return prj_ttf_reader_get_character_glyph_data(character, data);
+    }
+    if (!diskData) {
+        return nullptr;
+    }
+    std::vector<uint32_t>::const_iterator it = std::lower_bound(diskData->m_listGlyphCharacter.begin(), diskData->m_listGlyphCharacter.end(), character);
+    if (it == diskData->m_listGlyphCharacter.end() || *it != character) {
+        return nullptr;
+    }
+    return &diskData->m_listGlyph[static_cast<size_t>(it - diskData->m_listGlyphCharacter.begin())];
+}
+
+/*!
+ * \brief TgFontGlyphDiskCache::getKerning
+ *
+ * get kerning between two characters, either from prj_ttf_reader data
+ * or from data loaded from the disk cache
+ *
+ * \param leftCharacter left character
+ * \param rightCharacter right character
+ * \param data generated glyph data (can be nullptr)
+ * \param diskData glyph data from disk cache (can be nullptr)
+ * \return kerning, 0 if pair is not in the disk cache
+ */
+float TgFontGlyphDiskCache::getKerning(uint32_t leftCharacter, uint32_t rightCharacter, prj_ttf_reader_data_t *data,
+                                       const TgFontGlyphDiskCacheData *diskData)
+{
+    if (data) {
+        return prj_ttf_reader_get_kerning(leftCharacter, rightCharacter, data);
+    }
+    if (!diskData) {
+        return 0;
+    }
+    TgFontGlyphDiskCacheKerning pair;
+    pair.m_leftCharacter = leftCharacter;
+    pair.m_rightCharacter = rightCharacter;
+    pair.m_kerning = 0;
+    std::vector<TgFontGlyphDiskCacheKerning>::const_iterator it = std::lower_bound(diskData->m_listKerning.begin(), diskData->m_listKerning.end(),
+                                                                                   pair, isKerningLess);
+    if (it == diskData->m_listKerning.end()
+        || it->m_leftCharacter != leftCharacter
+        || it->m_rightCharacter != rightCharacter) {
+        return 0;
+    }
+    return it->m_kerning;
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file
+ * \brief file tg_font_glyph_disk_cache.h
+ *
+ * font glyph disk cache, stores rasterized glyph atlas
+ * and glyph metrics into memory-mappable file, so next application
+ * start can skip the glyph rasterization
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_FONT_GLYPH_DISK_CACHE_H
+#define TG_FONT_GLYPH_DISK_CACHE_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <prj-ttf-reader.h>
+
+#define TG_FONT_GLYPH_DISK_CACHE_VERSION            3
+#define TG_FONT_GLYPH_DISK_CACHE_DEFAULT_MAX_SIZE   (64*1024*1024)
+
+/*!
+ * \brief TgFontGlyphDiskCacheHeader
+ * header of the glyph disk cache file, after header there are
+ * m_characterCount x uint32_t characters (same order as generated),
+ * m_glyphCount x TgFontGlyphDiskCacheGlyph,
+ * m_imageWidth*m_imageHeight bytes of glyph atlas image and
+ * m_kerningCount x TgFontGlyphDiskCacheKerning (all non-zero kerning
+ * pairs between the glyphs, pairs that are not there have zero kerning)
+ */
+struct TgFontGlyphDiskCacheHeader
+{
+    char m_magic[4];
+    uint32_t m_version;
+    uint64_t m_fontFileHash;
+    uint64_t m_characterListHash;
+    float m_fontSize;
+    uint32_t m_accuracy;
+    uint32_t m_characterCount;
+    uint32_t m_glyphCount;
+    uint32_t m_kerningCount;
+    uint32_t m_imageWidth;
+    uint32_t m_imageHeight;
+    uint32_t m_reserved;
+};
+
+struct TgFontGlyphDiskCacheGlyph
+{
+    uint32_t m_character;
+    int32_t m_pixelLeftX;
+    int32_t m_pixelRightX;
+    int32_t m_pixelTopY;
+    int32_t m_pixelBottomY;
+    int32_t m_pixelOffsetLineY;
+    float m_pixelAdvanceX;
+    float m_pixelBearing;
+};
+
+struct TgFontGlyphDiskCacheKerning
+{
+    uint32_t m_leftCharacter;
+    uint32_t m_rightCharacter;
+    float m_kerning;
+};
+
+/*!
+ * \brief TgFontGlyphDiskCacheData
+ * glyph data that is loaded from the disk cache, this is used
+ * instead of prj_ttf_reader_data_t
+ */
+struct TgFontGlyphDiskCacheData
+{
+    std::vector<uint32_t>m_listGlyphCharacter;                  /*!< sorted list of characters, that have glyph */
+    std::vector<prj_ttf_reader_glyph_data_t>m_listGlyph;        /*!< glyph of m_listGlyphCharacter (same index) */
+    std::vector<TgFontGlyphDiskCacheKerning>m_listKerning;      /*!< sorted by left and right character */
+    const unsigned char *m_image = nullptr;                     /*!< glyph atlas (1 byte per pixel), points to mapped file */
+    int m_imageWidth = 0;
+    int m_imageHeight = 0;
+    void *m_mapAddress = nullptr;
+    size_t m_mapSize = 0;
+};
+
+class TgFontGlyphDiskCache
+{
+public:
+    explicit TgFontGlyphDiskCache();
+    ~TgFontGlyphDiskCache();
+
+    void setCacheDirectory(const std::string &directory);
+    std::string getCacheDirectory();
+    void setCacheMaxSize(uint64_t maxSize);
+    uint64_t getCacheMaxSize();
+
+    TgFontGlyphDiskCacheData *load(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy);
+    bool save(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy, prj_ttf_reader_data_t *data);
+
+    static void clearData(TgFontGlyphDiskCacheData **diskData);
+    static void releaseImage(TgFontGlyphDiskCacheData *diskData);
+    static const prj_ttf_reader_glyph_data_t *getCharacterGlyphData(uint32_t character, prj_ttf_reader_data_t *data, const TgFontGlyphDiskCacheData *diskData);
+    static float getKerning(uint32_t leftCharacter, uint32_t rightCharacter, prj_ttf_reader_data_t *data, const TgFontGlyphDiskCacheData *diskData);
+
+private:
+    std::mutex m_mutex;
+    std::string m_cacheDirectory;
+    bool m_cacheDirectoryCreated;
+    uint64_t m_cacheMaxSize;
+    std::vector<std::pair<std::string, uint64_t>>m_listFontFileHash;
+
+    bool getFontFileHash(const char *fontFile, uint64_t &hash);
+    std::string getCacheFileName(const std::vector<uint32_t> &listCharacters, const char *fontFile, float fontSize, int accuracy,
+                                 uint64_t &fontFileHash, uint64_t &characterListHash);
+    bool createCacheDirectory();
+
+    static uint64_t generateHash(const void *data, size_t size, uint64_t hash);
+    static bool isKerningLess(const TgFontGlyphDiskCacheKerning &a, const TgFontGlyphDiskCacheKerning &b);
+};
+
+#endif // TG_FONT_GLYPH_DISK_CACHE_H
@@ -0,0 +1,354 @@
+/*!
+ * \file
+ * \brief file tg_font_text_cache.cpp
+ *
+ * font text cache shares shaped texts (font infos and glyph
+ * metrics) between the items that have the same text, and laid-out
+ * texts (glyph positions) between the items with same layout values
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_font_text_cache.h"
+#include <cstring>
+#include <functional>
+#include <algorithm>
+#include "../../global/tg_global_log.h"
+#include "../../global/tg_global_application.h"
+#include "../tg_font_default.h"
+#include "../tg_font_text.h"
+#include "../tg_font_text_generator.h"
+#include "../tg_character_positions.h"
+
+TgFontTextCache::TgFontTextCache()
+{
+}
+
+TgFontTextCache::~TgFontTextCache()
+{
+    std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator it;
+    for (it=m_listEntry.begin();it!=m_listEntry.end();it++) {
+        deleteEntry(it->second);
+    }
+    m_listEntry.clear();
+    m_listLayoutByFontText.clear();
+}
+
+/*!
+ * \brief TgFontTextCache::getFontText
+ *
+ * get laid-out text, if there is already same text with same layout values
+ * it is shared, if there is same text with different layout values (for example
+ * item is resized), then shaped text is reused and only line breaking is done,
+ * otherwise new text is generated (glyphs and positions)
+ * must be called on OpenGL thread, returned text must not be modified
+ * and it must be released with releaseFontText()
+ *
+ * \param listText text (and colors)
+ * \param fontFile main font file
+ * \param fontSize font size
+ * \param maxLineCount max line count, 0 unlimited number of lines
+ * \param maxLineWidth max line width
+ * \param wordWrap
+ * \param allowBreakLineGoOverMaxLine
+ * \return laid-out text or nullptr if text is not valid
+ */
+TgFontText *TgFontTextCache::getFontText(const std::vector<TgTextFieldText> &listText, const std::string &fontFile, float fontSize,
+                                         uint32_t maxLineCount, float maxLineWidth, TgTextFieldWordWrap wordWrap, bool allowBreakLineGoOverMaxLine)
+{
+    TG_FUNCTION_BEGIN();
+    TgFontTextCacheKey key;
+    key.m_listText = listText;
+    key.m_fontChain = TgFontDefault::getMainFontChain(fontFile);
+    key.m_fontSize = fontSize;
+    TgFontTextCacheLayoutKey layoutKey;
+    layoutKey.m_maxLineCount = maxLineCount;
+    layoutKey.m_maxLineWidth = wordWrap == TgTextFieldWordWrap::WordWrapOff ? 0 : maxLineWidth;
+    layoutKey.m_wordWrap = wordWrap;
+    layoutKey.m_allowBreakLineGoOverMaxLine = allowBreakLineGoOverMaxLine;
+
+    TgFontTextCacheEntry *entry = getEntry(key);
+    if (!entry) {
+        TG_FUNCTION_END();
+        return nullptr;
+    }
+    TgFontTextCacheLayout *layout = getLayout(entry, layoutKey);
+    TG_FUNCTION_END();
+    return layout->m_fontText;
+}
+
+/*!
+ * \brief TgFontTextCache::releaseFontText
+ *
+ * releases the text got from getFontText(), text is deleted
+ * when there are no more references to it, and shaped text is
+ * deleted when there are no more laid-out texts of it
+ *
+ * \param fontText
+ */
+void TgFontTextCache::releaseFontText(TgFontText *fontText)
+{
+    TG_FUNCTION_BEGIN();
+    std::unordered_map<const TgFontText *, TgFontTextCacheLayout *>::iterator itFontText;
+    std::pair<std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator,
+              std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator> range;
+    std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator it;
+    std::vector<TgFontTextCacheLayout *>::iterator itLayout;
+    TgFontTextCacheLayout *layout;
+    TgFontTextCacheEntry *entry;
+    m_mutex.lock();
+    itFontText = m_listLayoutByFontText.find(fontText);
+    if (itFontText == m_listLayoutByFontText.end()) {
+        m_mutex.unlock();
+        TG_ERROR_LOG("Font text is not in the cache");
+        TG_FUNCTION_END();
+        return;
+    }
+    layout = itFontText->second;
+    layout->m_referenceCount--;
+    if (layout->m_referenceCount) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_listLayoutByFontText.erase(itFontText);
+    entry = layout->m_entry;
+    itLayout = std::find(entry->m_listLayout.begin(), entry->m_listLayout.end(), layout);
+    if (itLayout != entry->m_listLayout.end()) {
+        entry->m_listLayout.erase(itLayout);
+    }
+    if (!entry->m_listLayout.empty()) {
+        m_mutex.unlock();
+        // font infos are owned by the shaped text
+        delete layout->m_fontText;
+        delete layout;
+        TG_FUNCTION_END();
+        return;
+    }
+    range = m_listEntry.equal_range(entry->m_hash);
+    for (it=range.first;it!=range.second;it++) {
+        if (it->second == entry) {
+            m_listEntry.erase(it);
+            break;
+        }
+    }
+    m_mutex.unlock();
+    delete layout->m_fontText;
+    delete layout;
+    deleteEntry(entry);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgFontTextCache::getCount
+ *
+ * \return number of different shaped texts in the cache
+ */
+size_t TgFontTextCache::getCount()
+{
+    size_t ret;
+    m_mutex.lock();
+    ret = m_listEntry.size();
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgFontTextCache::getEntry
+ *
+ * get shaped text entry of the key, if it does not exist
+ * then it is generated and added to the cache
+ * entry is not referenced, so it must be referenced by
+ * getLayout() before releasing the text
+ *
+ * \param key [in/out] key is moved to the new entry
+ * \return entry or nullptr if text is not valid
+ */
+TgFontTextCacheEntry *TgFontTextCache::getEntry(TgFontTextCacheKey &key)
+{
+    uint64_t hash = generateHash(key);
+    std::pair<std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator,
+              std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator> range;
+    std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>::iterator it;
+    m_mutex.lock();
+    range = m_listEntry.equal_range(hash);
+    for (it=range.first;it!=range.second;it++) {
+        if (isEqualKey(it->second->m_key, key)) {
+            m_mutex.unlock();
+            return it->second;
+        }
+    }
+    m_mutex.unlock();
+
+    TgFontText *fontText = generateShapedFontText(key);
+    if (!fontText) {
+        return nullptr;
+    }
+
+    TgFontTextCacheEntry *entry = new TgFontTextCacheEntry;
+    entry->m_key = std::move(key);
+    entry->m_hash = hash;
+    entry->m_shapedFontText = fontText;
+    m_mutex.lock();
+    m_listEntry.insert(std::make_pair(hash, entry));
+    m_mutex.unlock();
+    return entry;
+}
+
+/*!
+ * \brief TgFontTextCache::getLayout
+ *
+ * get laid-out text of the shaped text, if there is no
+ * text with same layout values, then shaped text is copied
+ * and only character positions are generated for the copy
+ *
+ * \param entry shaped text entry
+ * \param layoutKey layout values
+ * \return referenced laid-out text
+ */
+TgFontTextCacheLayout *TgFontTextCache::getLayout(TgFontTextCacheEntry *entry, const TgFontTextCacheLayoutKey &layoutKey)
+{
+    size_t i;
+    m_mutex.lock();
+    for (i=0;i<entry->m_listLayout.size();i++) {
+        if (isEqualLayoutKey(entry->m_listLayout[i]->m_key, layoutKey)) {
+            entry->m_listLayout[i]->m_referenceCount++;
+            m_mutex.unlock();
+            return entry->m_listLayout[i];
+        }
+    }
+    m_mutex.unlock();
+
+    TgFontText *fontText = entry->m_shapedFontText->clone();
+    TgCharacterPositions::generateTextCharacterPositioning(fontText, layoutKey.m_maxLineCount, layoutKey.m_maxLineWidth,
+                                                           layoutKey.m_wordWrap, layoutKey.m_allowBreakLineGoOverMaxLine);
+    TgFontTextCacheLayout *layout = new TgFontTextCacheLayout;
+    layout->m_key = layoutKey;
+    layout->m_fontText = fontText;
+    layout->m_referenceCount = 1;
+    layout->m_entry = entry;
+    m_mutex.lock();
+    entry->m_listLayout.push_back(layout);
+    m_listLayoutByFontText[fontText] = layout;
+    m_mutex.unlock();
+    return layout;
+}
+
+/*!
+ * \brief TgFontTextCache::generateShapedFontText
+ *
+ * generates text glyphs (and glyph indexes of the characters),
+ * positions are generated per layout in getLayout()
+ *
+ * \param key
+ * \return generated text, or nullptr if text is not valid
+ */
+TgFontText *TgFontTextCache::generateShapedFontText(const TgFontTextCacheKey &key)
+{
+    TgFontText *fontText = TgFontTextGenerator::generateFontTextInfo(key.m_listText, key.m_fontChain);
+    if (!fontText) {
+        return nullptr;
+    }
+    fontText->generateFontTextInfoGlyphs(key.m_fontSize, false);
+    fontText->getLayout()->update(fontText);
+    return fontText;
+}
+
+/*!
+ * \brief TgFontTextCache::deleteEntry
+ *
+ * \param entry entry to delete (with its shaped and laid-out texts)
+ */
+void TgFontTextCache::deleteEntry(TgFontTextCacheEntry *entry)
+{
+    size_t i;
+    for (i=0;i<entry->m_listLayout.size();i++) {
+        delete entry->m_listLayout[i]->m_fontText;
+        delete entry->m_listLayout[i];
+    }
+    entry->m_shapedFontText->clearCacheValues(true);
+    delete entry->m_shapedFontText;
+    delete entry;
+}
+
+/*!
+ * \brief TgFontTextCache::isEqualKey
+ *
+ * \param key0
+ * \param key1
+ * \return true if keys are equal
+ */
+bool TgFontTextCache::isEqualKey(const TgFontTextCacheKey &key0, const TgFontTextCacheKey &key1)
+{
+    size_t i;
+    if (memcmp(&key0.m_fontSize, &key1.m_fontSize, sizeof(float)) != 0
+        || key0.m_listText.size() != key1.m_listText.size()
+        || key0.m_fontChain->m_listFontId != key1.m_fontChain->m_listFontId) {
+        return false;
+    }
+    for (i=0;i<key0.m_listText.size();i++) {
+        if (key0.m_listText[i].m_textColorR != key1.m_listText[i].m_textColorR
+            || key0.m_listText[i].m_textColorG != key1.m_listText[i].m_textColorG
+            || key0.m_listText[i].m_textColorB != key1.m_listText[i].m_textColorB
+            || key0.m_listText[i].m_text != key1.m_listText[i].m_text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief TgFontTextCache::isEqualLayoutKey
+ *
+ * \param key0
+ * \param key1
+ * \return true if layout keys are equal
+ */
+bool TgFontTextCache::isEqualLayoutKey(const TgFontTextCacheLayoutKey &key0, const TgFontTextCacheLayoutKey &key1)
+{
+    return memcmp(&key0.m_maxLineWidth, &key1.m_maxLineWidth, sizeof(float)) == 0
+        && key0.m_maxLineCount == key1.m_maxLineCount
+        && key0.m_wordWrap == key1.m_wordWrap
+        && key0.m_allowBreakLineGoOverMaxLine == key1.m_allowBreakLineGoOverMaxLine;
+}
+
+/*!
+ * \brief TgFontTextCache::generateHash
+ *
+ * \param key
+ * \return hash of the key
+ */
+uint64_t TgFontTextCache::generateHash(const TgFontTextCacheKey &key)
+{
+    size_t i;
+    uint32_t value32;
+    uint64_t hash = 0;
+    std::hash<std::string> hashString;
+    for (i=0;i<key.m_listText.size();i++) {
+        addHash(hash, hashString(key.m_listText[i].m_text));
+        addHash(hash, static_cast<uint64_t>(key.m_listText[i].m_textColorR) << 16
+                      | static_cast<uint64_t>(key.m_listText[i].m_textColorG) << 8
+                      | static_cast<uint64_t>(key.m_listText[i].m_textColorB));
+    }
+    for (i=0;i<key.m_fontChain->m_listFontId.size();i++) {
+        addHash(hash, key.m_fontChain->m_listFontId[i]);
+    }
+    memcpy(&value32, &key.m_fontSize, sizeof(float));
+    addHash(hash, value32);
+    return hash;
+}
+
+/*!
+ * \brief TgFontTextCache::addHash
+ *
+ * combines value into hash
+ *
+ * \param hash [in/out]
+ * \param value
+ */
+void TgFontTextCache::addHash(uint64_t &hash, uint64_t value)
+{
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+}
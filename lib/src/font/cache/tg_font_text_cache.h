@@ -0,0 +1,100 @@
+/*!
+ * \file
+ * \brief file tg_font_text_cache.h
+ *
+ * font text cache shares shaped texts (font infos and glyph
+ * metrics) between the items that have the same text, and laid-out
+ * texts (glyph positions) between the items with same layout values
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_FONT_TEXT_CACHE_H
+#define TG_FONT_TEXT_CACHE_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include "../../item2d/tg_item2d.h"
+
+class TgFontText;
+struct TgFontChain;
+
+/*!
+ * \brief TgFontTextCacheKey
+ * everything that affects to the shaped text (glyphs),
+ * line width does not affect, so resizing the item does not shape the text again
+ */
+struct TgFontTextCacheKey
+{
+    std::vector<TgTextFieldText> m_listText;
+    std::shared_ptr<const TgFontChain> m_fontChain;     /*!< font chain of the main font, compared by font ids */
+    float m_fontSize = 0;
+};
+
+/*!
+ * \brief TgFontTextCacheLayoutKey
+ * everything that affects to the line breaking of the shaped text
+ */
+struct TgFontTextCacheLayoutKey
+{
+    uint32_t m_maxLineCount = 0;
+    float m_maxLineWidth = 0;               /*!< 0 if m_wordWrap is WordWrapOff (width does not change the layout) */
+    TgTextFieldWordWrap m_wordWrap = TgTextFieldWordWrap::WordWrapBounded;
+    bool m_allowBreakLineGoOverMaxLine = false;
+};
+
+struct TgFontTextCacheEntry;
+
+/*!
+ * \brief TgFontTextCacheLayout
+ * laid-out copy of the shaped text, font infos are owned by the shaped text
+ */
+struct TgFontTextCacheLayout
+{
+    TgFontTextCacheLayoutKey m_key;
+    TgFontText *m_fontText;
+    size_t m_referenceCount;
+    TgFontTextCacheEntry *m_entry;
+};
+
+struct TgFontTextCacheEntry
+{
+    TgFontTextCacheKey m_key;
+    uint64_t m_hash;
+    TgFontText *m_shapedFontText;                       /*!< glyphs and glyph metrics, not positioned */
+    std::vector<TgFontTextCacheLayout *> m_listLayout;
+};
+
+class TgFontTextCache
+{
+public:
+    explicit TgFontTextCache();
+    ~TgFontTextCache();
+
+    TgFontText *getFontText(const std::vector<TgTextFieldText> &listText, const std::string &fontFile, float fontSize,
+                            uint32_t maxLineCount, float maxLineWidth, TgTextFieldWordWrap wordWrap, bool allowBreakLineGoOverMaxLine);
+    void releaseFontText(TgFontText *fontText);
+    size_t getCount();
+
+private:
+    std::mutex m_mutex;
+    std::unordered_multimap<uint64_t, TgFontTextCacheEntry *>m_listEntry;
+    std::unordered_map<const TgFontText *, TgFontTextCacheLayout *>m_listLayoutByFontText;
+
+    TgFontTextCacheEntry *getEntry(TgFontTextCacheKey &key);
+    TgFontTextCacheLayout *getLayout(TgFontTextCacheEntry *entry, const TgFontTextCacheLayoutKey &layoutKey);
+    static TgFontText *generateShapedFontText(const TgFontTextCacheKey &key);
+    static void deleteEntry(TgFontTextCacheEntry *entry);
+    static bool isEqualKey(const TgFontTextCacheKey &key0, const TgFontTextCacheKey &key1);
+    static bool isEqualLayoutKey(const TgFontTextCacheLayoutKey &key0, const TgFontTextCacheLayoutKey &key1);
+    static uint64_t generateHash(const TgFontTextCacheKey &key);
+    static void addHash(uint64_t &hash, uint64_t value);
+};
+
+#endif // TG_FONT_TEXT_CACHE_H
@@ -11,6 +11,7 @@
 
 #include "tg_text_parse_utf8.h"
 #include "../../global/tg_global_log.h"
+#include "tg_text_transcode_utf8.h"
 #include <cstring>
 
 /*!
@@ -25,37 +26,7 @@ void TgTextParseUtf8::generateCharactedIndexToUtf8(uint32_t character, char newC
 {
     TG_FUNCTION_BEGIN();
     memset(newCharacter, '\0', 5);
-    if (character >= 1 && character <= 127) {
-        newCharacter[0] = static_cast<char>(character);
-        TG_FUNCTION_END();
-        return;
-    }
-
-    // 110xxxxx 10xxxxxx == 2 bytes
-    // 0x0080 to 0x07FF
-    if (character >= 0x0080 && character <= 0x07FF) {
-        newCharacter[0] = static_cast<char>(0xC0 | static_cast<char>(character >> 6));
-        newCharacter[1] = static_cast<char>(0x80 | static_cast<char>(character & 0x3F));
-        TG_FUNCTION_END();
-        return;
-    }
-
-    if (character >= 0x0800 && character <= 0xFFFF) {
-        newCharacter[0] = static_cast<char>(0xE0 | static_cast<char>(character >> 12));
-        newCharacter[1] = static_cast<char>(0x80 | static_cast<char>( (character >> 6) &  0x3F));
-        newCharacter[2] = static_cast<char>(0x80 | static_cast<char>(character & 0x3F));
-        TG_FUNCTION_END();
-        return;
-    }
-
-    if (character >= 0x10000 && character <= 0x10FFFF) {
-        newCharacter[0] = static_cast<char>(0xF0 | static_cast<char>(character >> 18));
-        newCharacter[1] = static_cast<char>(0x80 | static_cast<char>( (character >> 12) &  0x3F));
-        newCharacter[2] = static_cast<char>(0x80 | static_cast<char>( (character >> 6) &  0x3F));
-        newCharacter[3] = static_cast<char>(0x80 | static_cast<char>(character & 0x3F));
-        TG_FUNCTION_END();
-        return;
-    }
+    TgTextTranscodeUtf8::convertUtf32ToUtf8(&character, 1, newCharacter);
     TG_FUNCTION_END();
 }
 
@@ -0,0 +1,353 @@
+/*!
+ * \file
+ * \brief file tg_text_transcode_utf8.cpp
+ *
+ * utf-8 <-> utf-32 conversion of whole texts into preallocated buffers,
+ * ascii runs are converted with SSE2/AVX2 when it's available
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_text_transcode_utf8.h"
+#include "../../global/tg_global_log.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TG_TEXT_TRANSCODE_USE_SSE2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TG_TEXT_TRANSCODE_USE_AVX2
+#endif
+#endif
+
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf8ToUtf32
+ *
+ * converts and validates utf8 text to utf32 characters,
+ * overlong encodings, surrogates and characters over 0x10FFFF are invalid
+ *
+ * \param text utf8 text
+ * \param textSize size of text in bytes
+ * \param characters [out] utf32 characters, must have space for textSize characters
+ * \param characterCount [out] number of characters written
+ * \return true on success, false if text is not valid utf8
+ */
+bool TgTextTranscodeUtf8::convertUtf8ToUtf32(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount)
+{
+    characterCount = 0;
+    if (!textSize) {
+        return true;
+    }
+#ifdef TG_TEXT_TRANSCODE_USE_AVX2
+    if (isAvx2Supported()) {
+        return convertUtf8ToUtf32Avx2(text, textSize, characters, characterCount);
+    }
+#endif
+#ifdef TG_TEXT_TRANSCODE_USE_SSE2
+    return convertUtf8ToUtf32Sse2(text, textSize, characters, characterCount);
+#else
+    size_t textIndex = 0;
+    return convertUtf8ToUtf32Scalar(text, textSize, textSize, textIndex, characters, characterCount);
+#endif
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf32ToUtf8
+ *
+ * converts utf32 characters to utf8 text, invalid characters
+ * (and 0) are skipped, text is not null terminated
+ *
+ * \param characters utf32 characters
+ * \param characterCount number of characters
+ * \param text [out] utf8 text, must have space for 4*characterCount bytes
+ * \return number of bytes written
+ */
+size_t TgTextTranscodeUtf8::convertUtf32ToUtf8(const uint32_t *characters, size_t characterCount, char *text)
+{
+#ifdef TG_TEXT_TRANSCODE_USE_SSE2
+    return convertUtf32ToUtf8Sse2(characters, characterCount, text);
+#else
+    return convertUtf32ToUtf8Scalar(characters, characterCount, text);
+#endif
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::addUtf8ToUtf32List
+ *
+ * converts text and adds characters to end of listCharacter
+ *
+ * \param text utf8 text
+ * \param listCharacter [in/out] characters are added here
+ * \return true on success, false if text is not valid utf8 (listCharacter is not changed)
+ */
+bool TgTextTranscodeUtf8::addUtf8ToUtf32List(const std::string &text, std::vector<uint32_t> &listCharacter)
+{
+    const size_t previousSize = listCharacter.size();
+    size_t characterCount;
+    listCharacter.resize(previousSize + text.size());
+    if (!convertUtf8ToUtf32(text.data(), text.size(), listCharacter.data() + previousSize, characterCount)) {
+        listCharacter.resize(previousSize);
+        return false;
+    }
+    listCharacter.resize(previousSize + characterCount);
+    return true;
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::addUtf32ToUtf8Text
+ *
+ * converts characters and adds them to end of text
+ *
+ * \param characters utf32 characters
+ * \param characterCount number of characters
+ * \param text [in/out] utf8 text
+ */
+void TgTextTranscodeUtf8::addUtf32ToUtf8Text(const uint32_t *characters, size_t characterCount, std::string &text)
+{
+    const size_t previousSize = text.size();
+    text.resize(previousSize + characterCount*4);
+    text.resize(previousSize + convertUtf32ToUtf8(characters, characterCount, &text[previousSize]));
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf8ToUtf32Scalar
+ *
+ * converts characters one by one, until textEnd is reached
+ * (last character can continue over textEnd, but not over textSize)
+ *
+ * \param text utf8 text
+ * \param textSize size of text in bytes
+ * \param textEnd conversion stops when textIndex reaches this
+ * \param textIndex [in/out] byte index of text
+ * \param characters [out] utf32 characters
+ * \param characterIndex [in/out] index of characters
+ * \return true on success, false if text is not valid utf8
+ */
+bool TgTextTranscodeUtf8::convertUtf8ToUtf32Scalar(const char *text, size_t textSize, size_t textEnd, size_t &textIndex, uint32_t *characters, size_t &characterIndex)
+{
+    const unsigned char *t = reinterpret_cast<const unsigned char *>(text);
+    uint32_t c;
+    unsigned char minSecond, maxSecond;
+    while (textIndex < textEnd) {
+        c = t[textIndex];
+        if (c < 0x80) {
+            characters[characterIndex++] = c;
+            textIndex++;
+            continue;
+        }
+        // 110xxxxx 10xxxxxx, 0x80 - 0x7FF
+        if (c >= 0xC2 && c <= 0xDF) {
+            if (textIndex+1 >= textSize || (t[textIndex+1] & 0xC0) != 0x80) {
+                return false;
+            }
+            characters[characterIndex++] = ((c & 0x1F) << 6) | (t[textIndex+1] & 0x3Fu);
+            textIndex += 2;
+            continue;
+        }
+        // 1110xxxx 10xxxxxx 10xxxxxx, 0x800 - 0xFFFF (without surrogates)
+        if (c >= 0xE0 && c <= 0xEF) {
+            minSecond = c == 0xE0 ? 0xA0 : 0x80;
+            maxSecond = c == 0xED ? 0x9F : 0xBF;
+            if (textIndex+2 >= textSize
+                || t[textIndex+1] < minSecond || t[textIndex+1] > maxSecond
+                || (t[textIndex+2] & 0xC0) != 0x80) {
+                return false;
+            }
+            characters[characterIndex++] = ((c & 0x0F) << 12) | ((t[textIndex+1] & 0x3Fu) << 6) | (t[textIndex+2] & 0x3Fu);
+            textIndex += 3;
+            continue;
+        }
+        // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx, 0x10000 - 0x10FFFF
+        if (c >= 0xF0 && c <= 0xF4) {
+            minSecond = c == 0xF0 ? 0x90 : 0x80;
+            maxSecond = c == 0xF4 ? 0x8F : 0xBF;
+            if (textIndex+3 >= textSize
+                || t[textIndex+1] < minSecond || t[textIndex+1] > maxSecond
+                || (t[textIndex+2] & 0xC0) != 0x80
+                || (t[textIndex+3] & 0xC0) != 0x80) {
+                return false;
+            }
+            characters[characterIndex++] = ((c & 0x07) << 18) | ((t[textIndex+1] & 0x3Fu) << 12)
+                                           | ((t[textIndex+2] & 0x3Fu) << 6) | (t[textIndex+3] & 0x3Fu);
+            textIndex += 4;
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf32ToUtf8Scalar
+ *
+ * \param characters utf32 characters
+ * \param characterCount number of characters
+ * \param text [out] utf8 text
+ * \return number of bytes written
+ */
+size_t TgTextTranscodeUtf8::convertUtf32ToUtf8Scalar(const uint32_t *characters, size_t characterCount, char *text)
+{
+    size_t i, ret = 0;
+    uint32_t c;
+    for (i=0;i<characterCount;i++) {
+        c = characters[i];
+        if (c >= 1 && c <= 0x7F) {
+            text[ret++] = static_cast<char>(c);
+        } else if (c >= 0x80 && c <= 0x7FF) {
+            text[ret++] = static_cast<char>(0xC0 | (c >> 6));
+            text[ret++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c >= 0x800 && c <= 0xFFFF) {
+            if (c >= 0xD800 && c <= 0xDFFF) {
+                continue;
+            }
+            text[ret++] = static_cast<char>(0xE0 | (c >> 12));
+            text[ret++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            text[ret++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c >= 0x10000 && c <= 0x10FFFF) {
+            text[ret++] = static_cast<char>(0xF0 | (c >> 18));
+            text[ret++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            text[ret++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            text[ret++] = static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return ret;
+}
+
+#ifdef TG_TEXT_TRANSCODE_USE_SSE2
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf8ToUtf32Sse2
+ *
+ * 16 bytes blocks that are all ascii are widened with SSE2,
+ * when block has non-ascii character, scalar conversion is used
+ * until that character is converted
+ *
+ * \param text utf8 text
+ * \param textSize size of text in bytes
+ * \param characters [out] utf32 characters
+ * \param characterCount [out] number of characters written
+ * \return true on success, false if text is not valid utf8
+ */
+bool TgTextTranscodeUtf8::convertUtf8ToUtf32Sse2(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v, v16;
+    int mask;
+    size_t textIndex = 0;
+    characterCount = 0;
+    while (textIndex + 16 <= textSize) {
+        v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + textIndex));
+        mask = _mm_movemask_epi8(v);
+        if (mask) {
+            // ascii start of block and the first non-ascii character
+            if (!convertUtf8ToUtf32Scalar(text, textSize, textIndex + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(mask))) + 1,
+                                          textIndex, characters, characterCount)) {
+                return false;
+            }
+            continue;
+        }
+        v16 = _mm_unpacklo_epi8(v, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(characters + characterCount), _mm_unpacklo_epi16(v16, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(characters + characterCount + 4), _mm_unpackhi_epi16(v16, zero));
+        v16 = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(characters + characterCount + 8), _mm_unpacklo_epi16(v16, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(characters + characterCount + 12), _mm_unpackhi_epi16(v16, zero));
+        textIndex += 16;
+        characterCount += 16;
+    }
+    return convertUtf8ToUtf32Scalar(text, textSize, textSize, textIndex, characters, characterCount);
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf32ToUtf8Sse2
+ *
+ * 16 characters blocks that are all ascii are narrowed with SSE2,
+ * other blocks are converted with scalar conversion
+ *
+ * \param characters utf32 characters
+ * \param characterCount number of characters
+ * \param text [out] utf8 text
+ * \return number of bytes written
+ */
+size_t TgTextTranscodeUtf8::convertUtf32ToUtf8Sse2(const uint32_t *characters, size_t characterCount, char *text)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAsciiMask = _mm_set1_epi32(~0x7F);
+    __m128i v0, v1, v2, v3, all;
+    size_t i = 0, ret = 0;
+    while (i + 16 <= characterCount) {
+        v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters + i));
+        v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters + i + 4));
+        v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters + i + 8));
+        v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(characters + i + 12));
+        all = _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3));
+        // 0 is skipped like in scalar conversion, so block with 0 is not copied directly
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonAsciiMask), zero)) != 0xFFFF
+            || _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(v0, zero), _mm_cmpeq_epi32(v1, zero)),
+                                              _mm_or_si128(_mm_cmpeq_epi32(v2, zero), _mm_cmpeq_epi32(v3, zero))))) {
+            ret += convertUtf32ToUtf8Scalar(characters + i, 16, text + ret);
+            i += 16;
+            continue;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(text + ret),
+                         _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3)));
+        i += 16;
+        ret += 16;
+    }
+    return ret + convertUtf32ToUtf8Scalar(characters + i, characterCount - i, text + ret);
+}
+#endif
+
+#ifdef TG_TEXT_TRANSCODE_USE_AVX2
+/*!
+ * \brief TgTextTranscodeUtf8::convertUtf8ToUtf32Avx2
+ *
+ * 32 bytes blocks that are all ascii are widened with AVX2,
+ * when block has non-ascii character, scalar conversion is used
+ * until that character is converted
+ *
+ * \param text utf8 text
+ * \param textSize size of text in bytes
+ * \param characters [out] utf32 characters
+ * \param characterCount [out] number of characters written
+ * \return true on success, false if text is not valid utf8
+ */
+__attribute__((target("avx2")))
+bool TgTextTranscodeUtf8::convertUtf8ToUtf32Avx2(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount)
+{
+    __m256i v;
+    int mask;
+    size_t i, textIndex = 0;
+    characterCount = 0;
+    while (textIndex + 32 <= textSize) {
+        v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + textIndex));
+        mask = _mm256_movemask_epi8(v);
+        if (mask) {
+            if (!convertUtf8ToUtf32Scalar(text, textSize, textIndex + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(mask))) + 1,
+                                          textIndex, characters, characterCount)) {
+                return false;
+            }
+            continue;
+        }
+        for (i=0;i<32;i+=8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(characters + characterCount + i),
+                                _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(text + textIndex + i))));
+        }
+        textIndex += 32;
+        characterCount += 32;
+    }
+    return convertUtf8ToUtf32Scalar(text, textSize, textSize, textIndex, characters, characterCount);
+}
+
+/*!
+ * \brief TgTextTranscodeUtf8::isAvx2Supported
+ *
+ * \return true if cpu supports AVX2
+ */
+bool TgTextTranscodeUtf8::isAvx2Supported()
+{
+    static const bool avx2Supported = __builtin_cpu_supports("avx2");
+    return avx2Supported;
+}
+#endif
@@ -0,0 +1,39 @@
+/*!
+ * \file
+ * \brief file tg_text_transcode_utf8.h
+ *
+ * utf-8 <-> utf-32 conversion of whole texts into preallocated buffers,
+ * ascii runs are converted with SSE2/AVX2 when it's available
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TEXT_TRANSCODE_UTF8_H
+#define TG_TEXT_TRANSCODE_UTF8_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+class TgTextTranscodeUtf8
+{
+public:
+    static bool convertUtf8ToUtf32(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount);
+    static size_t convertUtf32ToUtf8(const uint32_t *characters, size_t characterCount, char *text);
+
+    static bool addUtf8ToUtf32List(const std::string &text, std::vector<uint32_t> &listCharacter);
+    static void addUtf32ToUtf8Text(const uint32_t *characters, size_t characterCount, std::string &text);
+
+private:
+    static bool convertUtf8ToUtf32Scalar(const char *text, size_t textSize, size_t textEnd, size_t &textIndex, uint32_t *characters, size_t &characterIndex);
+    static bool convertUtf8ToUtf32Sse2(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount);
+    static bool convertUtf8ToUtf32Avx2(const char *text, size_t textSize, uint32_t *characters, size_t &characterCount);
+    static size_t convertUtf32ToUtf8Scalar(const uint32_t *characters, size_t characterCount, char *text);
+    static size_t convertUtf32ToUtf8Sse2(const uint32_t *characters, size_t characterCount, char *text);
+    static bool isAvx2Supported();
+};
+
+#endif // TG_TEXT_TRANSCODE_UTF8_H
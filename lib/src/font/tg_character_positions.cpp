@@ -30,25 +30,6 @@ TgCharacterPositions::~TgCharacterPositions()
     TG_FUNCTION_END();
 }
 
-/*!
- * \brief TgCharacterPositions::getCharacterIndex
- *
- * get chraracter index from newInfo's m_listCharacter
- *
- * \param newInfo [in] info
- * \param character character
- * \return character index to find from newInfo->m_listCharacter
- */
-size_t TgCharacterPositions::getCharacterIndex(const TgFontInfo *newInfo, uint32_t character)
-{
-    for (size_t i=0;i<newInfo->m_listCharacter.size();i++) {
-        if (newInfo->m_listCharacter.at(i) == character) {
-            return i;
-        }
-    }
-    return 0;
-}
-
 /*!
  * \brief TgCharacterPositions::generateTextCharacterPositioning
  *
@@ -59,32 +40,82 @@ size_t TgCharacterPositions::getCharacterIndex(const TgFontInfo *newInfo, uint32
  * \param maxLineWidth [in] max line width
  * \param wordWrap
  * \param allowBreakLineGoOverMaxLine
+ * \param startCharacterIndex characters before this index are not changed after previous
+ * positioning, so positioning continues from the last stored layout state (TgFontTextLineStart)
+ * before startCharacterIndex (0 == whole text is positioned)
  * \return true on success
  */
 bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText, const uint32_t maxLineCount, const float maxLineWidth,
-                                                            const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine)
+                                                            const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine,
+                                                            const size_t startCharacterIndex)
 {
     TG_FUNCTION_BEGIN();
     size_t i, i2, c = fontText->getCharacterCount();
     TgFontTextCharacterInfo *characterInfo;
     TgFontTextCharacterInfo *leftCharacterInfo = nullptr;
-    TgFontInfo *fontInfo;
-    TgFontInfo *leftFontInfo = nullptr;
-    const prj_ttf_reader_glyph_data_t *glyph;
-    const prj_ttf_reader_glyph_data_t *left_glyph = nullptr;
+    TgFontTextLayout *layout = fontText->getLayout();
+    const TgFontTextLayoutCharacter *layoutCharacter;
+    const TgFontTextLayoutCharacter *leftLayoutCharacter = nullptr;
     float positionLeftX = 0;
-    size_t infoCharacterIndex = 0;
-    float kerning = 0;
-    int32_t left_advance_x, left_bearing, right_bearing;
     uint32_t currentLine = 1;
     bool firstCharacterAdded = false;
     float textLinesWidth = 0;
     float textWidthToSet = 0;
     size_t previousSpaceIndex = c;
+    size_t firstIndex = 0;
+    size_t leftCharacterIndex = SIZE_MAX;
+    size_t lineStartIndex = 0;
+    uint32_t lineStartLineNumber = 1;
+    TgFontTextLineStart lineStart;
+    // glyph widths and kerning are looked up only for changed characters,
+    // so wrapping again with other width is only arithmetic
+    layout->update(fontText);
+    layout->resizePositionX(c);
     fontText->setTextWidth(0);
-    fontText->clearListLinesWidth();
-
-    for (i=0;i<c;i++) {
+    if (startCharacterIndex && fontText->getLineStart(startCharacterIndex, lineStart)) {
+        firstIndex = lineStart.m_characterIndex;
+        currentLine = lineStart.m_lineNumber;
+        textLinesWidth = lineStart.m_textLinesWidth;
+        textWidthToSet = lineStart.m_textWidth;
+        firstCharacterAdded = lineStart.m_firstCharacterAdded;
+        if (firstCharacterAdded) {
+            fontText->setVisibleTopY(lineStart.m_visibleTopY);
+            fontText->setVisibleBottomY(lineStart.m_visibleBottomY);
+        }
+        positionLeftX = lineStart.m_positionLeftX;
+        previousSpaceIndex = lineStart.m_previousSpaceIndex == SIZE_MAX ? c : lineStart.m_previousSpaceIndex;
+        fontText->resizeListLinesWidth(currentLine - 1);
+        if (lineStart.m_leftCharacterIndex != SIZE_MAX) {
+            leftCharacterIndex = lineStart.m_leftCharacterIndex;
+            leftLayoutCharacter = &layout->getCharacter(leftCharacterIndex);
+            fontText->setListLinesWidth(currentLine - 1, lineStart.m_lineWidth);
+        }
+        lineStartIndex = firstIndex;
+        lineStartLineNumber = currentLine;
+    } else {
+        fontText->clearListLinesWidth();
+    }
+    fontText->clearListLineStart(firstIndex);
+
+    for (i=firstIndex;i<c;i++) {
+        if (i != lineStartIndex
+            && (currentLine != lineStartLineNumber || i - lineStartIndex >= TG_FONT_TEXT_LINE_START_INTERVAL)) {
+            // new line or long line, store the state so editing can continue from here
+            lineStart.m_characterIndex = i;
+            lineStart.m_lineNumber = currentLine;
+            lineStart.m_textLinesWidth = textLinesWidth;
+            lineStart.m_textWidth = textWidthToSet;
+            lineStart.m_visibleTopY = fontText->getVisibleTopY();
+            lineStart.m_visibleBottomY = fontText->getVisibleBottomY();
+            lineStart.m_firstCharacterAdded = firstCharacterAdded;
+            lineStart.m_positionLeftX = positionLeftX;
+            lineStart.m_leftCharacterIndex = leftLayoutCharacter ? leftCharacterIndex : SIZE_MAX;
+            lineStart.m_previousSpaceIndex = previousSpaceIndex == c ? SIZE_MAX : previousSpaceIndex;
+            lineStart.m_lineWidth = fontText->getTextLineWidth(currentLine - 1);
+            fontText->addLineStart(lineStart);
+            lineStartIndex = i;
+            lineStartLineNumber = currentLine;
+        }
         characterInfo = fontText->getCharacter(i);
         characterInfo->m_draw = true;
         if (characterInfo->m_character == '\n') {
@@ -95,12 +126,13 @@ bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText
                 for (i2=i;i2<c;i2++) {
                     fontText->getCharacter(i2)->m_draw = false;
                     fontText->getCharacter(i2)->m_lineNumber = currentLine - 1;
+                    layout->setPositionX(i2, layout->getPreviousPositionX(i2), currentLine - 1);
                 }
                 break;
             }
-            if (left_glyph) {
-                if (textWidthToSet < textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x)) {
-                    textWidthToSet = textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+            if (leftLayoutCharacter) {
+                if (textWidthToSet < textLinesWidth + positionLeftX + leftLayoutCharacter->m_width) {
+                    textWidthToSet = textLinesWidth + positionLeftX + leftLayoutCharacter->m_width;
                 }
             } else {
                 if (textWidthToSet < positionLeftX) {
@@ -111,48 +143,28 @@ bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText
                 previousSpaceIndex = c;
                 currentLine++;
                 positionLeftX = 0;
-                left_glyph = nullptr;
+                leftLayoutCharacter = nullptr;
             }
             characterInfo->positionLeftX = 0;
             characterInfo->m_lineNumber = currentLine - 1;
+            layout->setPositionX(i, 0, currentLine - 1);
             continue;
         }
 
-        if (characterInfo->m_fontFileNameIndex == -1) {
-            continue;
-        }
-        fontInfo = fontText->getFontInfo(i);
-        if (!fontInfo) {
+        layoutCharacter = &layout->getCharacter(i);
+        if (!layoutCharacter->m_glyph) {
+            layout->setPositionX(i, layout->getPreviousPositionX(i), layout->getPreviousLineNumber(i));
             continue;
         }
 
-        glyph = prj_ttf_reader_get_character_glyph_data(characterInfo->m_character, fontInfo->m_data);
-        if (!glyph) {
-            continue;
-        }
-
-        if (i && left_glyph) {
-            left_glyph = prj_ttf_reader_get_character_glyph_data(leftCharacterInfo->m_character, leftFontInfo->m_data);
-            left_advance_x = static_cast<int32_t>(left_glyph->image_pixel_advance_x + 0.5f);
-            left_bearing = static_cast<int32_t>(left_glyph->image_pixel_bearing);
-            if (left_glyph->image_pixel_bearing < 0 && left_glyph->image_pixel_bearing > -1) {
-                left_bearing = -1;
-            }
-            left_advance_x -= left_bearing;
-            left_advance_x -= left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x;
-            right_bearing = static_cast<int32_t>(glyph->image_pixel_bearing);
-            if (glyph->image_pixel_bearing < 0 && glyph->image_pixel_bearing > -1) {
-                right_bearing = -1;
-            }
-
-            kerning = prj_ttf_reader_get_kerning(leftCharacterInfo->m_character, characterInfo->m_character, fontInfo->m_data) + static_cast<float>(right_bearing + left_advance_x);
-
-            positionLeftX += static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
-            positionLeftX += kerning;
+        if (leftLayoutCharacter) {
+            positionLeftX += leftLayoutCharacter->m_width;
+            positionLeftX += layoutCharacter->m_kerning;
         }
         if (wordWrap == TgTextFieldWordWrap::WordWrapOn
-            && isOverTheLine(currentLine, positionLeftX, glyph, maxLineCount, maxLineWidth)) {
+            && isOverTheLine(currentLine, positionLeftX, layoutCharacter->m_width, maxLineCount, maxLineWidth)) {
             if (previousSpaceIndex != c && previousSpaceIndex > 0) {
+                // continue from the break opportunity (previous space) on the next line
                 leftCharacterInfo = fontText->getCharacter(previousSpaceIndex);
                 fontText->setListLinesWidth(leftCharacterInfo->m_lineNumber,
                     leftCharacterInfo->positionLeftX);
@@ -160,13 +172,19 @@ bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText
                     textWidthToSet = leftCharacterInfo->positionLeftX;
                 }
                 i = previousSpaceIndex;
+                // break opportunity is used, so word that is longer than
+                // the line is not wrapped again to the same break opportunity
+                previousSpaceIndex = c;
                 positionLeftX = 0;
                 currentLine++;
-                left_glyph = nullptr;
+                leftLayoutCharacter = nullptr;
+                // states stored after the break opportunity are not valid anymore
+                fontText->clearListLineStart(previousSpaceIndex);
+                lineStartIndex = previousSpaceIndex;
                 continue;
             }
-            if (left_glyph) {
-                textLinesWidth += positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+            if (leftLayoutCharacter) {
+                textLinesWidth += positionLeftX + leftLayoutCharacter->m_width;
                 if (textWidthToSet < textLinesWidth) {
                     textWidthToSet = textLinesWidth;
                 }
@@ -174,9 +192,9 @@ bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText
             positionLeftX = 0;
             currentLine++;
         } else if (wordWrap == TgTextFieldWordWrap::WordWrapBounded
-                    && isOverTheLine(currentLine, positionLeftX, glyph, maxLineCount, maxLineWidth)) {
-            if (left_glyph) {
-                textLinesWidth += positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+                    && isOverTheLine(currentLine, positionLeftX, layoutCharacter->m_width, maxLineCount, maxLineWidth)) {
+            if (leftLayoutCharacter) {
+                textLinesWidth += positionLeftX + leftLayoutCharacter->m_width;
                 if (textWidthToSet < textLinesWidth) {
                     textWidthToSet = textLinesWidth;
                 }
@@ -185,39 +203,36 @@ bool TgCharacterPositions::generateTextCharacterPositioning(TgFontText *fontText
             currentLine++;
         }
 
-        if (characterInfo->m_character == ' ') {
+        if (layoutCharacter->m_breakOpportunity) {
             previousSpaceIndex = i;
         }
 
         characterInfo->positionLeftX = positionLeftX;
         characterInfo->m_lineNumber = currentLine - 1;
-        fontText->setListLinesWidth(characterInfo->m_lineNumber, positionLeftX + static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x));
+        layout->setPositionX(i, positionLeftX, currentLine - 1);
+        fontText->setListLinesWidth(characterInfo->m_lineNumber, positionLeftX + layoutCharacter->m_width);
 
-        infoCharacterIndex = getCharacterIndex(fontInfo, characterInfo->m_character);
-        characterInfo->m_characterInFontInfoIndex = infoCharacterIndex;
+        characterInfo->m_characterInFontInfoIndex = layoutCharacter->m_characterInFontInfoIndex;
         if (!firstCharacterAdded) {
-            fontText->setVisibleTopY(fontInfo->m_listTopPositionY.at(infoCharacterIndex));
-            fontText->setVisibleBottomY(fontInfo->m_listBottomPositionY.at(infoCharacterIndex));
+            fontText->setVisibleTopY(layoutCharacter->m_visibleTopY);
+            fontText->setVisibleBottomY(layoutCharacter->m_visibleBottomY);
             firstCharacterAdded = true;
-        } else {
-            if (fontInfo->m_listTopPositionY.size() > infoCharacterIndex
-                && fontText->getVisibleTopY() > fontInfo->m_listTopPositionY.at(infoCharacterIndex)) {
-                fontText->setVisibleTopY(fontInfo->m_listTopPositionY.at(infoCharacterIndex));
+        } else if (layoutCharacter->m_visibleY) {
+            if (fontText->getVisibleTopY() > layoutCharacter->m_visibleTopY) {
+                fontText->setVisibleTopY(layoutCharacter->m_visibleTopY);
             }
-            if (fontInfo->m_listBottomPositionY.size() > infoCharacterIndex
-                && fontText->getVisibleBottomY() < fontInfo->m_listBottomPositionY.at(infoCharacterIndex)) {
-                fontText->setVisibleBottomY(fontInfo->m_listBottomPositionY.at(infoCharacterIndex));
+            if (fontText->getVisibleBottomY() < layoutCharacter->m_visibleBottomY) {
+                fontText->setVisibleBottomY(layoutCharacter->m_visibleBottomY);
             }
         }
 
-        left_glyph = glyph;
-        leftCharacterInfo = characterInfo;
-        leftFontInfo = fontInfo;
+        leftLayoutCharacter = layoutCharacter;
+        leftCharacterIndex = i;
     }
 
-    if (left_glyph) {
-        if (textWidthToSet < textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x)) {
-            textWidthToSet = textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+    if (leftLayoutCharacter) {
+        if (textWidthToSet < textLinesWidth + positionLeftX + leftLayoutCharacter->m_width) {
+            textWidthToSet = textLinesWidth + positionLeftX + leftLayoutCharacter->m_width;
         }
         fontText->setTextWidth(textWidthToSet);
     }
@@ -255,16 +270,10 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
     size_t i, i2, c = listCharacter.size();
     TgFontTextCharacterInfo *characterInfo;
     TgFontTextCharacterInfo *leftCharacterInfo = nullptr;
-    TgFontInfoData *fontInfo;
-    TgFontInfoData *leftFontInfo = nullptr;
-    const prj_ttf_reader_glyph_data_t *glyph;
-    const prj_ttf_reader_glyph_data_t *left_glyph = nullptr;
+    const TgFontTextLayoutCharacter *layoutCharacter;
+    const TgFontTextLayoutCharacter *leftLayoutCharacter = nullptr;
     float positionLeftX = 0;
-    size_t infoCharacterIndex = 0;
-    float kerning = 0;
-    int32_t left_advance_x, left_bearing, right_bearing;
     uint32_t currentLine = 1;
-    bool firstCharacterAdded = false;
     float textLinesWidth = 0;
     float textWidthToSet = 0;
     size_t previousSpaceIndex = c;
@@ -272,6 +281,10 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
     mostTextHeight = 0;
     allDrawTextHeight = 0;
     std::vector<float> listLineWidth;
+    // glyph widths and kerning are looked up once, so going back
+    // to the break opportunity on word wrap is only arithmetic
+    std::vector<TgFontTextLayoutCharacter> listLayoutCharacter;
+    generateLayoutCharacters(listFontInfo, listCharacter, listLayoutCharacter);
 
     for (i=0;i<c;i++) {
         characterInfo = &listCharacter[i];
@@ -286,9 +299,9 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
                 }
                 break;
             }
-            if (left_glyph) {
-                if (textWidthToSet < textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x)) {
-                    textWidthToSet = textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+            if (leftLayoutCharacter) {
+                if (textWidthToSet < textLinesWidth + positionLeftX + leftLayoutCharacter->m_width) {
+                    textWidthToSet = textLinesWidth + positionLeftX + leftLayoutCharacter->m_width;
                 }
             } else {
                 if (textWidthToSet < positionLeftX) {
@@ -299,47 +312,24 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
                 previousSpaceIndex = c;
                 currentLine++;
                 positionLeftX = 0;
-                left_glyph = nullptr;
+                leftLayoutCharacter = nullptr;
             }
             characterInfo->positionLeftX = 0;
             characterInfo->m_lineNumber = currentLine - 1;
             continue;
         }
 
-        if (characterInfo->m_fontFileNameIndex == -1) {
-            continue;
-        }
-        fontInfo = listFontInfo[i];
-        if (!fontInfo) {
-            continue;
-        }
-
-        glyph = prj_ttf_reader_get_character_glyph_data(characterInfo->m_character, fontInfo->m_data);
-        if (!glyph) {
+        layoutCharacter = &listLayoutCharacter[i];
+        if (!layoutCharacter->m_glyph) {
             continue;
         }
 
-        if (i && left_glyph) {
-            left_glyph = prj_ttf_reader_get_character_glyph_data(leftCharacterInfo->m_character, leftFontInfo->m_data);
-            left_advance_x = static_cast<int32_t>(left_glyph->image_pixel_advance_x + 0.5f);
-            left_bearing = static_cast<int32_t>(left_glyph->image_pixel_bearing);
-            if (left_glyph->image_pixel_bearing < 0 && left_glyph->image_pixel_bearing > -1) {
-                left_bearing = -1;
-            }
-            left_advance_x -= left_bearing;
-            left_advance_x -= left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x;
-            right_bearing = static_cast<int32_t>(glyph->image_pixel_bearing);
-            if (glyph->image_pixel_bearing < 0 && glyph->image_pixel_bearing > -1) {
-                right_bearing = -1;
-            }
-
-            kerning = prj_ttf_reader_get_kerning(leftCharacterInfo->m_character, characterInfo->m_character, fontInfo->m_data) + static_cast<float>(right_bearing + left_advance_x);
-
-            positionLeftX += static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
-            positionLeftX += kerning;
+        if (leftLayoutCharacter) {
+            positionLeftX += leftLayoutCharacter->m_width;
+            positionLeftX += layoutCharacter->m_kerning;
         }
         if (wordWrap == TgTextFieldWordWrap::WordWrapOn
-            && isOverTheLine(currentLine, positionLeftX, glyph, maxLineCount, maxLineWidth)) {
+            && isOverTheLine(currentLine, positionLeftX, layoutCharacter->m_width, maxLineCount, maxLineWidth)) {
             if (previousSpaceIndex != c && previousSpaceIndex > 0) {
                 leftCharacterInfo = &listCharacter[previousSpaceIndex];
                 TgFontText::setListLinesWidth(listLineWidth, leftCharacterInfo->m_lineNumber,
@@ -348,13 +338,14 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
                     textWidthToSet = leftCharacterInfo->positionLeftX;
                 }
                 i = previousSpaceIndex;
+                previousSpaceIndex = c;
                 positionLeftX = 0;
                 currentLine++;
-                left_glyph = nullptr;
+                leftLayoutCharacter = nullptr;
                 continue;
             }
-            if (left_glyph) {
-                textLinesWidth += positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+            if (leftLayoutCharacter) {
+                textLinesWidth += positionLeftX + leftLayoutCharacter->m_width;
                 if (textWidthToSet < textLinesWidth) {
                     textWidthToSet = textLinesWidth;
                 }
@@ -362,9 +353,9 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
             positionLeftX = 0;
             currentLine++;
         } else if (wordWrap == TgTextFieldWordWrap::WordWrapBounded
-                    && isOverTheLine(currentLine, positionLeftX, glyph, maxLineCount, maxLineWidth)) {
-            if (left_glyph) {
-                textLinesWidth += positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+                    && isOverTheLine(currentLine, positionLeftX, layoutCharacter->m_width, maxLineCount, maxLineWidth)) {
+            if (leftLayoutCharacter) {
+                textLinesWidth += positionLeftX + leftLayoutCharacter->m_width;
                 if (textWidthToSet < textLinesWidth) {
                     textWidthToSet = textLinesWidth;
                 }
@@ -373,28 +364,20 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
             currentLine++;
         }
 
-        if (characterInfo->m_character == ' ') {
+        if (layoutCharacter->m_breakOpportunity) {
             previousSpaceIndex = i;
         }
 
         characterInfo->positionLeftX = positionLeftX;
         characterInfo->m_lineNumber = currentLine - 1;
-        TgFontText::setListLinesWidth(listLineWidth, characterInfo->m_lineNumber, positionLeftX + static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x));
-
-        infoCharacterIndex = getCharacterIndex(fontInfo, characterInfo->m_character);
-        characterInfo->m_characterInFontInfoIndex = infoCharacterIndex;
-        if (!firstCharacterAdded) {
-            firstCharacterAdded = true;
-        }
+        TgFontText::setListLinesWidth(listLineWidth, characterInfo->m_lineNumber, positionLeftX + layoutCharacter->m_width);
 
-        left_glyph = glyph;
-        leftCharacterInfo = characterInfo;
-        leftFontInfo = fontInfo;
+        leftLayoutCharacter = layoutCharacter;
     }
 
-    if (left_glyph) {
-        if (textWidthToSet < textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x)) {
-            textWidthToSet = textLinesWidth + positionLeftX + static_cast<float>(left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x);
+    if (leftLayoutCharacter) {
+        if (textWidthToSet < textLinesWidth + positionLeftX + leftLayoutCharacter->m_width) {
+            textWidthToSet = textLinesWidth + positionLeftX + leftLayoutCharacter->m_width;
         }
         mostTextWidth = textWidthToSet;
     }
@@ -405,22 +388,65 @@ bool TgCharacterPositions::calculateTextWidthHeight(std::vector<TgFontInfoData *
 }
 
 /*!
- * \brief TgCharacterPositions::getCharacterIndex
+ * \brief TgCharacterPositions::generateLayoutCharacters
  *
- * get chraracter index from newInfo's m_listCharacter
+ * looks up glyph widths and kerning of the characters by using glyph cache
+ * data, kerning of the character is to the previous character that has glyph
  *
- * \param newInfo [in] info
- * \param character character
- * \return character index to find from newInfo->m_listCharacter
+ * \param listFontInfo [in] font info of each character
+ * \param listCharacter [in] characters
+ * \param listLayoutCharacter [out] layout values of each character
  */
-size_t TgCharacterPositions::getCharacterIndex(const TgFontInfoData *newInfo, uint32_t character)
+void TgCharacterPositions::generateLayoutCharacters(const std::vector<TgFontInfoData *> &listFontInfo,
+                                                    const std::vector<TgFontTextCharacterInfo> &listCharacter,
+                                                    std::vector<TgFontTextLayoutCharacter> &listLayoutCharacter)
 {
-    for (size_t i=0;i<newInfo->m_listCharacter.size();i++) {
-        if (newInfo->m_listCharacter.at(i) == character) {
-            return i;
+    size_t i, c = listCharacter.size();
+    const TgFontTextCharacterInfo *characterInfo;
+    const TgFontTextCharacterInfo *leftCharacterInfo = nullptr;
+    const TgFontInfoData *fontInfo;
+    const prj_ttf_reader_glyph_data_t *glyph;
+    const prj_ttf_reader_glyph_data_t *left_glyph = nullptr;
+    int32_t left_advance_x, left_bearing, right_bearing;
+
+    listLayoutCharacter.assign(c, TgFontTextLayoutCharacter());
+    for (i=0;i<c;i++) {
+        TgFontTextLayoutCharacter &layoutCharacter = listLayoutCharacter[i];
+        characterInfo = &listCharacter[i];
+        layoutCharacter.m_breakOpportunity = TgFontTextLayout::isBreakOpportunity(characterInfo->m_character);
+        if (characterInfo->m_character == '\n' || characterInfo->m_fontFileNameIndex == -1) {
+            continue;
         }
+        fontInfo = i < listFontInfo.size() ? listFontInfo[i] : nullptr;
+        if (!fontInfo) {
+            continue;
+        }
+        glyph = TgFontGlyphDiskCache::getCharacterGlyphData(characterInfo->m_character, fontInfo->m_data, fontInfo->m_diskData);
+        if (!glyph) {
+            continue;
+        }
+
+        if (left_glyph) {
+            left_advance_x = static_cast<int32_t>(left_glyph->image_pixel_advance_x + 0.5f);
+            left_bearing = static_cast<int32_t>(left_glyph->image_pixel_bearing);
+            if (left_glyph->image_pixel_bearing < 0 && left_glyph->image_pixel_bearing > -1) {
+                left_bearing = -1;
+            }
+            left_advance_x -= left_bearing;
+            left_advance_x -= left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x;
+            right_bearing = static_cast<int32_t>(glyph->image_pixel_bearing);
+            if (glyph->image_pixel_bearing < 0 && glyph->image_pixel_bearing > -1) {
+                right_bearing = -1;
+            }
+            layoutCharacter.m_kerning = TgFontGlyphDiskCache::getKerning(leftCharacterInfo->m_character, characterInfo->m_character, fontInfo->m_data, fontInfo->m_diskData)
+                                        + static_cast<float>(right_bearing + left_advance_x);
+        }
+        layoutCharacter.m_width = static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x);
+        layoutCharacter.m_glyph = true;
+
+        left_glyph = glyph;
+        leftCharacterInfo = characterInfo;
     }
-    return 0;
 }
 
 /*!
@@ -430,15 +456,15 @@ size_t TgCharacterPositions::getCharacterIndex(const TgFontInfoData *newInfo, ui
  *
  * \param lineNumber [in] current line number, 1 == first line
  * \param positionLeftX [in] current glyph's left x
- * \param glyph [in] current glyph
+ * \param glyphWidth [in] current glyph's width
  * \param maxLineCount max line count
  * \param maxLineWidth max line width
  * \return true - if glyph position goes over the line
  */
-bool TgCharacterPositions::isOverTheLine(const uint32_t lineNumber, const float positionLeftX, const prj_ttf_reader_glyph_data_t *glyph,
+bool TgCharacterPositions::isOverTheLine(const uint32_t lineNumber, const float positionLeftX, const float glyphWidth,
                                          const uint32_t maxLineCount, const float maxLineWidth)
 {
-    if (positionLeftX + static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x) < maxLineWidth) {
+    if (positionLeftX + glyphWidth < maxLineWidth) {
         return false;
     }
 
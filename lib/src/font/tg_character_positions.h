@@ -18,6 +18,7 @@
 #include <prj-ttf-reader.h>
 #include "../item2d/tg_textfield.h"
 #include "tg_font_text.h"
+#include "tg_font_text_layout.h"
 
 struct TgFontInfo;
 class TgFontText;
@@ -28,16 +29,18 @@ class TgCharacterPositions
 public:
     explicit TgCharacterPositions();
     ~TgCharacterPositions();
-    static bool generateTextCharacterPositioning(TgFontText *fontText, const uint32_t maxLineCount, const float maxLineWidth, const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine);
+    static bool generateTextCharacterPositioning(TgFontText *fontText, const uint32_t maxLineCount, const float maxLineWidth, const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine,
+                                                 const size_t startCharacterIndex = 0);
     static bool calculateTextWidthHeight(std::vector<TgFontInfoData *> &listFontInfo,
                                                             std::vector<TgFontTextCharacterInfo> &listCharacter,
                                                             const uint32_t maxLineCount, const float maxLineWidth,
                                                             const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine,
                                                             float &mostTextWidth, float &mostTextHeight, float &allDrawTextHeight);
 private:
-    static size_t getCharacterIndex(const TgFontInfo *newInfo, uint32_t character);
-    static size_t getCharacterIndex(const TgFontInfoData *newInfo, uint32_t character);
-    static bool isOverTheLine(const uint32_t lineNumber, const float positionLeftX, const prj_ttf_reader_glyph_data_t *glyph, const uint32_t maxLineCount, const float maxLineWidth);
+    static void generateLayoutCharacters(const std::vector<TgFontInfoData *> &listFontInfo,
+                                         const std::vector<TgFontTextCharacterInfo> &listCharacter,
+                                         std::vector<TgFontTextLayoutCharacter> &listLayoutCharacter);
+    static bool isOverTheLine(const uint32_t lineNumber, const float positionLeftX, const float glyphWidth, const uint32_t maxLineCount, const float maxLineWidth);
 };
 
 #endif // TG_CHARACTER_POSITIONS_H
@@ -11,30 +11,52 @@
 
 #include "tg_font_default.h"
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include "../global/tg_global_application.h"
+#include "../global/tg_global_log.h"
+#include "../global/private/tg_global_thread_pool.h"
+#include "../global/private/tg_global_wait_renderer.h"
+#include "cache/tg_font_characters_cache.h"
+#include "cache/tg_font_glyph_cache.h"
+#include "cache/tg_font_glyph_cache_data.h"
 
 #ifndef TG_FONT_DEFAULT_FILENAME
 #define TG_FONT_DEFAULT_FILENAME "/usr/share/fonts/truetype/freefont/FreeSans.ttf"
 #endif
 
-TgFontDefault::TgFontDefault()
+TgFontDefault::TgFontDefault() :
+    m_fontList(std::make_shared<const TgFontList>())
 {
     setDefaultFont(TG_FONT_DEFAULT_FILENAME);
 }
 
+TgFontDefault::~TgFontDefault()
+{
+    size_t i;
+    std::atomic_store(&m_fontList, std::shared_ptr<const TgFontList>());
+    for (i=0;i<m_listFontEntry.size();i++) {
+        delete m_listFontEntry[i];
+    }
+    m_listFontEntry.clear();
+}
+
 /*!
  * \brief TgFontDefault::getDefaultFont
  *
  * get font default (full filepath name)
  *
- * \return font default (full filepath)
+ * \return font default (full filepath), it's valid as long as TgFontDefault is
  */
-std::string TgFontDefault::getDefaultFont()
+const std::string &TgFontDefault::getDefaultFont()
 {
-    if (m_defaultFont.empty()) {
-        return TG_FONT_DEFAULT_FILENAME;
+    static const std::string defaultFont = TG_FONT_DEFAULT_FILENAME;
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    if (fontList->m_listFont.empty()) {
+        return defaultFont;
     }
-    return m_defaultFont;
+    // font entries are not deleted when font list is changed
+    return fontList->m_listFont[0]->m_fontFile;
 }
 
 /*!
@@ -56,27 +78,122 @@ void TgFontDefault::setDefaultFont(std::string fullFilePathFont)
  */
 size_t TgFontDefault::getFontCount()
 {
-    size_t ret;
-    m_fontMutex.lock();
-    ret = m_listFont.size();
-    m_fontMutex.unlock();
-    return ret;
+    return getFontList()->m_listFont.size();
 }
 
 /*!
- * \brief TgFontDefault::getListFont
+ * \brief TgFontDefault::getFontList
+ *
+ * get current snapshot of the font list, snapshot is never
+ * changed, so it can be used without locking
+ *
+ * \return list of fonts that application support
+ */
+std::shared_ptr<const TgFontList> TgFontDefault::getFontList() const
+{
+    return std::atomic_load(&m_fontList);
+}
+
+/*!
+ * \brief TgFontDefault::getFontEntry
+ *
+ * get interned font, font is searched from the font list
+ * snapshot, so this locks only when the font is interned first time
  *
- * \return get list of fonts that application support
+ * \param fullFilePathFont font (full filepath), empty == default font
+ * \return font entry, added if it was not interned yet
  */
-std::vector<std::string> TgFontDefault::getListFont()
+TgFontEntry *TgFontDefault::getFontEntry(const std::string &fullFilePathFont)
 {
-    std::vector<std::string> ret;
+    const std::string &font = fullFilePathFont.empty() ? getDefaultFont() : fullFilePathFont;
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    std::unordered_map<std::string, TgFontEntry *>::const_iterator it = fontList->m_listFontEntryByFile.find(font);
+    if (it != fontList->m_listFontEntryByFile.end()) {
+        return it->second;
+    }
     m_fontMutex.lock();
-    ret = m_listFont;
+    TgFontEntry *ret = getFontEntryWithoutLock(font);
     m_fontMutex.unlock();
     return ret;
 }
 
+/*!
+ * \brief TgFontDefault::getFontEntryWithoutLock
+ *
+ * get interned font, m_fontMutex must be locked before calling this
+ *
+ * \param fullFilePathFont font (full filepath)
+ * \return font entry, added if it was not interned yet
+ */
+TgFontEntry *TgFontDefault::getFontEntryWithoutLock(const std::string &fullFilePathFont)
+{
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    std::unordered_map<std::string, TgFontEntry *>::const_iterator it = fontList->m_listFontEntryByFile.find(fullFilePathFont);
+    if (it != fontList->m_listFontEntryByFile.end()) {
+        return it->second;
+    }
+    TgFontEntry *entry = new TgFontEntry;
+    entry->m_fontFile = fullFilePathFont;
+    entry->m_id = static_cast<uint32_t>(m_listFontEntry.size());
+    m_listFontEntry.push_back(entry);
+
+    // new snapshot with same font list, so new font can be found without lock
+    std::shared_ptr<TgFontList> newFontList = std::make_shared<TgFontList>(*fontList);
+    newFontList->m_listFontEntry.push_back(entry);
+    newFontList->m_listFontEntryByFile[fullFilePathFont] = entry;
+    std::atomic_store(&m_fontList, std::shared_ptr<const TgFontList>(std::move(newFontList)));
+    return entry;
+}
+
+/*!
+ * \brief TgFontDefault::getFontId
+ *
+ * get id of the font, id is same as long as TgFontDefault exists,
+ * so caches can compare font ids instead of font file names
+ *
+ * \param fullFilePathFont font (full filepath), empty == default font
+ * \return font id
+ */
+uint32_t TgFontDefault::getFontId(const std::string &fullFilePathFont)
+{
+    return getFontEntry(fullFilePathFont)->m_id;
+}
+
+/*!
+ * \brief TgFontDefault::getFontCharacters
+ *
+ * get supported characters of the font, characters are read
+ * when they are needed first time
+ *
+ * \param fontId font id (getFontId())
+ * \return characters of the font, nullptr if font id is invalid or
+ * characters could not be read from the font
+ */
+const TgFontCharacterCache *TgFontDefault::getFontCharacters(uint32_t fontId)
+{
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    if (fontId >= fontList->m_listFontEntry.size()) {
+        return nullptr;
+    }
+    return addFontCharacters(fontList->m_listFontEntry[fontId]);
+}
+
+/*!
+ * \brief TgFontDefault::addFontCharacters
+ *
+ * adds font's characters into TgFontCharactersCache, if they are not added yet
+ *
+ * \param entry font
+ * \return characters of the font, nullptr if characters could not be read
+ */
+const TgFontCharacterCache *TgFontDefault::addFontCharacters(TgFontEntry *entry)
+{
+    if (!entry->m_charactersAdded.load(std::memory_order_acquire)) {
+        entry->m_characters.store(TgGlobalApplication::getInstance()->getFontCharactersCache()->addFont(entry->m_fontFile), std::memory_order_release);
+        entry->m_charactersAdded.store(true, std::memory_order_release);
+    }
+    return entry->m_characters.load(std::memory_order_acquire);
+}
 
 /*!
  * \brief TgFontDefault::setFont
@@ -93,48 +210,57 @@ size_t TgFontDefault::setFont(const std::string &fullFilePathFont, size_t positi
 {
     size_t i, ret;
     m_fontMutex.lock();
-    for (i=0;i<m_listFont.size();i++) {
-        if (m_listFont.at(i) == fullFilePathFont) {
-            if (i==position) {
-                m_fontMutex.unlock();
-                return i;
-            }
-            if (m_listFont.size() > position) {
-                movePosition(m_listFont, i, position);
-                if (position == 0) {
-                    m_defaultFont = fullFilePathFont;
-                }
-                m_fontMutex.unlock();
-                return position;
-            }
-            if (m_listFont.size()-1 != i) {
-                movePosition(m_listFont, i, m_listFont.size()-1);
-            }
-            if (m_listFont.size() == 1) {
-                m_defaultFont = fullFilePathFont;
-            }
-            ret = m_listFont.size()-1;
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    std::vector<TgFontEntry *> listFont = fontList->m_listFont;
+    std::vector<TgFontEntry *> listMainFont;
+    TgFontEntry *entry = getFontEntryWithoutLock(fullFilePathFont);
+    for (i=0;i<fontList->m_listChain.size();i++) {
+        listMainFont.push_back(fontList->m_listChain[i]->m_listFont[0]);
+    }
+
+    i = static_cast<size_t>(std::find(listFont.begin(), listFont.end(), entry) - listFont.begin());
+    if (i < listFont.size()) {
+        if (i == position) {
             m_fontMutex.unlock();
-            return ret;
+            return i;
         }
+        ret = listFont.size() > position ? position : listFont.size()-1;
+        movePosition(listFont, i, ret);
+    } else if (listFont.size() > position) {
+        listFont.insert(listFont.begin()+static_cast<int64_t>(position), entry);
+        ret = position;
+    } else {
+        listFont.push_back(entry);
+        ret = listFont.size()-1;
     }
-    if (m_listFont.size() > position) {
-        m_listFont.insert(m_listFont.begin()+position, fullFilePathFont);
-        if (position == 0) {
-            m_defaultFont = fullFilePathFont;
-        }
-        m_fontMutex.unlock();
-        return position;
-    }
-    m_listFont.push_back(fullFilePathFont);
-    if (m_listFont.size() == 1) {
-        m_defaultFont = fullFilePathFont;
-    }
-    ret = m_listFont.size()-1;
+    setFontList(listFont, listMainFont);
     m_fontMutex.unlock();
     return ret;
 }
 
+/*!
+ * \brief TgFontDefault::setFontList
+ *
+ * sets new snapshot of the font list, m_fontMutex must be locked before calling this
+ *
+ * \param listFont list of fonts
+ * \param listMainFont main fonts that have font chain
+ */
+void TgFontDefault::setFontList(const std::vector<TgFontEntry *> &listFont, const std::vector<TgFontEntry *> &listMainFont)
+{
+    size_t i;
+    std::shared_ptr<const TgFontList> currentFontList = getFontList();
+    std::shared_ptr<TgFontList> fontList = std::make_shared<TgFontList>();
+    fontList->m_listFont = listFont;
+    fontList->m_listFontEntry = currentFontList->m_listFontEntry;
+    fontList->m_listFontEntryByFile = currentFontList->m_listFontEntryByFile;
+    for (i=0;i<listMainFont.size();i++) {
+        fontList->m_listChain.push_back(generateFontChain(listFont, listMainFont[i]));
+        fontList->m_listChainIndex[listMainFont[i]->m_fontFile] = i;
+    }
+    std::atomic_store(&m_fontList, std::shared_ptr<const TgFontList>(std::move(fontList)));
+}
+
 /*!
  * \brief TgItem2dPosition::movePosition
  *
@@ -143,7 +269,7 @@ size_t TgFontDefault::setFont(const std::string &fullFilePathFont, size_t positi
  * \param from from this index
  * \param to to this index
  */
-void TgFontDefault::movePosition(std::vector<std::string> &vec, size_t from, size_t to)
+void TgFontDefault::movePosition(std::vector<TgFontEntry *> &vec, size_t from, size_t to)
 {
     if (from == to) {
         return;
@@ -163,62 +289,203 @@ void TgFontDefault::movePosition(std::vector<std::string> &vec, size_t from, siz
  */
 std::string TgFontDefault::getFont(size_t i)
 {
-    m_fontMutex.lock();
-    if (i >= m_listFont.size()) {
-        m_fontMutex.unlock();
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    if (i >= fontList->m_listFont.size()) {
         return "";
     }
-    std::string ret = m_listFont.at(i);
-    m_fontMutex.unlock();
-    return ret;
+    return fontList->m_listFont[i]->m_fontFile;
 }
 
 /*!
- * \brief TgFontDefault::getFontFiles
+ * \brief TgFontDefault::preload
  *
- * get list of font files
+ * preloads glyphs of the font in the background (worker pool), so
+ * texts using these sizes and characters do not need to rasterize glyphs
+ * when they are shown first time. Preloaded glyphs are uploaded
+ * into OpenGL on next render of the main window
  *
- * \param mainFontFile [in]
- * \return list of font files, that main font is first
+ * \param fullFilePathFont full file path of the font
+ * \param listFontSize list of font sizes to preload
+ * \param listCharacterRange list of character (unicode) ranges (first, last) to preload
+ * \param progress called (from the worker thread) each time one font size is preloaded,
+ * preloading is completed when preloadedCount is totalCount, can be nullptr
  */
-std::vector<std::string> TgFontDefault::getFontFiles(const std::string &mainFontFile)
+void TgFontDefault::preload(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                            const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                            const std::function<void(size_t preloadedCount, size_t totalCount)> &progress)
 {
-    std::vector<std::string> listFontFiles = TgGlobalApplication::getInstance()->getFontDefault()->getListFont();
-    std::vector<std::string> ret;
-    TgFontDefault::getFontFileNames(mainFontFile, listFontFiles, ret);
-    return ret;
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::shared_ptr<std::atomic<size_t>> preloadedCount = std::make_shared<std::atomic<size_t>>(0);
+    std::shared_ptr<std::mutex> progressMutex = std::make_shared<std::mutex>();
+    size_t totalCount = listFontSize.size();
+    if (!totalCount) {
+        if (progress) {
+            progress(0, 0);
+        }
+        TG_FUNCTION_END();
+        return;
+    }
+
+    for (i=0;i<totalCount;i++) {
+        float fontSize = listFontSize[i];
+        TgGlobalApplication::getInstance()->getThreadPool()->addJob([fullFilePathFont, fontSize, listCharacterRange, progress,
+                                                                     preloadedCount, progressMutex, totalCount]() {
+            preloadFontSize(fullFilePathFont, fontSize, listCharacterRange);
+            progressMutex->lock();
+            size_t count = ++(*preloadedCount);
+            if (progress) {
+                progress(count, totalCount);
+            }
+            progressMutex->unlock();
+            TgGlobalWaitRenderer::getInstance()->release();
+        });
+    }
+    TG_FUNCTION_END();
 }
 
 /*!
- * \brief TgFontDefault::getFontFileNames
+ * \brief TgFontDefault::preloadFontSize
  *
- * sets and re-generates the font list, sets main font file
- * as first font file on the list
+ * preloads glyphs of one font size, this is called from the worker thread
  *
- * \param mainFontFile [in]
- * \param listFontFiles [in] sets mainFontFile as first to this list
- * \param listFontFileNamesOut [out] sets mainFontFile as first to this list
+ * \param fullFilePathFont full file path of the font
+ * \param fontSize font size
+ * \param listCharacterRange list of character (unicode) ranges (first, last) to preload
  */
-void TgFontDefault::getFontFileNames(const std::string &mainFontFile, const std::vector<std::string> &listFontFileNames,
-                                  std::vector<std::string> &listFontFileNamesOut)
+void TgFontDefault::preloadFontSize(const std::string &fullFilePathFont, float fontSize,
+                                    const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange)
 {
-    std::vector<std::string>::iterator it;
-    listFontFileNamesOut = std::move(listFontFileNames);
-    if (mainFontFile.empty()
-        || (!listFontFileNamesOut.empty() && listFontFileNamesOut.at(0) == mainFontFile)) {
-        for (it=listFontFileNamesOut.begin();it!=listFontFileNamesOut.end();it++) {
-            TgGlobalApplication::getInstance()->getFontCharactersCache()->addFont(*it);
-        }
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<uint32_t> listCharacters, listRangeCharacters;
+    std::vector<TgFontGlyphCacheRequest> listRequest(1);
+    std::vector<TgFontInfoData *> listData;
+    std::vector<TgFontInfo *> listInfo;
+    TgFontDefault *fontDefault = TgGlobalApplication::getInstance()->getFontDefault();
+    uint32_t fontId = fontDefault->getFontId(fullFilePathFont);
+    const TgFontCharacterCache *fontCharacters = fontDefault->getFontCharacters(fontId);
+
+    if (!fontCharacters) {
+        TG_WARNING_LOG("Failed to preload font: ", fullFilePathFont);
+        TG_FUNCTION_END();
         return;
     }
+    for (i=0;i<listCharacterRange.size();i++) {
+        listRangeCharacters = TgFontCharactersCache::getCharactersForFont(fontCharacters, listCharacterRange[i].first, listCharacterRange[i].second);
+        listCharacters.insert(listCharacters.end(), listRangeCharacters.begin(), listRangeCharacters.end());
+    }
+    std::sort(listCharacters.begin(), listCharacters.end());
+    listCharacters.erase(std::unique(listCharacters.begin(), listCharacters.end()), listCharacters.end());
+
+    // glyph data for text size calculation (this also stores glyphs to disk cache)
+    listRequest[0].m_listCharacters = listCharacters;
+    listRequest[0].m_fontFile = fullFilePathFont;
+    listRequest[0].m_fontId = fontId;
+    listData = TgGlobalApplication::getInstance()->getFontGlyphCacheData()->generateCacheForTexts(listRequest, fontSize);
+    TgGlobalApplication::getInstance()->getFontGlyphCacheData()->addCache(listData[0]);
+
+    // glyph textures and vertices for rendering, uploaded on the render thread
+    listRequest[0] = TgFontGlyphCacheRequest();
+    listRequest[0].m_listCharacters = listCharacters;
+    listRequest[0].m_fontFile = fullFilePathFont;
+    listRequest[0].m_fontId = fontId;
+    listInfo = TgGlobalApplication::getInstance()->getFontGlyphCache()->prepareCacheForTexts(listRequest, fontSize);
+    if (listInfo[0] && listInfo[0]->m_uploadPending) {
+        TgGlobalApplication::getInstance()->getFontGlyphCache()->addPreparedCache(listInfo[0]);
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgFontDefault::getFontChain
+ *
+ * get font chain of the main font, chain is generated only when
+ * main font is used first time (or font list is changed), so usually
+ * this does not lock or allocate
+ *
+ * \param mainFontFile [in] main font, empty == default font
+ * \return font chain, main font is first
+ */
+std::shared_ptr<const TgFontChain> TgFontDefault::getFontChain(const std::string &mainFontFile)
+{
+    size_t i;
+    const std::string &mainFont = mainFontFile.empty() ? getDefaultFont() : mainFontFile;
+    std::shared_ptr<const TgFontList> fontList = getFontList();
+    std::shared_ptr<const TgFontChain> ret = findFontChain(fontList.get(), mainFont);
+    if (!ret) {
+        m_fontMutex.lock();
+        fontList = getFontList();
+        ret = findFontChain(fontList.get(), mainFont);
+        if (!ret) {
+            std::vector<TgFontEntry *> listMainFont;
+            for (i=0;i<fontList->m_listChain.size();i++) {
+                listMainFont.push_back(fontList->m_listChain[i]->m_listFont[0]);
+            }
+            listMainFont.push_back(getFontEntryWithoutLock(mainFont));
+            setFontList(fontList->m_listFont, listMainFont);
+            ret = getFontList()->m_listChain.back();
+        }
+        m_fontMutex.unlock();
+    }
 
+    // font's characters are read when the font is used first time
+    for (i=0;i<ret->m_listFont.size();i++) {
+        addFontCharacters(ret->m_listFont[i]);
+    }
+    return ret;
+}
 
-    for (it=listFontFileNamesOut.begin();it!=listFontFileNamesOut.end();it++) {
-        if ((*it) == mainFontFile) {
-            listFontFileNamesOut.erase(it);
+/*!
+ * \brief TgFontDefault::findFontChain
+ *
+ * \param fontList [in] font list snapshot
+ * \param mainFontFile [in] main font
+ * \return font chain of the main font, or nullptr if it's not generated yet
+ */
+std::shared_ptr<const TgFontChain> TgFontDefault::findFontChain(const TgFontList *fontList, const std::string &mainFontFile)
+{
+    std::unordered_map<std::string, size_t>::const_iterator it = fontList->m_listChainIndex.find(mainFontFile);
+    if (it == fontList->m_listChainIndex.end()) {
+        return nullptr;
+    }
+    return fontList->m_listChain[it->second];
+}
+
+/*!
+ * \brief TgFontDefault::generateFontChain
+ *
+ * \param listFont [in] list of fonts
+ * \param mainFont [in] main font
+ * \return font chain, main font first and then rest of listFont
+ */
+std::shared_ptr<const TgFontChain> TgFontDefault::generateFontChain(const std::vector<TgFontEntry *> &listFont, TgFontEntry *mainFont)
+{
+    size_t i;
+    std::shared_ptr<TgFontChain> ret = std::make_shared<TgFontChain>();
+    ret->m_mainFont = mainFont;
+    ret->m_listFont.push_back(mainFont);
+    for (i=0;i<listFont.size();i++) {
+        if (listFont[i] != mainFont) {
+            ret->m_listFont.push_back(listFont[i]);
         }
-        TgGlobalApplication::getInstance()->getFontCharactersCache()->addFont(*it);
     }
+    for (i=0;i<ret->m_listFont.size();i++) {
+        ret->m_listFontFile.push_back(ret->m_listFont[i]->m_fontFile);
+        ret->m_listFontId.push_back(ret->m_listFont[i]->m_id);
+    }
+    return ret;
+}
 
-    listFontFileNamesOut.insert(listFontFileNamesOut.begin(), mainFontFile);
-}
\ No newline at end of file
+/*!
+ * \brief TgFontDefault::getMainFontChain
+ *
+ * get font chain of the main font from the application's TgFontDefault
+ *
+ * \param mainFontFile [in] main font, empty == default font
+ * \return font chain, main font is first
+ */
+std::shared_ptr<const TgFontChain> TgFontDefault::getMainFontChain(const std::string &mainFontFile)
+{
+    return TgGlobalApplication::getInstance()->getFontDefault()->getFontChain(mainFontFile);
+}
@@ -15,30 +15,90 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
 #include <prj-ttf-reader.h>
 
+struct TgFontCharacterCache;
+
+/*!
+ * \brief TgFontEntry
+ * interned font, font entries are never removed (or changed)
+ * before TgFontDefault is destroyed
+ */
+struct TgFontEntry
+{
+    std::string m_fontFile;
+    uint32_t m_id;                                  /*!< font id, index of TgFontList::m_listFontEntry */
+    std::atomic<bool> m_charactersAdded { false };  /*!< font is added into TgFontCharactersCache */
+    std::atomic<const TgFontCharacterCache *> m_characters { nullptr };   /*!< characters of the font, nullptr if not added */
+};
+
+/*!
+ * \brief TgFontChain
+ * list of font files for texts using this main font,
+ * main font is first and rest of fonts are fallback fonts
+ */
+struct TgFontChain
+{
+    const TgFontEntry *m_mainFont;
+    std::vector<TgFontEntry *>m_listFont;
+    std::vector<std::string>m_listFontFile;         /*!< file names of m_listFont */
+    std::vector<uint32_t>m_listFontId;              /*!< font ids of m_listFont */
+};
+
+/*!
+ * \brief TgFontList
+ * immutable snapshot of the font list, new snapshot
+ * is (atomically) set each time the list is changed
+ */
+struct TgFontList
+{
+    std::vector<TgFontEntry *>m_listFont;           /*!< first one is default font */
+    std::vector<std::shared_ptr<const TgFontChain>>m_listChain;
+    std::unordered_map<std::string, size_t>m_listChainIndex;   /*!< main font file -> index of m_listChain */
+    std::vector<TgFontEntry *>m_listFontEntry;      /*!< all interned fonts, font id is the index */
+    std::unordered_map<std::string, TgFontEntry *>m_listFontEntryByFile;
+};
+
 class TgFontDefault
 {
 public:
     TgFontDefault();
-    std::string getDefaultFont();
+    ~TgFontDefault();
+    const std::string &getDefaultFont();
     void setDefaultFont(std::string fullFilePathFont);
 
     size_t getFontCount();
     size_t setFont(const std::string &fullFilePathFont, size_t position = UINT64_MAX);
     std::string getFont(size_t i);
-    std::vector<std::string> getListFont();
+    std::shared_ptr<const TgFontList> getFontList() const;
+    std::shared_ptr<const TgFontChain> getFontChain(const std::string &mainFontFile);
+    uint32_t getFontId(const std::string &fullFilePathFont);
+    const TgFontCharacterCache *getFontCharacters(uint32_t fontId);
 
-    static std::vector<std::string> getFontFiles(const std::string &mainFontFile);
-    static void getFontFileNames(const std::string &mainFontFile, const std::vector<std::string> &listFontFileNames,
-                                  std::vector<std::string> &listFontFileNamesOut);
-private:
-    std::string m_defaultFont;
-    std::mutex m_fontMutex;
+    void preload(const std::string &fullFilePathFont, const std::vector<float> &listFontSize,
+                 const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange,
+                 const std::function<void(size_t preloadedCount, size_t totalCount)> &progress);
 
-    std::vector<std::string>m_listFont;
+    static std::shared_ptr<const TgFontChain> getMainFontChain(const std::string &mainFontFile);
+private:
+    std::mutex m_fontMutex;                         /*!< only for changing the font list */
+    std::vector<TgFontEntry *>m_listFontEntry;      /*!< interned fonts, owned by this */
+    std::shared_ptr<const TgFontList>m_fontList;    /*!< use only with std::atomic_load/std::atomic_store */
 
-    static void movePosition(std::vector<std::string> &vec, size_t from, size_t to);
+    TgFontEntry *getFontEntry(const std::string &fullFilePathFont);
+    TgFontEntry *getFontEntryWithoutLock(const std::string &fullFilePathFont);
+    void setFontList(const std::vector<TgFontEntry *> &listFont, const std::vector<TgFontEntry *> &listMainFont);
+    static std::shared_ptr<const TgFontChain> findFontChain(const TgFontList *fontList, const std::string &mainFontFile);
+    static std::shared_ptr<const TgFontChain> generateFontChain(const std::vector<TgFontEntry *> &listFont, TgFontEntry *mainFont);
+    static void movePosition(std::vector<TgFontEntry *> &vec, size_t from, size_t to);
+    static const TgFontCharacterCache *addFontCharacters(TgFontEntry *entry);
+    static void preloadFontSize(const std::string &fullFilePathFont, float fontSize,
+                                const std::vector<std::pair<uint32_t, uint32_t>> &listCharacterRange);
 };
 
 #endif // TG_FONT_DEFAULT_H
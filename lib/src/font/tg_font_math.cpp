@@ -15,6 +15,11 @@
 #include "tg_font_text.h"
 #include "tg_font_text_generator.h"
 #include "../global/tg_global_log.h"
+#include "../global/private/tg_global_thread_pool.h"
+#include "tg_font_default.h"
+#include "tg_character_positions.h"
+#include <cstring>
+#include <algorithm>
 
 /*!
  * \brief TgFontMath::getFontWidthHeight
@@ -70,14 +75,14 @@ bool TgFontMath::getFontWidthHeightCacheWithoutRender(const std::vector<TgTextFi
         return true;
     }
 
-    std::vector<std::string> listFontFiles = TgFontDefault::getFontFiles(mainFontFile);
-    std::vector<TgFontTextCharacterInfo> listCharacter = TgFontTextGenerator::generateCharacterList(listText, listFontFiles);
+    std::shared_ptr<const TgFontChain> fontChain = TgFontDefault::getMainFontChain(mainFontFile);
+    std::vector<TgFontTextCharacterInfo> listCharacter = TgFontTextGenerator::generateCharacterList(listText, *fontChain);
     if (listCharacter.empty()) {
         return true;
     }
 
     std::vector<TgFontInfoData *> listFontInfo;
-    TgFontText::generateFontTextInfoGlyphsData(fontSize, listCharacter, listFontInfo, listFontFiles);
+    TgFontText::generateFontTextInfoGlyphsData(fontSize, listCharacter, listFontInfo, *fontChain);
 
     if (TgCharacterPositions::calculateTextWidthHeight(listFontInfo, listCharacter, maxLineCount, maxLineWidth, wordWrap, allowBreakLineGoOverMaxLine, textWidth, textHeight, allDrawTextHeight)) {
         for (size_t i=0;i<listFontInfo.size();i++) {
@@ -86,3 +91,163 @@ bool TgFontMath::getFontWidthHeightCacheWithoutRender(const std::vector<TgTextFi
     }
     return true;
 }
+
+/*!
+ * \brief TgFontMath::measureTexts
+ *
+ * measures several texts without OpenGL, this is thread safe
+ *
+ * 1. character lists of the texts are generated in parallel
+ * 2. glyphs of all texts using same fonts and font size are generated once
+ * 3. texts are measured in parallel by using glyph cache data
+ *
+ * \param listRequest list of texts to measure
+ * \return result for each request (same index)
+ */
+std::vector<TgTextMeasureResult> TgFontMath::measureTexts(const std::vector<TgTextMeasureRequest> &listRequest)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<TgTextMeasureResult> ret(listRequest.size());
+    std::vector<std::string> listMainFontFile;
+    std::vector<std::shared_ptr<const TgFontChain>> listFontChain;
+    std::vector<size_t> listFontChainIndex(listRequest.size());
+    std::vector<std::vector<TgFontTextCharacterInfo>> listCharacter(listRequest.size());
+
+    // font chain is resolved once for each main font
+    for (i=0;i<listRequest.size();i++) {
+        std::vector<std::string>::iterator it = std::find(listMainFontFile.begin(), listMainFontFile.end(), listRequest[i].m_fontFile);
+        listFontChainIndex[i] = static_cast<size_t>(it - listMainFontFile.begin());
+        if (it == listMainFontFile.end()) {
+            listMainFontFile.push_back(listRequest[i].m_fontFile);
+            listFontChain.push_back(TgFontDefault::getMainFontChain(listRequest[i].m_fontFile));
+        }
+    }
+
+    runInParallel(listRequest.size(), [&](size_t index) {
+        if (listRequest[index].m_text.empty()) {
+            ret[index].m_valid = true;
+            return;
+        }
+        std::vector<TgTextFieldText> listText(1);
+        listText[0].m_text = listRequest[index].m_text;
+        listCharacter[index] = TgFontTextGenerator::generateCharacterList(listText, *listFontChain[listFontChainIndex[index]]);
+    });
+
+    generateGlyphsForMeasure(listRequest, listFontChainIndex, listFontChain, listCharacter);
+
+    runInParallel(listRequest.size(), [&](size_t index) {
+        size_t i2;
+        if (listCharacter[index].empty()) {
+            return;
+        }
+        std::vector<TgFontInfoData *> listFontInfo;
+        TgFontText::generateFontTextInfoGlyphsData(listRequest[index].m_fontSize, listCharacter[index], listFontInfo,
+                                                   *listFontChain[listFontChainIndex[index]]);
+        if (!TgCharacterPositions::calculateTextWidthHeight(listFontInfo, listCharacter[index], listRequest[index].m_maxLineCount,
+                                                            listRequest[index].m_maxLineWidth, listRequest[index].m_wordWrap,
+                                                            listRequest[index].m_allowBreakLineGoOverMaxLine, ret[index].m_textWidth,
+                                                            ret[index].m_textHeight, ret[index].m_allDrawTextHeight)) {
+            return;
+        }
+        for (i2=0;i2<listFontInfo.size();i2++) {
+            TgGlobalApplication::getInstance()->getFontGlyphCacheData()->addCache(listFontInfo[i2]);
+        }
+        for (i2=0;i2<listCharacter[index].size();i2++) {
+            if (listCharacter[index][i2].m_draw && ret[index].m_lineCount <= listCharacter[index][i2].m_lineNumber) {
+                ret[index].m_lineCount = listCharacter[index][i2].m_lineNumber + 1;
+            }
+        }
+        ret[index].m_valid = true;
+    });
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgFontMath::generateGlyphsForMeasure
+ *
+ * generates glyph cache once for all characters of texts that are using
+ * same fonts and font size, so parallel measuring of the texts only
+ * uses the cache and same glyphs are not rasterized several times
+ *
+ * \param listRequest [in] list of texts to measure
+ * \param listFontChainIndex [in] index of listFontChain for each request
+ * \param listFontChain [in] font chains
+ * \param listCharacter [in] characters of each request
+ */
+void TgFontMath::generateGlyphsForMeasure(const std::vector<TgTextMeasureRequest> &listRequest, const std::vector<size_t> &listFontChainIndex,
+                                          std::vector<std::shared_ptr<const TgFontChain>> &listFontChain,
+                                          std::vector<std::vector<TgFontTextCharacterInfo>> &listCharacter)
+{
+    size_t i, i2, i3;
+    std::vector<bool> listHandled(listRequest.size(), false);
+    for (i=0;i<listRequest.size();i++) {
+        if (listHandled[i] || listCharacter[i].empty()) {
+            continue;
+        }
+        std::vector<TgFontTextCharacterInfo> listUniqueCharacter;
+        for (i2=i;i2<listRequest.size();i2++) {
+            if (listHandled[i2]
+                || listFontChainIndex[i2] != listFontChainIndex[i]
+                || std::memcmp(&listRequest[i2].m_fontSize, &listRequest[i].m_fontSize, sizeof(float)) != 0) {
+                continue;
+            }
+            listHandled[i2] = true;
+            for (i3=0;i3<listCharacter[i2].size();i3++) {
+                const TgFontTextCharacterInfo &info = listCharacter[i2][i3];
+                if (info.m_fontFileNameIndex == -1
+                    || std::find_if(listUniqueCharacter.begin(), listUniqueCharacter.end(), [&info](const TgFontTextCharacterInfo &unique) {
+                        return unique.m_character == info.m_character && unique.m_fontFileNameIndex == info.m_fontFileNameIndex;
+                    }) != listUniqueCharacter.end()) {
+                    continue;
+                }
+                listUniqueCharacter.push_back(info);
+            }
+        }
+        if (listUniqueCharacter.empty()) {
+            continue;
+        }
+        std::vector<TgFontInfoData *> listFontInfo;
+        TgFontText::generateFontTextInfoGlyphsData(listRequest[i].m_fontSize, listUniqueCharacter, listFontInfo,
+                                                   *listFontChain[listFontChainIndex[i]]);
+        for (i2=0;i2<listFontInfo.size();i2++) {
+            TgGlobalApplication::getInstance()->getFontGlyphCacheData()->addCache(listFontInfo[i2]);
+        }
+    }
+}
+
+/*!
+ * \brief TgFontMath::runInParallel
+ *
+ * splits indexes 0...count-1 into chunks and runs them in worker threads,
+ * calling thread runs the first chunk and returns when all are completed
+ *
+ * \param count number of indexes
+ * \param job called for each index
+ */
+void TgFontMath::runInParallel(size_t count, const std::function<void(size_t index)> &job)
+{
+    size_t i;
+    std::vector<std::future<void>> listJob;
+    TgGlobalThreadPool *threadPool = TgGlobalApplication::getInstance()->getThreadPool();
+    size_t chunkCount = std::min(count, threadPool->getThreadCount() + 1);
+    if (!chunkCount) {
+        return;
+    }
+    uint64_t jobGroup = threadPool->createJobGroup();
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    for (i=chunkSize;i<count;i+=chunkSize) {
+        size_t start = i;
+        size_t end = std::min(count, i + chunkSize);
+        listJob.push_back(threadPool->addJob([start, end, &job]() {
+            for (size_t index=start;index<end;index++) {
+                job(index);
+            }
+        }, jobGroup));
+    }
+    for (i=0;i<chunkSize;i++) {
+        job(i);
+    }
+    threadPool->waitJobs(listJob, jobGroup);
+}
@@ -14,7 +14,12 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <memory>
 #include "../item2d/tg_textfield.h"
+#include "../application/tg_application.h"
+struct TgFontTextCharacterInfo;
+struct TgFontChain;
 
 class TgFontMath
 {
@@ -26,7 +31,12 @@ public:
     static bool getFontWidthHeightCacheWithoutRender(const std::vector<TgTextFieldText> &listText, float fontSize, const std::string &mainFontFile,
                                   float &textWidth, float &textHeight, float &allDrawTextHeight, const uint32_t maxLineCount, const float maxLineWidth,
                                   const TgTextFieldWordWrap wordWrap, const bool allowBreakLineGoOverMaxLine);
+    static std::vector<TgTextMeasureResult> measureTexts(const std::vector<TgTextMeasureRequest> &listRequest);
 private:
+    static void generateGlyphsForMeasure(const std::vector<TgTextMeasureRequest> &listRequest, const std::vector<size_t> &listFontChainIndex,
+                                         std::vector<std::shared_ptr<const TgFontChain>> &listFontChain,
+                                         std::vector<std::vector<TgFontTextCharacterInfo>> &listCharacter);
+    static void runInParallel(size_t count, const std::function<void(size_t index)> &job);
 };
 
 #endif // TG_FONT_MATH_H
@@ -27,58 +27,53 @@ TgFontText::TgFontText() :
 
 }
 /*!
- * \brief TgFontText::setFontFileNames
+ * \brief TgFontText::setFontChain
  *
- * sets and re-generates the font list, sets main font file
- * as first font file on the list
+ * sets the font list, main font file is first font file on the list
  *
- * \param mainFontFile [in]
- * \param listFontFiles [in] sets mainFontFile as first to this list
+ * \param fontChain [in] font chain (TgFontDefault::getMainFontChain())
  */
-void TgFontText::setFontFileNames(const std::string &mainFontFile, const std::vector<std::string> &listFontFileNames)
+void TgFontText::setFontChain(const std::shared_ptr<const TgFontChain> &fontChain)
 {
-    TgFontDefault::getFontFileNames(mainFontFile, listFontFileNames, m_listFontFileNames);
+    m_fontChain = fontChain;
 }
 
 /*!
  * \brief TgFontText::addCharacter
  *
  * add character to list
- * setFontFileNames must be called first before this function
+ * setFontChain must be called first before this function
  *
  * \param character [in] character to add into m_listCharacter
  * \param r text red color
  * \param g text green color
  * \param b text blue color
+ * \param listFontCharacters [in] characters of the font files (TgFontCharactersCache::getFontCharacters())
  */
-void TgFontText::addCharacter(uint32_t character, uint8_t r, uint8_t g, uint8_t b)
+void TgFontText::addCharacter(uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<const TgFontCharacterCache *> &listFontCharacters)
 {
-    addCharacter(m_listCharacter, character, r, g, b, m_listFontFileNames);
+    addCharacter(m_listCharacter, character, r, g, b, listFontCharacters);
 }
 
 /*!
  * \brief TgFontText::addCharacter
  *
  * add character to list
- * setFontFileNames must be called first before this function
+ * setFontChain must be called first before this function
  *
  * \param listCharacter [in/out] fill character into list
  * \param character [in] character to add into m_listCharacter
  * \param r text red color
  * \param g text green color
  * \param b text blue color
+ * \param listFontCharacters [in] characters of the font files (TgFontCharactersCache::getFontCharacters())
  */
-void TgFontText::addCharacter(std::vector<TgFontTextCharacterInfo>&listCharacter, uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<std::string> &listFontFileNames)
+void TgFontText::addCharacter(std::vector<TgFontTextCharacterInfo>&listCharacter, uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<const TgFontCharacterCache *> &listFontCharacters)
 {
     TgFontTextCharacterInfo charInfo;
-    std::string fontFileName;
+    int previousFontIndex = listCharacter.empty() ? -1 : listCharacter.back().m_fontFileNameIndex;
 
-    if (!listCharacter.empty()
-        && listCharacter.back().m_fontFileNameIndex != -1) {
-        fontFileName = listFontFileNames.at( listCharacter.back().m_fontFileNameIndex );
-    }
-
-    charInfo.m_fontFileNameIndex = TgGlobalApplication::getInstance()->getFontCharactersCache()->getFontIndexForCharacter(character, fontFileName, listFontFileNames);
+    charInfo.m_fontFileNameIndex = TgFontCharactersCache::getFontIndexForCharacter(character, previousFontIndex, listFontCharacters);
     charInfo.m_character = character;
     charInfo.m_textColorR = r;
     charInfo.m_textColorG = g;
@@ -137,57 +132,159 @@ std::vector<uint32_t> TgFontText::getCharactersByFontFileNameIndex(int32_t fontF
  *
  * generates m_listFontInfo for this text
  * which font textures contains these glyphs in the text
+ * glyphs of different fonts are rasterized in parallel
  *
  * \param fontSize
  * \param onlyForCalculation if true, then this TgFontInfo is not set into cache
  */
 void TgFontText::generateFontTextInfoGlyphs(float fontSize, bool onlyForCalculation)
 {
-    TgFontInfo *fontInfo;
-    size_t i, indexToUse;
-    std::vector<bool> characterUsed;
-    characterUsed.resize(getCharacterCount(), false);
+    size_t i;
+    std::vector<int32_t> listFontFileNameIndex;
+    std::vector<TgFontGlyphCacheRequest> listRequest;
     m_mutex.lock();
     clearCacheValues(false);
     m_listFontInfo.resize(getCharacterCount(), nullptr);
-    bool added;
+    m_layout.invalidate(0);
 
-    while (1) {
-        indexToUse = characterUsed.size();
-        for (i=0;i<characterUsed.size();i++) {
-            if (!characterUsed[i]) {
-                indexToUse = i;
-                break;
-            }
+    generateFontRequests(m_listCharacter, *m_fontChain, listFontFileNameIndex, listRequest);
+    std::vector<TgFontInfo *> listFontInfo = TgGlobalApplication::getInstance()->getFontGlyphCache()->generateCacheForTexts(listRequest, fontSize, onlyForCalculation);
+    for (i=0;i<m_listCharacter.size();i++) {
+        if (m_listCharacter[i].m_fontFileNameIndex != -1) {
+            m_listFontInfo[i] = listFontInfo[ static_cast<size_t>(std::find(listFontFileNameIndex.begin(), listFontFileNameIndex.end(), m_listCharacter[i].m_fontFileNameIndex) - listFontFileNameIndex.begin()) ];
         }
-        if (indexToUse == characterUsed.size()) {
-            break;
+    }
+    setFontInfoByFontFileNameIndex(listFontFileNameIndex, listFontInfo);
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgFontText::prepareFontTextInfoGlyphs
+ *
+ * same as generateFontTextInfoGlyphs(), but this does not use OpenGL,
+ * so this can be called from the worker thread,
+ * TgFontGlyphCache::uploadPreparedCache() must be called on
+ * OpenGL thread before rendering this text
+ *
+ * \param fontSize
+ */
+void TgFontText::prepareFontTextInfoGlyphs(float fontSize)
+{
+    size_t i;
+    std::vector<int32_t> listFontFileNameIndex;
+    std::vector<TgFontGlyphCacheRequest> listRequest;
+    m_mutex.lock();
+    clearCacheValues(false);
+    m_listFontInfo.resize(getCharacterCount(), nullptr);
+    m_layout.invalidate(0);
+
+    generateFontRequests(m_listCharacter, *m_fontChain, listFontFileNameIndex, listRequest);
+    std::vector<TgFontInfo *> listFontInfo = TgGlobalApplication::getInstance()->getFontGlyphCache()->prepareCacheForTexts(listRequest, fontSize);
+    for (i=0;i<m_listCharacter.size();i++) {
+        if (m_listCharacter[i].m_fontFileNameIndex != -1) {
+            m_listFontInfo[i] = listFontInfo[ static_cast<size_t>(std::find(listFontFileNameIndex.begin(), listFontFileNameIndex.end(), m_listCharacter[i].m_fontFileNameIndex) - listFontFileNameIndex.begin()) ];
         }
+    }
+    setFontInfoByFontFileNameIndex(listFontFileNameIndex, listFontInfo);
+    m_mutex.unlock();
+}
 
-        fontInfo = nullptr;
-        if (m_listCharacter[indexToUse].m_fontFileNameIndex != -1) {
-            std::vector<uint32_t> listCharacters = getCharactersByFontFileNameIndex(m_listCharacter[indexToUse].m_fontFileNameIndex, m_listCharacter);
-            fontInfo = TgGlobalApplication::getInstance()->getFontGlyphCache()->generateCacheForText(listCharacters,
-                                        m_listFontFileNames.at( getCharacter(indexToUse)->m_fontFileNameIndex ).c_str(),
-                                        fontSize, onlyForCalculation);
+/*!
+ * \brief TgFontText::setFontInfoByFontFileNameIndex
+ *
+ * sets m_listFontInfoByFontFileNameIndex, m_mutex must be locked
+ *
+ * \param listFontFileNameIndex font file name index of each listFontInfo
+ * \param listFontInfo
+ */
+void TgFontText::setFontInfoByFontFileNameIndex(const std::vector<int32_t> &listFontFileNameIndex, const std::vector<TgFontInfo *> &listFontInfo)
+{
+    size_t i;
+    m_listFontInfoByFontFileNameIndex.clear();
+    m_listFontInfoByFontFileNameIndex.resize(m_fontChain->m_listFont.size(), nullptr);
+    for (i=0;i<listFontFileNameIndex.size() && i<listFontInfo.size();i++) {
+        if (listFontFileNameIndex[i] >= 0
+            && static_cast<size_t>(listFontFileNameIndex[i]) < m_listFontInfoByFontFileNameIndex.size()) {
+            m_listFontInfoByFontFileNameIndex[static_cast<size_t>(listFontFileNameIndex[i])] = listFontInfo[i];
         }
+    }
+}
 
-        added = false;
-        for (i=0;i<characterUsed.size();i++) {
-            if (getCharacter(i)->m_fontFileNameIndex == getCharacter(indexToUse)->m_fontFileNameIndex) {
-                characterUsed[i] = true;
-                m_listFontInfo[i] = fontInfo;
-                added = true;
-            }
+/*!
+ * \brief TgFontText::editCharacters
+ *
+ * removes and adds characters in place, font infos (glyphs) of
+ * the text are re-used for added characters, so glyphs are not
+ * regenerated. Character positions must be re-generated from
+ * startCharacterIndex with TgCharacterPositions::generateTextCharacterPositioning
+ *
+ * \param startCharacterIndex index of first character to remove, and where to add characters
+ * \param characterCountToRemove number of characters to remove
+ * \param listAddCharacter characters to add
+ * \param r text red color of added characters
+ * \param g text green color of added characters
+ * \param b text blue color of added characters
+ * \return false if some added character's glyph was not in the font infos
+ * of this text, then generateFontTextInfoGlyphs() must be called
+ */
+bool TgFontText::editCharacters(size_t startCharacterIndex, size_t characterCountToRemove,
+                                const std::vector<uint32_t> &listAddCharacter, uint8_t r, uint8_t g, uint8_t b)
+{
+    size_t i;
+    int32_t fontFileNameIndex;
+    bool ret = true;
+    TgFontInfo *info;
+    std::vector<TgFontTextCharacterInfo> listAdd(listAddCharacter.size());
+    m_mutex.lock();
+    if (startCharacterIndex + characterCountToRemove > m_listCharacter.size()
+        || m_listFontInfo.size() != m_listCharacter.size()) {
+        m_mutex.unlock();
+        return false;
+    }
+    for (i=0;i<listAddCharacter.size();i++) {
+        listAdd[i].m_character = listAddCharacter[i];
+        listAdd[i].m_fontFileNameIndex = -1;
+        listAdd[i].positionLeftX = 0;
+        listAdd[i].m_lineNumber = 0;
+        listAdd[i].m_textColorR = r;
+        listAdd[i].m_textColorG = g;
+        listAdd[i].m_textColorB = b;
+    }
+    m_listCharacter.erase(m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex),
+                          m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex+characterCountToRemove));
+    m_listCharacter.insert(m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex), listAdd.begin(), listAdd.end());
+    m_listFontInfo.erase(m_listFontInfo.begin()+static_cast<int64_t>(startCharacterIndex),
+                         m_listFontInfo.begin()+static_cast<int64_t>(startCharacterIndex+characterCountToRemove));
+    m_listFontInfo.insert(m_listFontInfo.begin()+static_cast<int64_t>(startCharacterIndex), listAdd.size(), nullptr);
+
+    // font of the character depends on the font of the previous character,
+    // so continue after added characters until font does not change
+    std::vector<const TgFontCharacterCache *> listFontCharacters = TgFontCharactersCache::getFontCharacters(*m_fontChain);
+    for (i=startCharacterIndex;i<m_listCharacter.size();i++) {
+        fontFileNameIndex = TgFontCharactersCache::getFontIndexForCharacter(m_listCharacter[i].m_character,
+                                                                            i > 0 ? m_listCharacter[i-1].m_fontFileNameIndex : -1,
+                                                                            listFontCharacters);
+        if (i >= startCharacterIndex + listAdd.size()
+            && fontFileNameIndex == m_listCharacter[i].m_fontFileNameIndex) {
+            break;
         }
-        if (!added) {
-            if (fontInfo->m_data) {
-                prj_ttf_reader_clear_data(&fontInfo->m_data);
-            }
-            delete fontInfo;
+        m_listCharacter[i].m_fontFileNameIndex = fontFileNameIndex;
+        m_listFontInfo[i] = nullptr;
+        if (fontFileNameIndex == -1) {
+            continue;
+        }
+        info = static_cast<size_t>(fontFileNameIndex) < m_listFontInfoByFontFileNameIndex.size()
+                ? m_listFontInfoByFontFileNameIndex[static_cast<size_t>(fontFileNameIndex)] : nullptr;
+        if (!info || std::find(info->m_listCharacter.begin(), info->m_listCharacter.end(), m_listCharacter[i].m_character) == info->m_listCharacter.end()) {
+            ret = false;
+            continue;
         }
+        m_listFontInfo[i] = info;
     }
+    clearListLineStart(startCharacterIndex);
+    m_layout.invalidate(startCharacterIndex);
     m_mutex.unlock();
+    return ret;
 }
 
 /*!
@@ -201,49 +298,46 @@ void TgFontText::generateFontTextInfoGlyphs(float fontSize, bool onlyForCalculat
  */
 void TgFontText::generateFontTextInfoGlyphsData(float fontSize, std::vector<TgFontTextCharacterInfo>&listCharacter,
                                                 std::vector<TgFontInfoData *>&listFontInfo,
-                                                std::vector<std::string> &listFontFiles)
+                                                const TgFontChain &fontChain)
 {
-    TgFontInfoData *fontInfo;
-    size_t i, indexToUse;
-    std::vector<bool> characterUsed;
-    characterUsed.resize(listCharacter.size(), false);
+    size_t i;
+    std::vector<int32_t> listFontFileNameIndex;
+    std::vector<TgFontGlyphCacheRequest> listRequest;
     listFontInfo.resize(listCharacter.size(), nullptr);
-    bool added;
-
-    while (1) {
-        indexToUse = characterUsed.size();
-        for (i=0;i<characterUsed.size();i++) {
-            if (!characterUsed[i]) {
-                indexToUse = i;
-                break;
-            }
-        }
-        if (indexToUse == characterUsed.size()) {
-            break;
-        }
 
-        fontInfo = nullptr;
-        if (listCharacter[indexToUse].m_fontFileNameIndex != -1) {
-            std::vector<uint32_t> listCharacters = getCharactersByFontFileNameIndex(listCharacter[indexToUse].m_fontFileNameIndex, listCharacter);
-            fontInfo = TgGlobalApplication::getInstance()->getFontGlyphCacheData()->generateCacheForText(listCharacters,
-                                        listFontFiles.at( listCharacter[indexToUse].m_fontFileNameIndex ).c_str(),
-                                        fontSize);
+    generateFontRequests(listCharacter, fontChain, listFontFileNameIndex, listRequest);
+    std::vector<TgFontInfoData *> listFontInfoData = TgGlobalApplication::getInstance()->getFontGlyphCacheData()->generateCacheForTexts(listRequest, fontSize);
+    for (i=0;i<listCharacter.size();i++) {
+        if (listCharacter[i].m_fontFileNameIndex != -1) {
+            listFontInfo[i] = listFontInfoData[ static_cast<size_t>(std::find(listFontFileNameIndex.begin(), listFontFileNameIndex.end(), listCharacter[i].m_fontFileNameIndex) - listFontFileNameIndex.begin()) ];
         }
+    }
+}
 
-        added = false;
-        for (i=0;i<characterUsed.size();i++) {
-            if (listCharacter[i].m_fontFileNameIndex == listCharacter[indexToUse].m_fontFileNameIndex) {
-                characterUsed[i] = true;
-                listFontInfo[i] = fontInfo;
-                added = true;
-            }
-        }
-        if (!added) {
-            if (fontInfo->m_data) {
-                prj_ttf_reader_clear_data(&fontInfo->m_data);
-            }
-            delete fontInfo;
+/*!
+ * \brief TgFontText::generateFontRequests
+ *
+ * generates glyph cache request for each font that is used in the text
+ *
+ * \param listCharacter [in] characters of the text
+ * \param fontChain [in] fonts of the text
+ * \param listFontFileNameIndex [out] font file name index of each request
+ * \param listRequest [out] glyph cache request for each font used in text
+ */
+void TgFontText::generateFontRequests(const std::vector<TgFontTextCharacterInfo>&listCharacter, const TgFontChain &fontChain,
+                                      std::vector<int32_t> &listFontFileNameIndex, std::vector<TgFontGlyphCacheRequest> &listRequest)
+{
+    std::vector<TgFontTextCharacterInfo>::const_iterator it;
+    for (it=listCharacter.begin();it!=listCharacter.end();it++) {
+        if (it->m_fontFileNameIndex == -1
+            || std::find(listFontFileNameIndex.begin(), listFontFileNameIndex.end(), it->m_fontFileNameIndex) != listFontFileNameIndex.end()) {
+            continue;
         }
+        listFontFileNameIndex.push_back(it->m_fontFileNameIndex);
+        listRequest.push_back(TgFontGlyphCacheRequest());
+        listRequest.back().m_listCharacters = getCharactersByFontFileNameIndex(it->m_fontFileNameIndex, listCharacter);
+        listRequest.back().m_fontFile = fontChain.m_listFontFile.at( static_cast<size_t>(it->m_fontFileNameIndex) );
+        listRequest.back().m_fontId = fontChain.m_listFontId.at( static_cast<size_t>(it->m_fontFileNameIndex) );
     }
 }
 
@@ -255,36 +349,31 @@ void TgFontText::generateFontTextInfoGlyphsData(float fontSize, std::vector<TgFo
  */
 void TgFontText::clearCacheValues(bool useLock)
 {
-    size_t i, i2;
-    std::vector<size_t>listToDelete;
+    size_t i;
+    std::vector<TgFontInfo *>listToDelete;
     if (useLock) {
         m_mutex.lock();
     }
-    for (i=0;i<m_listFontInfo.size();i++) {
-        if (!m_listFontInfo[i]
-            || m_listFontInfo[i]->m_addedToCache
-            || !m_listFontInfo[i]->m_data) {
+    for (i=0;i<m_listFontInfo.size()+m_listFontInfoByFontFileNameIndex.size();i++) {
+        TgFontInfo *info = i < m_listFontInfo.size() ? m_listFontInfo[i] : m_listFontInfoByFontFileNameIndex[i-m_listFontInfo.size()];
+        if (!info
+            || info->m_addedToCache
+            || (!info->m_data && !info->m_diskData)
+            || std::find(listToDelete.begin(), listToDelete.end(), info) != listToDelete.end()) {
             continue;
         }
-        for (i2=i+1;i2<m_listFontInfo.size();i2++) {
-            if (m_listFontInfo[i2]
-                && m_listFontInfo[i2]->m_data
-                && m_listFontInfo[i]->m_data == m_listFontInfo[i2]->m_data) {
-                m_listFontInfo[i2]->m_addedToCache = true;
-            }
-        }
-        prj_ttf_reader_clear_data(&m_listFontInfo[i]->m_data);
-        listToDelete.insert(listToDelete.begin(), i);
+        listToDelete.push_back(info);
     }
     for (i=0;i<listToDelete.size();i++) {
-        delete m_listFontInfo[listToDelete[i]];
+        TgFontGlyphCache::clearFontInfoData(listToDelete[i]);
+        delete listToDelete[i];
     }
     m_listFontInfo.clear();
+    m_listFontInfoByFontFileNameIndex.clear();
     if (useLock) {
         m_mutex.unlock();
     }
 }
-
 /*!
  * \brief TgFontText::getFontInfo
  *
@@ -301,6 +390,32 @@ TgFontInfo *TgFontText::getFontInfo(size_t i)
     return m_listFontInfo[i];
 }
 
+/*!
+ * \brief TgFontText::replaceFontInfo
+ *
+ * replaces font info with other font info that has exactly same glyphs,
+ * so glyph indexes of the characters stay valid
+ *
+ * \param oldInfo font info to replace
+ * \param newInfo new font info
+ */
+void TgFontText::replaceFontInfo(const TgFontInfo *oldInfo, TgFontInfo *newInfo)
+{
+    size_t i;
+    m_mutex.lock();
+    for (i=0;i<m_listFontInfo.size();i++) {
+        if (m_listFontInfo[i] == oldInfo) {
+            m_listFontInfo[i] = newInfo;
+        }
+    }
+    for (i=0;i<m_listFontInfoByFontFileNameIndex.size();i++) {
+        if (m_listFontInfoByFontFileNameIndex[i] == oldInfo) {
+            m_listFontInfoByFontFileNameIndex[i] = newInfo;
+        }
+    }
+    m_mutex.unlock();
+}
+
 /*!
  * \brief TgFontText::getTextWidth
  *
@@ -452,6 +567,63 @@ void TgFontText::setListLinesWidth(std::vector<float> &listLineWidth, size_t lin
     }
 }
 
+/*!
+ * \brief TgFontText::resizeListLinesWidth
+ *
+ * \param lineCount number of line widths to keep
+ */
+void TgFontText::resizeListLinesWidth(size_t lineCount)
+{
+    if (m_listLineWidth.size() > lineCount) {
+        m_listLineWidth.resize(lineCount);
+    }
+}
+
+/*!
+ * \brief TgFontText::clearListLineStart
+ *
+ * removes line starts, that are after fromCharacterIndex
+ *
+ * \param fromCharacterIndex
+ */
+void TgFontText::clearListLineStart(size_t fromCharacterIndex)
+{
+    while (!m_listLineStart.empty() && m_listLineStart.back().m_characterIndex > fromCharacterIndex) {
+        m_listLineStart.pop_back();
+    }
+}
+
+/*!
+ * \brief TgFontText::addLineStart
+ *
+ * \param lineStart layout state at the start of the line, must be after previous line start
+ */
+void TgFontText::addLineStart(const TgFontTextLineStart &lineStart)
+{
+    m_listLineStart.push_back(lineStart);
+}
+
+/*!
+ * \brief TgFontText::getLineStart
+ *
+ * get last line start, that is at or before characterIndex
+ *
+ * \param characterIndex
+ * \param lineStart [out]
+ * \return true if line start was found
+ */
+bool TgFontText::getLineStart(size_t characterIndex, TgFontTextLineStart &lineStart)
+{
+    std::vector<TgFontTextLineStart>::const_iterator it;
+    it = std::upper_bound(m_listLineStart.begin(), m_listLineStart.end(), characterIndex,
+                          [](size_t index, const TgFontTextLineStart &l) { return index < l.m_characterIndex; });
+    if (it == m_listLineStart.begin()) {
+        return false;
+    }
+    lineStart = *(it-1);
+    return true;
+}
+
 /*!
  * \brief TgFontText::getTextLineWidth
  *
@@ -465,3 +637,41 @@ float TgFontText::getTextLineWidth(size_t lineNumber)
     }
     return 0;
 }
+
+/*!
+ * \brief TgFontText::getLayout
+ *
+ * \return layout index of this text
+ */
+TgFontTextLayout *TgFontText::getLayout()
+{
+    return &m_layout;
+}
+
+/*!
+ * \brief TgFontText::clone
+ *
+ * copies the text (characters, font infos, positions and layout),
+ * font infos are not copied, so the clone must not clear the cache values
+ * and it must be deleted before the original text
+ *
+ * \return new copy of the text
+ */
+TgFontText *TgFontText::clone()
+{
+    TgFontText *ret = new TgFontText();
+    m_mutex.lock();
+    ret->m_textWidth = m_textWidth;
+    ret->m_visibleTopY = m_visibleTopY;
+    ret->m_visibleBottomY = m_visibleBottomY;
+    ret->m_allLineCount = m_allLineCount;
+    ret->m_listLineWidth = m_listLineWidth;
+    ret->m_fontChain = m_fontChain;
+    ret->m_listCharacter = m_listCharacter;
+    ret->m_listFontInfo = m_listFontInfo;
+    ret->m_listFontInfoByFontFileNameIndex = m_listFontInfoByFontFileNameIndex;
+    ret->m_listLineStart = m_listLineStart;
+    ret->m_layout = m_layout;
+    m_mutex.unlock();
+    return ret;
+}
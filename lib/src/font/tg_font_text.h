@@ -14,16 +14,21 @@
 #define TG_FONT_TEXT_H
 
 #include <vector>
+#include <memory>
 #include <string>
 #include <mutex>
+#include "tg_font_text_layout.h"
 
 struct TgFontInfo;
 struct TgFontInfoData;
+struct TgFontGlyphCacheRequest;
+struct TgFontCharacterCache;
+struct TgFontChain;
 
 struct TgFontTextCharacterInfo
 {
     uint32_t m_character;           /*!< character index */
-    int32_t m_fontFileNameIndex;    /*!< character is drawed from this TgFontText's index, from m_listFontFileNames, -1 == ignored */
+    int32_t m_fontFileNameIndex;    /*!< character is drawed from this TgFontText's index, from m_fontChain, -1 == ignored */
 
     float positionLeftX;            /*!< glyph X position, generated in TgCharacterPositions::generateTextCharacterPositioning */
     size_t m_characterInFontInfoIndex = 0; /*!< glyph index in TgFontInfo, generated in TgCharacterPositions::generateTextCharacterPositioning */
@@ -36,20 +41,54 @@ struct TgFontTextCharacterInfo
     bool m_draw { true };           /*!< false == not draw */
 };
 
+/*!
+ * \brief TG_FONT_TEXT_LINE_START_INTERVAL
+ * layout state is stored at least after this many characters
+ * also within the line, so editing long line (single line text)
+ * does not position the whole line again
+ */
+#define TG_FONT_TEXT_LINE_START_INTERVAL        128
+
+/*!
+ * \brief TgFontTextLineStart
+ * layout state at the start of the line (after line break '\n' or
+ * wrapped line), or within the line after TG_FONT_TEXT_LINE_START_INTERVAL
+ * characters, character positioning can continue from here
+ * generated in TgCharacterPositions::generateTextCharacterPositioning
+ */
+struct TgFontTextLineStart
+{
+    size_t m_characterIndex;        /*!< first character to position from here */
+    uint32_t m_lineNumber;          /*!< line number, 1 == first line */
+    float m_textLinesWidth;
+    float m_textWidth;
+    float m_visibleTopY;
+    float m_visibleBottomY;
+    bool m_firstCharacterAdded;
+    float m_positionLeftX;          /*!< x position of the left character */
+    size_t m_leftCharacterIndex;    /*!< left character on the same line, SIZE_MAX == none */
+    size_t m_previousSpaceIndex;    /*!< previous break opportunity on the same line, SIZE_MAX == none */
+    float m_lineWidth;              /*!< width of the line so far, valid if m_leftCharacterIndex is set */
+};
+
 class TgFontText
 {
 public:
     TgFontText();
 
-    void setFontFileNames(const std::string &mainFontFile, const std::vector<std::string> &listFontFileNames);
-    void addCharacter(uint32_t character, uint8_t r, uint8_t g, uint8_t b);
-    static void addCharacter(std::vector<TgFontTextCharacterInfo>&listCharacter, uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<std::string> &listFontFileNames);
+    void setFontChain(const std::shared_ptr<const TgFontChain> &fontChain);
+    void addCharacter(uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<const TgFontCharacterCache *> &listFontCharacters);
+    static void addCharacter(std::vector<TgFontTextCharacterInfo>&listCharacter, uint32_t character, uint8_t r, uint8_t g, uint8_t b, const std::vector<const TgFontCharacterCache *> &listFontCharacters);
     void generateFontTextInfoGlyphs(float fontSize, bool onlyForCalculation);
-    static void generateFontTextInfoGlyphsData(float fontSize, std::vector<TgFontTextCharacterInfo>&listCharacter, std::vector<TgFontInfoData *>&listFontInfo, std::vector<std::string> &listFontFiles);
+    void prepareFontTextInfoGlyphs(float fontSize);
+    bool editCharacters(size_t startCharacterIndex, size_t characterCountToRemove,
+                        const std::vector<uint32_t> &listAddCharacter, uint8_t r, uint8_t g, uint8_t b);
+    static void generateFontTextInfoGlyphsData(float fontSize, std::vector<TgFontTextCharacterInfo>&listCharacter, std::vector<TgFontInfoData *>&listFontInfo, const TgFontChain &fontChain);
 
     size_t getCharacterCount();
     TgFontTextCharacterInfo *getCharacter(size_t i);
     TgFontInfo *getFontInfo(size_t i);
+    void replaceFontInfo(const TgFontInfo *oldInfo, TgFontInfo *newInfo);
 
     static std::vector<uint32_t> getCharactersByFontFileNameIndex(int32_t fontFileNameIndex, const std::vector<TgFontTextCharacterInfo>&listCharacter);
 
@@ -70,10 +109,20 @@ public:
     void setListLinesWidth(size_t lineNumber, float lineWidth);
     static void setListLinesWidth(std::vector<float> &listLineWidth, size_t lineNumber, float lineWidth);
     float getTextLineWidth(size_t lineNumber);
+    void resizeListLinesWidth(size_t lineCount);
+
+    void clearListLineStart(size_t fromCharacterIndex);
+    void addLineStart(const TgFontTextLineStart &lineStart);
+    bool getLineStart(size_t characterIndex, TgFontTextLineStart &lineStart);
 
     void clearCacheValues(bool useLock);
+    TgFontTextLayout *getLayout();
+    TgFontText *clone();
 
 private:
+    static void generateFontRequests(const std::vector<TgFontTextCharacterInfo>&listCharacter, const TgFontChain &fontChain,
+                                     std::vector<int32_t> &listFontFileNameIndex, std::vector<TgFontGlyphCacheRequest> &listRequest);
+
     std::mutex m_mutex;
     float m_textWidth;
     float m_visibleTopY;
@@ -81,9 +130,14 @@ private:
     uint32_t m_allLineCount;
     std::vector<float>m_listLineWidth;   // [0] line width of the first line
 
-    std::vector<std::string>m_listFontFileNames;
+    std::shared_ptr<const TgFontChain>m_fontChain;      /*!< main font first, shared with TgFontDefault */
     std::vector<TgFontTextCharacterInfo>m_listCharacter;
     std::vector<TgFontInfo *>m_listFontInfo;
+    std::vector<TgFontInfo *>m_listFontInfoByFontFileNameIndex;   /*!< font info of each font of m_fontChain */
+    std::vector<TgFontTextLineStart>m_listLineStart;              /*!< sorted by m_characterIndex */
+    TgFontTextLayout m_layout;
+
+    void setFontInfoByFontFileNameIndex(const std::vector<int32_t> &listFontFileNameIndex, const std::vector<TgFontInfo *> &listFontInfo);
 };
 
 #endif // TG_FONT_TEXT_H
@@ -17,6 +17,7 @@
 #include "../global/tg_global_application.h"
 #include "tg_font_default.h"
 #include "tg_font_text.h"
+#include "text/tg_text_transcode_utf8.h"
 
 /*!
  * \brief TgFontText::getCharacters
@@ -32,24 +33,14 @@ void TgFontTextGenerator::getCharacters(const std::vector<TgTextFieldText> &list
     if (listText.empty()) {
         return;
     }
-    uint32_t characterIndex;
-    uint32_t *list_characters = nullptr, list_characters_size;
-
     for (size_t i=0;i<listText.size();i++) {
         if (listText.at(i).m_text.empty()) {
             continue;
         }
-        if (prj_ttf_reader_get_characters(listText.at(i).m_text.c_str(), &list_characters, &list_characters_size)) {
+        if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(listText.at(i).m_text, listCharacter)) {
             TG_ERROR_LOG("Invalid UTF-8 text: ", generateSingleLineText(listText).c_str());
             return;
         }
-        for (characterIndex=0;characterIndex<list_characters_size;characterIndex++) {
-            listCharacter.push_back(list_characters[characterIndex]);
-        }
-        if (list_characters) {
-            free(list_characters);
-            list_characters = nullptr;
-        }
     }
     return;
 }
@@ -68,28 +59,26 @@ void TgFontTextGenerator::getCharacters(const std::vector<TgTextFieldText> &list
     if (listText.empty()) {
         return;
     }
-    uint32_t characterIndex;
-    uint32_t *list_characters = nullptr, list_characters_size;
+    size_t characterIndex, listCharacterSize;
+    std::vector<uint32_t> listUtf32;
 
     for (size_t i=0;i<listText.size();i++) {
         if (listText.at(i).m_text.empty()) {
             continue;
         }
-        if (prj_ttf_reader_get_characters(listText.at(i).m_text.c_str(), &list_characters, &list_characters_size)) {
+        listUtf32.clear();
+        if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(listText.at(i).m_text, listUtf32)) {
             TG_ERROR_LOG("Invalid UTF-8 text: ", generateSingleLineText(listText).c_str());
             return;
         }
-        for (characterIndex=0;characterIndex<list_characters_size;characterIndex++) {
-            TgTextCharacter c;
-            c.m_character = list_characters[characterIndex];
+        listCharacterSize = listCharacter.size();
+        listCharacter.resize(listCharacterSize + listUtf32.size());
+        for (characterIndex=0;characterIndex<listUtf32.size();characterIndex++) {
+            TgTextCharacter &c = listCharacter[listCharacterSize + characterIndex];
+            c.m_character = listUtf32[characterIndex];
             c.m_r = listText.at(i).m_textColorR;
             c.m_g = listText.at(i).m_textColorG;
             c.m_b = listText.at(i).m_textColorB;
-            listCharacter.push_back(c);
-        }
-        if (list_characters) {
-            free(list_characters);
-            list_characters = nullptr;
         }
     }
     return;
@@ -104,67 +93,77 @@ void TgFontTextGenerator::getCharacters(const std::vector<TgTextFieldText> &list
  * \param mainFontFile [in] main font file
  */
 TgFontText *TgFontTextGenerator::generateFontTextInfo(const std::vector<TgTextFieldText> &listText, const std::string &mainFontFile)
+{
+    return generateFontTextInfo(listText, TgFontDefault::getMainFontChain(mainFontFile));
+}
+
+/*!
+ * \brief TgFontText::generateFontTextInfo
+ *
+ * generate TgFontText for the text
+ *
+ * \param listText [in] text
+ * \param fontChain [in] fonts, main font first (TgFontDefault::getMainFontChain())
+ */
+TgFontText *TgFontTextGenerator::generateFontTextInfo(const std::vector<TgTextFieldText> &listText,
+                                                      const std::shared_ptr<const TgFontChain> &fontChain)
 {
     TgFontText *ret = new TgFontText();
-    std::vector<std::string> listFontFiles = TgGlobalApplication::getInstance()->getFontDefault()->getListFont();
-    ret->setFontFileNames(mainFontFile, listFontFiles);
+    ret->setFontChain(fontChain);
     if (listText.empty()) {
         return ret;
     }
-    uint32_t *list_characters = nullptr, list_characters_size;
-    uint32_t characterIndex;
+    std::vector<uint32_t> listUtf32;
+    size_t characterIndex;
+    std::vector<const TgFontCharacterCache *> listFontCharacters = TgFontCharactersCache::getFontCharacters(*fontChain);
 
     for (size_t i=0;i<listText.size();i++) {
         if (listText.at(i).m_text.empty()) {
             continue;
         }
-        if (prj_ttf_reader_get_characters(listText.at(i).m_text.c_str(), &list_characters, &list_characters_size)) {
+        listUtf32.clear();
+        if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(listText.at(i).m_text, listUtf32)) {
             TG_ERROR_LOG("Invalid UTF-8 text: ", generateSingleLineText(listText).c_str());
             delete ret;
             return nullptr;
         }
 
-        for (characterIndex=0;characterIndex<list_characters_size;characterIndex++) {
-            ret->addCharacter(list_characters[characterIndex],
+        for (characterIndex=0;characterIndex<listUtf32.size();characterIndex++) {
+            ret->addCharacter(listUtf32[characterIndex],
                               listText.at(i).m_textColorR,
                               listText.at(i).m_textColorG,
-                              listText.at(i).m_textColorB);
-        }
-
-        if (list_characters) {
-            free(list_characters);
+                              listText.at(i).m_textColorB,
+                              listFontCharacters);
         }
     }
 
     return ret;
 }
 
-std::vector<TgFontTextCharacterInfo> TgFontTextGenerator::generateCharacterList(const std::vector<TgTextFieldText> &listText, const std::vector<std::string> &listFontFiles)
+std::vector<TgFontTextCharacterInfo> TgFontTextGenerator::generateCharacterList(const std::vector<TgTextFieldText> &listText, const TgFontChain &fontChain)
 {
     std::vector<TgFontTextCharacterInfo> ret;
-    uint32_t *list_characters = nullptr, list_characters_size;
-    uint32_t characterIndex;
+    std::vector<uint32_t> listUtf32;
+    size_t characterIndex;
+    std::vector<const TgFontCharacterCache *> listFontCharacters = TgFontCharactersCache::getFontCharacters(fontChain);
 
     for (size_t i=0;i<listText.size();i++) {
         if (listText.at(i).m_text.empty()) {
             continue;
         }
-        if (prj_ttf_reader_get_characters(listText.at(i).m_text.c_str(), &list_characters, &list_characters_size)) {
+        listUtf32.clear();
+        if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(listText.at(i).m_text, listUtf32)) {
             TG_ERROR_LOG("Invalid UTF-8 text: ", generateSingleLineText(listText).c_str());
             ret.clear();
             return ret;
         }
 
-        for (characterIndex=0;characterIndex<list_characters_size;characterIndex++) {
-            TgFontText::addCharacter(ret, list_characters[characterIndex],
+        for (characterIndex=0;characterIndex<listUtf32.size();characterIndex++) {
+            TgFontText::addCharacter(ret, listUtf32[characterIndex],
                                 listText.at(i).m_textColorR,
                                 listText.at(i).m_textColorG,
                                 listText.at(i).m_textColorB,
-                                listFontFiles);
-        }
-
-        if (list_characters) {
-            free(list_characters);
+                                listFontCharacters);
         }
     }
     return ret;
@@ -204,19 +203,21 @@ std::string TgFontTextGenerator::generateSingleLineText(const std::vector<TgText
  */
 bool TgFontTextGenerator::changeTextColor(const std::vector<TgTextFieldText> &listText, TgFontText *fontText)
 {
-    uint32_t *list_characters = nullptr, list_characters_size;
-    uint32_t characterIndex;
+    std::vector<uint32_t> listUtf32;
+    size_t characterIndex;
     size_t fontTextIndex = 0;
     bool ret = true;
 
     for (size_t i=0;i<listText.size() && ret;i++) {
-        if (prj_ttf_reader_get_characters(listText.at(i).m_text.c_str(), &list_characters, &list_characters_size)) {
+        listUtf32.clear();
+        if (!TgTextTranscodeUtf8::addUtf8ToUtf32List(listText.at(i).m_text, listUtf32)) {
             TG_ERROR_LOG("Invalid UTF-8 text: ", generateSingleLineText(listText).c_str());
             return false;
         }
 
-        for (characterIndex=0;characterIndex<list_characters_size;characterIndex++) {
-            if (fontText->getCharacter(fontTextIndex)->m_character != list_characters[characterIndex]) {
+        for (characterIndex=0;characterIndex<listUtf32.size();characterIndex++,fontTextIndex++) {
+            if (fontTextIndex >= fontText->getCharacterCount()
+                || fontText->getCharacter(fontTextIndex)->m_character != listUtf32[characterIndex]) {
                 ret = false;
                 break;
             }
@@ -224,10 +225,6 @@ bool TgFontTextGenerator::changeTextColor(const std::vector<TgTextFieldText> &li
             fontText->getCharacter(fontTextIndex)->m_textColorG = listText.at(i).m_textColorG;
             fontText->getCharacter(fontTextIndex)->m_textColorB = listText.at(i).m_textColorB;
         }
-
-        if (list_characters) {
-            free(list_characters);
-        }
     }
     return ret;
 }
\ No newline at end of file
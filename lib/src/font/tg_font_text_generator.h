@@ -34,10 +34,11 @@ public:
     static void getCharacters(const std::vector<TgTextFieldText> &listText, std::vector<uint32_t> &listCharacter);
     static void getCharacters(const std::vector<TgTextFieldText> &listText, std::vector<TgTextCharacter> &listCharacter);
     static TgFontText *generateFontTextInfo(const std::vector<TgTextFieldText> &listText, const std::string &mainFontFile);
+    static TgFontText *generateFontTextInfo(const std::vector<TgTextFieldText> &listText,
+                                            const std::shared_ptr<const TgFontChain> &fontChain);
     static bool changeTextColor(const std::vector<TgTextFieldText> &listText, TgFontText *fontText);
     static std::string generateSingleLineText(const std::vector<TgTextFieldText> &listText);
-    static std::vector<TgFontTextCharacterInfo> generateCharacterList(const std::vector<TgTextFieldText> &listText, const std::vector<std::string> &listFontFiles);
-;
+    static std::vector<TgFontTextCharacterInfo> generateCharacterList(const std::vector<TgTextFieldText> &listText, const TgFontChain &fontChain);
 };
 
 #endif // TG_FONT_TEXT_GENERATOR_H
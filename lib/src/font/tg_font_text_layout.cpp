@@ -0,0 +1,247 @@
+/*!
+ * \file
+ * \brief file tg_font_text_layout.cpp
+ *
+ * layout index of the text, glyph widths, kerning and font info
+ * indexes of the characters are looked up once per text, so
+ * wrapping the text again (e.g. on resize) is only simple
+ * arithmetic over the characters
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_font_text_layout.h"
+#include <algorithm>
+#include "tg_font_text.h"
+#include "cache/tg_font_glyph_cache.h"
+
+TgFontTextLayout::TgFontTextLayout() :
+    m_validCount(0)
+{
+}
+
+/*!
+ * \brief TgFontTextLayout::invalidate
+ *
+ * characters from fromCharacterIndex are looked up again on next update(),
+ * this must be called when characters or font infos of the text change
+ *
+ * \param fromCharacterIndex first changed character
+ */
+void TgFontTextLayout::invalidate(size_t fromCharacterIndex)
+{
+    if (m_validCount > fromCharacterIndex) {
+        m_validCount = fromCharacterIndex;
+    }
+}
+
+/*!
+ * \brief TgFontTextLayout::update
+ *
+ * looks up glyph values of the characters that are not yet up to date,
+ * kerning of the character is to the previous character that has glyph
+ *
+ * \param fontText [in] text, font infos of the text must be generated
+ */
+void TgFontTextLayout::update(TgFontText *fontText)
+{
+    size_t i, c = fontText->getCharacterCount();
+    const TgFontTextCharacterInfo *characterInfo;
+    const TgFontTextCharacterInfo *leftCharacterInfo = nullptr;
+    const TgFontInfo *fontInfo;
+    const prj_ttf_reader_glyph_data_t *glyph;
+    const prj_ttf_reader_glyph_data_t *left_glyph = nullptr;
+    int32_t left_advance_x, left_bearing, right_bearing;
+
+    if (m_validCount > c) {
+        m_validCount = c;
+    }
+    if (m_validCount == c && m_listCharacter.size() == c) {
+        return;
+    }
+    m_listCharacter.resize(c);
+
+    for (i=m_validCount;i>0;i--) {
+        if (m_listCharacter[i-1].m_glyph) {
+            leftCharacterInfo = fontText->getCharacter(i-1);
+            fontInfo = fontText->getFontInfo(i-1);
+            left_glyph = TgFontGlyphDiskCache::getCharacterGlyphData(leftCharacterInfo->m_character, fontInfo->m_data, fontInfo->m_diskData);
+            break;
+        }
+    }
+
+    for (i=m_validCount;i<c;i++) {
+        TgFontTextLayoutCharacter &layoutCharacter = m_listCharacter[i];
+        layoutCharacter = TgFontTextLayoutCharacter();
+        characterInfo = fontText->getCharacter(i);
+        layoutCharacter.m_breakOpportunity = isBreakOpportunity(characterInfo->m_character);
+        if (characterInfo->m_character == '\n' || characterInfo->m_fontFileNameIndex == -1) {
+            continue;
+        }
+        fontInfo = fontText->getFontInfo(i);
+        if (!fontInfo) {
+            continue;
+        }
+        glyph = TgFontGlyphDiskCache::getCharacterGlyphData(characterInfo->m_character, fontInfo->m_data, fontInfo->m_diskData);
+        if (!glyph) {
+            continue;
+        }
+
+        if (left_glyph) {
+            left_advance_x = static_cast<int32_t>(left_glyph->image_pixel_advance_x + 0.5f);
+            left_bearing = static_cast<int32_t>(left_glyph->image_pixel_bearing);
+            if (left_glyph->image_pixel_bearing < 0 && left_glyph->image_pixel_bearing > -1) {
+                left_bearing = -1;
+            }
+            left_advance_x -= left_bearing;
+            left_advance_x -= left_glyph->image_pixel_right_x - left_glyph->image_pixel_left_x;
+            right_bearing = static_cast<int32_t>(glyph->image_pixel_bearing);
+            if (glyph->image_pixel_bearing < 0 && glyph->image_pixel_bearing > -1) {
+                right_bearing = -1;
+            }
+            layoutCharacter.m_kerning = TgFontGlyphDiskCache::getKerning(leftCharacterInfo->m_character, characterInfo->m_character, fontInfo->m_data, fontInfo->m_diskData)
+                                        + static_cast<float>(right_bearing + left_advance_x);
+        }
+
+        layoutCharacter.m_width = static_cast<float>(glyph->image_pixel_right_x - glyph->image_pixel_left_x);
+        layoutCharacter.m_characterInFontInfoIndex = getGlyphIndex(fontInfo, characterInfo->m_character);
+        if (fontInfo->m_listTopPositionY.size() > layoutCharacter.m_characterInFontInfoIndex
+            && fontInfo->m_listBottomPositionY.size() > layoutCharacter.m_characterInFontInfoIndex) {
+            layoutCharacter.m_visibleTopY = fontInfo->m_listTopPositionY[layoutCharacter.m_characterInFontInfoIndex];
+            layoutCharacter.m_visibleBottomY = fontInfo->m_listBottomPositionY[layoutCharacter.m_characterInFontInfoIndex];
+            layoutCharacter.m_visibleY = true;
+        }
+        layoutCharacter.m_glyph = true;
+
+        left_glyph = glyph;
+        leftCharacterInfo = characterInfo;
+    }
+    m_validCount = c;
+}
+
+/*!
+ * \brief TgFontTextLayout::getCharacter
+ *
+ * \param i character index, update() must be called first
+ * \return layout values of the character
+ */
+const TgFontTextLayoutCharacter &TgFontTextLayout::getCharacter(size_t i) const
+{
+    return m_listCharacter[i];
+}
+
+/*!
+ * \brief TgFontTextLayout::resizePositionX
+ *
+ * \param characterCount number of characters in the text
+ */
+void TgFontTextLayout::resizePositionX(size_t characterCount)
+{
+    m_listPositionX.resize(characterCount, 0);
+    m_listLineNumber.resize(characterCount, 0);
+}
+
+/*!
+ * \brief TgFontTextLayout::setPositionX
+ *
+ * \param i character index
+ * \param positionX x position of the character (positionLeftX)
+ * \param lineNumber line number of the character (0 == first line)
+ */
+void TgFontTextLayout::setPositionX(size_t i, float positionX, uint32_t lineNumber)
+{
+    m_listPositionX[i] = positionX;
+    m_listLineNumber[i] = lineNumber;
+}
+
+/*!
+ * \brief TgFontTextLayout::getPreviousPositionX
+ *
+ * \param i character index
+ * \return x position of the character before i, 0 if i is first character
+ */
+float TgFontTextLayout::getPreviousPositionX(size_t i) const
+{
+    return i ? m_listPositionX[i-1] : 0;
+}
+
+/*!
+ * \brief TgFontTextLayout::getPreviousLineNumber
+ *
+ * \param i character index
+ * \return line number of the character before i, 0 if i is first character
+ */
+uint32_t TgFontTextLayout::getPreviousLineNumber(size_t i) const
+{
+    return i ? m_listLineNumber[i-1] : 0;
+}
+
+/*!
+ * \brief TgFontTextLayout::getLineRange
+ *
+ * binary search of the characters of the line
+ *
+ * \param lineNumber line number (0 == first line)
+ * \param start [out] first character of the line
+ * \param end [out] character after the last character of the line
+ */
+void TgFontTextLayout::getLineRange(uint32_t lineNumber, size_t &start, size_t &end) const
+{
+    std::pair<std::vector<uint32_t>::const_iterator, std::vector<uint32_t>::const_iterator> range;
+    range = std::equal_range(m_listLineNumber.begin(), m_listLineNumber.end(), lineNumber);
+    start = static_cast<size_t>(range.first - m_listLineNumber.begin());
+    end = static_cast<size_t>(range.second - m_listLineNumber.begin());
+}
+
+/*!
+ * \brief TgFontTextLayout::getCharacterIndex
+ *
+ * binary search of the last character of the line that starts
+ * at or before x (x positions are ascending within the line)
+ *
+ * \param start first character of the line (getLineRange())
+ * \param end character after the last character of the line (getLineRange())
+ * \param x x position
+ * \return character index by the x, start if x is before all characters of the line
+ */
+size_t TgFontTextLayout::getCharacterIndex(size_t start, size_t end, float x) const
+{
+    std::vector<float>::const_iterator it = std::upper_bound(m_listPositionX.begin() + static_cast<int64_t>(start),
+                                                             m_listPositionX.begin() + static_cast<int64_t>(end), x);
+    if (it == m_listPositionX.begin() + static_cast<int64_t>(start)) {
+        return start;
+    }
+    return static_cast<size_t>(it - m_listPositionX.begin()) - 1;
+}
+
+/*!
+ * \brief TgFontTextLayout::isBreakOpportunity
+ *
+ * \param character
+ * \return true if line can be wrapped after the character
+ */
+bool TgFontTextLayout::isBreakOpportunity(uint32_t character)
+{
+    return character == ' ';
+}
+
+/*!
+ * \brief TgFontTextLayout::getGlyphIndex
+ *
+ * get chraracter index from newInfo's m_listCharacter
+ *
+ * \param newInfo [in] info
+ * \param character character
+ * \return character index to find from newInfo->m_listCharacter
+ */
+size_t TgFontTextLayout::getGlyphIndex(const TgFontInfo *newInfo, uint32_t character)
+{
+    for (size_t i=0;i<newInfo->m_listCharacter.size();i++) {
+        if (newInfo->m_listCharacter.at(i) == character) {
+            return i;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+/*!
+ * \file
+ * \brief file tg_font_text_layout.h
+ *
+ * layout index of the text, glyph widths, kerning and font info
+ * indexes of the characters are looked up once per text, so
+ * wrapping the text again (e.g. on resize) is only simple
+ * arithmetic over the characters
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_FONT_TEXT_LAYOUT_H
+#define TG_FONT_TEXT_LAYOUT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class TgFontText;
+struct TgFontInfo;
+
+/*!
+ * \brief TgFontTextLayoutCharacter
+ * layout values of single character, these do not depend on the line width
+ */
+struct TgFontTextLayoutCharacter
+{
+    float m_width = 0;                      /*!< glyph width (image_pixel_right_x - image_pixel_left_x) */
+    float m_kerning = 0;                    /*!< x distance from right of previous glyph to left of this glyph, when they are on same line */
+    float m_visibleTopY = 0;
+    float m_visibleBottomY = 0;
+    size_t m_characterInFontInfoIndex = 0;  /*!< glyph index in TgFontInfo */
+    bool m_glyph = false;                   /*!< false if character has no glyph, then it's not positioned */
+    bool m_visibleY = false;                /*!< true if m_visibleTopY and m_visibleBottomY are set */
+    bool m_breakOpportunity = false;        /*!< line can be wrapped after this character (space) */
+};
+
+class TgFontTextLayout
+{
+public:
+    explicit TgFontTextLayout();
+
+    void invalidate(size_t fromCharacterIndex);
+    void update(TgFontText *fontText);
+    const TgFontTextLayoutCharacter &getCharacter(size_t i) const;
+
+    void resizePositionX(size_t characterCount);
+    void setPositionX(size_t i, float positionX, uint32_t lineNumber);
+    float getPreviousPositionX(size_t i) const;
+    uint32_t getPreviousLineNumber(size_t i) const;
+    void getLineRange(uint32_t lineNumber, size_t &start, size_t &end) const;
+    size_t getCharacterIndex(size_t start, size_t end, float x) const;
+
+    static bool isBreakOpportunity(uint32_t character);
+
+private:
+    std::vector<TgFontTextLayoutCharacter>m_listCharacter;
+    std::vector<float>m_listPositionX;      /*!< x position of each character, not positioned character has previous character's x */
+    std::vector<uint32_t>m_listLineNumber;  /*!< line number (0 == first line) of each character, ascending */
+    size_t m_validCount;                    /*!< characters before this index are up to date in m_listCharacter */
+
+    static size_t getGlyphIndex(const TgFontInfo *newInfo, uint32_t character);
+};
+
+#endif // TG_FONT_TEXT_LAYOUT_H
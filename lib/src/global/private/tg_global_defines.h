@@ -1,6 +1,8 @@
 #ifndef TG_GLOBAL_DEFINES
 #define TG_GLOBAL_DEFINES
 
+#include <cstdint>
+
 #define IMAGES_PATH     "/usr/share/prj-tg-ui-lib/images"
 
 /*!
@@ -14,6 +16,19 @@ struct Vertice
     float s, t;
 };
 
+/*!
+ * \brief The VerticeColor struct
+ *
+ * 2D texture vertice point with color,
+ * texts are drawn with these (all characters in one vertex buffer)
+ */
+struct VerticeColor
+{
+    float x, y;
+    float s, t;
+    uint8_t r, g, b, a;
+};
+
 #define TG_MENU_DEFAULT_HEIGHT                  24
 #define TG_MENU_DEFAULT_SUB_MENU_ARROW_HEIGHT   12
 #define TG_MENU_DEFAULT_SUB_MENU_ARROW_MARGIN   5
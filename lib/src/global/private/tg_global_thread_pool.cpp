@@ -0,0 +1,246 @@
+/*!
+ * \file
+ * \brief file tg_global_thread_pool.cpp
+ *
+ * worker thread pool for jobs that do not require OpenGL context,
+ * and one background thread for long jobs
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_global_thread_pool.h"
+#include <algorithm>
+#include "../tg_global_log.h"
+
+TgGlobalThreadPool::TgGlobalThreadPool() :
+    m_nextJobGroup(1),
+    m_exit(false)
+{
+}
+
+/*!
+ * \brief TgGlobalThreadPool::~TgGlobalThreadPool
+ *
+ * worker threads (and background thread) run all queued jobs before
+ * they end, so futures of the jobs are always ready (never broken promise)
+ */
+TgGlobalThreadPool::~TgGlobalThreadPool()
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    m_mutex.lock();
+    m_exit = true;
+    m_mutex.unlock();
+    m_cv.notify_all();
+    m_backgroundCv.notify_all();
+    for (i=0;i<m_listThread.size();i++) {
+        m_listThread[i].join();
+    }
+    m_listThread.clear();
+    if (m_backgroundThread.joinable()) {
+        m_backgroundThread.join();
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgGlobalThreadPool::getThreadCount
+ *
+ * \return count of worker threads
+ */
+size_t TgGlobalThreadPool::getThreadCount()
+{
+    size_t ret = std::thread::hardware_concurrency();
+    return ret ? ret : 1;
+}
+
+/*!
+ * \brief TgGlobalThreadPool::start
+ *
+ * starts the worker threads, if they are not started yet
+ * m_mutex must be locked before calling this
+ */
+void TgGlobalThreadPool::start()
+{
+    size_t i, c;
+    if (!m_listThread.empty()) {
+        return;
+    }
+    c = getThreadCount();
+    for (i=0;i<c;i++) {
+        m_listThread.push_back(std::thread(&TgGlobalThreadPool::run, this));
+    }
+}
+
+/*!
+ * \brief TgGlobalThreadPool::createJobGroup
+ *
+ * creates new job group, jobs of the batch are added with the same
+ * job group, so waitJobs() runs only them on the calling thread
+ *
+ * \return job group id (never 0)
+ */
+uint64_t TgGlobalThreadPool::createJobGroup()
+{
+    m_mutex.lock();
+    uint64_t ret = m_nextJobGroup++;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgGlobalThreadPool::addJob
+ *
+ * adds job to be run on worker thread, job must not use OpenGL
+ *
+ * \param job
+ * \param jobGroup job group from createJobGroup(), or 0 if the job
+ * is not waited with waitJobs()
+ * \return future of the job, it can be used to wait the job
+ */
+std::future<void> TgGlobalThreadPool::addJob(const std::function<void()> &job, uint64_t jobGroup)
+{
+    TgGlobalThreadPoolJob poolJob;
+    poolJob.m_task = std::packaged_task<void()>(job);
+    poolJob.m_jobGroup = jobGroup;
+    std::future<void> ret = poolJob.m_task.get_future();
+    m_mutex.lock();
+    if (m_exit) {
+        m_mutex.unlock();
+        poolJob.m_task();
+        return ret;
+    }
+    start();
+    m_listJob.push_back(std::move(poolJob));
+    m_mutex.unlock();
+    m_cv.notify_one();
+    return ret;
+}
+
+/*!
+ * \brief TgGlobalThreadPool::addBackgroundJob
+ *
+ * adds long job (for example splitting large image into tiles) to be run
+ * on the background thread, so it does not block worker threads from
+ * the other jobs, job must not use OpenGL
+ *
+ * \param job
+ * \return future of the job
+ */
+std::future<void> TgGlobalThreadPool::addBackgroundJob(const std::function<void()> &job)
+{
+    std::packaged_task<void()> task(job);
+    std::future<void> ret = task.get_future();
+    m_mutex.lock();
+    if (m_exit) {
+        m_mutex.unlock();
+        task();
+        return ret;
+    }
+    if (!m_backgroundThread.joinable()) {
+        m_backgroundThread = std::thread(&TgGlobalThreadPool::runBackground, this);
+    }
+    m_listBackgroundJob.push_back(std::move(task));
+    m_mutex.unlock();
+    m_backgroundCv.notify_one();
+    return ret;
+}
+
+/*!
+ * \brief TgGlobalThreadPool::runPendingJob
+ *
+ * runs one pending job of the job group (if there is any) on calling thread,
+ * jobs of the other callers are never run here, because calling thread
+ * may hold locks that those jobs need, or it must not be blocked by them
+ *
+ * \param jobGroup job group
+ * \return true if job was run
+ */
+bool TgGlobalThreadPool::runPendingJob(uint64_t jobGroup)
+{
+    if (!jobGroup) {
+        return false;
+    }
+    m_mutex.lock();
+    std::deque<TgGlobalThreadPoolJob>::iterator it = std::find_if(m_listJob.begin(), m_listJob.end(), [jobGroup](const TgGlobalThreadPoolJob &job) {
+        return job.m_jobGroup == jobGroup;
+    });
+    if (it == m_listJob.end()) {
+        m_mutex.unlock();
+        return false;
+    }
+    std::packaged_task<void()> task = std::move(it->m_task);
+    m_listJob.erase(it);
+    m_mutex.unlock();
+    task();
+    return true;
+}
+
+/*!
+ * \brief TgGlobalThreadPool::waitJobs
+ *
+ * waits until all jobs in listJob are done, calling thread runs pending
+ * jobs of the same job group while waiting, so this can be called
+ * also from the job itself
+ *
+ * \param listJob
+ * \param jobGroup job group that jobs of listJob were added with,
+ * if 0, then calling thread only waits
+ */
+void TgGlobalThreadPool::waitJobs(std::vector<std::future<void>> &listJob, uint64_t jobGroup)
+{
+    size_t i;
+    for (i=0;i<listJob.size();i++) {
+        if (!listJob[i].valid()) {
+            continue;
+        }
+        while (listJob[i].wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runPendingJob(jobGroup)) {
+                listJob[i].wait();
+            }
+        }
+        listJob[i].get();
+    }
+}
+
+/*!
+ * \brief TgGlobalThreadPool::run
+ *
+ * worker thread loop
+ */
+void TgGlobalThreadPool::run()
+{
+    while (1) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return m_exit || !m_listJob.empty(); });
+        if (m_listJob.empty()) {
+            return;
+        }
+        std::packaged_task<void()> task = std::move(m_listJob.front().m_task);
+        m_listJob.pop_front();
+        lock.unlock();
+        task();
+    }
+}
+
+/*!
+ * \brief TgGlobalThreadPool::runBackground
+ *
+ * background thread loop
+ */
+void TgGlobalThreadPool::runBackground()
+{
+    while (1) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_backgroundCv.wait(lock, [this] { return m_exit || !m_listBackgroundJob.empty(); });
+        if (m_listBackgroundJob.empty()) {
+            return;
+        }
+        std::packaged_task<void()> task = std::move(m_listBackgroundJob.front());
+        m_listBackgroundJob.pop_front();
+        lock.unlock();
+        task();
+    }
+}
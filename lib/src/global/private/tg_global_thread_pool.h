@@ -0,0 +1,63 @@
+/*!
+ * \file
+ * \brief file tg_global_thread_pool.h
+ *
+ * worker thread pool for jobs that do not require OpenGL context,
+ * and one background thread for long jobs
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_GLOBAL_THREAD_POOL_H
+#define TG_GLOBAL_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <functional>
+#include <condition_variable>
+
+/*!
+ * \brief TgGlobalThreadPoolJob
+ * queued job and the job group it belongs to
+ */
+struct TgGlobalThreadPoolJob
+{
+    std::packaged_task<void()> m_task;
+    uint64_t m_jobGroup;    /*!< 0 if job does not belong to any job group */
+};
+
+class TgGlobalThreadPool
+{
+public:
+    explicit TgGlobalThreadPool();
+    ~TgGlobalThreadPool();
+
+    uint64_t createJobGroup();
+    std::future<void> addJob(const std::function<void()> &job, uint64_t jobGroup = 0);
+    std::future<void> addBackgroundJob(const std::function<void()> &job);
+    void waitJobs(std::vector<std::future<void>> &listJob, uint64_t jobGroup = 0);
+    size_t getThreadCount();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<TgGlobalThreadPoolJob>m_listJob;
+    std::vector<std::thread>m_listThread;
+    std::condition_variable m_backgroundCv;
+    std::deque<std::packaged_task<void()>>m_listBackgroundJob;
+    std::thread m_backgroundThread;
+    uint64_t m_nextJobGroup;
+    bool m_exit;
+
+    void start();
+    void run();
+    void runBackground();
+    bool runPendingJob(uint64_t jobGroup);
+};
+
+#endif // TG_GLOBAL_THREAD_POOL_H
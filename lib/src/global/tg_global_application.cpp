@@ -96,6 +96,20 @@ TgFontGlyphCacheData *TgGlobalApplication::getFontGlyphCacheData()
     return &m_fontGlyphCacheData;
 }
 
+/*!
+ * \brief TgGlobalApplication::getFontGlyphDiskCache
+ *
+ * get font glyph disk cache
+ *
+ * \return global font glyph disk cache
+ */
+TgFontGlyphDiskCache *TgGlobalApplication::getFontGlyphDiskCache()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return &m_fontGlyphDiskCache;
+}
+
 
 /*!
  * \brief TgGlobalApplication::getFontCharactersCache
@@ -126,6 +140,34 @@ TgFontDefault *TgGlobalApplication::getFontDefault()
     return &m_fontDefault;
 }
 
+/*!
+ * \brief TgGlobalApplication::getFontTextCache
+ *
+ * get cache of laid-out texts, shared between the items
+ *
+ * \return global font text cache
+ */
+TgFontTextCache *TgGlobalApplication::getFontTextCache()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return &m_fontTextCache;
+}
+
+/*!
+ * \brief TgGlobalApplication::getThreadPool
+ *
+ * get worker thread pool, for jobs that do not use OpenGL
+ *
+ * \return global worker thread pool
+ */
+TgGlobalThreadPool *TgGlobalApplication::getThreadPool()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return &m_threadPool;
+}
+
 /*!
  * \brief TgGlobalApplication::addMainWindow
  *
@@ -18,8 +18,11 @@
 #include <mutex>
 #include "../font/cache/tg_font_glyph_cache.h"
 #include "../font/cache/tg_font_glyph_cache_data.h"
+#include "../font/cache/tg_font_glyph_disk_cache.h"
 #include "../font/cache/tg_font_characters_cache.h"
+#include "../font/cache/tg_font_text_cache.h"
 #include "../font/tg_font_default.h"
+#include "private/tg_global_thread_pool.h"
 
 class TgMainWindow;
 #ifdef USE_GLFW
@@ -40,8 +43,11 @@ public:
     TgImageAssets *getImageAssets();
     TgFontGlyphCache *getFontGlyphCache();
     TgFontGlyphCacheData *getFontGlyphCacheData();
+    TgFontGlyphDiskCache *getFontGlyphDiskCache();
     TgFontCharactersCache *getFontCharactersCache();
     TgFontDefault *getFontDefault();
+    TgFontTextCache *getFontTextCache();
+    TgGlobalThreadPool *getThreadPool();
 #ifdef USE_GLFW
     void addEvent(GLFWwindow *window, const TgEventData *eventData);
 #else
@@ -54,10 +60,13 @@ private:
     static TgGlobalApplication *m_globalApplication;
     bool m_exit;
     TgImageAssets m_imageAssets;
+    TgFontGlyphDiskCache m_fontGlyphDiskCache;
     TgFontGlyphCache m_fontGlyphCache;
     TgFontGlyphCacheData m_fontGlyphCacheData;
     TgFontCharactersCache m_fontCharactersCache;
     TgFontDefault m_fontDefault;
+    TgFontTextCache m_fontTextCache;
+    TgGlobalThreadPool m_threadPool;  // declared last, so worker threads end before caches are destroyed
     std::recursive_mutex m_mutex;
 
     std::vector<TgMainWindow *>m_listMainWindow;
@@ -10,10 +10,24 @@
  */
 
 #include "tg_image_assets.h"
+#include <algorithm>
+#include <iterator>
+#include <cstring>
 #include "../global/tg_global_log.h"
+#include "../application/tg_application.h"
+#include "../global/tg_global_application.h"
+#include "../global/private/tg_global_wait_renderer.h"
 #include "tg_image_load.h"
+#include "tg_image_texture_file.h"
 
-TgImageAssets::TgImageAssets()
+TgImageAssets::TgImageAssets() :
+    m_cacheBudget(TG_IMAGE_ASSETS_DEFAULT_CACHE_BUDGET),
+    m_residentByteCount(0),
+    m_unusedByteCount(0),
+    m_hitCount(0),
+    m_missCount(0),
+    m_evictionCount(0),
+    m_loadRequestCount(0)
 {
     TG_FUNCTION_BEGIN();
     TG_FUNCTION_END();
@@ -22,29 +36,332 @@ TgImageAssets::TgImageAssets()
 TgImageAssets::~TgImageAssets()
 {
     TG_FUNCTION_BEGIN();
-    std::vector<TgImageAsset>::iterator it;
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it;
     for (it=m_listImages.begin();it!=m_listImages.end();it++) {
-        if (it->m_textureIndex) {
-            glDeleteTextures(1, &it->m_textureIndex);
+        if (it->second.m_asset.m_textureIndex && !it->second.m_asset.m_inAtlas) {
+            glDeleteTextures(1, &it->second.m_asset.m_textureIndex);
         }
-        clear(&(*it));
+        clear(&it->second.m_asset);
     }
     m_listImages.clear();
+    m_listUnused.clear();
+    m_mutex.lock();
+    m_listReleased.clear();
+    for (size_t i=0;i<m_listDecoded.size();i++) {
+        delete[] m_listDecoded[i].m_imageData;
+    }
+    m_listDecoded.clear();
+    m_mutex.unlock();
     TG_FUNCTION_END();
 }
 
+/*!
+ * \brief TgImageAssets::deleteImage
+ *
+ * removes image from the cache and deletes its texture,
+ * even if other assets still use it
+ *
+ * \param asset [in/out] image asset, texture index is set to 0
+ * \return true if image was found and deleted
+ */
 bool TgImageAssets::deleteImage(TgImageAsset &asset)
 {
-    std::vector<TgImageAsset>::iterator it;
-    for (it=m_listImages.begin();it!=m_listImages.end();it++) {
-        if (it->m_textureIndex == asset.m_textureIndex) {
-            glDeleteTextures(1, &it->m_textureIndex);
-            clear(&(*it));
-            m_listImages.erase(it);
+    TG_FUNCTION_BEGIN();
+    if (!asset.m_textureIndex) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = m_listImages.find(getCacheKey(asset, asset.m_inAtlas));
+    if (it == m_listImages.end() || it->second.m_asset.m_textureIndex != asset.m_textureIndex) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    removeImage(it);
+    if (asset.m_type == TgImageType::GeneratedImage) {
+        // image data was owned by the cache
+        asset.m_imageData.m_generatedImage.m_imageData = nullptr;
+    }
+    asset.m_textureIndex = 0;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageAssets::releaseImage
+ *
+ * releases the asset's reference to the image, can be called
+ * from any thread. Reference is released on OpenGL thread
+ * in releasePendingImages(). Image that is not used anymore is kept
+ * in the cache until cache budget is exceeded, generated image is deleted
+ *
+ * \param asset image asset that was given to generateImage()
+ */
+void TgImageAssets::releaseImage(const TgImageAsset &asset)
+{
+    TG_FUNCTION_BEGIN();
+    if (!asset.m_textureIndex) {
+        TG_FUNCTION_END();
+        return;
+    }
+    std::string key = getCacheKey(asset, asset.m_inAtlas);
+    m_mutex.lock();
+    m_listReleased.push_back(key);
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageAssets::releasePendingImages
+ *
+ * releases references given with releaseImage() and
+ * evicts least recently used images while cache budget is exceeded,
+ * must be called on OpenGL thread
+ */
+void TgImageAssets::releasePendingImages()
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<std::string> listReleased;
+    m_mutex.lock();
+    listReleased.swap(m_listReleased);
+    m_mutex.unlock();
+    for (i=0;i<listReleased.size();i++) {
+        releaseReference(listReleased[i]);
+    }
+    evictUnusedImages();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageAssets::setCacheBudget
+ *
+ * sets texture memory budget, images that are not used by any asset are
+ * deleted (least recently used first) while the textures take more memory than this.
+ * Atlas pages are not counted, because their images are never evicted
+ *
+ * \param byteCount budget in bytes
+ */
+void TgImageAssets::setCacheBudget(size_t byteCount)
+{
+    m_cacheBudget = byteCount;
+}
+
+/*!
+ * \brief TgImageAssets::getCacheBudget
+ *
+ * \return texture memory budget in bytes
+ */
+size_t TgImageAssets::getCacheBudget() const
+{
+    return m_cacheBudget;
+}
+
+/*!
+ * \brief TgImageAssets::getCacheStatistics
+ *
+ * \param statistics [out] cache counters
+ */
+void TgImageAssets::getCacheStatistics(TgImageCacheStatistics &statistics) const
+{
+    statistics.m_residentByteCount = m_residentByteCount + m_atlas.getByteCount();
+    statistics.m_unusedByteCount = m_unusedByteCount;
+    statistics.m_budgetByteCount = m_cacheBudget;
+    statistics.m_imageCount = m_listImages.size();
+    statistics.m_hitCount = m_hitCount;
+    statistics.m_missCount = m_missCount;
+    statistics.m_evictionCount = m_evictionCount;
+}
+
+/*!
+ * \brief TgImageAssets::getCacheKey
+ *
+ * \param asset image asset
+ * \param inAtlas true to get key of the image in atlas
+ * \return key of the image in m_listImages
+ */
+std::string TgImageAssets::getCacheKey(const TgImageAsset &asset, bool inAtlas)
+{
+    switch (asset.m_type) {
+        case TgImageType::PlainImage:
+            return std::string(inAtlas ? "pa" : "pt")
+                + std::to_string(static_cast<uint32_t>(asset.m_imageData.m_plainImage.r) << 24
+                                 | static_cast<uint32_t>(asset.m_imageData.m_plainImage.g) << 16
+                                 | static_cast<uint32_t>(asset.m_imageData.m_plainImage.b) << 8
+                                 | static_cast<uint32_t>(asset.m_imageData.m_plainImage.a));
+        case TgImageType::LoadedImage:
+            return std::string(inAtlas ? "la" : (asset.m_mipmaps ? "lm" : "lt")) + asset.m_filename;
+        case TgImageType::GeneratedImage:
+            // generated image is never shared
+            return "g" + std::to_string(asset.m_textureIndex);
+        case TgImageType::ImageTypeNA:
+        default:
+            return std::string();
+    }
+}
+
+/*!
+ * \brief TgImageAssets::findImage
+ *
+ * finds plain or loaded image from the cache,
+ * image in atlas is preferred if asset allows atlas,
+ * image with mip levels is never in atlas
+ *
+ * \param asset image asset
+ * \return iterator to the image, m_listImages.end() if not found
+ */
+std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator TgImageAssets::findImage(const TgImageAsset &asset)
+{
+    if (asset.m_type != TgImageType::PlainImage && asset.m_type != TgImageType::LoadedImage) {
+        return m_listImages.end();
+    }
+    if (asset.m_atlasAllowed && !asset.m_mipmaps) {
+        std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = m_listImages.find(getCacheKey(asset, true));
+        if (it != m_listImages.end()) {
+            return it;
         }
-        return true;
     }
-    return false;
+    return m_listImages.find(getCacheKey(asset, false));
+}
+
+/*!
+ * \brief TgImageAssets::acquireImage
+ *
+ * adds reference to cached image
+ *
+ * \param it image in the cache
+ * \param asset [in/out] image asset, texture index, area and size are set
+ * \return texture index
+ */
+GLuint TgImageAssets::acquireImage(std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it, TgImageAsset &asset)
+{
+    TgImageAssetCacheEntry &entry = it->second;
+    if (entry.m_unused) {
+        m_listUnused.erase(entry.m_unusedIterator);
+        m_unusedByteCount -= entry.m_byteCount;
+        entry.m_unused = false;
+    }
+    entry.m_referenceCount++;
+    m_hitCount++;
+    setTextureArea(asset, entry.m_asset);
+    if (asset.m_type == TgImageType::LoadedImage) {
+        asset.m_imageData.m_loadedImage.m_width = entry.m_asset.m_imageData.m_loadedImage.m_width;
+        asset.m_imageData.m_loadedImage.m_height = entry.m_asset.m_imageData.m_loadedImage.m_height;
+        asset.m_loadPending = false;
+    }
+    return asset.m_textureIndex;
+}
+
+/*!
+ * \brief TgImageAssets::addImage
+ *
+ * adds image into the cache
+ *
+ * \param asset image, cache takes ownership of its image data
+ * \param byteCount texture memory of the image, 0 if image is in atlas
+ * \param referenceCount number of assets using the image
+ */
+void TgImageAssets::addImage(const TgImageAsset &asset, size_t byteCount, uint32_t referenceCount)
+{
+    const std::string key = getCacheKey(asset, asset.m_inAtlas);
+    TgImageAssetCacheEntry &entry = m_listImages[key];
+    entry.m_asset = asset;
+    entry.m_referenceCount = referenceCount;
+    entry.m_byteCount = byteCount;
+    m_residentByteCount += byteCount;
+    if (!referenceCount) {
+        setUnused(entry, key);
+    }
+}
+
+/*!
+ * \brief TgImageAssets::removeImage
+ *
+ * deletes image's texture and data, and removes it from the cache
+ *
+ * \param it image in the cache
+ */
+void TgImageAssets::removeImage(std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it)
+{
+    TgImageAssetCacheEntry &entry = it->second;
+    if (entry.m_unused) {
+        m_listUnused.erase(entry.m_unusedIterator);
+        m_unusedByteCount -= entry.m_byteCount;
+    }
+    // atlas page is shared with other images
+    if (entry.m_asset.m_textureIndex && entry.m_asset.m_inAtlas) {
+        m_atlas.releaseImage(entry.m_asset.m_textureIndex);
+    } else if (entry.m_asset.m_textureIndex) {
+        glDeleteTextures(1, &entry.m_asset.m_textureIndex);
+    }
+    m_residentByteCount -= entry.m_byteCount;
+    clear(&entry.m_asset);
+    m_listImages.erase(it);
+}
+
+/*!
+ * \brief TgImageAssets::releaseReference
+ *
+ * removes reference from cached image, generated image is
+ * deleted when it's not used anymore, other images are moved
+ * to least recently used list
+ *
+ * \param key key of the image
+ */
+void TgImageAssets::releaseReference(const std::string &key)
+{
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = m_listImages.find(key);
+    if (it == m_listImages.end() || !it->second.m_referenceCount) {
+        return;
+    }
+    it->second.m_referenceCount--;
+    if (it->second.m_referenceCount) {
+        return;
+    }
+    if (it->second.m_asset.m_type == TgImageType::GeneratedImage) {
+        removeImage(it);
+        return;
+    }
+    setUnused(it->second, key);
+}
+
+/*!
+ * \brief TgImageAssets::setUnused
+ *
+ * adds image to the end of least recently used list,
+ * image in atlas stays in the cache, because atlas area is not reused
+ *
+ * \param entry image in the cache
+ * \param key key of the image
+ */
+void TgImageAssets::setUnused(TgImageAssetCacheEntry &entry, const std::string &key)
+{
+    if (entry.m_unused || entry.m_asset.m_inAtlas) {
+        return;
+    }
+    m_listUnused.push_back(key);
+    entry.m_unusedIterator = std::prev(m_listUnused.end());
+    entry.m_unused = true;
+    m_unusedByteCount += entry.m_byteCount;
+}
+
+/*!
+ * \brief TgImageAssets::evictUnusedImages
+ *
+ * deletes least recently used images that are not used
+ * while texture memory (also atlas pages) exceeds cache budget
+ */
+void TgImageAssets::evictUnusedImages()
+{
+    // atlas page is freed when all of its images are evicted
+    while (m_residentByteCount + m_atlas.getByteCount() > m_cacheBudget && !m_listUnused.empty()) {
+        std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = m_listImages.find(m_listUnused.front());
+        if (it == m_listImages.end()) {
+            m_listUnused.pop_front();
+            continue;
+        }
+        removeImage(it);
+        m_evictionCount++;
+    }
 }
 
 /**
@@ -64,6 +381,11 @@ void TgImageAssets::clear(TgImageAsset *asset)
             }
             break;
         case TgImageType::LoadedImage:
+            if (asset->m_imageData.m_loadedImage.m_imageData) {
+                delete[] asset->m_imageData.m_loadedImage.m_imageData;
+                asset->m_imageData.m_loadedImage.m_imageData = nullptr;
+            }
+            break;
         case TgImageType::PlainImage:
         case TgImageType::ImageTypeNA:
         default:
@@ -72,9 +394,10 @@ void TgImageAssets::clear(TgImageAsset *asset)
 }
 
 /*!
- * \brief TgImageAssets::generatePlainImage
+ * \brief TgImageAssets::generateImage
  *
- * generates image by image asset
+ * generates image by image asset, or gets it from the cache.
+ * Asset holds reference to the image until it's given to releaseImage()
  *
  * \param asset
  * \return generated image texture id
@@ -83,10 +406,7 @@ GLuint TgImageAssets::generateImage(TgImageAsset &asset)
 {
     switch (asset.m_type) {
         case TgImageType::PlainImage:
-            return generatePlainImage(asset.m_imageData.m_plainImage.r,
-                                      asset.m_imageData.m_plainImage.g,
-                                      asset.m_imageData.m_plainImage.b,
-                                      asset.m_imageData.m_plainImage.a);
+            return generatePlainImage(asset);
         case TgImageType::LoadedImage:
             return loadImage(asset);
         case TgImageType::GeneratedImage:
@@ -102,36 +422,27 @@ GLuint TgImageAssets::generateImage(TgImageAsset &asset)
  *
  * generates plain image
  *
- * \param r red
- * \param g green
- * \param b blue
- * \param a alpha
+ * \param asset [in/out] image asset, color is read from m_plainImage
+ * and texture index and area are set
  * \return texture index
  */
-GLuint TgImageAssets::generatePlainImage(const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a)
+GLuint TgImageAssets::generatePlainImage(TgImageAsset &asset)
 {
     TG_FUNCTION_BEGIN();
-    std::vector<TgImageAsset>::const_iterator it;
-    for (it=m_listImages.begin();it!=m_listImages.end();it++) {
-        if (it->m_type == TgImageType::PlainImage
-            && it->m_imageData.m_plainImage.r == r
-            && it->m_imageData.m_plainImage.g == g
-            && it->m_imageData.m_plainImage.b == b
-            && it->m_imageData.m_plainImage.a == a) {
-            return it->m_textureIndex;
-        }
+    const unsigned char r = asset.m_imageData.m_plainImage.r;
+    const unsigned char g = asset.m_imageData.m_plainImage.g;
+    const unsigned char b = asset.m_imageData.m_plainImage.b;
+    const unsigned char a = asset.m_imageData.m_plainImage.a;
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = findImage(asset);
+    if (it != m_listImages.end()) {
+        TG_FUNCTION_END();
+        return acquireImage(it, asset);
     }
+    m_missCount++;
     int x, y, i = 0;
     const int width = 2;
     const int height = 2;
     unsigned char* imageData = nullptr;
-    TgImageAsset asset;
-    asset.m_textureIndex = 0;
-    asset.m_type = TgImageType::PlainImage;
-    asset.m_imageData.m_plainImage.r = r;
-    asset.m_imageData.m_plainImage.g = g;
-    asset.m_imageData.m_plainImage.b = b;
-    asset.m_imageData.m_plainImage.a = a;
 
     imageData = new unsigned char[width*height*4];
     for (x=0;x<width;x++) {
@@ -143,13 +454,21 @@ GLuint TgImageAssets::generatePlainImage(const unsigned char r, const unsigned c
         }
     }
 
-    asset.m_textureIndex = setImageDataToTexture(imageData, width, height);
+    setImageDataToAtlasOrTexture(asset, imageData, width, height);
 
     delete[]imageData;
     if (!asset.m_textureIndex) {
+        TG_FUNCTION_END();
         return asset.m_textureIndex;
     }
-    m_listImages.push_back(asset);
+    TgImageAsset newAsset;
+    newAsset.m_type = TgImageType::PlainImage;
+    newAsset.m_imageData.m_plainImage.r = r;
+    newAsset.m_imageData.m_plainImage.g = g;
+    newAsset.m_imageData.m_plainImage.b = b;
+    newAsset.m_imageData.m_plainImage.a = a;
+    setTextureArea(newAsset, asset);
+    addImage(newAsset, newAsset.m_inAtlas ? 0 : static_cast<size_t>(width*height*4), 1);
     TG_FUNCTION_END();
     return asset.m_textureIndex;
 }
@@ -157,49 +476,251 @@ GLuint TgImageAssets::generatePlainImage(const unsigned char r, const unsigned c
 /*!
  * \brief TgImageAssets::loadImage
  *
- * loads image and sets it as texture
+ * loads image and sets it as texture, pre-baked texture file
+ * (image.tgtex next to image.png) is used instead of png if it exists
  *
  * \param asset image assets
- * \return texture index
+ * \return texture index, 0 if image is not loaded (yet)
  */
 GLuint TgImageAssets::loadImage(TgImageAsset &asset)
 {
     TG_FUNCTION_BEGIN();
-    std::vector<TgImageAsset>::const_iterator it;
-    for (it=m_listImages.begin();it!=m_listImages.end();it++) {
-        if (it->m_type == TgImageType::LoadedImage
-            && it->m_textureIndex > 0
-            && asset.m_filename.compare(it->m_filename) == 0) {
-            asset.m_imageData.m_loadedImage.m_width = it->m_imageData.m_loadedImage.m_width;
-            asset.m_imageData.m_loadedImage.m_height = it->m_imageData.m_loadedImage.m_height;
-            return it->m_textureIndex;
+    if (asset.m_loadFailed) {
+        TG_FUNCTION_END();
+        return 0;
+    }
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it = findImage(asset);
+    if (it != m_listImages.end()) {
+        TG_FUNCTION_END();
+        return acquireImage(it, asset);
+    }
+    // texture file does not need decoding, so it's not loaded on the worker thread
+    std::string textureFileName = TgImageTextureFile::findTextureFile(asset.m_filename);
+    if (!textureFileName.empty()) {
+        GLuint ret = loadTextureFile(asset, textureFileName);
+        if (ret) {
+            TG_FUNCTION_END();
+            return ret;
         }
     }
+    if (asset.m_asyncLoad) {
+        TG_FUNCTION_END();
+        return loadImageAsync(asset);
+    }
+    m_missCount++;
     unsigned char *imageData = TgImageLoad::loadPng(asset.m_filename.c_str(),
                                                     asset.m_imageData.m_loadedImage.m_width,
                                                     asset.m_imageData.m_loadedImage.m_height);
+    // failed image is not loaded again on next frames
     if (!imageData) {
+        asset.m_loadFailed = true;
+        TG_FUNCTION_END();
         return 0;
     }
 
+    GLuint ret = addLoadedImage(asset, imageData, asset.m_imageData.m_loadedImage.m_width, asset.m_imageData.m_loadedImage.m_height, 1);
+    if (!ret) {
+        asset.m_loadFailed = true;
+    }
+
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgImageAssets::loadImageAsync
+ *
+ * starts decoding the image on the worker thread, if it's not started yet,
+ * decoded image is uploaded as texture in uploadDecodedImages()
+ * and loadImage() finds it from the cache after that
+ *
+ * failed decoding fails only the assets that were waiting for that decode
+ * request, asset that is set again (m_loadPending is false) starts new request
+ *
+ * \param asset [in/out] image asset, m_loadPending is true while image is decoded
+ * and m_loadFailed is set if decoding failed
+ * \return 0
+ */
+GLuint TgImageAssets::loadImageAsync(TgImageAsset &asset)
+{
+    TG_FUNCTION_BEGIN();
+    std::unordered_map<std::string, uint64_t>::iterator it;
+    if (asset.m_loadPending) {
+        it = m_listFailedLoad.find(asset.m_filename);
+        if (it != m_listFailedLoad.end() && asset.m_loadRequest <= it->second) {
+            asset.m_loadPending = false;
+            asset.m_loadFailed = true;
+            TG_FUNCTION_END();
+            return 0;
+        }
+    }
+    it = m_listPendingLoad.find(asset.m_filename);
+    if (it != m_listPendingLoad.end()) {
+        asset.m_loadPending = true;
+        asset.m_loadRequest = it->second;
+        TG_FUNCTION_END();
+        return 0;
+    }
+    std::string filename = asset.m_filename;
+    bool mipmaps = asset.m_mipmaps;
+    uint64_t loadRequest = ++m_loadRequestCount;
+    m_missCount++;
+    m_listPendingLoad[filename] = loadRequest;
+    asset.m_loadPending = true;
+    asset.m_loadRequest = loadRequest;
+    TgGlobalApplication::getInstance()->getThreadPool()->addJob([this, filename, mipmaps, loadRequest]() {
+        decodeImage(filename, mipmaps, loadRequest);
+    });
+    TG_FUNCTION_END();
+    return 0;
+}
+
+/*!
+ * \brief TgImageAssets::loadTextureFile
+ *
+ * maps pre-baked texture file and uploads it directly from the file,
+ * CPU copy of the image is not kept, it's read back from texture if needed
+ *
+ * \param asset [in/out] image asset, texture index and size are set
+ * \param textureFileName texture file
+ * \return texture index, 0 if fails
+ */
+GLuint TgImageAssets::loadTextureFile(TgImageAsset &asset, const std::string &textureFileName)
+{
+    TG_FUNCTION_BEGIN();
+    TgImageTextureFile textureFile;
+    uint32_t width, height;
+    if (!textureFile.open(textureFileName)) {
+        TG_FUNCTION_END();
+        return 0;
+    }
+    m_missCount++;
+    const unsigned char *imageData = textureFile.getLevel(0, width, height);
+    // atlas has no mip levels, so only level 0 is used for atlas
+    if (!asset.m_atlasAllowed || asset.m_mipmaps
+        || !setImageDataToAtlas(asset, imageData, static_cast<int>(width), static_cast<int>(height))) {
+        asset.m_textureIndex = setTextureFileToTexture(textureFile, asset.m_mipmaps);
+        setTextureAreaToFullTexture(asset);
+    }
+    asset.m_imageData.m_loadedImage.m_width = static_cast<int>(width);
+    asset.m_imageData.m_loadedImage.m_height = static_cast<int>(height);
+    if (!asset.m_textureIndex) {
+        TG_FUNCTION_END();
+        return 0;
+    }
     TgImageAsset newAsset;
-    newAsset.m_textureIndex = 0;
+    setTextureArea(newAsset, asset);
     newAsset.m_type = TgImageType::LoadedImage;
     newAsset.m_filename = asset.m_filename;
-    newAsset.m_textureIndex = setImageDataToTexture(imageData, asset.m_imageData.m_loadedImage.m_width, asset.m_imageData.m_loadedImage.m_height);
-    asset.m_textureIndex = newAsset.m_textureIndex;
+    newAsset.m_mipmaps = asset.m_mipmaps;
+    newAsset.m_imageData.m_loadedImage.m_imageData = nullptr;
     newAsset.m_imageData.m_loadedImage.m_width = asset.m_imageData.m_loadedImage.m_width;
     newAsset.m_imageData.m_loadedImage.m_height = asset.m_imageData.m_loadedImage.m_height;
+    if (newAsset.m_inAtlas) {
+        addImage(newAsset, 0, 1);
+    } else if (textureFile.getLevelCount() == 1) {
+        addImage(newAsset, getTextureByteCount(static_cast<int>(width), static_cast<int>(height), newAsset.m_mipmaps), 1);
+    } else {
+        addImage(newAsset, textureFile.getByteCount(), 1);
+    }
+    TG_FUNCTION_END();
+    return newAsset.m_textureIndex;
+}
 
-    delete[] imageData;
+/*!
+ * \brief TgImageAssets::decodeImage
+ *
+ * decodes the png image on the worker thread, and adds it
+ * to wait the texture upload
+ *
+ * \param filename png filename
+ * \param mipmaps true if texture gets mip levels when it's uploaded
+ * \param loadRequest decode request
+ */
+void TgImageAssets::decodeImage(const std::string &filename, bool mipmaps, uint64_t loadRequest)
+{
+    TG_FUNCTION_BEGIN();
+    TgImageDecodeResult result;
+    result.m_filename = filename;
+    result.m_mipmaps = mipmaps;
+    result.m_loadRequest = loadRequest;
+    result.m_width = 0;
+    result.m_height = 0;
+    result.m_imageData = TgImageLoad::loadPng(filename.c_str(), result.m_width, result.m_height);
+    m_mutex.lock();
+    m_listDecoded.push_back(result);
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
 
-    if (!newAsset.m_textureIndex) {
-        return newAsset.m_textureIndex;
+/*!
+ * \brief TgImageAssets::uploadDecodedImages
+ *
+ * uploads images decoded on the worker thread as textures,
+ * must be called on OpenGL thread
+ */
+void TgImageAssets::uploadDecodedImages()
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    std::vector<TgImageDecodeResult> listDecoded;
+    m_mutex.lock();
+    listDecoded.swap(m_listDecoded);
+    m_mutex.unlock();
+    for (i=0;i<listDecoded.size();i++) {
+        TgImageAsset asset;
+        asset.m_textureIndex = 0;
+        asset.m_type = TgImageType::LoadedImage;
+        asset.m_filename = listDecoded[i].m_filename;
+        asset.m_mipmaps = listDecoded[i].m_mipmaps;
+        m_listPendingLoad.erase(asset.m_filename);
+        // image can be loaded meanwhile without asynchronous loading
+        if (!listDecoded[i].m_imageData) {
+            m_listFailedLoad[asset.m_filename] = listDecoded[i].m_loadRequest;
+        } else if (findImage(asset) != m_listImages.end()) {
+            delete[] listDecoded[i].m_imageData;
+        } else if (!addLoadedImage(asset, listDecoded[i].m_imageData, listDecoded[i].m_width, listDecoded[i].m_height, 0)) {
+            m_listFailedLoad[asset.m_filename] = listDecoded[i].m_loadRequest;
+        } else {
+            m_listFailedLoad.erase(asset.m_filename);
+        }
     }
-    m_listImages.push_back(newAsset);
-
     TG_FUNCTION_END();
-    return asset.m_textureIndex;
+}
+
+/*!
+ * \brief TgImageAssets::addLoadedImage
+ *
+ * sets loaded image data as texture and adds it into the cache,
+ * image data is kept as CPU copy of the image for later modifications
+ *
+ * \param asset [in/out] image asset, texture index and size are set
+ * \param imageData image data (RGBA), ownership moves to TgImageAssets
+ * \param width width of image (imageData)
+ * \param height height of image (imageData)
+ * \param referenceCount 1 if asset uses the image, 0 if image is only cached
+ * \return texture index, 0 if fails
+ */
+GLuint TgImageAssets::addLoadedImage(TgImageAsset &asset, unsigned char *imageData, int width, int height, uint32_t referenceCount)
+{
+    TgImageAsset newAsset;
+    setImageDataToAtlasOrTexture(asset, imageData, width, height);
+    setTextureArea(newAsset, asset);
+    newAsset.m_type = TgImageType::LoadedImage;
+    newAsset.m_filename = asset.m_filename;
+    newAsset.m_mipmaps = asset.m_mipmaps;
+    newAsset.m_imageData.m_loadedImage.m_imageData = imageData;
+    newAsset.m_imageData.m_loadedImage.m_width = width;
+    newAsset.m_imageData.m_loadedImage.m_height = height;
+    asset.m_imageData.m_loadedImage.m_width = width;
+    asset.m_imageData.m_loadedImage.m_height = height;
+    if (!newAsset.m_textureIndex) {
+        delete[] imageData;
+        return 0;
+    }
+    addImage(newAsset, newAsset.m_inAtlas ? 0 : getTextureByteCount(width, height, newAsset.m_mipmaps), referenceCount);
+    return newAsset.m_textureIndex;
 }
 
 /*!
@@ -215,22 +736,116 @@ GLuint TgImageAssets::setImageGenerated(TgImageAsset &asset)
     TgImageAsset newAsset;
     newAsset.m_textureIndex = 0;
     newAsset.m_type = TgImageType::GeneratedImage;
+    newAsset.m_mipmaps = asset.m_mipmaps;
     newAsset.m_imageData.m_generatedImage.m_imageData = asset.m_imageData.m_generatedImage.m_imageData;
-    newAsset.m_textureIndex = setImageDataToTexture(asset.m_imageData.m_generatedImage.m_imageData, asset.m_imageData.m_generatedImage.m_width, asset.m_imageData.m_generatedImage.m_height);
+    newAsset.m_textureIndex = setImageDataToTexture(asset.m_imageData.m_generatedImage.m_imageData, asset.m_imageData.m_generatedImage.m_width, asset.m_imageData.m_generatedImage.m_height, asset.m_mipmaps);
     asset.m_textureIndex = newAsset.m_textureIndex;
+    setTextureAreaToFullTexture(asset);
     newAsset.m_imageData.m_generatedImage.m_width = asset.m_imageData.m_generatedImage.m_width;
     newAsset.m_imageData.m_generatedImage.m_height = asset.m_imageData.m_generatedImage.m_height;
 
     if (!newAsset.m_textureIndex) {
         return newAsset.m_textureIndex;
     }
-    m_listImages.push_back(newAsset);
+    addImage(newAsset, getTextureByteCount(newAsset.m_imageData.m_generatedImage.m_width,
+                                           newAsset.m_imageData.m_generatedImage.m_height, newAsset.m_mipmaps), 1);
 
     TG_FUNCTION_END();
     return asset.m_textureIndex;
 }
 
 
+/*!
+ * \brief TgImageAssets::setImageDataToAtlasOrTexture
+ *
+ * adds small image into atlas if asset allows it and
+ * image has no mip levels, otherwise image gets own texture
+ *
+ * \param asset [in/out] image asset, texture index and area are set
+ * \param imageData image data (RGBA)
+ * \param width width of image (imageData)
+ * \param height height of image (imageData)
+ * \return texture index, 0 if fails
+ */
+GLuint TgImageAssets::setImageDataToAtlasOrTexture(TgImageAsset &asset, const unsigned char *imageData, int width, int height)
+{
+    TG_FUNCTION_BEGIN();
+    if (asset.m_atlasAllowed && !asset.m_mipmaps && setImageDataToAtlas(asset, imageData, width, height)) {
+        TG_FUNCTION_END();
+        return asset.m_textureIndex;
+    }
+    asset.m_textureIndex = setImageDataToTexture(imageData, width, height, asset.m_mipmaps);
+    setTextureAreaToFullTexture(asset);
+    TG_FUNCTION_END();
+    return asset.m_textureIndex;
+}
+
+/*!
+ * \brief TgImageAssets::setImageDataToAtlas
+ *
+ * adds small image into atlas
+ *
+ * \param asset [in/out] image asset, texture index and area are set if image was added
+ * \param imageData image data (RGBA)
+ * \param width width of image (imageData)
+ * \param height height of image (imageData)
+ * \return false if image does not fit into atlas
+ */
+bool TgImageAssets::setImageDataToAtlas(TgImageAsset &asset, const unsigned char *imageData, int width, int height)
+{
+    TgImageAtlasArea area;
+    if (!m_atlas.addImage(imageData, width, height, area)) {
+        return false;
+    }
+    asset.m_textureIndex = area.m_textureIndex;
+    asset.m_inAtlas = true;
+    asset.m_atlasX = area.m_x;
+    asset.m_atlasY = area.m_y;
+    asset.m_textureLeft = area.m_textureLeft;
+    asset.m_textureTop = area.m_textureTop;
+    asset.m_textureRight = area.m_textureRight;
+    asset.m_textureBottom = area.m_textureBottom;
+    return true;
+}
+
+/*!
+ * \brief TgImageAssets::setTextureArea
+ *
+ * copies texture index and texture area from source
+ *
+ * \param asset [out] image asset
+ * \param source image asset
+ */
+void TgImageAssets::setTextureArea(TgImageAsset &asset, const TgImageAsset &source)
+{
+    asset.m_textureIndex = source.m_textureIndex;
+    asset.m_inAtlas = source.m_inAtlas;
+    asset.m_atlasX = source.m_atlasX;
+    asset.m_atlasY = source.m_atlasY;
+    asset.m_textureLeft = source.m_textureLeft;
+    asset.m_textureTop = source.m_textureTop;
+    asset.m_textureRight = source.m_textureRight;
+    asset.m_textureBottom = source.m_textureBottom;
+}
+
+/*!
+ * \brief TgImageAssets::setTextureAreaToFullTexture
+ *
+ * sets image to use whole texture (image is not in atlas)
+ *
+ * \param asset [out] image asset
+ */
+void TgImageAssets::setTextureAreaToFullTexture(TgImageAsset &asset)
+{
+    asset.m_inAtlas = false;
+    asset.m_atlasX = 0;
+    asset.m_atlasY = 0;
+    asset.m_textureLeft = 0;
+    asset.m_textureTop = 0;
+    asset.m_textureRight = 1;
+    asset.m_textureBottom = 1;
+}
+
 /*!
  * \brief TgImageAssets::setImageDataToTexture
  *
@@ -239,8 +854,10 @@ GLuint TgImageAssets::setImageGenerated(TgImageAsset &asset)
  * \param imageData image data (RGBA)
  * \param width width of image (imageData)
  * \param height height of image (imageData)
+ * \param mipmaps if true, mip levels are generated and
+ * scaled down image is drawn with trilinear filtering
  */
-GLuint TgImageAssets::setImageDataToTexture(const unsigned char *imageData, int width, int height)
+GLuint TgImageAssets::setImageDataToTexture(const unsigned char *imageData, int width, int height, bool mipmaps)
 {
     GLuint textureIndex;
     TG_FUNCTION_BEGIN();
@@ -260,41 +877,161 @@ GLuint TgImageAssets::setImageDataToTexture(const unsigned char *imageData, int
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    if (mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
     TG_FUNCTION_END();
     return textureIndex;
 }
 
-/**
- * @brief TgImageAssets::modifyTexture
+/*!
+ * \brief TgImageAssets::setTextureFileToTexture
  *
- * modify texture data
+ * uploads all levels of texture file into texture, if file has
+ * mip levels then minified image is drawn with trilinear filtering
  *
- * @param imageData new image data of texture
- * @param width new image width of texture
- * @param height new image height of texture
- * @param textureIndex texture index
+ * \param textureFile opened texture file
+ * \param mipmaps if true and file has no mip levels, mip levels are generated
+ * \return texture index, 0 if fails
  */
-void TgImageAssets::modifyTexture(const unsigned char *imageData, int width, int height, GLuint textureIndex)
+GLuint TgImageAssets::setTextureFileToTexture(const TgImageTextureFile &textureFile, bool mipmaps)
 {
+    GLuint textureIndex;
+    uint32_t level, width, height;
     TG_FUNCTION_BEGIN();
+    glGenTextures(1, &textureIndex);
+
+    if (!textureIndex) {
+        TG_ERROR_LOG("Failed to create texture");
+        TG_FUNCTION_END();
+        return 0;
+    }
+
     glBindTexture(GL_TEXTURE_2D, textureIndex);
 
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, textureFile.getLevelCount() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    if (textureFile.getLevelCount() > 1) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(textureFile.getLevelCount() - 1));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    for (level=0;level<textureFile.getLevelCount();level++) {
+        const unsigned char *imageData = textureFile.getLevel(level, width, height);
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA, static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    }
+    if (mipmaps && textureFile.getLevelCount() == 1) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
+    TG_FUNCTION_END();
+    return textureIndex;
+}
+
+/**
+ * @brief TgImageAssets::modifyTexture
+ *
+ * modify area of texture data, only the area is uploaded
+ *
+ * @param imageData image data of whole texture
+ * @param width image width of texture
+ * @param height image height of texture
+ * @param textureIndex texture index
+ * @param areaX x position of modified area
+ * @param areaY y position of modified area
+ * @param areaWidth width of modified area
+ * @param areaHeight height of modified area
+ */
+void TgImageAssets::modifyTexture(const unsigned char *imageData, int width, int height, GLuint textureIndex,
+                                  int areaX, int areaY, int areaWidth, int areaHeight)
+{
+    TG_FUNCTION_BEGIN();
+    if (areaX < 0 || areaY < 0 || areaWidth <= 0 || areaHeight <= 0
+        || areaX + areaWidth > width || areaY + areaHeight > height) {
+        TG_FUNCTION_END();
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, textureIndex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, areaX);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, areaY);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, areaX, areaY, areaWidth, areaHeight, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
     TG_FUNCTION_END();
 }
 
+/*!
+ * \brief TgImageAssets::updateMipmaps
+ *
+ * regenerates mip levels after texture is modified, or sets
+ * filtering when mip levels are enabled/disabled for the image
+ *
+ * \param asset image asset, nothing is done for image in atlas
+ */
+void TgImageAssets::updateMipmaps(const TgImageAsset &asset)
+{
+    TG_FUNCTION_BEGIN();
+    if (!asset.m_textureIndex || asset.m_inAtlas) {
+        TG_FUNCTION_END();
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, asset.m_textureIndex);
+    if (asset.m_mipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    } else {
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageAssets::getTextureByteCount
+ *
+ * \param width width of image
+ * \param height height of image
+ * \param mipmaps true if texture has mip levels
+ * \return texture memory of the image, mip levels add about one third
+ */
+size_t TgImageAssets::getTextureByteCount(int width, int height, bool mipmaps)
+{
+    size_t ret = static_cast<size_t>(width)*static_cast<size_t>(height)*4;
+    return mipmaps ? ret + ret/3 : ret;
+}
+
+/**
+ * @brief TgImageAssets::getLoadedImageData
+ *
+ * gets CPU copy of loaded image
+ *
+ * @param asset loaded image
+ * @return image data (RGBA), nullptr if not found
+ */
+const unsigned char *TgImageAssets::getLoadedImageData(const TgImageAsset &asset) const
+{
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::const_iterator it = m_listImages.find(getCacheKey(asset, asset.m_inAtlas));
+    if (it == m_listImages.end()
+        || it->second.m_asset.m_type != TgImageType::LoadedImage
+        || it->second.m_asset.m_textureIndex != asset.m_textureIndex) {
+        return nullptr;
+    }
+    return it->second.m_asset.m_imageData.m_loadedImage.m_imageData;
+}
+
 /**
  * @brief TgImageAssets::convertLoadedImageToGeneratedImage
  *
  * converts loaded image to generated image
  *
- * @param asset [in/out] TgImageAsset is modified from LoadedImage to GeneratedImage
- * and asset is also added to m_listImages
+ * @param asset [in/out] TgImageAsset is modified from LoadedImage to GeneratedImage,
+ * generated image is added to the cache and reference to loaded image is released
  * @return GLuint 0 if fails
  */
 GLuint TgImageAssets::convertLoadedImageToGeneratedImage(TgImageAsset &asset)
@@ -308,24 +1045,35 @@ GLuint TgImageAssets::convertLoadedImageToGeneratedImage(TgImageAsset &asset)
     int width = asset.m_imageData.m_loadedImage.m_width;
     int height = asset.m_imageData.m_loadedImage.m_height;
     unsigned char *imageData = new unsigned char[width*height*4];
+    const unsigned char *loadedImageData = getLoadedImageData(asset);
 
-    glBindTexture(GL_TEXTURE_2D, asset.m_textureIndex);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    if (loadedImageData) {
+        memcpy(imageData, loadedImageData, static_cast<size_t>(width)*static_cast<size_t>(height)*4);
+    } else if (asset.m_inAtlas) {
+        m_atlas.readImage(asset.m_textureIndex, asset.m_atlasX, asset.m_atlasY, width, height, imageData);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, asset.m_textureIndex);
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, imageData);
+    }
 
-    GLuint textureIndex = setImageDataToTexture(imageData, width, height);
+    GLuint textureIndex = setImageDataToTexture(imageData, width, height, asset.m_mipmaps);
     if (!textureIndex) {
         delete[]imageData;
         TG_FUNCTION_END();
         return 0;
     }
-    m_listImages.push_back(TgImageAsset());
-    m_listImages.back().m_textureIndex = textureIndex;
-    m_listImages.back().m_type = TgImageType::GeneratedImage;
-    m_listImages.back().m_imageData.m_generatedImage.m_imageData = imageData;
-    m_listImages.back().m_imageData.m_generatedImage.m_width = width;
-    m_listImages.back().m_imageData.m_generatedImage.m_height = height;
+    TgImageAsset generatedAsset;
+    generatedAsset.m_textureIndex = textureIndex;
+    generatedAsset.m_type = TgImageType::GeneratedImage;
+    generatedAsset.m_mipmaps = asset.m_mipmaps;
+    generatedAsset.m_imageData.m_generatedImage.m_imageData = imageData;
+    generatedAsset.m_imageData.m_generatedImage.m_width = width;
+    generatedAsset.m_imageData.m_generatedImage.m_height = height;
+    addImage(generatedAsset, getTextureByteCount(width, height, asset.m_mipmaps), 1);
+    releaseReference(getCacheKey(asset, asset.m_inAtlas));
 
     asset.m_textureIndex = textureIndex;
+    setTextureAreaToFullTexture(asset);
     asset.m_type = TgImageType::GeneratedImage;
     asset.m_imageData.m_generatedImage.m_imageData = imageData;
     asset.m_imageData.m_generatedImage.m_width = width;
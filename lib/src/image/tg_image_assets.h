@@ -15,7 +15,17 @@
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <vector>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include "tg_image_atlas.h"
+
+#define TG_IMAGE_ASSETS_DEFAULT_CACHE_BUDGET (128*1024*1024)
+
+struct TgImageCacheStatistics;
+class TgImageTextureFile;
 
 enum TgImageType
 {
@@ -30,6 +40,19 @@ struct TgImageAsset
     GLuint m_textureIndex;
     TgImageType m_type;
     std::string m_filename;
+    bool m_asyncLoad = false;       /*!< LoadedImage is decoded on the worker thread */
+    bool m_loadPending = false;     /*!< LoadedImage is still being decoded on the worker thread */
+    bool m_loadFailed = false;      /*!< LoadedImage could not be loaded, it's not loaded again until image is set again */
+    uint64_t m_loadRequest = 0;     /*!< decode request of the LoadedImage while m_loadPending is true */
+    bool m_atlasAllowed = true;     /*!< small LoadedImage or PlainImage can be packed into shared atlas texture */
+    bool m_mipmaps = false;         /*!< LoadedImage or GeneratedImage texture has mip levels, it's never in atlas */
+    bool m_inAtlas = false;         /*!< m_textureIndex is atlas page, image is at m_atlasX/m_atlasY */
+    int m_atlasX = 0;
+    int m_atlasY = 0;
+    float m_textureLeft = 0;        /*!< area (S/T) of the image in texture m_textureIndex */
+    float m_textureTop = 0;
+    float m_textureRight = 1;
+    float m_textureBottom = 1;
 
     union {
         struct {
@@ -39,6 +62,7 @@ struct TgImageAsset
             unsigned char a;
         } m_plainImage;
         struct {
+            uint8_t *m_imageData;   /*!< CPU copy of the image, only set in TgImageAssets cache */
             int m_width;
             int m_height;
         } m_loadedImage;
@@ -48,6 +72,47 @@ struct TgImageAsset
             int m_height;
         } m_generatedImage;
     } m_imageData;
+
+    /*!
+     * \brief getTextureS
+     * \param s texture S of the image (0 - 1)
+     * \return texture S in m_textureIndex
+     */
+    float getTextureS(float s) const { return m_textureLeft + s*(m_textureRight - m_textureLeft); }
+
+    /*!
+     * \brief getTextureT
+     * \param t texture T of the image (0 - 1)
+     * \return texture T in m_textureIndex
+     */
+    float getTextureT(float t) const { return m_textureTop + t*(m_textureBottom - m_textureTop); }
+};
+
+/*!
+ * \brief TgImageDecodeResult
+ * png image decoded on the worker thread, waiting for the texture upload
+ */
+struct TgImageDecodeResult
+{
+    std::string m_filename;
+    unsigned char *m_imageData;     /*!< RGBA, nullptr if decoding failed */
+    int m_width;
+    int m_height;
+    bool m_mipmaps;
+    uint64_t m_loadRequest;         /*!< decode request, see TgImageAsset::m_loadRequest */
+};
+
+/*!
+ * \brief TgImageAssetCacheEntry
+ * image in TgImageAssets cache
+ */
+struct TgImageAssetCacheEntry
+{
+    TgImageAsset m_asset;
+    uint32_t m_referenceCount = 0;                  /*!< number of assets (items) using the image */
+    size_t m_byteCount = 0;                         /*!< texture memory of the image, 0 if image is in atlas */
+    bool m_unused = false;                          /*!< image is in TgImageAssets::m_listUnused */
+    std::list<std::string>::iterator m_unusedIterator;
 };
 
 class TgImageAssets
@@ -57,19 +122,62 @@ public:
     ~TgImageAssets();
 
     GLuint generateImage(TgImageAsset &asset);
+    void releaseImage(const TgImageAsset &asset);
     bool deleteImage(TgImageAsset &asset);
     GLuint convertLoadedImageToGeneratedImage(TgImageAsset &asset);
-    void modifyTexture(const unsigned char *imageData, int width, int height, GLuint textureIndex);
+    void modifyTexture(const unsigned char *imageData, int width, int height, GLuint textureIndex,
+                       int areaX, int areaY, int areaWidth, int areaHeight);
+    void updateMipmaps(const TgImageAsset &asset);
+    void uploadDecodedImages();
+    void releasePendingImages();
+
+    void setCacheBudget(size_t byteCount);
+    size_t getCacheBudget() const;
+    void getCacheStatistics(TgImageCacheStatistics &statistics) const;
 
 private:
-    std::vector<TgImageAsset>m_listImages;
+    std::unordered_map<std::string, TgImageAssetCacheEntry>m_listImages;  /*!< images by getCacheKey() */
+    std::list<std::string>m_listUnused;             /*!< keys of images that no asset uses, least recently used first */
+    std::vector<std::string>m_listReleased;         /*!< keys released by releaseImage(), m_mutex must be locked */
+    size_t m_cacheBudget;
+    size_t m_residentByteCount;                     /*!< texture memory of images that are not in atlas */
+    size_t m_unusedByteCount;
+    uint64_t m_hitCount;
+    uint64_t m_missCount;
+    uint64_t m_evictionCount;
+    TgImageAtlas m_atlas;
+    std::unordered_map<std::string, uint64_t>m_listPendingLoad; /*!< decode request of the files that are being decoded on the worker thread */
+    std::unordered_map<std::string, uint64_t>m_listFailedLoad;  /*!< latest decode request of the files that failed to decode */
+    uint64_t m_loadRequestCount;
+    std::vector<TgImageDecodeResult>m_listDecoded;  /*!< decoded images waiting for upload, m_mutex must be locked */
+    std::mutex m_mutex;
 
-    GLuint generatePlainImage(const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a);
+    GLuint generatePlainImage(TgImageAsset &asset);
     GLuint loadImage(TgImageAsset &asset);
-    GLuint setImageDataToTexture(const unsigned char *imageData, int width, int height);
+    std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator findImage(const TgImageAsset &asset);
+    GLuint acquireImage(std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it, TgImageAsset &asset);
+    void addImage(const TgImageAsset &asset, size_t byteCount, uint32_t referenceCount);
+    void removeImage(std::unordered_map<std::string, TgImageAssetCacheEntry>::iterator it);
+    void releaseReference(const std::string &key);
+    void setUnused(TgImageAssetCacheEntry &entry, const std::string &key);
+    void evictUnusedImages();
+    GLuint loadImageAsync(TgImageAsset &asset);
+    GLuint loadTextureFile(TgImageAsset &asset, const std::string &textureFileName);
+    GLuint addLoadedImage(TgImageAsset &asset, unsigned char *imageData, int width, int height, uint32_t referenceCount);
+    const unsigned char *getLoadedImageData(const TgImageAsset &asset) const;
+    void decodeImage(const std::string &filename, bool mipmaps, uint64_t loadRequest);
+    GLuint setImageDataToTexture(const unsigned char *imageData, int width, int height, bool mipmaps);
     GLuint setImageGenerated(TgImageAsset &asset);
 
+    GLuint setImageDataToAtlasOrTexture(TgImageAsset &asset, const unsigned char *imageData, int width, int height);
+    bool setImageDataToAtlas(TgImageAsset &asset, const unsigned char *imageData, int width, int height);
+    static GLuint setTextureFileToTexture(const TgImageTextureFile &textureFile, bool mipmaps);
+
     static void clear(TgImageAsset *asset);
+    static std::string getCacheKey(const TgImageAsset &asset, bool inAtlas);
+    static void setTextureArea(TgImageAsset &asset, const TgImageAsset &source);
+    static void setTextureAreaToFullTexture(TgImageAsset &asset);
+    static size_t getTextureByteCount(int width, int height, bool mipmaps);
 };
 
 #endif // TG_IMAGE_ASSETS_H
@@ -0,0 +1,237 @@
+/*!
+ * \file
+ * \brief file tg_image_atlas.cpp
+ *
+ * it packs small images into shared texture pages
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_image_atlas.h"
+#include <cstring>
+#include "../global/tg_global_log.h"
+
+TgImageAtlas::TgImageAtlas()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgImageAtlas::~TgImageAtlas()
+{
+    TG_FUNCTION_BEGIN();
+    for (size_t i=0;i<m_listPage.size();i++) {
+        glDeleteTextures(1, &m_listPage[i].m_textureIndex);
+    }
+    m_listPage.clear();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageAtlas::isImageSizeAllowed
+ *
+ * \param width width of image
+ * \param height height of image
+ * \return true if image is small enough to be added into atlas
+ */
+bool TgImageAtlas::isImageSizeAllowed(int width, int height)
+{
+    return width > 0 && height > 0
+        && width <= TG_IMAGE_ATLAS_MAX_IMAGE_SIZE
+        && height <= TG_IMAGE_ATLAS_MAX_IMAGE_SIZE;
+}
+
+/*!
+ * \brief TgImageAtlas::addImage
+ *
+ * adds image into first atlas page that has room for it,
+ * image's edge pixels are repeated around the image, so
+ * neighbour images are not sampled at image edge
+ *
+ * \param imageData image data (RGBA)
+ * \param width width of image (imageData)
+ * \param height height of image (imageData)
+ * \param area [out] area of the image in atlas
+ * \return true on success, false if image is too large or page can't be created
+ */
+bool TgImageAtlas::addImage(const unsigned char *imageData, int width, int height, TgImageAtlasArea &area)
+{
+    TG_FUNCTION_BEGIN();
+    if (!isImageSizeAllowed(width, height)) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    int x = 0, y = 0;
+    size_t i;
+    for (i=0;i<m_listPage.size();i++) {
+        if (m_listPage[i].m_shelf.reserveArea(width + TG_IMAGE_ATLAS_PADDING*2, height + TG_IMAGE_ATLAS_PADDING*2, x, y)) {
+            break;
+        }
+    }
+    if (i == m_listPage.size()) {
+        if (!addPage()
+            || !m_listPage.back().m_shelf.reserveArea(width + TG_IMAGE_ATLAS_PADDING*2, height + TG_IMAGE_ATLAS_PADDING*2, x, y)) {
+            TG_FUNCTION_END();
+            return false;
+        }
+    }
+    uploadImage(m_listPage[i], imageData, width, height, x, y);
+    m_listPage[i].m_imageCount++;
+
+    const float pageSize = static_cast<float>(TG_IMAGE_ATLAS_PAGE_SIZE);
+    area.m_textureIndex = m_listPage[i].m_textureIndex;
+    area.m_x = x + TG_IMAGE_ATLAS_PADDING;
+    area.m_y = y + TG_IMAGE_ATLAS_PADDING;
+    area.m_textureLeft = static_cast<float>(area.m_x)/pageSize;
+    area.m_textureTop = static_cast<float>(area.m_y)/pageSize;
+    area.m_textureRight = static_cast<float>(area.m_x + width)/pageSize;
+    area.m_textureBottom = static_cast<float>(area.m_y + height)/pageSize;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageAtlas::releaseImage
+ *
+ * releases image from the atlas page, area of the image is not
+ * reused, but page is deleted when it does not have images anymore
+ *
+ * \param textureIndex texture index of atlas page
+ */
+void TgImageAtlas::releaseImage(GLuint textureIndex)
+{
+    TG_FUNCTION_BEGIN();
+    for (size_t i=0;i<m_listPage.size();i++) {
+        if (m_listPage[i].m_textureIndex != textureIndex) {
+            continue;
+        }
+        if (m_listPage[i].m_imageCount) {
+            m_listPage[i].m_imageCount--;
+        }
+        if (!m_listPage[i].m_imageCount) {
+            glDeleteTextures(1, &m_listPage[i].m_textureIndex);
+            m_listPage.erase(m_listPage.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        break;
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageAtlas::getByteCount
+ *
+ * \return texture memory of all atlas pages
+ */
+size_t TgImageAtlas::getByteCount() const
+{
+    return m_listPage.size()*TG_IMAGE_ATLAS_PAGE_SIZE*TG_IMAGE_ATLAS_PAGE_SIZE*4;
+}
+
+/*!
+ * \brief TgImageAtlas::readImage
+ *
+ * reads image back from the atlas page
+ *
+ * \param textureIndex texture index of atlas page
+ * \param x x position of image in atlas page
+ * \param y y position of image in atlas page
+ * \param width width of image
+ * \param height height of image
+ * \param imageData [out] image data (RGBA), size must be width*height*4
+ * \return true on success
+ */
+bool TgImageAtlas::readImage(GLuint textureIndex, int x, int y, int width, int height, unsigned char *imageData)
+{
+    TG_FUNCTION_BEGIN();
+    if (x < 0 || y < 0 || width <= 0 || height <= 0
+        || x + width > TG_IMAGE_ATLAS_PAGE_SIZE || y + height > TG_IMAGE_ATLAS_PAGE_SIZE) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    const size_t pageRowSize = static_cast<size_t>(TG_IMAGE_ATLAS_PAGE_SIZE)*4;
+    const size_t rowSize = static_cast<size_t>(width)*4;
+    unsigned char *pageData = new unsigned char[pageRowSize*TG_IMAGE_ATLAS_PAGE_SIZE];
+    glBindTexture(GL_TEXTURE_2D, textureIndex);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pageData);
+    for (int i=0;i<height;i++) {
+        memcpy(imageData + rowSize*static_cast<size_t>(i),
+               pageData + pageRowSize*static_cast<size_t>(y + i) + static_cast<size_t>(x)*4,
+               rowSize);
+    }
+    delete[] pageData;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageAtlas::addPage
+ *
+ * creates new empty atlas page
+ *
+ * \return true on success
+ */
+bool TgImageAtlas::addPage()
+{
+    TG_FUNCTION_BEGIN();
+    TgImageAtlasPage page = { 0, TgImageAtlasShelf(TG_IMAGE_ATLAS_PAGE_SIZE), 0 };
+    glGenTextures(1, &page.m_textureIndex);
+    if (!page.m_textureIndex) {
+        TG_ERROR_LOG("Failed to create atlas texture");
+        TG_FUNCTION_END();
+        return false;
+    }
+    glBindTexture(GL_TEXTURE_2D, page.m_textureIndex);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TG_IMAGE_ATLAS_PAGE_SIZE, TG_IMAGE_ATLAS_PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    m_listPage.push_back(page);
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageAtlas::uploadImage
+ *
+ * uploads image with repeated edge pixels into atlas page
+ *
+ * \param page atlas page
+ * \param imageData image data (RGBA)
+ * \param width width of image (imageData)
+ * \param height height of image (imageData)
+ * \param x x position of the padded area
+ * \param y y position of the padded area
+ */
+void TgImageAtlas::uploadImage(const TgImageAtlasPage &page, const unsigned char *imageData, int width, int height, int x, int y)
+{
+    const int paddedWidth = width + TG_IMAGE_ATLAS_PADDING*2;
+    const int paddedHeight = height + TG_IMAGE_ATLAS_PADDING*2;
+    unsigned char *paddedData = new unsigned char[static_cast<size_t>(paddedWidth)*static_cast<size_t>(paddedHeight)*4];
+    int paddedX, paddedY, imageX, imageY;
+    for (paddedY=0;paddedY<paddedHeight;paddedY++) {
+        imageY = paddedY - TG_IMAGE_ATLAS_PADDING;
+        if (imageY < 0) {
+            imageY = 0;
+        } else if (imageY >= height) {
+            imageY = height - 1;
+        }
+        for (paddedX=0;paddedX<paddedWidth;paddedX++) {
+            imageX = paddedX - TG_IMAGE_ATLAS_PADDING;
+            if (imageX < 0) {
+                imageX = 0;
+            } else if (imageX >= width) {
+                imageX = width - 1;
+            }
+            memcpy(paddedData + (static_cast<size_t>(paddedY)*static_cast<size_t>(paddedWidth) + static_cast<size_t>(paddedX))*4,
+                   imageData + (static_cast<size_t>(imageY)*static_cast<size_t>(width) + static_cast<size_t>(imageX))*4,
+                   4);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, page.m_textureIndex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, paddedData);
+    delete[] paddedData;
+}
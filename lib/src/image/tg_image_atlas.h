@@ -0,0 +1,69 @@
+/*!
+ * \file
+ * \brief file tg_image_atlas.h
+ *
+ * it packs small images into shared texture pages
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+#ifndef TG_IMAGE_ATLAS_H
+#define TG_IMAGE_ATLAS_H
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <vector>
+#include <cstddef>
+#include "tg_image_atlas_shelf.h"
+
+#define TG_IMAGE_ATLAS_PAGE_SIZE 1024
+#define TG_IMAGE_ATLAS_MAX_IMAGE_SIZE 128
+#define TG_IMAGE_ATLAS_PADDING 1
+
+/*!
+ * \brief TgImageAtlasPage
+ * one atlas texture, images are placed into rows (shelves) from top to bottom
+ */
+struct TgImageAtlasPage
+{
+    GLuint m_textureIndex;
+    TgImageAtlasShelf m_shelf;
+    size_t m_imageCount;    /*!< number of images in the page, page is deleted when it's 0 */
+};
+
+/*!
+ * \brief TgImageAtlasArea
+ * area of the image in the atlas page
+ */
+struct TgImageAtlasArea
+{
+    GLuint m_textureIndex;
+    int m_x;
+    int m_y;
+    float m_textureLeft;
+    float m_textureTop;
+    float m_textureRight;
+    float m_textureBottom;
+};
+
+class TgImageAtlas
+{
+public:
+    TgImageAtlas();
+    ~TgImageAtlas();
+
+    static bool isImageSizeAllowed(int width, int height);
+    bool addImage(const unsigned char *imageData, int width, int height, TgImageAtlasArea &area);
+    void releaseImage(GLuint textureIndex);
+    bool readImage(GLuint textureIndex, int x, int y, int width, int height, unsigned char *imageData);
+    size_t getByteCount() const;
+
+private:
+    std::vector<TgImageAtlasPage>m_listPage;
+
+    bool addPage();
+    static void uploadImage(const TgImageAtlasPage &page, const unsigned char *imageData, int width, int height, int x, int y);
+};
+
+#endif // TG_IMAGE_ATLAS_H
@@ -0,0 +1,55 @@
+/*!
+ * \file
+ * \brief file tg_image_atlas_shelf.cpp
+ *
+ * it reserves areas of atlas page in rows (shelves)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_image_atlas_shelf.h"
+
+TgImageAtlasShelf::TgImageAtlasShelf(int pageSize) :
+    m_pageSize(pageSize),
+    m_shelfX(0),
+    m_shelfY(0),
+    m_shelfHeight(0)
+{
+}
+
+/*!
+ * \brief TgImageAtlasShelf::reserveArea
+ *
+ * reserves area from the page, area is added to current shelf
+ * or new shelf is started below the current shelf,
+ * shelves are not changed if page does not have room for the area
+ *
+ * \param width width of area
+ * \param height height of area
+ * \param x [out] x position of area
+ * \param y [out] y position of area
+ * \return true if page had room for the area
+ */
+bool TgImageAtlasShelf::reserveArea(int width, int height, int &x, int &y)
+{
+    int shelfX = m_shelfX;
+    int shelfY = m_shelfY;
+    int shelfHeight = m_shelfHeight;
+    if (shelfX + width > m_pageSize) {
+        shelfX = 0;
+        shelfY += shelfHeight;
+        shelfHeight = 0;
+    }
+    if (shelfX + width > m_pageSize
+        || shelfY + height > m_pageSize) {
+        return false;
+    }
+    x = shelfX;
+    y = shelfY;
+    m_shelfX = shelfX + width;
+    m_shelfY = shelfY;
+    m_shelfHeight = height > shelfHeight ? height : shelfHeight;
+    return true;
+}
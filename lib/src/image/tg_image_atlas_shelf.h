@@ -0,0 +1,32 @@
+/*!
+ * \file
+ * \brief file tg_image_atlas_shelf.h
+ *
+ * it reserves areas of atlas page in rows (shelves)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+#ifndef TG_IMAGE_ATLAS_SHELF_H
+#define TG_IMAGE_ATLAS_SHELF_H
+
+/*!
+ * \brief TgImageAtlasShelf
+ * areas are placed into rows (shelves) from top to bottom
+ */
+class TgImageAtlasShelf
+{
+public:
+    explicit TgImageAtlasShelf(int pageSize);
+
+    bool reserveArea(int width, int height, int &x, int &y);
+
+private:
+    int m_pageSize;
+    int m_shelfX;           /*!< next free x position on current shelf */
+    int m_shelfY;           /*!< y position of current shelf */
+    int m_shelfHeight;      /*!< height of the highest area on current shelf */
+};
+
+#endif // TG_IMAGE_ATLAS_SHELF_H
@@ -17,7 +17,8 @@
 /*!
  * \brief TgImageLoad::loadPng
  *
- * creates image data from rowPointers
+ * loads png image as RGBA, rows are decoded straight into the returned
+ * buffer and libpng converts palette, gray, 16 bit and RGB images to 8 bit RGBA
  *
  * \param filename png filename
  * \param width [out} width of image
@@ -30,6 +31,8 @@ unsigned char *TgImageLoad::loadPng(const char *filename, int &width, int &heigh
     png_structp png;
     png_infop info;
     png_bytep *rowPointers;
+    unsigned char *imageData;
+    size_t rowBytes;
     unsigned char header[8];    // 8 is the maximum size that can be checked
     FILE *fp = fopen(filename, "rb");
     if (!fp) {
@@ -61,84 +64,204 @@ unsigned char *TgImageLoad::loadPng(const char *filename, int &width, int &heigh
         return nullptr;
     }
 
+    if (setjmp(png_jmpbuf(png))) {
+        TG_ERROR_LOG("Png header read failed: ", filename);
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return nullptr;
+    }
+
     png_init_io(png, fp);
     png_set_sig_bytes(png, 8);
     png_read_info(png, info);
-    width = png_get_image_width(png, info);
-    height = png_get_image_height(png, info);
-    int colorType = png_get_color_type(png, info);
+    width = static_cast<int>(png_get_image_width(png, info));
+    height = static_cast<int>(png_get_image_height(png, info));
+    setTransformToRgba(png, info);
     png_read_update_info(png, info);
 
-
-    if (setjmp(png_jmpbuf(png))) {
-        TG_ERROR_LOG("setjmp failed");
+    rowBytes = png_get_rowbytes(png, info);
+    if (width <= 0 || height <= 0 || rowBytes != static_cast<size_t>(width)*4) {
+        TG_ERROR_LOG("Png image cannot be converted to RGBA: ", filename);
         fclose(fp);
         png_destroy_read_struct(&png, &info, nullptr);
         return nullptr;
     }
 
+    imageData = new unsigned char[rowBytes*static_cast<size_t>(height)];
     rowPointers = new png_bytep[height];
     for (int y=0;y<height;y++) {
-        rowPointers[y] = new png_byte[png_get_rowbytes(png, info)];
+        rowPointers[y] = imageData + rowBytes*static_cast<size_t>(y);
     }
-    png_read_image(png, rowPointers);
-    unsigned char *imageData = generateImageData(rowPointers, colorType, width, height);
-    if (!imageData) {
-        TG_ERROR_LOG("Filename: ", filename);
+
+    // imageData and rowPointers are not modified after this point, so they are valid on longjmp
+    if (setjmp(png_jmpbuf(png))) {
+        TG_ERROR_LOG("Png image read failed: ", filename);
+        delete[] rowPointers;
+        delete[] imageData;
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return nullptr;
     }
+
+    png_read_image(png, rowPointers);
+    png_read_end(png, nullptr);
     png_destroy_read_struct(&png, &info, nullptr);
-    for (int y=0;y<height;y++) {
-        delete[] rowPointers[y];
-    }
     delete[] rowPointers;
     fclose(fp);
     return imageData;
 }
 
 /*!
- * \brief TgImageLoad::generateImageData
+ * \brief TgImageLoad::readPngRows
  *
- * creates image data from rowPointers
+ * reads png image as RGBA one row at a time, so whole image
+ * is never in memory (except interlaced png, that is loaded with loadPng())
  *
- * \param rowPointers from png lib
- * \param colorType type of color
- * \param width width of image
- * \param height height of image
- * \return pointer of image data that is ready to go into glTexImage2D
+ * \param filename png filename
+ * \param imageSize called once before rows with image size, returning false stops reading
+ * \param imageRow called for each row from top to bottom (width*4 bytes), returning false stops reading
+ * \return true if all rows were read
  */
-unsigned char *TgImageLoad::generateImageData(const png_bytep *rowPointers, int colorType, int width, int height)
+bool TgImageLoad::readPngRows(const char *filename,
+                              const std::function<bool(int width, int height)> &imageSize,
+                              const std::function<bool(const unsigned char *row)> &imageRow)
 {
-    if (colorType != PNG_COLOR_TYPE_RGBA
-        && colorType != PNG_COLOR_TYPE_RGB) {
-        TG_ERROR_LOG("Png color type is not PNG_COLOR_TYPE_RGBA or PNG_COLOR_TYPE_RGB");
-        return nullptr;
+    png_structp png;
+    png_infop info;
+    unsigned char *row;
+    size_t rowBytes;
+    int width, height, y;
+    unsigned char header[8];    // 8 is the maximum size that can be checked
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        TG_ERROR_LOG("File could not open: ", filename);
+        return false;
+    }
+
+    if (fread(header, 1, 8, fp) != 8 ||
+        png_sig_cmp(header, 0, 8)) {
+        TG_ERROR_LOG("File is not png image: ", filename);
+        fclose(fp);
+        return false;
+    }
+
+    png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (!png) {
+        TG_ERROR_LOG("png_create_read_struct failed");
+        fclose(fp);
+        return false;
+    }
+
+    info = png_create_info_struct(png);
+    if (!info) {
+        TG_ERROR_LOG("png_create_info_struct failed");
+        fclose(fp);
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        return false;
+    }
+
+    if (setjmp(png_jmpbuf(png))) {
+        TG_ERROR_LOG("Png header read failed: ", filename);
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return false;
     }
-    int x, y;
-    png_byte *row;
-    png_byte *ptr;
-    unsigned char *ret = new unsigned char[width*height*4];
-    if (colorType == PNG_COLOR_TYPE_RGBA) {
-        for (y=0;y<height;y++) {
-            row = rowPointers[y];
-            for (x=0;x<width; x++) {
-                ptr = &(row[x*4]);
-                ret[y*width*4+x*4+0] = ptr[0];
-                ret[y*width*4+x*4+1] = ptr[1];
-                ret[y*width*4+x*4+2] = ptr[2];
-                ret[y*width*4+x*4+3] = ptr[3];
-            }
+
+    png_init_io(png, fp);
+    png_set_sig_bytes(png, 8);
+    png_read_info(png, info);
+    if (png_get_interlace_type(png, info) != PNG_INTERLACE_NONE) {
+        // rows of interlaced png are complete only after the last pass
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        unsigned char *imageData = loadPng(filename, width, height);
+        if (!imageData) {
+            return false;
         }
+        bool ret = imageSize(width, height);
+        for (y=0;y<height && ret;y++) {
+            ret = imageRow(imageData + static_cast<size_t>(y)*static_cast<size_t>(width)*4);
+        }
+        delete[] imageData;
         return ret;
     }
+    width = static_cast<int>(png_get_image_width(png, info));
+    height = static_cast<int>(png_get_image_height(png, info));
+    setTransformToRgba(png, info);
+    png_read_update_info(png, info);
+
+    rowBytes = png_get_rowbytes(png, info);
+    if (width <= 0 || height <= 0 || rowBytes != static_cast<size_t>(width)*4) {
+        TG_ERROR_LOG("Png image cannot be converted to RGBA: ", filename);
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return false;
+    }
+    if (!imageSize(width, height)) {
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return false;
+    }
+
+    row = new unsigned char[rowBytes];
+
+    // row is not modified after this point, so it's valid on longjmp
+    if (setjmp(png_jmpbuf(png))) {
+        TG_ERROR_LOG("Png image read failed: ", filename);
+        delete[] row;
+        fclose(fp);
+        png_destroy_read_struct(&png, &info, nullptr);
+        return false;
+    }
+
     for (y=0;y<height;y++) {
-        row = rowPointers[y];
-        for (x=0;x<width; x++) {
-            ptr = &(row[x*3]);
-            ret[y*width*4+x*4+0] = ptr[0];
-            ret[y*width*4+x*4+1] = ptr[1];
-            ret[y*width*4+x*4+2] = ptr[2];
-            ret[y*width*4+x*4+3] = 255;
+        png_read_row(png, row, nullptr);
+        if (!imageRow(row)) {
+            break;
         }
     }
-    return ret;
+    if (y == height) {
+        png_read_end(png, nullptr);
+    }
+    png_destroy_read_struct(&png, &info, nullptr);
+    delete[] row;
+    fclose(fp);
+    return y == height;
+}
+
+/*!
+ * \brief TgImageLoad::setTransformToRgba
+ *
+ * sets libpng transforms so every png color type and bit depth
+ * is read as 8 bit RGBA
+ *
+ * \param png png read struct
+ * \param info png info struct, png_read_info() must be called before
+ */
+void TgImageLoad::setTransformToRgba(png_structp png, png_infop info)
+{
+    png_byte colorType = png_get_color_type(png, info);
+    png_byte bitDepth = png_get_bit_depth(png, info);
+
+    if (bitDepth == 16) {
+        png_set_strip_16(png);
+    }
+    if (colorType == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png);
+    }
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png);
+    }
+    if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+        png_set_tRNS_to_alpha(png);
+    }
+    if (colorType == PNG_COLOR_TYPE_GRAY
+        || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_gray_to_rgb(png);
+    }
+    if (!(colorType & PNG_COLOR_MASK_ALPHA)
+        && !png_get_valid(png, info, PNG_INFO_tRNS)) {
+        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    }
+    png_set_interlace_handling(png);
 }
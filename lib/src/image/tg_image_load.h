@@ -12,14 +12,18 @@
 #define TG_IMAGE_LOAD_H
 
 #include <png.h>
+#include <functional>
 
 class TgImageLoad
 {
 public:
     static unsigned char *loadPng(const char *filename, int &width, int &height);
+    static bool readPngRows(const char *filename,
+                            const std::function<bool(int width, int height)> &imageSize,
+                            const std::function<bool(const unsigned char *row)> &imageRow);
 
 private:
-    static unsigned char *generateImageData(const png_bytep *rowPointers, int colorType, int width, int height);
+    static void setTransformToRgba(png_structp png, png_infop info);
 
 };
 
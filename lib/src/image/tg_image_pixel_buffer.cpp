@@ -0,0 +1,113 @@
+/*!
+ * \file
+ * \brief file tg_image_pixel_buffer.cpp
+ *
+ * it streams image data into textures through ring of pixel buffer objects
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_image_pixel_buffer.h"
+#include <cstring>
+#include "../global/tg_global_log.h"
+
+TgImagePixelBuffer::TgImagePixelBuffer(size_t pixelBufferCount) :
+    m_listPixelBufferObject(pixelBufferCount ? pixelBufferCount : 1, 0),
+    m_pixelBufferIndex(0)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgImagePixelBuffer::~TgImagePixelBuffer()
+{
+    TG_FUNCTION_BEGIN();
+    if (m_listPixelBufferObject[0]) {
+        glDeleteBuffers(static_cast<GLsizei>(m_listPixelBufferObject.size()), m_listPixelBufferObject.data());
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePixelBuffer::upload
+ *
+ * copies rows into pixel buffer object and uploads them into texture
+ * from there, so the transfer to GPU is asynchronous
+ *
+ * \param textureIndex texture index, texture size must be width * (rowStart+rowCount) or more
+ * \param imageData image data (RGBA) of whole image
+ * \param width width of image (imageData)
+ * \param rowStart first row to upload
+ * \param rowCount count of rows to upload
+ * \return true on success
+ */
+bool TgImagePixelBuffer::upload(GLuint textureIndex, const unsigned char *imageData, int width, int rowStart, int rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    if (!textureIndex || width <= 0 || rowStart < 0 || rowCount <= 0) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    const size_t rowSize = static_cast<size_t>(width)*4;
+    const size_t size = rowSize*static_cast<size_t>(rowCount);
+    const unsigned char *rowData = imageData + rowSize*static_cast<size_t>(rowStart);
+
+    glBindTexture(GL_TEXTURE_2D, textureIndex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    unsigned char *buffer = beginUpload(size);
+    if (!buffer) {
+        TG_WARNING_LOG("Failed to map pixel buffer, uploading without it");
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rowStart, width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, rowData);
+        TG_FUNCTION_END();
+        return true;
+    }
+    memcpy(buffer, rowData, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rowStart, width, rowCount, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    endUpload();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImagePixelBuffer::beginUpload
+ *
+ * binds next pixel buffer object of the ring and maps it for writing,
+ * previous storage is orphaned, so driver doesn't need to wait if it's still in use.
+ * After writing, caller unmaps the buffer with glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER),
+ * uploads the textures with buffer offsets and calls endUpload()
+ *
+ * \param size size of the data in bytes
+ * \return mapped buffer, or nullptr if mapping failed (then buffer is not bound)
+ */
+unsigned char *TgImagePixelBuffer::beginUpload(size_t size)
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_listPixelBufferObject[0]) {
+        glGenBuffers(static_cast<GLsizei>(m_listPixelBufferObject.size()), m_listPixelBufferObject.data());
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_listPixelBufferObject[m_pixelBufferIndex]);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+    void *buffer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!buffer) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    TG_FUNCTION_END();
+    return static_cast<unsigned char *>(buffer);
+}
+
+/*!
+ * \brief TgImagePixelBuffer::endUpload
+ *
+ * unbinds the pixel buffer object and moves to next one in the ring
+ */
+void TgImagePixelBuffer::endUpload()
+{
+    TG_FUNCTION_BEGIN();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_pixelBufferIndex = (m_pixelBufferIndex + 1) % m_listPixelBufferObject.size();
+    TG_FUNCTION_END();
+}
@@ -0,0 +1,37 @@
+/*!
+ * \file
+ * \brief file tg_image_pixel_buffer.h
+ *
+ * it streams image data into textures through ring of pixel buffer objects
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+#ifndef TG_IMAGE_PIXEL_BUFFER_H
+#define TG_IMAGE_PIXEL_BUFFER_H
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <cstddef>
+#include <vector>
+
+#define TG_IMAGE_PIXEL_BUFFER_DEFAULT_COUNT 2
+
+class TgImagePixelBuffer
+{
+public:
+    explicit TgImagePixelBuffer(size_t pixelBufferCount = TG_IMAGE_PIXEL_BUFFER_DEFAULT_COUNT);
+    ~TgImagePixelBuffer();
+
+    bool upload(GLuint textureIndex, const unsigned char *imageData, int width, int rowStart, int rowCount);
+
+    unsigned char *beginUpload(size_t size);
+    void endUpload();
+
+private:
+    std::vector<GLuint> m_listPixelBufferObject;
+    size_t m_pixelBufferIndex;
+};
+
+#endif // TG_IMAGE_PIXEL_BUFFER_H
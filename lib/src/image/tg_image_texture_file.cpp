@@ -0,0 +1,366 @@
+/*!
+ * \file
+ * \brief file tg_image_texture_file.cpp
+ *
+ * pre-baked texture file, RGBA image and its mip levels
+ * are memory mapped and uploaded without decoding
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_image_texture_file.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../global/tg_global_log.h"
+
+#define TG_IMAGE_TEXTURE_FILE_MAGIC         "TGTX"
+
+TgImageTextureFile::TgImageTextureFile() :
+    m_mapAddress(nullptr),
+    m_mapSize(0)
+{
+    TG_FUNCTION_BEGIN();
+    memset(&m_header, 0, sizeof(m_header));
+    TG_FUNCTION_END();
+}
+
+TgImageTextureFile::~TgImageTextureFile()
+{
+    TG_FUNCTION_BEGIN();
+    close();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageTextureFile::open
+ *
+ * memory maps the texture file
+ *
+ * \param textureFileName texture file
+ * \return false if file does not exist or it's not valid
+ */
+bool TgImageTextureFile::open(const std::string &textureFileName)
+{
+    TG_FUNCTION_BEGIN();
+    close();
+    int fd = ::open(textureFileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        TG_ERROR_LOG("File could not open: ", textureFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    struct stat fileStat;
+    TgImageTextureFileHeader header;
+    if (fstat(fd, &fileStat) != 0
+        || static_cast<size_t>(fileStat.st_size) < sizeof(header)
+        || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || memcmp(header.m_magic, TG_IMAGE_TEXTURE_FILE_MAGIC, sizeof(header.m_magic)) != 0
+        || header.m_version != TG_IMAGE_TEXTURE_FILE_VERSION
+        || header.m_format != TG_IMAGE_TEXTURE_FILE_FORMAT_RGBA
+        || !header.m_width || !header.m_height
+        || header.m_width > INT32_MAX || header.m_height > INT32_MAX
+        || !header.m_levelCount || header.m_levelCount > getMaxLevelCount(header.m_width, header.m_height)
+        || getLevelOffset(header.m_width, header.m_height, header.m_levelCount) != static_cast<uint64_t>(fileStat.st_size)) {
+        TG_WARNING_LOG("Texture file is not valid: ", textureFileName);
+        ::close(fd);
+        TG_FUNCTION_END();
+        return false;
+    }
+    const size_t mapSize = static_cast<size_t>(fileStat.st_size);
+    void *mapAddress = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapAddress == MAP_FAILED) {
+        TG_WARNING_LOG("Could not map texture file: ", textureFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    // levels are uploaded in file order right after opening
+    madvise(mapAddress, mapSize, MADV_SEQUENTIAL | MADV_WILLNEED);
+    m_mapAddress = mapAddress;
+    m_mapSize = mapSize;
+    m_header = header;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageTextureFile::close
+ *
+ * unmaps the texture file, level pointers are not valid after this
+ */
+void TgImageTextureFile::close()
+{
+    if (m_mapAddress) {
+        munmap(m_mapAddress, m_mapSize);
+        m_mapAddress = nullptr;
+        m_mapSize = 0;
+    }
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+/*!
+ * \brief TgImageTextureFile::getWidth
+ *
+ * \return width of the image, 0 if file is not open
+ */
+uint32_t TgImageTextureFile::getWidth() const
+{
+    return m_header.m_width;
+}
+
+/*!
+ * \brief TgImageTextureFile::getHeight
+ *
+ * \return height of the image, 0 if file is not open
+ */
+uint32_t TgImageTextureFile::getHeight() const
+{
+    return m_header.m_height;
+}
+
+/*!
+ * \brief TgImageTextureFile::getLevelCount
+ *
+ * \return number of mip levels, 1 if file has only the image
+ */
+uint32_t TgImageTextureFile::getLevelCount() const
+{
+    return m_header.m_levelCount;
+}
+
+/*!
+ * \brief TgImageTextureFile::getByteCount
+ *
+ * \return size of all levels (texture memory of the image)
+ */
+size_t TgImageTextureFile::getByteCount() const
+{
+    return m_mapAddress ? m_mapSize - sizeof(m_header) : 0;
+}
+
+/*!
+ * \brief TgImageTextureFile::getLevel
+ *
+ * \param level mip level
+ * \param levelWidth [out] width of the level
+ * \param levelHeight [out] height of the level
+ * \return RGBA data of the level from the mapped file, it can be
+ * given directly to glTexImage2D(), nullptr if level does not exist
+ */
+const unsigned char *TgImageTextureFile::getLevel(uint32_t level, uint32_t &levelWidth, uint32_t &levelHeight) const
+{
+    if (!m_mapAddress || level >= m_header.m_levelCount) {
+        return nullptr;
+    }
+    levelWidth = std::max<uint32_t>(1, m_header.m_width >> level);
+    levelHeight = std::max<uint32_t>(1, m_header.m_height >> level);
+    return static_cast<const unsigned char *>(m_mapAddress) + getLevelOffset(m_header.m_width, m_header.m_height, level);
+}
+
+/*!
+ * \brief TgImageTextureFile::write
+ *
+ * writes the image (and its mip levels) into texture file
+ *
+ * \param textureFileName texture file
+ * \param imageData image data (RGBA)
+ * \param width width of image
+ * \param height height of image
+ * \param mipmaps if true, all mip levels down to 1x1 are generated
+ * \return true on success
+ */
+bool TgImageTextureFile::write(const std::string &textureFileName, const unsigned char *imageData,
+                               uint32_t width, uint32_t height, bool mipmaps)
+{
+    TG_FUNCTION_BEGIN();
+    if (!imageData || !width || !height || width > INT32_MAX || height > INT32_MAX) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    // write into temporary file first, so other process never maps half written file
+    std::string tmpFileName = textureFileName + "." + std::to_string(getpid()) + ".tmp";
+    int fd = ::open(tmpFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        TG_WARNING_LOG("Could not write texture file: ", tmpFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    uint32_t level;
+    TgImageTextureFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, TG_IMAGE_TEXTURE_FILE_MAGIC, sizeof(header.m_magic));
+    header.m_version = TG_IMAGE_TEXTURE_FILE_VERSION;
+    header.m_format = TG_IMAGE_TEXTURE_FILE_FORMAT_RGBA;
+    header.m_width = width;
+    header.m_height = height;
+    header.m_levelCount = mipmaps ? getMaxLevelCount(width, height) : 1;
+
+    bool ret = write(fd, reinterpret_cast<const unsigned char *>(&header), sizeof(header))
+            && write(fd, imageData, static_cast<size_t>(width)*height*4);
+    std::vector<unsigned char> levelData, nextLevelData;
+    const unsigned char *previousLevelData = imageData;
+    for (level=1;ret && level<header.m_levelCount;level++) {
+        const uint32_t previousWidth = std::max<uint32_t>(1, width >> (level - 1));
+        const uint32_t previousHeight = std::max<uint32_t>(1, height >> (level - 1));
+        nextLevelData.resize(static_cast<size_t>(std::max<uint32_t>(1, width >> level))*std::max<uint32_t>(1, height >> level)*4);
+        downsample(previousLevelData, previousWidth, previousHeight, nextLevelData.data());
+        ret = write(fd, nextLevelData.data(), nextLevelData.size());
+        levelData.swap(nextLevelData);
+        previousLevelData = levelData.data();
+    }
+    if (::close(fd) != 0) {
+        ret = false;
+    }
+    if (!ret || rename(tmpFileName.c_str(), textureFileName.c_str()) != 0) {
+        TG_WARNING_LOG("Could not write texture file: ", textureFileName);
+        unlink(tmpFileName.c_str());
+        TG_FUNCTION_END();
+        return false;
+    }
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageTextureFile::getTextureFileName
+ *
+ * \param filename png filename
+ * \return texture filename of the png, ".png" is replaced with ".tgtex"
+ */
+std::string TgImageTextureFile::getTextureFileName(const std::string &filename)
+{
+    const size_t extensionLength = strlen(TG_IMAGE_TEXTURE_FILE_EXTENSION);
+    if (filename.size() >= extensionLength
+        && filename.compare(filename.size() - extensionLength, extensionLength, TG_IMAGE_TEXTURE_FILE_EXTENSION) == 0) {
+        return filename;
+    }
+    if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".png") == 0) {
+        return filename.substr(0, filename.size() - 4) + TG_IMAGE_TEXTURE_FILE_EXTENSION;
+    }
+    return filename + TG_IMAGE_TEXTURE_FILE_EXTENSION;
+}
+
+/*!
+ * \brief TgImageTextureFile::findTextureFile
+ *
+ * finds pre-baked texture file next to the png,
+ * texture file that is older than png is not used
+ *
+ * \param filename png filename
+ * \return texture filename, or empty if there is no (up to date) texture file
+ */
+std::string TgImageTextureFile::findTextureFile(const std::string &filename)
+{
+    struct stat textureFileStat, fileStat;
+    std::string textureFileName = getTextureFileName(filename);
+    if (stat(textureFileName.c_str(), &textureFileStat) != 0) {
+        return "";
+    }
+    if (textureFileName != filename
+        && stat(filename.c_str(), &fileStat) == 0
+        && fileStat.st_mtime > textureFileStat.st_mtime) {
+        TG_DEBUG_LOG("Texture file is older than image: ", textureFileName);
+        return "";
+    }
+    return textureFileName;
+}
+
+/*!
+ * \brief TgImageTextureFile::getMaxLevelCount
+ *
+ * \param width width of image
+ * \param height height of image
+ * \return number of levels down to 1x1
+ */
+uint32_t TgImageTextureFile::getMaxLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t ret = 1;
+    while (width > 1 || height > 1) {
+        width >>= 1;
+        height >>= 1;
+        ret++;
+    }
+    return ret;
+}
+
+/*!
+ * \brief TgImageTextureFile::getLevelOffset
+ *
+ * \param width width of image
+ * \param height height of image
+ * \param level mip level
+ * \return position of the level in the file (end of file if level == level count)
+ */
+uint64_t TgImageTextureFile::getLevelOffset(uint32_t width, uint32_t height, uint32_t level)
+{
+    uint64_t ret = sizeof(TgImageTextureFileHeader);
+    for (uint32_t i=0;i<level;i++) {
+        ret += static_cast<uint64_t>(std::max<uint32_t>(1, width >> i))*std::max<uint32_t>(1, height >> i)*4;
+    }
+    return ret;
+}
+
+/*!
+ * \brief TgImageTextureFile::downsample
+ *
+ * averages 2x2 pixels into one pixel, odd last row/column
+ * is left out as in glGenerateMipmap
+ *
+ * \param imageData RGBA image
+ * \param width width of image
+ * \param height height of image
+ * \param downsampledImageData [out] RGBA image, size is max(1, width/2) x max(1, height/2)
+ */
+void TgImageTextureFile::downsample(const unsigned char *imageData, uint32_t width, uint32_t height, unsigned char *downsampledImageData)
+{
+    uint32_t x, y, c;
+    const uint32_t downsampledWidth = std::max<uint32_t>(1, width/2);
+    const uint32_t downsampledHeight = std::max<uint32_t>(1, height/2);
+    const size_t rowSize = static_cast<size_t>(width)*4;
+    for (y=0;y<downsampledHeight;y++) {
+        const unsigned char *row0 = imageData + static_cast<size_t>(y)*2*rowSize;
+        const unsigned char *row1 = (y*2 + 1 < height) ? row0 + rowSize : row0;
+        unsigned char *downsampledRow = downsampledImageData + static_cast<size_t>(y)*downsampledWidth*4;
+        for (x=0;x<downsampledWidth;x++) {
+            const size_t left = static_cast<size_t>(x)*8;
+            const size_t right = (x*2 + 1 < width) ? left + 4 : left;
+            for (c=0;c<4;c++) {
+                downsampledRow[x*4 + c] = static_cast<unsigned char>((row0[left + c] + row0[right + c]
+                                                                      + row1[left + c] + row1[right + c] + 2)/4);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief TgImageTextureFile::write
+ *
+ * \param fd file
+ * \param data data to write
+ * \param size size of data
+ * \return true if all data was written
+ */
+bool TgImageTextureFile::write(int fd, const unsigned char *data, size_t size)
+{
+    while (size) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
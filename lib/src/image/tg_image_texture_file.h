@@ -0,0 +1,72 @@
+/*!
+ * \file
+ * \brief file tg_image_texture_file.h
+ *
+ * pre-baked texture file, RGBA image and its mip levels
+ * are memory mapped and uploaded without decoding
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_IMAGE_TEXTURE_FILE_H
+#define TG_IMAGE_TEXTURE_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#define TG_IMAGE_TEXTURE_FILE_VERSION       1
+#define TG_IMAGE_TEXTURE_FILE_EXTENSION     ".tgtex"
+#define TG_IMAGE_TEXTURE_FILE_FORMAT_RGBA   0
+
+/*!
+ * \brief TgImageTextureFileHeader
+ * header of the texture file, after header there are all
+ * levels from largest (level 0 == image size) to smallest,
+ * each level is RGBA rows without padding. Level + 1 is
+ * half of level (rounded down, at least 1 pixel) as in OpenGL
+ */
+struct TgImageTextureFileHeader
+{
+    char m_magic[4];
+    uint32_t m_version;
+    uint32_t m_format;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_levelCount;
+};
+
+class TgImageTextureFile
+{
+public:
+    explicit TgImageTextureFile();
+    ~TgImageTextureFile();
+
+    bool open(const std::string &textureFileName);
+    void close();
+
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getLevelCount() const;
+    size_t getByteCount() const;
+    const unsigned char *getLevel(uint32_t level, uint32_t &levelWidth, uint32_t &levelHeight) const;
+
+    static bool write(const std::string &textureFileName, const unsigned char *imageData,
+                      uint32_t width, uint32_t height, bool mipmaps);
+    static std::string getTextureFileName(const std::string &filename);
+    static std::string findTextureFile(const std::string &filename);
+
+private:
+    TgImageTextureFileHeader m_header;
+    void *m_mapAddress;
+    size_t m_mapSize;
+
+    static uint32_t getMaxLevelCount(uint32_t width, uint32_t height);
+    static uint64_t getLevelOffset(uint32_t width, uint32_t height, uint32_t level);
+    static void downsample(const unsigned char *imageData, uint32_t width, uint32_t height, unsigned char *downsampledImageData);
+    static bool write(int fd, const unsigned char *data, size_t size);
+};
+
+#endif // TG_IMAGE_TEXTURE_FILE_H
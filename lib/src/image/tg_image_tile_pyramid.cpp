@@ -0,0 +1,549 @@
+/*!
+ * \file
+ * \brief file tg_image_tile_pyramid.cpp
+ *
+ * giant image split into tiles on several mip levels,
+ * tiles are stored into disk cache file
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_image_tile_pyramid.h"
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../global/tg_global_log.h"
+#include "tg_image_load.h"
+#include "../common/tg_disk_cache_directory.h"
+
+#define TG_IMAGE_TILE_PYRAMID_MAGIC         "TGTP"
+#define TG_IMAGE_TILE_PYRAMID_FNV_OFFSET    14695981039346656037ULL
+#define TG_IMAGE_TILE_PYRAMID_FNV_PRIME     1099511628211ULL
+
+TgImageTilePyramid::TgImageTilePyramid() :
+    m_mapAddress(nullptr),
+    m_mapSize(0)
+{
+    TG_FUNCTION_BEGIN();
+    memset(&m_header, 0, sizeof(m_header));
+    TG_FUNCTION_END();
+}
+
+TgImageTilePyramid::~TgImageTilePyramid()
+{
+    TG_FUNCTION_BEGIN();
+    close();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImageTilePyramid::open
+ *
+ * opens (memory maps) tile pyramid of the png image from the cache directory,
+ * if it does not exist yet, then the png is split into tiles first.
+ * Splitting reads the png one row at a time, so this can take long time
+ * and it should be called on worker thread
+ *
+ * Pyramid file of the previous version of the png is removed when new one is built,
+ * and least recently used pyramid files are removed when the files of the
+ * directory exceed cacheMaxSize, pyramid file of this png is never removed
+ * (even if it is larger than cacheMaxSize), so it's not built again on next open()
+ *
+ * \param filename png filename
+ * \param cacheDirectory directory of tile pyramid files, empty == default directory
+ * $PRJ_TG_UI_LIB_TILE_CACHE_DIR, $XDG_CACHE_HOME/prj-tg-ui-lib/tiles (or $HOME/.cache/prj-tg-ui-lib/tiles)
+ * \param cacheMaxSize max size (bytes) of the tile pyramid files in the cache directory
+ * \return true on success
+ */
+bool TgImageTilePyramid::open(const std::string &filename, const std::string &cacheDirectory, uint64_t cacheMaxSize)
+{
+    TG_FUNCTION_BEGIN();
+    close();
+    struct stat fileStat;
+    if (stat(filename.c_str(), &fileStat) != 0) {
+        TG_ERROR_LOG("File could not open: ", filename);
+        TG_FUNCTION_END();
+        return false;
+    }
+    std::string directory = cacheDirectory.empty()
+            ? TgDiskCacheDirectory::getDefaultDirectory("PRJ_TG_UI_LIB_TILE_CACHE_DIR", "tiles") : cacheDirectory;
+    if (directory.empty() || !TgDiskCacheDirectory::createDirectory(directory)) {
+        TG_ERROR_LOG("Tile cache directory is not available: ", directory);
+        TG_FUNCTION_END();
+        return false;
+    }
+    uint64_t filenameHash = generateHash(filename.c_str(), filename.size(), TG_IMAGE_TILE_PYRAMID_FNV_OFFSET);
+    int64_t fileSize = static_cast<int64_t>(fileStat.st_size);
+    int64_t modifiedTime = static_cast<int64_t>(fileStat.st_mtime);
+    uint64_t sourceHash = generateHash(&fileSize, sizeof(fileSize), filenameHash);
+    sourceHash = generateHash(&modifiedTime, sizeof(modifiedTime), sourceHash);
+
+    // file name starts with the hash of png filename, so
+    // files of the previous versions of the png can be found
+    char filePrefix[32];
+    char fileName[64];
+    snprintf(filePrefix, sizeof(filePrefix), "%016llx_",
+             static_cast<unsigned long long>(filenameHash));
+    snprintf(fileName, sizeof(fileName), "%s%016llx_%d.tgtiles",
+             filePrefix, static_cast<unsigned long long>(sourceHash), TG_IMAGE_TILE_SIZE);
+    std::string pyramidFileName = directory + "/" + fileName;
+    if (map(pyramidFileName, sourceHash)) {
+        TG_FUNCTION_END();
+        return true;
+    }
+    bool ret = build(filename, pyramidFileName, sourceHash) && map(pyramidFileName, sourceHash);
+    TgDiskCacheDirectory::removeOtherFiles(directory, filePrefix, ".tgtiles", fileName);
+    TgDiskCacheDirectory::cleanDirectory(directory, ".tgtiles", cacheMaxSize, fileName);
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgImageTilePyramid::close
+ *
+ * unmaps the tile pyramid, tile pointers are not valid after this
+ */
+void TgImageTilePyramid::close()
+{
+    if (m_mapAddress) {
+        munmap(m_mapAddress, m_mapSize);
+        m_mapAddress = nullptr;
+        m_mapSize = 0;
+    }
+    memset(&m_header, 0, sizeof(m_header));
+    m_listLevelOffset.clear();
+}
+
+/*!
+ * \brief TgImageTilePyramid::getWidth
+ *
+ * \return width of the source image, 0 if pyramid is not open
+ */
+uint32_t TgImageTilePyramid::getWidth() const
+{
+    return m_header.m_width;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getHeight
+ *
+ * \return height of the source image, 0 if pyramid is not open
+ */
+uint32_t TgImageTilePyramid::getHeight() const
+{
+    return m_header.m_height;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getLevelCount
+ *
+ * \return number of mip levels, the last level fits into single tile
+ */
+uint32_t TgImageTilePyramid::getLevelCount() const
+{
+    return m_header.m_levelCount;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getLevelWidth
+ *
+ * \param level mip level
+ * \return width of the level, level + 1 is half of level (rounded up)
+ */
+uint32_t TgImageTilePyramid::getLevelWidth(uint32_t level) const
+{
+    uint32_t levelWidth, levelHeight;
+    getLevelSize(m_header.m_width, m_header.m_height, level, levelWidth, levelHeight);
+    return levelWidth;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getLevelHeight
+ *
+ * \param level mip level
+ * \return height of the level
+ */
+uint32_t TgImageTilePyramid::getLevelHeight(uint32_t level) const
+{
+    uint32_t levelWidth, levelHeight;
+    getLevelSize(m_header.m_width, m_header.m_height, level, levelWidth, levelHeight);
+    return levelHeight;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getTileCountX
+ *
+ * \param level mip level
+ * \return number of tile columns in level
+ */
+uint32_t TgImageTilePyramid::getTileCountX(uint32_t level) const
+{
+    return (getLevelWidth(level) + TG_IMAGE_TILE_SIZE - 1)/TG_IMAGE_TILE_SIZE;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getTileCountY
+ *
+ * \param level mip level
+ * \return number of tile rows in level
+ */
+uint32_t TgImageTilePyramid::getTileCountY(uint32_t level) const
+{
+    return (getLevelHeight(level) + TG_IMAGE_TILE_SIZE - 1)/TG_IMAGE_TILE_SIZE;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getTile
+ *
+ * gets the tile from the mapped file, reading it may
+ * cause disk read, so it should be done on worker thread
+ *
+ * \param level mip level
+ * \param tileX tile column
+ * \param tileY tile row
+ * \param tileWidth [out] width of the tile, edge tiles can be smaller than TG_IMAGE_TILE_SIZE
+ * \param tileHeight [out] height of the tile
+ * \return RGBA data of tile (row is tileWidth*4 bytes), nullptr if tile does not exist
+ */
+const unsigned char *TgImageTilePyramid::getTile(uint32_t level, uint32_t tileX, uint32_t tileY, uint32_t &tileWidth, uint32_t &tileHeight) const
+{
+    if (!m_mapAddress || level >= m_header.m_levelCount) {
+        return nullptr;
+    }
+    uint32_t levelWidth, levelHeight;
+    getLevelSize(m_header.m_width, m_header.m_height, level, levelWidth, levelHeight);
+    if (static_cast<uint64_t>(tileX)*TG_IMAGE_TILE_SIZE >= levelWidth
+        || static_cast<uint64_t>(tileY)*TG_IMAGE_TILE_SIZE >= levelHeight) {
+        return nullptr;
+    }
+    tileWidth = std::min<uint32_t>(TG_IMAGE_TILE_SIZE, levelWidth - tileX*TG_IMAGE_TILE_SIZE);
+    tileHeight = std::min<uint32_t>(TG_IMAGE_TILE_SIZE, levelHeight - tileY*TG_IMAGE_TILE_SIZE);
+    uint64_t offset = m_listLevelOffset[level]
+            + static_cast<uint64_t>(tileY)*TG_IMAGE_TILE_SIZE*levelWidth*4
+            + static_cast<uint64_t>(tileX)*TG_IMAGE_TILE_SIZE*tileHeight*4;
+    return static_cast<const unsigned char *>(m_mapAddress) + offset;
+}
+
+/*!
+ * \brief TgImageTilePyramid::map
+ *
+ * memory maps the tile pyramid file
+ *
+ * \param pyramidFileName tile pyramid file
+ * \param sourceHash hash of the source image
+ * \return false if file does not exist or it's not valid
+ */
+bool TgImageTilePyramid::map(const std::string &pyramidFileName, uint64_t sourceHash)
+{
+    TG_FUNCTION_BEGIN();
+    int fd = ::open(pyramidFileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    struct stat fileStat;
+    TgImageTilePyramidHeader header;
+    if (fstat(fd, &fileStat) != 0
+        || static_cast<size_t>(fileStat.st_size) < sizeof(header)
+        || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || memcmp(header.m_magic, TG_IMAGE_TILE_PYRAMID_MAGIC, sizeof(header.m_magic)) != 0
+        || header.m_version != TG_IMAGE_TILE_PYRAMID_VERSION
+        || header.m_sourceHash != sourceHash
+        || header.m_tileSize != TG_IMAGE_TILE_SIZE
+        || !header.m_width || !header.m_height
+        || header.m_levelCount != getLevelCount(header.m_width, header.m_height)) {
+        ::close(fd);
+        TG_FUNCTION_END();
+        return false;
+    }
+    uint32_t level, levelWidth, levelHeight;
+    uint64_t offset = sizeof(header);
+    std::vector<uint64_t> listLevelOffset;
+    for (level=0;level<header.m_levelCount;level++) {
+        getLevelSize(header.m_width, header.m_height, level, levelWidth, levelHeight);
+        listLevelOffset.push_back(offset);
+        offset += static_cast<uint64_t>(levelWidth)*levelHeight*4;
+    }
+    if (offset != static_cast<uint64_t>(fileStat.st_size)) {
+        TG_WARNING_LOG("Tile cache file is not valid: ", pyramidFileName);
+        ::close(fd);
+        TG_FUNCTION_END();
+        return false;
+    }
+    void *mapAddress = mmap(nullptr, static_cast<size_t>(offset), PROT_READ, MAP_PRIVATE, fd, 0);
+    // file is used now, so it's not removed first when cache size is exceeded
+    TgDiskCacheDirectory::touchFile(fd);
+    ::close(fd);
+    if (mapAddress == MAP_FAILED) {
+        TG_WARNING_LOG("Could not map tile cache file: ", pyramidFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    // tiles are read in viewport order, not in file order
+    madvise(mapAddress, static_cast<size_t>(offset), MADV_RANDOM);
+    m_mapAddress = mapAddress;
+    m_mapSize = static_cast<size_t>(offset);
+    m_header = header;
+    m_listLevelOffset = listLevelOffset;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageTilePyramid::build
+ *
+ * reads png one row at a time and writes tiles of all levels into
+ * tile pyramid file, only one row of tiles per level is in memory
+ *
+ * \param filename png filename
+ * \param pyramidFileName tile pyramid file
+ * \param sourceHash hash of the source image
+ * \return true on success
+ */
+bool TgImageTilePyramid::build(const std::string &filename, const std::string &pyramidFileName, uint64_t sourceHash)
+{
+    TG_FUNCTION_BEGIN();
+    // write into temporary file first, so other process never maps half written file
+    std::string tmpFileName = pyramidFileName + "." + std::to_string(getpid()) + ".tmp";
+    int fd = ::open(tmpFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        TG_WARNING_LOG("Could not write tile cache file: ", tmpFileName);
+        TG_FUNCTION_END();
+        return false;
+    }
+    TgImageTilePyramidHeader header;
+    memset(&header, 0, sizeof(header));
+    std::vector<TgImageTilePyramidLevel> listLevel;
+    bool ret = TgImageLoad::readPngRows(filename.c_str(), [&](int width, int height) {
+        uint32_t level;
+        uint64_t offset = sizeof(header);
+        memcpy(header.m_magic, TG_IMAGE_TILE_PYRAMID_MAGIC, sizeof(header.m_magic));
+        header.m_version = TG_IMAGE_TILE_PYRAMID_VERSION;
+        header.m_sourceHash = sourceHash;
+        header.m_width = static_cast<uint32_t>(width);
+        header.m_height = static_cast<uint32_t>(height);
+        header.m_tileSize = TG_IMAGE_TILE_SIZE;
+        header.m_levelCount = getLevelCount(header.m_width, header.m_height);
+        listLevel.resize(header.m_levelCount);
+        for (level=0;level<header.m_levelCount;level++) {
+            TgImageTilePyramidLevel &pyramidLevel = listLevel[level];
+            getLevelSize(header.m_width, header.m_height, level, pyramidLevel.m_width, pyramidLevel.m_height);
+            pyramidLevel.m_offset = offset;
+            offset += static_cast<uint64_t>(pyramidLevel.m_width)*pyramidLevel.m_height*4;
+            pyramidLevel.m_band.resize(static_cast<size_t>(pyramidLevel.m_width)*TG_IMAGE_TILE_SIZE*4);
+            pyramidLevel.m_tile.resize(TG_IMAGE_TILE_SIZE*TG_IMAGE_TILE_SIZE*4);
+            if (level + 1 < header.m_levelCount) {
+                pyramidLevel.m_pendingRow.resize(static_cast<size_t>(pyramidLevel.m_width)*4);
+                pyramidLevel.m_downsampledRow.resize(static_cast<size_t>((pyramidLevel.m_width + 1)/2)*4);
+            }
+        }
+        return true;
+    }, [&](const unsigned char *row) {
+        return addRow(fd, listLevel, 0, row);
+    });
+
+    // header is written last, so file is not valid if building is interrupted
+    ret = ret && write(fd, reinterpret_cast<const unsigned char *>(&header), sizeof(header), 0);
+    if (::close(fd) != 0) {
+        ret = false;
+    }
+    if (!ret || rename(tmpFileName.c_str(), pyramidFileName.c_str()) != 0) {
+        TG_WARNING_LOG("Could not write tile cache file: ", pyramidFileName);
+        unlink(tmpFileName.c_str());
+        TG_FUNCTION_END();
+        return false;
+    }
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImageTilePyramid::addRow
+ *
+ * adds row into level, writes row of tiles when it's complete,
+ * and every two rows are downsampled into next level
+ *
+ * \param fd tile pyramid file
+ * \param listLevel all levels
+ * \param levelIndex level of the row
+ * \param row RGBA row, width of the level
+ * \return false if write fails
+ */
+bool TgImageTilePyramid::addRow(int fd, std::vector<TgImageTilePyramidLevel> &listLevel, size_t levelIndex, const unsigned char *row)
+{
+    TgImageTilePyramidLevel &level = listLevel[levelIndex];
+    const size_t rowSize = static_cast<size_t>(level.m_width)*4;
+    if (level.m_rowIndex >= level.m_height) {
+        return false;
+    }
+    memcpy(level.m_band.data() + level.m_bandRowCount*rowSize, row, rowSize);
+    level.m_bandRowCount++;
+    level.m_rowIndex++;
+    if ((level.m_bandRowCount == TG_IMAGE_TILE_SIZE || level.m_rowIndex == level.m_height)
+        && !writeBand(fd, level)) {
+        return false;
+    }
+    if (levelIndex + 1 == listLevel.size()) {
+        return true;
+    }
+    if (!level.m_pendingRowSet) {
+        if (level.m_rowIndex != level.m_height) {
+            memcpy(level.m_pendingRow.data(), row, rowSize);
+            level.m_pendingRowSet = true;
+            return true;
+        }
+        // last row of odd height is downsampled alone
+        downsampleRows(row, row, level.m_width, level.m_downsampledRow.data());
+    } else {
+        downsampleRows(level.m_pendingRow.data(), row, level.m_width, level.m_downsampledRow.data());
+        level.m_pendingRowSet = false;
+    }
+    return addRow(fd, listLevel, levelIndex + 1, level.m_downsampledRow.data());
+}
+
+/*!
+ * \brief TgImageTilePyramid::writeBand
+ *
+ * writes collected rows of the level as row of tiles
+ *
+ * \param fd tile pyramid file
+ * \param level level
+ * \return false if write fails
+ */
+bool TgImageTilePyramid::writeBand(int fd, TgImageTilePyramidLevel &level)
+{
+    uint32_t tileX, y;
+    const uint32_t bandIndex = (level.m_rowIndex - 1)/TG_IMAGE_TILE_SIZE;
+    const uint32_t bandHeight = level.m_bandRowCount;
+    const uint64_t bandOffset = level.m_offset + static_cast<uint64_t>(bandIndex)*TG_IMAGE_TILE_SIZE*level.m_width*4;
+    const size_t rowSize = static_cast<size_t>(level.m_width)*4;
+    for (tileX=0;tileX*TG_IMAGE_TILE_SIZE<level.m_width;tileX++) {
+        const uint32_t tileWidth = std::min<uint32_t>(TG_IMAGE_TILE_SIZE, level.m_width - tileX*TG_IMAGE_TILE_SIZE);
+        for (y=0;y<bandHeight;y++) {
+            memcpy(level.m_tile.data() + static_cast<size_t>(y)*tileWidth*4,
+                   level.m_band.data() + y*rowSize + static_cast<size_t>(tileX)*TG_IMAGE_TILE_SIZE*4,
+                   static_cast<size_t>(tileWidth)*4);
+        }
+        if (!write(fd, level.m_tile.data(), static_cast<size_t>(tileWidth)*bandHeight*4,
+                   bandOffset + static_cast<uint64_t>(tileX)*TG_IMAGE_TILE_SIZE*bandHeight*4)) {
+            return false;
+        }
+    }
+    level.m_bandRowCount = 0;
+    return true;
+}
+
+/*!
+ * \brief TgImageTilePyramid::write
+ *
+ * \param fd file
+ * \param data data to write
+ * \param size size of data
+ * \param offset position in file
+ * \return true if all data was written
+ */
+bool TgImageTilePyramid::write(int fd, const unsigned char *data, size_t size, uint64_t offset)
+{
+    while (size) {
+        ssize_t written = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+/*!
+ * \brief TgImageTilePyramid::downsampleRows
+ *
+ * averages 2x2 pixels of two rows into one pixel
+ *
+ * \param row0 RGBA row
+ * \param row1 RGBA row below row0
+ * \param width width of row0 and row1
+ * \param downsampledRow [out] RGBA row, width is (width + 1)/2
+ */
+void TgImageTilePyramid::downsampleRows(const unsigned char *row0, const unsigned char *row1, uint32_t width, unsigned char *downsampledRow)
+{
+    uint32_t x, c;
+    const uint32_t downsampledWidth = (width + 1)/2;
+    for (x=0;x<downsampledWidth;x++) {
+        const size_t left = static_cast<size_t>(x)*8;
+        const size_t right = (x*2 + 1 < width) ? left + 4 : left;
+        for (c=0;c<4;c++) {
+            downsampledRow[x*4 + c] = static_cast<unsigned char>((row0[left + c] + row0[right + c]
+                                                                  + row1[left + c] + row1[right + c] + 2)/4);
+        }
+    }
+}
+
+/*!
+ * \brief TgImageTilePyramid::getLevelCount
+ *
+ * \param width width of source image
+ * \param height height of source image
+ * \return number of levels, so that the last level fits into single tile
+ */
+uint32_t TgImageTilePyramid::getLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t ret = 1;
+    while (width > TG_IMAGE_TILE_SIZE || height > TG_IMAGE_TILE_SIZE) {
+        width = (width + 1)/2;
+        height = (height + 1)/2;
+        ret++;
+    }
+    return ret;
+}
+
+/*!
+ * \brief TgImageTilePyramid::getLevelSize
+ *
+ * \param width width of source image
+ * \param height height of source image
+ * \param level mip level
+ * \param levelWidth [out] width of level
+ * \param levelHeight [out] height of level
+ */
+void TgImageTilePyramid::getLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t &levelWidth, uint32_t &levelHeight)
+{
+    levelWidth = width;
+    levelHeight = height;
+    for (uint32_t i=0;i<level;i++) {
+        levelWidth = (levelWidth + 1)/2;
+        levelHeight = (levelHeight + 1)/2;
+    }
+}
+
+/*!
+ * \brief TgImageTilePyramid::generateHash
+ *
+ * FNV-1a hash
+ *
+ * \param data data to hash
+ * \param size size of data
+ * \param hash previous hash value
+ * \return hash
+ */
+uint64_t TgImageTilePyramid::generateHash(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (size_t i=0;i<size;i++) {
+        hash ^= p[i];
+        hash *= TG_IMAGE_TILE_PYRAMID_FNV_PRIME;
+    }
+    return hash;
+}
@@ -0,0 +1,104 @@
+/*!
+ * \file
+ * \brief file tg_image_tile_pyramid.h
+ *
+ * giant image split into tiles on several mip levels,
+ * tiles are stored into disk cache file
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_IMAGE_TILE_PYRAMID_H
+#define TG_IMAGE_TILE_PYRAMID_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#define TG_IMAGE_TILE_PYRAMID_VERSION   1
+#define TG_IMAGE_TILE_SIZE              256
+/*!
+ * default max size of the tile cache directory, so that at least one
+ * giant image fits, pyramid of 30000x30000 image is about 4.8GB
+ * (RGBA and 1/3 more for the smaller levels)
+ */
+#define TG_IMAGE_TILE_PYRAMID_DEFAULT_CACHE_MAX_SIZE    (8ULL*1024*1024*1024)
+
+/*!
+ * \brief TgImageTilePyramidHeader
+ * header of the tile pyramid file, after header there are
+ * all levels from largest (level 0 == source image size) to smallest.
+ * Level is stored as rows of tiles, each tile is stored as
+ * RGBA rows of the tile, so single tile is continuous area in the file
+ */
+struct TgImageTilePyramidHeader
+{
+    char m_magic[4];
+    uint32_t m_version;
+    uint64_t m_sourceHash;      /*!< hash of source image filename, size and modification time */
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_tileSize;
+    uint32_t m_levelCount;
+};
+
+/*!
+ * \brief TgImageTilePyramidLevel
+ * one level while the pyramid is built, it collects rows
+ * until one row of tiles can be written
+ */
+struct TgImageTilePyramidLevel
+{
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint64_t m_offset = 0;                          /*!< position of the level in the file */
+    uint32_t m_rowIndex = 0;                        /*!< number of rows added into level */
+    uint32_t m_bandRowCount = 0;                    /*!< number of rows in m_band */
+    std::vector<unsigned char>m_band;               /*!< rows of one row of tiles */
+    std::vector<unsigned char>m_tile;
+    std::vector<unsigned char>m_pendingRow;         /*!< even row waiting for next row to be downsampled */
+    bool m_pendingRowSet = false;
+    std::vector<unsigned char>m_downsampledRow;     /*!< row of next level */
+};
+
+class TgImageTilePyramid
+{
+public:
+    explicit TgImageTilePyramid();
+    ~TgImageTilePyramid();
+
+    bool open(const std::string &filename, const std::string &cacheDirectory,
+              uint64_t cacheMaxSize = TG_IMAGE_TILE_PYRAMID_DEFAULT_CACHE_MAX_SIZE);
+    void close();
+
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getLevelCount() const;
+    uint32_t getLevelWidth(uint32_t level) const;
+    uint32_t getLevelHeight(uint32_t level) const;
+    uint32_t getTileCountX(uint32_t level) const;
+    uint32_t getTileCountY(uint32_t level) const;
+    const unsigned char *getTile(uint32_t level, uint32_t tileX, uint32_t tileY, uint32_t &tileWidth, uint32_t &tileHeight) const;
+
+private:
+    TgImageTilePyramidHeader m_header;
+    std::vector<uint64_t>m_listLevelOffset;
+    void *m_mapAddress;
+    size_t m_mapSize;
+
+    bool map(const std::string &pyramidFileName, uint64_t sourceHash);
+    bool build(const std::string &filename, const std::string &pyramidFileName, uint64_t sourceHash);
+
+    static bool addRow(int fd, std::vector<TgImageTilePyramidLevel> &listLevel, size_t levelIndex, const unsigned char *row);
+    static bool writeBand(int fd, TgImageTilePyramidLevel &level);
+    static bool write(int fd, const unsigned char *data, size_t size, uint64_t offset);
+    static void downsampleRows(const unsigned char *row0, const unsigned char *row1, uint32_t width, unsigned char *downsampledRow);
+    static uint32_t getLevelCount(uint32_t width, uint32_t height);
+    static void getLevelSize(uint32_t width, uint32_t height, uint32_t level, uint32_t &levelWidth, uint32_t &levelHeight);
+    static uint64_t generateHash(const void *data, size_t size, uint64_t hash);
+};
+
+#endif // TG_IMAGE_TILE_PYRAMID_H
@@ -58,7 +58,59 @@ float TgGridViewCellPrivate::getCellRequiredWidth()
 {
     TG_FUNCTION_BEGIN();
     TG_FUNCTION_END();
-    return std::roundf(getTextMarginLeft() + getTextMarginRight() + m_text.getTextWidth())+1;
+    return getCellRequiredWidth(m_text.getTextWidth());
+}
+
+/*!
+ * \brief TgGridViewCellPrivate::getCellRequiredWidth
+ *
+ * \param textWidth width of the text
+ * \return cell required width for the text, margin left + margin right + textWidth + 1
+ */
+float TgGridViewCellPrivate::getCellRequiredWidth(float textWidth)
+{
+    return std::roundf(getTextMarginLeft() + getTextMarginRight() + textWidth)+1;
+}
+
+/*!
+ * \brief TgGridViewCellPrivate::getTextMeasureRequest
+ *
+ * \param text
+ * \return request to measure the text with font of this cell
+ */
+TgTextMeasureRequest TgGridViewCellPrivate::getTextMeasureRequest(const std::string &text)
+{
+    TgTextMeasureRequest ret;
+    ret.m_text = text;
+    ret.m_fontFile = m_text.getFontFile();
+    ret.m_fontSize = m_text.getFontSize();
+    return ret;
+}
+
+/*! \brief TgGridViewCellPrivate::setCellIndex
+ * \param column column of the cell in grid view
+ * \param row row of the cell in grid view
+ */
+void TgGridViewCellPrivate::setCellIndex(size_t column, size_t row)
+{
+    m_column = column;
+    m_row = row;
+}
+
+/*! \brief TgGridViewCellPrivate::getColumn
+ * \return column of the cell in grid view
+ */
+size_t TgGridViewCellPrivate::getColumn() const
+{
+    return m_column;
+}
+
+/*! \brief TgGridViewCellPrivate::getRow
+ * \return row of the cell in grid view
+ */
+size_t TgGridViewCellPrivate::getRow() const
+{
+    return m_row;
 }
 
 /*! \brief TgGridViewCellPrivate::setText
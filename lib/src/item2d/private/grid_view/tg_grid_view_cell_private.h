@@ -17,6 +17,7 @@ class TgGridView;
 #include "../../tg_textfield.h"
 #include "../../tg_rectangle.h"
 #include "../../tg_grid_view_cell.h"
+#include "../../../application/tg_application.h"
 #include <string>
 
 class TgGridViewCellPrivate
@@ -46,6 +47,11 @@ public:
     float getTextMarginRight();
     float getTextMarginBottom();
     float getCellRequiredWidth();
+    float getCellRequiredWidth(float textWidth);
+    TgTextMeasureRequest getTextMeasureRequest(const std::string &text);
+    void setCellIndex(size_t column, size_t row);
+    size_t getColumn() const;
+    size_t getRow() const;
 
 private:
     TgGridViewCell *m_currentItem;
@@ -53,6 +59,8 @@ private:
     TgRectangle m_background;
     TgTextfield m_text;
     TgGridViewCellSizeType m_widthType = TgGridViewCellSizeType::TgGridViewCellSize_FixedSize;
+    size_t m_column = 0;
+    size_t m_row = 0;
 };
 
 #endif // TG_GRID_VIEW_CELL_PRIVATE_H
@@ -0,0 +1,122 @@
+/*!
+ * \file
+ * \brief file tg_grid_view_model_private.cpp
+ *
+ * it holds general TgGridViewModelPrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_grid_view_model_private.h"
+#include "../../../global/tg_global_log.h"
+#include "tg_grid_view_private.h"
+
+TgGridViewModelPrivate::TgGridViewModelPrivate()
+{
+}
+
+TgGridViewModelPrivate::~TgGridViewModelPrivate()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool detached = m_listGridView.empty();
+    m_mutex.unlock();
+    if (!detached) {
+        TG_ERROR_LOG("TgGridViewModel::detach() is not called in the destructor of the model");
+        detach();
+    }
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewModelPrivate::addGridView
+ * \param gridView gridview that uses this model
+ */
+void TgGridViewModelPrivate::addGridView(TgGridViewPrivate *gridView)
+{
+    m_mutex.lock();
+    m_listGridView.push_back(gridView);
+    m_mutex.unlock();
+}
+
+/*! \brief TgGridViewModelPrivate::removeGridView
+ * waits until the gridview is not called anymore
+ * \param gridView gridview that does not use this model anymore
+ */
+void TgGridViewModelPrivate::removeGridView(TgGridViewPrivate *gridView)
+{
+    m_notifyMutex.lock();
+    m_mutex.lock();
+    for (size_t i=0;i<m_listGridView.size();i++) {
+        if (m_listGridView[i] == gridView) {
+            m_listGridView.erase(m_listGridView.begin()+static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+    m_mutex.unlock();
+    m_notifyMutex.unlock();
+}
+
+/*! \brief TgGridViewModelPrivate::getGridViews
+ * \return copy of gridviews that use this model, so
+ * gridviews are called without m_mutex
+ */
+std::vector<TgGridViewPrivate *> TgGridViewModelPrivate::getGridViews()
+{
+    m_mutex.lock();
+    std::vector<TgGridViewPrivate *> ret = m_listGridView;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*! \brief TgGridViewModelPrivate::notifyCellsChanged
+ * \param column first changed column
+ * \param row first changed row
+ * \param columnCount count of changed columns
+ * \param rowCount count of changed rows
+ */
+void TgGridViewModelPrivate::notifyCellsChanged(size_t column, size_t row, size_t columnCount, size_t rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    if (!columnCount || !rowCount) {
+        TG_FUNCTION_END();
+        return;
+    }
+    m_notifyMutex.lock();
+    std::vector<TgGridViewPrivate *> listGridView = getGridViews();
+    for (size_t i=0;i<listGridView.size();i++) {
+        listGridView[i]->modelCellsChanged(column, row, columnCount, rowCount);
+    }
+    m_notifyMutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewModelPrivate::notifySizeChanged
+ */
+void TgGridViewModelPrivate::notifySizeChanged()
+{
+    TG_FUNCTION_BEGIN();
+    m_notifyMutex.lock();
+    std::vector<TgGridViewPrivate *> listGridView = getGridViews();
+    for (size_t i=0;i<listGridView.size();i++) {
+        listGridView[i]->modelSizeChanged();
+    }
+    m_notifyMutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewModelPrivate::detach
+ * removes the model from all gridviews that use it
+ */
+void TgGridViewModelPrivate::detach()
+{
+    TG_FUNCTION_BEGIN();
+    m_notifyMutex.lock();
+    std::vector<TgGridViewPrivate *> listGridView = getGridViews();
+    for (size_t i=0;i<listGridView.size();i++) {
+        listGridView[i]->setModel(nullptr);
+    }
+    m_notifyMutex.unlock();
+    TG_FUNCTION_END();
+}
@@ -0,0 +1,40 @@
+/*!
+ * \file
+ * \brief file tg_grid_view_model_private.h
+ *
+ * it holds general TgGridViewModelPrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_GRID_VIEW_MODEL_PRIVATE_H
+#define TG_GRID_VIEW_MODEL_PRIVATE_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+class TgGridViewPrivate;
+
+class TgGridViewModelPrivate
+{
+public:
+    TgGridViewModelPrivate();
+    ~TgGridViewModelPrivate();
+
+    void addGridView(TgGridViewPrivate *gridView);
+    void removeGridView(TgGridViewPrivate *gridView);
+    void notifyCellsChanged(size_t column, size_t row, size_t columnCount, size_t rowCount);
+    void notifySizeChanged();
+    void detach();
+
+private:
+    std::mutex m_mutex;
+    std::recursive_mutex m_notifyMutex;        /*!< gridview is not removed while it's called */
+    std::vector<TgGridViewPrivate *> m_listGridView;
+
+    std::vector<TgGridViewPrivate *> getGridViews();
+};
+
+#endif // TG_GRID_VIEW_MODEL_PRIVATE_H
@@ -4,12 +4,20 @@
  *
  * it holds general TgGridViewPrivate class
  *
+ * Only visible cells have cell item: cells that are requested with getCell()
+ * have own cell item, and rest of the visible cells are drawn with pooled cell
+ * items that are recycled when the grid view is scrolled. Column widths and
+ * row heights are kept in arrays, so visible cells are found with binary search.
+ * If gridview has model, text and background of visible cells are asked from the model
+ *
  * Copyright of Timo Hannukkala. All rights reserved.
  *
  * \author Timo Hannukkala <timohannukkala@hotmail.com>
  */
 
 #include "tg_grid_view_private.h"
+#include <algorithm>
+#include <unordered_set>
 #include "../../../global/tg_global_log.h"
 #include "../../tg_grid_view.h"
 #include "../../tg_grid_view_cell.h"
@@ -17,11 +25,15 @@
 #include "../../../global/private/tg_global_wait_renderer.h"
 #include "../item2d/tg_item2d_private.h"
 #include "tg_grid_view_cell_private.h"
+#include "../../tg_grid_view_model.h"
+#include "tg_grid_view_model_private.h"
+#include "../../../font/tg_font_math.h"
 
 #define DEFAULT_GRID_CELL_WIDTH     100
 #define DEFAULT_GRID_CELL_HEIGHT    25
 #define DEFAULT_GRID_CELL_BORDER    1
 #define DEFAULT_GRID_VIEW_SLIDER    15
+#define MAX_GRID_VIEW_CHANGED_RANGES 32
 
 TgGridViewPrivate::TgGridViewPrivate(TgGridView *currentItem, size_t columnCount, size_t rowCount) :
     m_currentItem(currentItem),
@@ -30,20 +42,14 @@ TgGridViewPrivate::TgGridViewPrivate(TgGridView *currentItem, size_t columnCount
     m_backgroundHorizontalSlider(currentItem, 0, 0, DEFAULT_GRID_VIEW_SLIDER, DEFAULT_GRID_VIEW_SLIDER, 128, 128, 128),
     m_verticalSlider(currentItem, 0, 0, DEFAULT_GRID_VIEW_SLIDER, 100, TgSliderType::SliderType_Vertical),
     m_horizontalSlider(currentItem, 0, 0, 100, DEFAULT_GRID_VIEW_SLIDER, TgSliderType::SliderType_Horizontal),
+    m_listColumnWidth(columnCount, static_cast<float>(DEFAULT_GRID_CELL_WIDTH)),
+    m_listRowHeight(rowCount, static_cast<float>(DEFAULT_GRID_CELL_HEIGHT)),
     m_columnCount(columnCount),
     m_rowCount(rowCount)
 {
     TG_FUNCTION_BEGIN();
-    size_t x, y;
-    for (y=0;y<rowCount;y++) {
-        for (x=0;x<columnCount;x++) {
-            m_listItems.push_back(new TgGridViewCell(currentItem,
-                static_cast<float>(x*(DEFAULT_GRID_CELL_WIDTH+DEFAULT_GRID_CELL_BORDER)+DEFAULT_GRID_CELL_BORDER),
-                static_cast<float>(y*(DEFAULT_GRID_CELL_HEIGHT+DEFAULT_GRID_CELL_BORDER)+DEFAULT_GRID_CELL_BORDER),
-                static_cast<float>(DEFAULT_GRID_CELL_WIDTH),
-                static_cast<float>(DEFAULT_GRID_CELL_HEIGHT) ));
-        }
-    }
+    updatePositions(m_listColumnWidth, m_listColumnPosition, 0);
+    updatePositions(m_listRowHeight, m_listRowPosition, 0);
     setSliderVisibilityAndPosition();
     m_verticalSlider.connectOnSliderPositionChanged( std::bind(&TgGridViewPrivate::onVerticalSliderPositionChanged, this, std::placeholders::_1) );
     m_horizontalSlider.connectOnSliderPositionChanged( std::bind(&TgGridViewPrivate::onHorizontalSliderPositionChanged, this, std::placeholders::_1) );
@@ -52,13 +58,26 @@ TgGridViewPrivate::TgGridViewPrivate(TgGridView *currentItem, size_t columnCount
 
 TgGridViewPrivate::~TgGridViewPrivate()
 {
-    std::vector<TgGridViewCell *>::iterator it;
-    for (it=m_listItems.begin();it!=m_listItems.end();it++) {
-        if (*it) {
-            delete *it;
-        }
+    m_modelMutex.lock();
+    m_mutex.lock();
+    TgGridViewModel *model = m_model;
+    m_model = nullptr;
+    m_mutex.unlock();
+    m_modelMutex.unlock();
+    if (model) {
+        model->m_private->removeGridView(this);
+    }
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    for (it=m_listCell.begin();it!=m_listCell.end();it++) {
+        delete it->second;
+    }
+    m_listCell.clear();
+    for (size_t i=0;i<m_listPoolCell.size();i++) {
+        delete m_listPoolCell[i];
     }
-    m_listItems.clear();
+    m_listPoolCell.clear();
+    m_listFreePoolCell.clear();
+    m_listPoolCellInUse.clear();
 }
 
 /*! \brief TgGridViewPrivate::onVerticalSliderPositionChanged
@@ -72,7 +91,9 @@ void TgGridViewPrivate::onVerticalSliderPositionChanged(uint64_t position)
         TG_FUNCTION_END();
         return;
     }
-    setGridCellsPositions();
+    m_mutex.lock();
+    updateVisibleCells();
+    m_mutex.unlock();
     TgGlobalWaitRenderer::getInstance()->release();
     m_previousVerticalSliderPosition = position;
     TG_FUNCTION_END();
@@ -89,14 +110,16 @@ void TgGridViewPrivate::onHorizontalSliderPositionChanged(uint64_t position)
         TG_FUNCTION_END();
         return;
     }
-    setGridCellsPositions();
+    m_mutex.lock();
+    updateVisibleCells();
+    m_mutex.unlock();
     TgGlobalWaitRenderer::getInstance()->release();
     m_previousHorizontalSliderPosition = position;
     TG_FUNCTION_END();
 }
 
 /*! \brief TgGridViewPrivate::setSliderVisibilityAndPosition
- * sets position and visiblity for sliders
+ * sets position and visiblity for sliders, and updates visible cells
  */
 void TgGridViewPrivate::setSliderVisibilityAndPosition()
 {
@@ -106,13 +129,16 @@ void TgGridViewPrivate::setSliderVisibilityAndPosition()
         m_horizontalSlider.setSliderMaxPosition(0);
         m_verticalSlider.setVisible(false);
         m_horizontalSlider.setVisible(false);
+        m_mutex.lock();
+        updateVisibleCells();
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return;
     }
-    TgGridViewCell *tmp = getCell(m_columnCount-1, 0);
-    m_maxInnerAreaWidth = static_cast<size_t>(tmp->getX() + tmp->getWidth() + DEFAULT_GRID_CELL_BORDER) - static_cast<size_t>(getCell(0, 0)->getX() - DEFAULT_GRID_CELL_BORDER);
-    tmp = getCell(0, m_rowCount-1);
-    m_maxInnerAreaHeight = static_cast<size_t>(tmp->getY() + tmp->getHeight() + DEFAULT_GRID_CELL_BORDER) - static_cast<size_t>(getCell(0, 0)->getY() - DEFAULT_GRID_CELL_BORDER);
+    m_mutex.lock();
+    m_maxInnerAreaWidth = static_cast<size_t>(m_listColumnPosition[m_columnCount]);
+    m_maxInnerAreaHeight = static_cast<size_t>(m_listRowPosition[m_rowCount]);
+    m_mutex.unlock();
 
     bool hor = setSliderVisibilityAndPositionHor();
     bool ver = setSliderVisibilityAndPositionVer();
@@ -131,27 +157,231 @@ void TgGridViewPrivate::setSliderVisibilityAndPosition()
         m_verticalSlider.setToTop();
         m_horizontalSlider.setSliderMaxPosition(0);
     }
+    m_mutex.lock();
+    updateVisibleCells();
+    m_mutex.unlock();
     TG_FUNCTION_END();
 }
 
-void TgGridViewPrivate::setGridCellsPositions()
+/*! \brief TgGridViewPrivate::checkVisibleCells
+ * updates visible cells before rendering, if cells or
+ * their sizes or model's cells are changed after previous update
+ */
+void TgGridViewPrivate::checkVisibleCells()
 {
-    TgGridViewCell *tmp;
-    size_t x, y;
-    float w, h = DEFAULT_GRID_CELL_BORDER;
-    for (y=0;y<m_rowCount;y++) {
-        w = DEFAULT_GRID_CELL_BORDER;
-        for (x=0;x<m_columnCount;x++) {
-            tmp = getCell(x, y);
-            tmp->TgItem2d::setX( w - static_cast<float>(m_horizontalSlider.getSliderCurrentPosition() ) );
-            tmp->TgItem2d::setY( h - static_cast<float>(  m_verticalSlider.getSliderCurrentPosition() ) );
-            w += tmp->getWidth() + DEFAULT_GRID_CELL_BORDER;
+    TG_FUNCTION_BEGIN();
+    updateModelSize();
+    m_mutex.lock();
+    if (m_visibleCellsChanged || m_slidersToTop) {
+        updateVisibleCells();
+    }
+    updateChangedCells();
+    m_mutex.unlock();
+    updateModelData();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::updateVisibleCells
+ * positions the cells that are inside the grid view area,
+ * cells that don't have own cell item are drawn with pooled cell
+ * item, pooled cell items of cells that are not visible anymore
+ * are hidden and reused, so this depends only on count of visible cells
+ *
+ * m_mutex must be locked when this is called
+ */
+void TgGridViewPrivate::updateVisibleCells()
+{
+    TG_FUNCTION_BEGIN();
+    size_t column, row, i, columnStart = 0, columnEnd = 0, rowStart = 0, rowEnd = 0;
+    uint64_t key;
+    bool newCells = false;
+    TgGridViewCell *cell;
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    std::unordered_map<uint64_t, TgGridViewCell *> listPoolCellInUse;
+    std::vector<uint64_t> listUnboundCell;
+    double scrollX = static_cast<double>(m_horizontalSlider.getSliderCurrentPosition());
+    double scrollY = static_cast<double>(m_verticalSlider.getSliderCurrentPosition());
+
+    m_visibleCellsChanged = false;
+    if (m_columnCount && m_rowCount) {
+        getVisibleRange(m_listColumnPosition, scrollX, scrollX + static_cast<double>(m_currentItem->getWidth()), columnStart, columnEnd);
+        getVisibleRange(m_listRowPosition, scrollY, scrollY + static_cast<double>(m_currentItem->getHeight()), rowStart, rowEnd);
+    }
+
+    for (i=0;i<m_listVisibleCell.size();i++) {
+        column = static_cast<size_t>(m_listVisibleCell[i] & 0xFFFFFFFF);
+        row = static_cast<size_t>(m_listVisibleCell[i] >> 32);
+        if (column >= columnStart && column < columnEnd && row >= rowStart && row < rowEnd) {
+            continue;
         }
-        tmp = getCell(x-1, y);
-        if (tmp) {
-            h += tmp->getHeight() + DEFAULT_GRID_CELL_BORDER;
+        it = m_listCell.find(m_listVisibleCell[i]);
+        if (it != m_listCell.end()) {
+            it->second->setVisible(false);
         }
     }
+    m_listVisibleCell.clear();
+
+    for (row=rowStart;row<rowEnd;row++) {
+        for (column=columnStart;column<columnEnd;column++) {
+            key = getCellKey(column, row);
+            it = m_listCell.find(key);
+            if (it != m_listCell.end()) {
+                if (m_model && (column < m_visibleColumnStart || column >= m_visibleColumnEnd
+                                || row < m_visibleRowStart || row >= m_visibleRowEnd)) {
+                    // changes of the model are not followed when cell is not visible
+                    m_listModelDataCell.push_back(key);
+                }
+                it->second->TgItem2d::setX( static_cast<float>(m_listColumnPosition[column] - scrollX) );
+                it->second->TgItem2d::setY( static_cast<float>(m_listRowPosition[row] - scrollY) );
+                it->second->setVisible(true);
+                m_listVisibleCell.push_back(key);
+                continue;
+            }
+            it = m_listPoolCellInUse.find(key);
+            if (it != m_listPoolCellInUse.end()) {
+                listPoolCellInUse[key] = it->second;
+                m_listPoolCellInUse.erase(it);
+            } else {
+                listUnboundCell.push_back(key);
+            }
+        }
+    }
+    for (it=m_listPoolCellInUse.begin();it!=m_listPoolCellInUse.end();it++) {
+        releasePoolCell(it->second);
+    }
+    m_listPoolCellInUse.swap(listPoolCellInUse);
+
+    for (i=0;i<listUnboundCell.size();i++) {
+        if (m_listFreePoolCell.empty()) {
+            cell = new TgGridViewCell(m_currentItem, 0, 0, static_cast<float>(DEFAULT_GRID_CELL_WIDTH), static_cast<float>(DEFAULT_GRID_CELL_HEIGHT));
+            m_listPoolCell.push_back(cell);
+            newCells = true;
+        } else {
+            cell = m_listFreePoolCell.back();
+            m_listFreePoolCell.pop_back();
+        }
+        bindPoolCell(cell, listUnboundCell[i]);
+        m_listPoolCellInUse[listUnboundCell[i]] = cell;
+    }
+
+    for (it=m_listPoolCellInUse.begin();it!=m_listPoolCellInUse.end();it++) {
+        column = static_cast<size_t>(it->first & 0xFFFFFFFF);
+        row = static_cast<size_t>(it->first >> 32);
+        cell = it->second;
+        cell->TgItem2d::setX( static_cast<float>(m_listColumnPosition[column] - scrollX) );
+        cell->TgItem2d::setY( static_cast<float>(m_listRowPosition[row] - scrollY) );
+        reinterpret_cast<TgItem2d *>(cell)->m_private->setWidth(m_listColumnWidth[column], false);
+        reinterpret_cast<TgItem2d *>(cell)->m_private->setHeight(m_listRowHeight[row], false);
+        cell->setVisible(true);
+    }
+
+    m_visibleColumnStart = columnStart;
+    m_visibleColumnEnd = columnEnd;
+    m_visibleRowStart = rowStart;
+    m_visibleRowEnd = rowEnd;
+    if (newCells || m_slidersToTop) {
+        setSlidersToTop();
+        m_slidersToTop = false;
+    }
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::bindPoolCell
+ * sets cell's text and background to pooled cell item
+ * from the cell data, or asks them from the model
+ * before next render
+ * \param cell pooled cell item
+ * \param key key of the cell
+ */
+void TgGridViewPrivate::bindPoolCell(TgGridViewCell *cell, uint64_t key)
+{
+    if (m_model) {
+        m_listModelDataCell.push_back(key);
+        return;
+    }
+    std::unordered_map<uint64_t, TgGridViewCellData>::iterator it = m_listCellData.find(key);
+    if (it == m_listCellData.end()) {
+        cell->m_private->setText("");
+        cell->m_private->setBackground(255, 255, 255, 255);
+        return;
+    }
+    cell->m_private->setText(it->second.m_text.c_str());
+    cell->m_private->setBackground(static_cast<unsigned char>(it->second.m_background >> 24),
+                                   static_cast<unsigned char>(it->second.m_background >> 16),
+                                   static_cast<unsigned char>(it->second.m_background >> 8),
+                                   static_cast<unsigned char>(it->second.m_background));
+}
+
+/*! \brief TgGridViewPrivate::releasePoolCell
+ * hides pooled cell item, so it can be reused for other cell
+ * \param cell pooled cell item
+ */
+void TgGridViewPrivate::releasePoolCell(TgGridViewCell *cell)
+{
+    cell->setVisible(false);
+    m_listFreePoolCell.push_back(cell);
+}
+
+/*! \brief TgGridViewPrivate::setSlidersToTop
+ * new cell items are added as last children, so
+ * sliders are moved back on top of the cells
+ */
+void TgGridViewPrivate::setSlidersToTop()
+{
+    m_backgroundVerticalSlider.setToTop();
+    m_backgroundHorizontalSlider.setToTop();
+    m_verticalSlider.setToTop();
+    m_horizontalSlider.setToTop();
+}
+
+/*! \brief TgGridViewPrivate::updatePositions
+ * updates start positions of columns or rows from index start,
+ * last position is the size of inner area
+ * \param listSize widths of columns or heights of rows
+ * \param listPosition [out] start positions of columns or rows
+ * \param start first changed index
+ */
+void TgGridViewPrivate::updatePositions(const std::vector<float> &listSize, std::vector<double> &listPosition, size_t start)
+{
+    listPosition.resize(listSize.size()+1);
+    if (start == 0) {
+        listPosition[0] = DEFAULT_GRID_CELL_BORDER;
+    }
+    for (size_t i=start;i<listSize.size();i++) {
+        listPosition[i+1] = listPosition[i] + static_cast<double>(listSize[i]) + DEFAULT_GRID_CELL_BORDER;
+    }
+}
+
+/*! \brief TgGridViewPrivate::getVisibleRange
+ * finds columns or rows that are between start and end
+ * \param listPosition start positions of columns or rows
+ * \param start start of visible area
+ * \param end end of visible area
+ * \param first [out] first visible index
+ * \param last [out] index after last visible index
+ */
+void TgGridViewPrivate::getVisibleRange(const std::vector<double> &listPosition, double start, double end, size_t &first, size_t &last)
+{
+    if (listPosition.size() < 2) {
+        first = last = 0;
+        return;
+    }
+    std::vector<double>::const_iterator itEnd = listPosition.end()-1;
+    first = static_cast<size_t>(std::upper_bound(listPosition.begin(), itEnd, start) - listPosition.begin());
+    if (first) {
+        first--;
+    }
+    last = static_cast<size_t>(std::lower_bound(listPosition.begin()+static_cast<std::ptrdiff_t>(first), itEnd, end) - listPosition.begin());
+}
+
+/*! \brief TgGridViewPrivate::getCellKey
+ * \param column
+ * \param row
+ * \return key of the cell for cell maps
+ */
+uint64_t TgGridViewPrivate::getCellKey(size_t column, size_t row)
+{
+    return (static_cast<uint64_t>(row) << 32) | (static_cast<uint64_t>(column) & 0xFFFFFFFF);
 }
 
 bool TgGridViewPrivate::isSliderRequired(bool horizontal)
@@ -215,6 +445,271 @@ bool TgGridViewPrivate::setSliderVisibilityAndPositionVer()
     return true;
 }
 
+/*! \brief TgGridViewPrivate::updateChangedCells
+ * updates visible cells that are changed in the model
+ * after previous update, several changes of the same
+ * cell are updated only once
+ *
+ * m_mutex must be locked when this is called
+ */
+void TgGridViewPrivate::updateChangedCells()
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_allCellsChanged && m_listChangedRange.empty()) {
+        TG_FUNCTION_END();
+        return;
+    }
+    size_t i;
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    for (it=m_listPoolCellInUse.begin();it!=m_listPoolCellInUse.end();it++) {
+        if (isCellChanged(it->first)) {
+            bindPoolCell(it->second, it->first);
+        }
+    }
+    if (m_model) {
+        for (i=0;i<m_listVisibleCell.size();i++) {
+            if (isCellChanged(m_listVisibleCell[i])) {
+                m_listModelDataCell.push_back(m_listVisibleCell[i]);
+            }
+        }
+    }
+    m_allCellsChanged = false;
+    m_listChangedRange.clear();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::isCellChanged
+ * \param key key of the cell
+ * \return true if cell is changed in the model after previous update
+ */
+bool TgGridViewPrivate::isCellChanged(uint64_t key)
+{
+    if (m_allCellsChanged) {
+        return true;
+    }
+    size_t column = static_cast<size_t>(key & 0xFFFFFFFF);
+    size_t row = static_cast<size_t>(key >> 32);
+    for (size_t i=0;i<m_listChangedRange.size();i++) {
+        if (column >= m_listChangedRange[i].m_columnStart && column < m_listChangedRange[i].m_columnEnd
+            && row >= m_listChangedRange[i].m_rowStart && row < m_listChangedRange[i].m_rowEnd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*! \brief TgGridViewPrivate::updateModelSize
+ * gets column and row count from the model, if model
+ * has told that they are changed, this is called on render thread
+ */
+void TgGridViewPrivate::updateModelSize()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool modelSizeChanged = m_modelSizeChanged;
+    m_modelSizeChanged = false;
+    m_mutex.unlock();
+    if (!modelSizeChanged) {
+        TG_FUNCTION_END();
+        return;
+    }
+    m_modelMutex.lock();
+    TgGridViewModel *model = getModel();
+    if (!model) {
+        m_modelMutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    size_t columnCount = model->getColumnCount();
+    size_t rowCount = model->getRowCount();
+    m_modelMutex.unlock();
+    // render thread holds the render lock already
+    setColumnAndRowCount(columnCount, rowCount);
+    m_mutex.lock();
+    m_allCellsChanged = true;
+    m_listChangedRange.clear();
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::updateModelData
+ * asks text and background of the cells in m_listModelDataCell
+ * from the model and sets them to the cell items. Model is asked
+ * without m_mutex, so model can hold its own lock while it calls
+ * notifyCellsChanged(), and cell items that are not visible
+ * anymore after asking are skipped
+ */
+void TgGridViewPrivate::updateModelData()
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    unsigned char r, g, b, a;
+    std::vector<uint64_t> listKey;
+    std::vector<TgGridViewModelCellData> listModelCellData;
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    m_modelMutex.lock();
+    m_mutex.lock();
+    TgGridViewModel *model = m_model;
+    listKey.swap(m_listModelDataCell);
+    m_mutex.unlock();
+    if (!model || listKey.empty()) {
+        m_modelMutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    std::sort(listKey.begin(), listKey.end());
+    listKey.erase(std::unique(listKey.begin(), listKey.end()), listKey.end());
+    listModelCellData.resize(listKey.size());
+    for (i=0;i<listKey.size();i++) {
+        TgGridViewModelCellData &modelCellData = listModelCellData[i];
+        const size_t column = static_cast<size_t>(listKey[i] & 0xFFFFFFFF);
+        const size_t row = static_cast<size_t>(listKey[i] >> 32);
+        r = g = b = a = 255;
+        modelCellData.m_key = listKey[i];
+        modelCellData.m_data.m_text = model->getCellText(column, row);
+        modelCellData.m_backgroundSet = model->getCellBackground(column, row, r, g, b, a);
+        modelCellData.m_data.m_background = (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16)
+                                            | (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(a);
+    }
+    m_mutex.lock();
+    for (i=0;i<listModelCellData.size();i++) {
+        it = m_listCell.find(listModelCellData[i].m_key);
+        if (it != m_listCell.end()) {
+            setModelDataToCell(it->second, listModelCellData[i], false);
+            continue;
+        }
+        it = m_listPoolCellInUse.find(listModelCellData[i].m_key);
+        if (it != m_listPoolCellInUse.end()) {
+            setModelDataToCell(it->second, listModelCellData[i], true);
+        }
+    }
+    m_mutex.unlock();
+    m_modelMutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::setModelDataToCell
+ * sets text and background from the model to the cell item
+ * \param cell cell item
+ * \param modelCellData text and background asked from the model
+ * \param defaultBackground if true, background is set to default
+ * when model does not give background color for the cell
+ */
+void TgGridViewPrivate::setModelDataToCell(TgGridViewCell *cell, const TgGridViewModelCellData &modelCellData, bool defaultBackground)
+{
+    cell->m_private->setText(modelCellData.m_data.m_text.c_str());
+    if (!modelCellData.m_backgroundSet) {
+        if (defaultBackground) {
+            cell->m_private->setBackground(255, 255, 255, 255);
+        }
+        return;
+    }
+    cell->m_private->setBackground(static_cast<unsigned char>(modelCellData.m_data.m_background >> 24),
+                                   static_cast<unsigned char>(modelCellData.m_data.m_background >> 16),
+                                   static_cast<unsigned char>(modelCellData.m_data.m_background >> 8),
+                                   static_cast<unsigned char>(modelCellData.m_data.m_background));
+}
+
+/*! \brief TgGridViewPrivate::setModel
+ * sets model, column and row count and text and background
+ * of cells are taken from the model
+ * \param model model, or nullptr to remove the model
+ */
+void TgGridViewPrivate::setModel(TgGridViewModel *model)
+{
+    TG_FUNCTION_BEGIN();
+    // waits until previous model is not asked anymore
+    m_modelMutex.lock();
+    m_mutex.lock();
+    TgGridViewModel *previousModel = m_model;
+    if (previousModel == model) {
+        m_mutex.unlock();
+        m_modelMutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_model = model;
+    m_allCellsChanged = true;
+    m_listChangedRange.clear();
+    m_listModelDataCell.clear();
+    m_modelSizeChanged = false;
+    m_mutex.unlock();
+    m_modelMutex.unlock();
+    if (previousModel) {
+        previousModel->m_private->removeGridView(this);
+    }
+    if (model) {
+        model->m_private->addGridView(this);
+        size_t columnCount = model->getColumnCount();
+        size_t rowCount = model->getRowCount();
+        TgGlobalWaitRenderer::getInstance()->renderLock();
+        setColumnAndRowCount(columnCount, rowCount);
+        TgGlobalWaitRenderer::getInstance()->renderUnlock();
+    }
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::getModel
+ * \return current model, nullptr if model is not set
+ */
+TgGridViewModel *TgGridViewPrivate::getModel()
+{
+    m_mutex.lock();
+    TgGridViewModel *ret = m_model;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*! \brief TgGridViewPrivate::modelCellsChanged
+ * when model's cells are changed, this is called,
+ * range is limited to visible cells and it is updated
+ * before next render, changes of not visible cells are ignored
+ * \param column first changed column
+ * \param row first changed row
+ * \param columnCount count of changed columns
+ * \param rowCount count of changed rows
+ */
+void TgGridViewPrivate::modelCellsChanged(size_t column, size_t row, size_t columnCount, size_t rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    TgGridViewCellRange range;
+    m_mutex.lock();
+    range.m_columnStart = std::max(column, m_visibleColumnStart);
+    range.m_columnEnd = std::min(columnCount > SIZE_MAX - column ? SIZE_MAX : column + columnCount, m_visibleColumnEnd);
+    range.m_rowStart = std::max(row, m_visibleRowStart);
+    range.m_rowEnd = std::min(rowCount > SIZE_MAX - row ? SIZE_MAX : row + rowCount, m_visibleRowEnd);
+    if (m_allCellsChanged || range.m_columnStart >= range.m_columnEnd || range.m_rowStart >= range.m_rowEnd) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    if (m_listChangedRange.size() >= MAX_GRID_VIEW_CHANGED_RANGES) {
+        m_allCellsChanged = true;
+        m_listChangedRange.clear();
+    } else {
+        m_listChangedRange.push_back(range);
+    }
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::modelSizeChanged
+ * when model's column or row count is changed, this is called,
+ * new counts are asked from the model on render thread before next
+ * render, so this does not wait the render lock
+ */
+void TgGridViewPrivate::modelSizeChanged()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_modelSizeChanged = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
 /*! \brief TgGridViewPrivate::getColumCount
  * \return column count
  */
@@ -233,7 +728,9 @@ size_t TgGridViewPrivate::getRowCount()
 
 /*! \brief TgGridViewPrivate::getCell
  *
- * get pointer of item
+ * get pointer of item, cell item is created when
+ * it's requested first time and it's kept until the cell
+ * is removed with setRowCount() or setColumCount()
  *
  * \param column
  * \param row
@@ -243,99 +740,305 @@ size_t TgGridViewPrivate::getRowCount()
 TgGridViewCell *TgGridViewPrivate::getCell(size_t column, size_t row)
 {
     TG_FUNCTION_BEGIN();
+    m_mutex.lock();
     if (column >= m_columnCount || row >= m_rowCount) {
         TG_WARNING_LOG("Incorrect cell, Column:", column, "/", m_columnCount, "Row:", row, "/", m_rowCount );
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return nullptr;
     }
+    uint64_t key = getCellKey(column, row);
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it = m_listCell.find(key);
+    if (it != m_listCell.end()) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return it->second;
+    }
+    TgGridViewCell *cell = new TgGridViewCell(m_currentItem,
+        static_cast<float>(m_listColumnPosition[column] - static_cast<double>(m_horizontalSlider.getSliderCurrentPosition())),
+        static_cast<float>(m_listRowPosition[row] - static_cast<double>(m_verticalSlider.getSliderCurrentPosition())),
+        m_listColumnWidth[column], m_listRowHeight[row]);
+    cell->m_private->setCellIndex(column, row);
+    std::unordered_map<uint64_t, TgGridViewCellData>::iterator itData = m_listCellData.find(key);
+    if (m_model) {
+        m_listModelDataCell.push_back(key);
+    } else if (itData != m_listCellData.end()) {
+        cell->m_private->setText(itData->second.m_text.c_str());
+        cell->m_private->setBackground(static_cast<unsigned char>(itData->second.m_background >> 24),
+                                       static_cast<unsigned char>(itData->second.m_background >> 16),
+                                       static_cast<unsigned char>(itData->second.m_background >> 8),
+                                       static_cast<unsigned char>(itData->second.m_background));
+    }
+    if (itData != m_listCellData.end()) {
+        m_listCellData.erase(itData);
+    }
+    if (column < m_visibleColumnStart || column >= m_visibleColumnEnd
+        || row < m_visibleRowStart || row >= m_visibleRowEnd) {
+        cell->setVisible(false);
+    }
+    m_listCell[key] = cell;
+    m_visibleCellsChanged = true;
+    m_slidersToTop = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
     TG_FUNCTION_END();
-    return m_listItems[row*m_columnCount+column];
+    return cell;
 }
 
-/*! \brief TgGridViewPrivate::setRowCount
+/*! \brief TgGridViewPrivate::setCellText
+ * \param column
  * \param row
+ * \param text
  */
-void TgGridViewPrivate::setRowCount(size_t row)
+void TgGridViewPrivate::setCellText(size_t column, size_t row, const char *text)
 {
     TG_FUNCTION_BEGIN();
-    if (row == m_rowCount) {
+    TgGridViewCell *cell = nullptr;
+    m_mutex.lock();
+    if (column >= m_columnCount || row >= m_rowCount) {
+        TG_WARNING_LOG("Incorrect cell, Column:", column, "/", m_columnCount, "Row:", row, "/", m_rowCount );
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return;
     }
-    TgGlobalWaitRenderer::getInstance()->renderLock();
-    if (row == 0) {
-        clear();
-        m_rowCount = row;
-        setGridCellsPositions();
-        setSliderVisibilityAndPosition();
-        TgGlobalWaitRenderer::getInstance()->renderUnlock();
+    if (m_model) {
+        TG_WARNING_LOG("Cell text is taken from the model, Column:", column, "Row:", row);
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return;
     }
-    std::vector<TgGridViewCell *>tmpList;
-    for (size_t i=0;i<m_listItems.size();i++) {
-        tmpList.push_back(m_listItems.at(i));
+    uint64_t key = getCellKey(column, row);
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it = m_listCell.find(key);
+    if (it != m_listCell.end()) {
+        cell = it->second;
+    } else {
+        m_listCellData[key].m_text = text ? text : "";
+        it = m_listPoolCellInUse.find(key);
+        if (it != m_listPoolCellInUse.end()) {
+            it->second->m_private->setText(text ? text : "");
+        }
     }
-    size_t x, y;
-    float posX, posY, newWidth;
-    TgGridViewCell *cell;
-    m_listItems.clear();
-    if (row > m_rowCount) {
-        for (y=0;y<row;y++) {
-            for (x=0;x<m_columnCount;x++) {
-                if (y < m_rowCount) {
-                    m_listItems.push_back(tmpList[y*m_columnCount+x]);
-                    continue;
-                }
-                if (x == 0) {
-                    posX = DEFAULT_GRID_CELL_BORDER;
-                } else {
-                    cell = m_listItems[y*m_columnCount+x-1];
-                    posX = cell->getX() + cell->getWidth() + DEFAULT_GRID_CELL_BORDER;
-                }
-                if (y == 0) {
-                    posY = DEFAULT_GRID_CELL_BORDER;
-                    newWidth = DEFAULT_GRID_CELL_WIDTH;
-                } else {
-                    cell = m_listItems[ (y-1)*m_columnCount+x];
-                    posY = cell->getY() + cell->getHeight() + DEFAULT_GRID_CELL_BORDER;
-                    newWidth = cell->getWidth();
-                }
-                m_listItems.push_back(new TgGridViewCell(m_currentItem,
-                        posX, posY,
-                        newWidth, static_cast<float>(DEFAULT_GRID_CELL_HEIGHT) ));
-            }
+    m_mutex.unlock();
+    if (cell) {
+        cell->m_private->setText(text ? text : "");
+    }
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::getCellText
+ * \param column
+ * \param row
+ * \return text of the cell, if model is set and cell does
+ * not have own cell item, text is asked from the model
+ */
+std::string TgGridViewPrivate::getCellText(size_t column, size_t row)
+{
+    TG_FUNCTION_BEGIN();
+    std::string ret;
+    uint64_t key = getCellKey(column, row);
+    m_mutex.lock();
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it = m_listCell.find(key);
+    if (it != m_listCell.end()) {
+        ret = it->second->m_private->getText();
+    } else if (m_model) {
+        m_mutex.unlock();
+        m_modelMutex.lock();
+        TgGridViewModel *model = getModel();
+        if (model && column < model->getColumnCount() && row < model->getRowCount()) {
+            ret = model->getCellText(column, row);
         }
+        m_modelMutex.unlock();
+        TG_FUNCTION_END();
+        return ret;
     } else {
-        for (y=0;y<row;y++) {
-            for (x=0;x<m_columnCount;x++) {
-                m_listItems.push_back(tmpList[y*m_columnCount+x]);
-            }
+        std::unordered_map<uint64_t, TgGridViewCellData>::iterator itData = m_listCellData.find(key);
+        if (itData != m_listCellData.end()) {
+            ret = itData->second.m_text;
         }
-        for (y=row;y<m_rowCount;y++) {
-            for (x=0;x<m_columnCount;x++) {
-                tmpList[y*m_columnCount+x]->setVisible(false);
-                TgGlobalDeleter::getInstance()->add(tmpList[y*m_columnCount+x]);
-            }
+    }
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*! \brief TgGridViewPrivate::setCellBackground
+ * \param column
+ * \param row
+ * \param r red
+ * \param g green
+ * \param b blue
+ * \param a alpha
+ */
+void TgGridViewPrivate::setCellBackground(size_t column, size_t row, const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (column >= m_columnCount || row >= m_rowCount) {
+        TG_WARNING_LOG("Incorrect cell, Column:", column, "/", m_columnCount, "Row:", row, "/", m_rowCount );
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    if (m_model) {
+        TG_WARNING_LOG("Cell background is taken from the model, Column:", column, "Row:", row);
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    uint64_t key = getCellKey(column, row);
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it = m_listCell.find(key);
+    if (it != m_listCell.end()) {
+        it->second->m_private->setBackground(r, g, b, a);
+    } else {
+        m_listCellData[key].m_background = (static_cast<uint32_t>(r) << 24) | (static_cast<uint32_t>(g) << 16)
+                                            | (static_cast<uint32_t>(b) << 8) | static_cast<uint32_t>(a);
+        it = m_listPoolCellInUse.find(key);
+        if (it != m_listPoolCellInUse.end()) {
+            it->second->m_private->setBackground(r, g, b, a);
         }
     }
-    tmpList.clear();
-    m_rowCount = row;
-    setGridCellsPositions();
-    setSliderVisibilityAndPosition();
-    static_cast<TgItem2d *>(m_currentItem)->setPositionChanged(true);
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::setColumnWidth
+ * \param column
+ * \param width new width of the column
+ */
+void TgGridViewPrivate::setColumnWidth(size_t column, float width)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (column >= m_columnCount) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_listColumnWidth[column] = width;
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    for (it=m_listCell.begin();it!=m_listCell.end();it++) {
+        if (it->second->m_private->getColumn() == column) {
+            reinterpret_cast<TgItem2d *>(it->second)->m_private->setWidth(width, false);
+        }
+    }
+    updatePositions(m_listColumnWidth, m_listColumnPosition, column);
+    m_visibleCellsChanged = true;
+    m_mutex.unlock();
+    m_currentItem->setPositionChanged(true);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::getColumnWidth
+ * \param column
+ * \return width of the column, 0 if column doesn't exist
+ */
+float TgGridViewPrivate::getColumnWidth(size_t column)
+{
+    float ret = 0;
+    m_mutex.lock();
+    if (column < m_columnCount) {
+        ret = m_listColumnWidth[column];
+    }
+    m_mutex.unlock();
+    return ret;
+}
+
+/*! \brief TgGridViewPrivate::setRowHeight
+ * \param row
+ * \param height new height of the row
+ */
+void TgGridViewPrivate::setRowHeight(size_t row, float height)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (row >= m_rowCount) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_listRowHeight[row] = height;
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    for (it=m_listCell.begin();it!=m_listCell.end();it++) {
+        if (it->second->m_private->getRow() == row) {
+            reinterpret_cast<TgItem2d *>(it->second)->m_private->setHeight(height, false);
+        }
+    }
+    updatePositions(m_listRowHeight, m_listRowPosition, row);
+    m_visibleCellsChanged = true;
+    m_mutex.unlock();
+    m_currentItem->setPositionChanged(true);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::getRowHeight
+ * \param row
+ * \return height of the row, 0 if row doesn't exist
+ */
+float TgGridViewPrivate::getRowHeight(size_t row)
+{
+    float ret = 0;
+    m_mutex.lock();
+    if (row < m_rowCount) {
+        ret = m_listRowHeight[row];
+    }
+    m_mutex.unlock();
+    return ret;
+}
+
+/*! \brief TgGridViewPrivate::setRowCount
+ * \param row
+ */
+void TgGridViewPrivate::setRowCount(size_t row)
+{
+    TG_FUNCTION_BEGIN();
+    if (row == m_rowCount) {
+        TG_FUNCTION_END();
+        return;
+    }
+    TgGlobalWaitRenderer::getInstance()->renderLock();
+    setColumnAndRowCount(m_columnCount, row);
     TgGlobalWaitRenderer::getInstance()->renderUnlock();
     TG_FUNCTION_END();
 }
 
-void TgGridViewPrivate::clear()
+/*! \brief TgGridViewPrivate::removeCells
+ * removes cell items and cell data that are outside
+ * of the new column and row count
+ *
+ * m_mutex must be locked when this is called
+ *
+ * \param columnCount new column count
+ * \param rowCount new row count
+ */
+void TgGridViewPrivate::removeCells(size_t columnCount, size_t rowCount)
 {
     TG_FUNCTION_BEGIN();
-    for (size_t i=0;i<m_listItems.size();i++) {
-        m_listItems[i]->setVisible(false);
-        TgGlobalDeleter::getInstance()->add(m_listItems[i]);
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    for (it=m_listCell.begin();it!=m_listCell.end();) {
+        if (it->second->m_private->getColumn() >= columnCount || it->second->m_private->getRow() >= rowCount) {
+            it->second->setVisible(false);
+            TgGlobalDeleter::getInstance()->add(it->second);
+            it = m_listCell.erase(it);
+        } else {
+            it++;
+        }
+    }
+    for (it=m_listPoolCellInUse.begin();it!=m_listPoolCellInUse.end();) {
+        if (static_cast<size_t>(it->first & 0xFFFFFFFF) >= columnCount || static_cast<size_t>(it->first >> 32) >= rowCount) {
+            releasePoolCell(it->second);
+            it = m_listPoolCellInUse.erase(it);
+        } else {
+            it++;
+        }
+    }
+    std::unordered_map<uint64_t, TgGridViewCellData>::iterator itData;
+    for (itData=m_listCellData.begin();itData!=m_listCellData.end();) {
+        if (static_cast<size_t>(itData->first & 0xFFFFFFFF) >= columnCount || static_cast<size_t>(itData->first >> 32) >= rowCount) {
+            itData = m_listCellData.erase(itData);
+        } else {
+            itData++;
+        }
     }
-    m_listItems.clear();
     TG_FUNCTION_END();
 }
 
@@ -350,108 +1053,125 @@ void TgGridViewPrivate::setColumCount(size_t column)
         return;
     }
     TgGlobalWaitRenderer::getInstance()->renderLock();
-    if (column == 0) {
-        clear();
-        m_columnCount = column;
-        setGridCellsPositions();
-        setSliderVisibilityAndPosition();
-        TgGlobalWaitRenderer::getInstance()->renderUnlock();
+    setColumnAndRowCount(column, m_rowCount);
+    TgGlobalWaitRenderer::getInstance()->renderUnlock();
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridViewPrivate::setColumnAndRowCount
+ * sets column and row count at once, so render
+ * never sees only one of them changed
+ *
+ * render lock must be locked when this is called
+ *
+ * \param column column count
+ * \param row row count
+ */
+void TgGridViewPrivate::setColumnAndRowCount(size_t column, size_t row)
+{
+    TG_FUNCTION_BEGIN();
+    size_t start;
+    m_mutex.lock();
+    if (column == m_columnCount && row == m_rowCount) {
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return;
     }
-    std::vector<TgGridViewCell *>tmpList;
-    for (size_t i=0;i<m_listItems.size();i++) {
-        tmpList.push_back(m_listItems.at(i));
-    }
-    size_t x, y;
-    float posX, posY;
-    float newHeight;
-    TgGridViewCell *cell;
-    m_listItems.clear();
-    if (column > m_columnCount) {
-        for (y=0;y<m_rowCount;y++) {
-            for (x=0;x<column;x++) {
-                if (x < m_columnCount) {
-                    m_listItems.push_back(tmpList[y*m_columnCount+x]);
-                    continue;
-                }
-                if (x == 0) {
-                    posX = DEFAULT_GRID_CELL_BORDER;
-                    newHeight = DEFAULT_GRID_CELL_HEIGHT;
-                } else {
-                    cell = m_listItems[y*column+x-1];
-                    posX = cell->getX() + cell->getWidth() + DEFAULT_GRID_CELL_BORDER;
-                    newHeight = cell->getHeight();
-                }
-                if (y == 0) {
-                    posY = DEFAULT_GRID_CELL_BORDER;
-                } else {
-                    cell = m_listItems[ (y-1)*column+x];
-                    posY = cell->getY() + cell->getHeight() + DEFAULT_GRID_CELL_BORDER;
-                }
-                m_listItems.push_back(new TgGridViewCell(m_currentItem,
-                        posX, posY,
-                        static_cast<float>(DEFAULT_GRID_CELL_WIDTH),
-                        newHeight ));
-            }
+    if (column != m_columnCount) {
+        if (column < m_columnCount) {
+            removeCells(column, m_rowCount);
         }
-    } else {
-        for (y=0;y<m_rowCount;y++) {
-            for (x=0;x<column;x++) {
-                m_listItems.push_back(tmpList[y*m_columnCount+x]);
-            }
+        if (column == 0) {
+            std::fill(m_listRowHeight.begin(), m_listRowHeight.end(), static_cast<float>(DEFAULT_GRID_CELL_HEIGHT));
+            updatePositions(m_listRowHeight, m_listRowPosition, 0);
         }
-        for (y=0;y<m_rowCount;y++) {
-            for (x=column;x<m_columnCount;x++) {
-                tmpList[y*m_columnCount+x]->setVisible(false);
-                TgGlobalDeleter::getInstance()->add(tmpList[y*m_columnCount+x]);
-            }
+        start = std::min(column, m_columnCount);
+        m_listColumnWidth.resize(column, static_cast<float>(DEFAULT_GRID_CELL_WIDTH));
+        updatePositions(m_listColumnWidth, m_listColumnPosition, start);
+        m_columnCount = column;
+    }
+    if (row != m_rowCount) {
+        if (row < m_rowCount) {
+            removeCells(m_columnCount, row);
+        }
+        if (row == 0) {
+            std::fill(m_listColumnWidth.begin(), m_listColumnWidth.end(), static_cast<float>(DEFAULT_GRID_CELL_WIDTH));
+            updatePositions(m_listColumnWidth, m_listColumnPosition, 0);
         }
+        start = std::min(row, m_rowCount);
+        m_listRowHeight.resize(row, static_cast<float>(DEFAULT_GRID_CELL_HEIGHT));
+        updatePositions(m_listRowHeight, m_listRowPosition, start);
+        m_rowCount = row;
     }
-    tmpList.clear();
-    m_columnCount = column;
-    setGridCellsPositions();
+    m_visibleCellsChanged = true;
+    m_mutex.unlock();
     setSliderVisibilityAndPosition();
     static_cast<TgItem2d *>(m_currentItem)->setPositionChanged(true);
-    TgGlobalWaitRenderer::getInstance()->renderUnlock();
     TG_FUNCTION_END();
 }
 
 /*! \brief TgGridViewPrivate::cellWidthTypeChanged
  * when cell type is changed, this is called
+ * with SizeFollowTextSize, column width follows the widest text of the column,
+ * texts set with setCellText() are measured with the font of the cell,
+ * texts of the model are not measured
  * \param type new widtht of the cell
  * \param cell
  */
 void TgGridViewPrivate::cellWidthTypeChanged(TgGridViewCellSizeType type, TgGridViewCell *cell)
 {
     TG_FUNCTION_BEGIN();
-    size_t x, y, y2;
     float fRequiredWidth, w;
-    for (y=0;y<m_rowCount;y++) {
-        for (x=0;x<m_columnCount;x++) {
-            if (getCell(x, y) == cell) {
-                fRequiredWidth = cell->m_private->getCellRequiredWidth();
-                if (type == TgGridViewCellSizeType::TgGridViewCellSize_SizeFollowTextSize) {
-                    for (y2=0;y2<m_rowCount;y2++) {
-                        if (y != y2) {
-                            w = getCell(x, y2)->m_private->getCellRequiredWidth();
-                            if (w > fRequiredWidth) {
-                                fRequiredWidth = w;
-                            }
-                        }
-                    }
-                }
-                for (y2=0;y2<m_rowCount;y2++) {
-                    reinterpret_cast<TgItem2d *>(getCell(x, y2))->m_private->setWidth(fRequiredWidth, false);
-                    getCell(x, y2)->m_private->setWidthType(type, false);
+    size_t column = cell->m_private->getColumn();
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it;
+    m_mutex.lock();
+    if (!isCell(cell)) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    fRequiredWidth = cell->m_private->getCellRequiredWidth();
+    if (type == TgGridViewCellSizeType::TgGridViewCellSize_SizeFollowTextSize) {
+        for (it=m_listCell.begin();it!=m_listCell.end();it++) {
+            if (it->second != cell && it->second->m_private->getColumn() == column) {
+                w = it->second->m_private->getCellRequiredWidth();
+                if (w > fRequiredWidth) {
+                    fRequiredWidth = w;
                 }
-                setGridCellsPositions();
-                m_currentItem->setPositionChanged(true);
-                TG_FUNCTION_END();
-                return;
             }
         }
+        // cells without own cell item, each different text is measured once
+        std::unordered_set<std::string> listText;
+        std::unordered_map<uint64_t, TgGridViewCellData>::iterator itData;
+        for (itData=m_listCellData.begin();itData!=m_listCellData.end();itData++) {
+            if ((itData->first & 0xFFFFFFFF) == column && !itData->second.m_text.empty()) {
+                listText.insert(itData->second.m_text);
+            }
+        }
+        std::vector<TgTextMeasureRequest> listRequest;
+        std::unordered_set<std::string>::iterator itText;
+        for (itText=listText.begin();itText!=listText.end();itText++) {
+            listRequest.push_back(cell->m_private->getTextMeasureRequest(*itText));
+        }
+        std::vector<TgTextMeasureResult> listResult = TgFontMath::measureTexts(listRequest);
+        for (size_t i=0;i<listResult.size();i++) {
+            w = cell->m_private->getCellRequiredWidth(listResult[i].m_textWidth);
+            if (listResult[i].m_valid && w > fRequiredWidth) {
+                fRequiredWidth = w;
+            }
+        }
+    }
+    m_listColumnWidth[column] = fRequiredWidth;
+    for (it=m_listCell.begin();it!=m_listCell.end();it++) {
+        if (it->second->m_private->getColumn() == column) {
+            reinterpret_cast<TgItem2d *>(it->second)->m_private->setWidth(fRequiredWidth, false);
+            it->second->m_private->setWidthType(type, false);
+        }
     }
+    updatePositions(m_listColumnWidth, m_listColumnPosition, column);
+    m_visibleCellsChanged = true;
+    m_mutex.unlock();
+    m_currentItem->setPositionChanged(true);
     TG_FUNCTION_END();
 }
 
@@ -463,21 +1183,8 @@ void TgGridViewPrivate::cellWidthTypeChanged(TgGridViewCellSizeType type, TgGrid
 void TgGridViewPrivate::widthCellChanged(float width, TgGridViewCell *cell)
 {
     TG_FUNCTION_BEGIN();
-    size_t x, y, y2;
-    for (y=0;y<m_rowCount;y++) {
-        for (x=0;x<m_columnCount;x++) {
-            if (getCell(x, y) == cell) {
-                for (y2=0;y2<m_rowCount;y2++) {
-                    if (y != y2) {
-                        reinterpret_cast<TgItem2d *>(getCell(x, y2))->m_private->setWidth(width, false);
-                    }
-                }
-                setGridCellsPositions();
-                m_currentItem->setPositionChanged(true);
-                TG_FUNCTION_END();
-                return;
-            }
-        }
+    if (isCell(cell)) {
+        setColumnWidth(cell->m_private->getColumn(), width);
     }
     TG_FUNCTION_END();
 }
@@ -490,25 +1197,26 @@ void TgGridViewPrivate::widthCellChanged(float width, TgGridViewCell *cell)
 void TgGridViewPrivate::heightCellChanged(float height, TgGridViewCell *cell)
 {
     TG_FUNCTION_BEGIN();
-    size_t x, y, x2;
-    for (y=0;y<m_rowCount;y++) {
-        for (x=0;x<m_columnCount;x++) {
-            if (getCell(x, y) == cell) {
-                for (x2=0;x2<m_columnCount;x2++) {
-                    if (x != x2) {
-                        reinterpret_cast<TgItem2d *>(getCell(x2, y))->m_private->setHeight(height, false);
-                    }
-                }
-                setGridCellsPositions();
-                m_currentItem->setPositionChanged(true);
-                TG_FUNCTION_END();
-                return;
-            }
-        }
+    if (isCell(cell)) {
+        setRowHeight(cell->m_private->getRow(), height);
     }
     TG_FUNCTION_END();
 }
 
+/*! \brief TgGridViewPrivate::isCell
+ * \param cell
+ * \return true if cell is still cell item of this grid view
+ */
+bool TgGridViewPrivate::isCell(TgGridViewCell *cell)
+{
+    m_mutex.lock();
+    std::unordered_map<uint64_t, TgGridViewCell *>::iterator it = m_listCell.find(getCellKey(cell->m_private->getColumn(), cell->m_private->getRow()));
+    bool ret = it != m_listCell.end() && it->second == cell;
+    m_mutex.unlock();
+    return ret;
+}
+
+
 /*!
  * \brief TgGridViewPrivate::setMouseScrollMove
  *
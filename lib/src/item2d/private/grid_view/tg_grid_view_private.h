@@ -13,10 +13,50 @@
 #define TG_GRID_VIEW_PRIVATE_H
 
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "../../tg_rectangle.h"
 #include "../../tg_slider.h"
 #include "../../tg_grid_view_cell.h"
 class TgGridView;
+class TgGridViewModel;
+
+/*!
+ * \brief TgGridViewCellData
+ * text and background of the cell that does not have own cell item,
+ * it is drawn by the pooled cell item when the cell is visible
+ */
+struct TgGridViewCellData
+{
+    std::string m_text;
+    uint32_t m_background = 0xFFFFFFFF;
+};
+
+/*!
+ * \brief TgGridViewModelCellData
+ * text and background of the cell asked from the model
+ */
+struct TgGridViewModelCellData
+{
+    uint64_t m_key;
+    TgGridViewCellData m_data;
+    bool m_backgroundSet = false;   /*!< false if model does not give background for the cell */
+};
+
+/*!
+ * \brief TgGridViewCellRange
+ * range of changed cells, end column and row are not included
+ */
+struct TgGridViewCellRange
+{
+    size_t m_columnStart;
+    size_t m_columnEnd;
+    size_t m_rowStart;
+    size_t m_rowEnd;
+};
 
 class TgGridViewPrivate
 {
@@ -28,11 +68,23 @@ public:
     void setRowCount(size_t row);
     void setColumCount(size_t column);
     TgGridViewCell *getCell(size_t column, size_t row);
+    void setCellText(size_t column, size_t row, const char *text);
+    std::string getCellText(size_t column, size_t row);
+    void setCellBackground(size_t column, size_t row, const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a);
+    void setColumnWidth(size_t column, float width);
+    float getColumnWidth(size_t column);
+    void setRowHeight(size_t row, float height);
+    float getRowHeight(size_t row);
+    void setModel(TgGridViewModel *model);
+    TgGridViewModel *getModel();
+    void modelCellsChanged(size_t column, size_t row, size_t columnCount, size_t rowCount);
+    void modelSizeChanged();
     void cellWidthTypeChanged(TgGridViewCellSizeType type, TgGridViewCell *cell);
     void widthCellChanged(float width, TgGridViewCell *cell);
     void heightCellChanged(float height, TgGridViewCell *cell);
 
     void setSliderVisibilityAndPosition();
+    void checkVisibleCells();
     void setMouseScrollMove(int64_t x, int64_t y);
     void setMouseScrollMultiplier(uint32_t multiplier);
     uint32_t getMouseScrollMultiplier();
@@ -44,7 +96,30 @@ private:
     TgSlider m_verticalSlider;
     TgSlider m_horizontalSlider;
 
-    std::vector<TgGridViewCell *>m_listItems;
+    std::recursive_mutex m_mutex;
+    std::mutex m_modelMutex;                            /*!< locked while model is asked, so model is not removed meanwhile */
+    std::vector<float> m_listColumnWidth;
+    std::vector<float> m_listRowHeight;
+    std::vector<double> m_listColumnPosition;
+    std::vector<double> m_listRowPosition;
+    std::unordered_map<uint64_t, TgGridViewCell *> m_listCell;
+    std::unordered_map<uint64_t, TgGridViewCellData> m_listCellData;
+    std::unordered_map<uint64_t, TgGridViewCell *> m_listPoolCellInUse;
+    std::vector<TgGridViewCell *> m_listPoolCell;
+    std::vector<TgGridViewCell *> m_listFreePoolCell;
+    std::vector<uint64_t> m_listVisibleCell;
+    size_t m_visibleColumnStart = 0;
+    size_t m_visibleColumnEnd = 0;
+    size_t m_visibleRowStart = 0;
+    size_t m_visibleRowEnd = 0;
+    bool m_visibleCellsChanged = false;
+    bool m_slidersToTop = false;
+    TgGridViewModel *m_model = nullptr;
+    std::vector<TgGridViewCellRange> m_listChangedRange;
+    bool m_allCellsChanged = false;
+    std::vector<uint64_t> m_listModelDataCell;         /*!< cells that are waiting data from the model */
+    bool m_modelSizeChanged = false;
+
     size_t m_columnCount = 0;
     size_t m_rowCount = 0;
     size_t m_maxInnerAreaWidth = 0;
@@ -53,13 +128,26 @@ private:
     uint64_t m_previousHorizontalSliderPosition = 0;
     uint32_t m_multiplier = 1;
 
-    void setGridCellsPositions();
+    void updateVisibleCells();
+    void bindPoolCell(TgGridViewCell *cell, uint64_t key);
+    void releasePoolCell(TgGridViewCell *cell);
+    void updateChangedCells();
+    bool isCellChanged(uint64_t key);
+    void updateModelSize();
+    void updateModelData();
+    void setModelDataToCell(TgGridViewCell *cell, const TgGridViewModelCellData &modelCellData, bool defaultBackground);
+    void setColumnAndRowCount(size_t column, size_t row);
+    void setSlidersToTop();
     void onVerticalSliderPositionChanged(uint64_t position);
     void onHorizontalSliderPositionChanged(uint64_t position);
     bool isSliderRequired(bool horizontal);
     bool setSliderVisibilityAndPositionHor();
     bool setSliderVisibilityAndPositionVer();
-    void clear();
+    void removeCells(size_t columnCount, size_t rowCount);
+    bool isCell(TgGridViewCell *cell);
+    static void updatePositions(const std::vector<float> &listSize, std::vector<double> &listPosition, size_t start);
+    static void getVisibleRange(const std::vector<double> &listPosition, double start, double end, size_t &first, size_t &last);
+    static uint64_t getCellKey(size_t column, size_t row);
     static void setMouseScrollMove(int64_t value, TgSlider &slider);
 };
 
@@ -0,0 +1,527 @@
+/*!
+ * \file
+ * \brief file tg_text_document_private.cpp
+ *
+ * it holds general TgTextDocumentPrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_text_document_private.h"
+#include <cmath>
+#include <cstdint>
+#include "../../../global/tg_global_log.h"
+#include "../../../global/tg_global_application.h"
+#include "../../../global/private/tg_global_deleter.h"
+#include "../../../global/private/tg_global_wait_renderer.h"
+#include "../../../font/tg_font_math.h"
+#include "../../../font/tg_font_default.h"
+#include "../../tg_text_document.h"
+
+#define DEFAULT_TEXT_DOCUMENT_SLIDER    15
+
+TgTextDocumentPrivate::TgTextDocumentPrivate(TgTextDocument *currentItem, const char *fontFile, float fontSize, uint8_t r, uint8_t g, uint8_t b) :
+    m_currentItem(currentItem),
+    m_backgroundVerticalSlider(currentItem, 0, 0, DEFAULT_TEXT_DOCUMENT_SLIDER, DEFAULT_TEXT_DOCUMENT_SLIDER, 128, 128, 128),
+    m_verticalSlider(currentItem, 0, 0, DEFAULT_TEXT_DOCUMENT_SLIDER, 100, TgSliderType::SliderType_Vertical),
+    m_invalidLineStart(SIZE_MAX),
+    m_invalidLineEnd(0),
+    m_fontSize(fontSize),
+    m_textColorR(r),
+    m_textColorG(g),
+    m_textColorB(b),
+    m_lineHeight(0),
+    m_firstVisibleLine(0),
+    m_visibleLineCount(0),
+    m_updateRequired(true),
+    m_previousVerticalSliderPosition(0),
+    m_multiplier(1)
+{
+    TG_FUNCTION_BEGIN();
+    if (fontFile && fontFile[0]) {
+        m_fontFile = fontFile;
+    } else {
+        m_fontFile = TgGlobalApplication::getInstance()->getFontDefault()->getDefaultFont();
+    }
+    m_backgroundVerticalSlider.setVisible(false);
+    m_verticalSlider.setVisible(false);
+    m_verticalSlider.connectOnSliderPositionChanged( std::bind(&TgTextDocumentPrivate::onVerticalSliderPositionChanged, this, std::placeholders::_1) );
+    TG_FUNCTION_END();
+}
+
+TgTextDocumentPrivate::~TgTextDocumentPrivate()
+{
+    std::vector<TgTextfield *>::iterator it;
+    for (it=m_listRow.begin();it!=m_listRow.end();it++) {
+        if (*it) {
+            delete *it;
+        }
+    }
+    m_listRow.clear();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setText
+ *
+ * replaces the whole text of document
+ *
+ * \param text utf8 text
+ */
+void TgTextDocumentPrivate::setText(const char *text)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_pieceTable.setText(text ? text : "");
+    m_firstVisibleLine = 0;
+    invalidateLines(0, SIZE_MAX);
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::appendText
+ *
+ * adds text to end of document
+ *
+ * \param text utf8 text
+ */
+void TgTextDocumentPrivate::appendText(const char *text)
+{
+    TG_FUNCTION_BEGIN();
+    if (!text || !text[0]) {
+        TG_FUNCTION_END();
+        return;
+    }
+    m_mutex.lock();
+    size_t line = m_pieceTable.getLineCount()-1;
+    m_pieceTable.insert(m_pieceTable.getLength(), text);
+    invalidateLines(line, getLineBreakCount(text) ? SIZE_MAX : line);
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::insertText
+ *
+ * inserts text into document
+ *
+ * \param line line index (0 is first line)
+ * \param column character index in line
+ * \param text utf8 text
+ * \return true if line and column were valid
+ */
+bool TgTextDocumentPrivate::insertText(size_t line, size_t column, const char *text)
+{
+    TG_FUNCTION_BEGIN();
+    if (!text || !text[0]) {
+        TG_FUNCTION_END();
+        return true;
+    }
+    size_t offset;
+    m_mutex.lock();
+    if (!m_pieceTable.getOffset(line, column, offset)) {
+        m_mutex.unlock();
+        TG_WARNING_LOG("Incorrect position, Line:", line, "Column:", column);
+        TG_FUNCTION_END();
+        return false;
+    }
+    m_pieceTable.insert(offset, text);
+    invalidateLines(line, getLineBreakCount(text) ? SIZE_MAX : line);
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::removeText
+ *
+ * removes text from document, removed text can
+ * continue to next lines (line break is one character)
+ *
+ * \param line line index (0 is first line)
+ * \param column character index in line
+ * \param characterCount number of characters to remove
+ * \return true if line and column were valid
+ */
+bool TgTextDocumentPrivate::removeText(size_t line, size_t column, size_t characterCount)
+{
+    TG_FUNCTION_BEGIN();
+    size_t offset;
+    m_mutex.lock();
+    if (!m_pieceTable.getOffset(line, column, offset)) {
+        m_mutex.unlock();
+        TG_WARNING_LOG("Incorrect position, Line:", line, "Column:", column);
+        TG_FUNCTION_END();
+        return false;
+    }
+    size_t lineCount = m_pieceTable.getLineCount();
+    m_pieceTable.remove(offset, m_pieceTable.getOffsetAfterCharacters(offset, characterCount) - offset);
+    invalidateLines(line, lineCount != m_pieceTable.getLineCount() ? SIZE_MAX : line);
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getText
+ *
+ * \return whole document as utf8 text
+ */
+std::string TgTextDocumentPrivate::getText()
+{
+    m_mutex.lock();
+    std::string ret = m_pieceTable.getText();
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getLine
+ *
+ * \param line line index (0 is first line)
+ * \return utf8 text of the line (without line break)
+ */
+std::string TgTextDocumentPrivate::getLine(size_t line)
+{
+    m_mutex.lock();
+    std::string ret = m_pieceTable.getLine(line);
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getLineCount
+ *
+ * \return number of lines in document
+ */
+size_t TgTextDocumentPrivate::getLineCount()
+{
+    m_mutex.lock();
+    size_t ret = m_pieceTable.getLineCount();
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setFirstVisibleLine
+ *
+ * scrolls the document, line is limited so that
+ * last line is still at the bottom of the document view
+ *
+ * \param line line index (0 is first line)
+ */
+void TgTextDocumentPrivate::setFirstVisibleLine(size_t line)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_firstVisibleLine = line;
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getFirstVisibleLine
+ *
+ * \return line index of the top most line
+ */
+size_t TgTextDocumentPrivate::getFirstVisibleLine()
+{
+    m_mutex.lock();
+    size_t ret = m_firstVisibleLine;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getVisibleLineCount
+ *
+ * \return number of lines that fully fit into document view,
+ * this is updated on rendering
+ */
+size_t TgTextDocumentPrivate::getVisibleLineCount()
+{
+    m_mutex.lock();
+    size_t ret = m_visibleLineCount;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getUpdateRequired
+ *
+ * \return true if text or first visible line is changed
+ * after previous updateVisibleLines()
+ */
+bool TgTextDocumentPrivate::getUpdateRequired()
+{
+    m_mutex.lock();
+    bool ret = m_updateRequired;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::updateVisibleLines
+ *
+ * updates slider and the rows, only the lines that are visible
+ * are laid out, rows that still show the same line are only moved.
+ * Slider is updated without the lock, because slider's position
+ * callback locks m_mutex. This is called before rendering
+ *
+ * \param positionChanged true if document view's position or size has changed
+ */
+void TgTextDocumentPrivate::updateVisibleLines(bool positionChanged)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (m_lineHeight <= 0) {
+        std::vector<TgTextFieldText> listText(1);
+        listText[0].m_text = "Ag";
+        float textWidth, textHeight, allDrawTextHeight;
+        TgFontMath::getFontWidthHeightCacheWithoutRender(listText, m_fontSize, m_fontFile, textWidth, textHeight, allDrawTextHeight,
+                                                        1, 0, TgTextFieldWordWrap::WordWrapOff, false);
+        if (textHeight <= 0) {
+            textHeight = m_fontSize;
+        }
+        m_lineHeight = std::ceil(textHeight*1.5f);
+        positionChanged = true;
+    }
+    const float w = m_currentItem->getWidth();
+    const float h = m_currentItem->getHeight();
+    const size_t lineCount = m_pieceTable.getLineCount();
+    m_visibleLineCount = h > 0 ? static_cast<size_t>(h/m_lineHeight) : 0;
+    if (m_visibleLineCount == 0) {
+        m_visibleLineCount = 1;
+    }
+    size_t maxFirstVisibleLine = lineCount > m_visibleLineCount ? lineCount - m_visibleLineCount : 0;
+    if (m_firstVisibleLine > maxFirstVisibleLine) {
+        m_firstVisibleLine = maxFirstVisibleLine;
+    }
+    const bool sliderVisible = maxFirstVisibleLine > 0;
+    const bool sliderChanged = positionChanged || sliderVisible != m_verticalSlider.getVisible();
+    if (sliderChanged) {
+        positionChanged = true;
+    }
+    // slider callback ignores the position that is already set here
+    m_previousVerticalSliderPosition = m_firstVisibleLine;
+    const size_t firstVisibleLine = m_firstVisibleLine;
+
+    size_t rowCount = h > 0 ? static_cast<size_t>(std::ceil(h/m_lineHeight)) : 0;
+    if (rowCount != m_listRow.size() || positionChanged) {
+        setRowCount(rowCount, sliderVisible ? w-DEFAULT_TEXT_DOCUMENT_SLIDER : w);
+    }
+    setRowTexts();
+    m_updateRequired = false;
+    m_mutex.unlock();
+
+    if (sliderChanged) {
+        m_backgroundVerticalSlider.TgItem2d::setX(w-DEFAULT_TEXT_DOCUMENT_SLIDER);
+        m_backgroundVerticalSlider.TgItem2d::setHeight(h);
+        m_verticalSlider.TgItem2d::setX(w-DEFAULT_TEXT_DOCUMENT_SLIDER);
+        m_verticalSlider.setHeight(h);
+        m_backgroundVerticalSlider.setVisible(sliderVisible);
+        m_verticalSlider.setVisible(sliderVisible);
+    }
+    m_verticalSlider.setSliderMaxPosition(maxFirstVisibleLine);
+    m_verticalSlider.setSliderCurrentPosition(firstVisibleLine);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setRowCount
+ *
+ * creates or removes the rows, and sets width of rows
+ *
+ * \param rowCount number of rows that are needed to fill document view
+ * \param rowWidth width of row
+ */
+void TgTextDocumentPrivate::setRowCount(size_t rowCount, float rowWidth)
+{
+    TG_FUNCTION_BEGIN();
+    size_t i;
+    if (rowCount != m_listRow.size()) {
+        if (rowCount < m_listRow.size()) {
+            for (i=rowCount;i<m_listRow.size();i++) {
+                m_listRow[i]->setVisible(false);
+                TgGlobalDeleter::getInstance()->add(m_listRow[i]);
+            }
+            m_listRow.resize(rowCount);
+        } else {
+            TgTextfield *row;
+            for (i=m_listRow.size();i<rowCount;i++) {
+                row = new TgTextfield(m_currentItem, 0, 0, rowWidth, m_lineHeight, "", m_fontFile.c_str(), m_fontSize,
+                                      m_textColorR, m_textColorG, m_textColorB);
+                row->setWordWrap(TgTextFieldWordWrap::WordWrapOff);
+                row->setMaxLineCount(1);
+                row->setVisible(false);
+                m_listRow.push_back(row);
+            }
+            m_backgroundVerticalSlider.setToTop();
+            m_verticalSlider.setToTop();
+        }
+        // line to row mapping depends on row count
+        m_listRowLine.assign(rowCount, SIZE_MAX);
+    }
+    for (i=0;i<m_listRow.size();i++) {
+        m_listRow[i]->setWidth(rowWidth);
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setRowTexts
+ *
+ * sets visible lines into rows, row keeps its laid out text
+ * as long as its line is visible and not edited
+ */
+void TgTextDocumentPrivate::setRowTexts()
+{
+    TG_FUNCTION_BEGIN();
+    const size_t rowCount = m_listRow.size();
+    const size_t lineCount = m_pieceTable.getLineCount();
+    size_t i, line, index;
+    TgTextfield *row;
+    for (i=0;i<rowCount;i++) {
+        line = m_firstVisibleLine + i;
+        index = line % rowCount;
+        row = m_listRow[index];
+        if (line >= lineCount) {
+            row->setVisible(false);
+            m_listRowLine[index] = SIZE_MAX;
+            continue;
+        }
+        if (m_listRowLine[index] != line
+            || (line >= m_invalidLineStart && line <= m_invalidLineEnd)) {
+            row->setText(m_pieceTable.getLine(line).c_str());
+            m_listRowLine[index] = line;
+        }
+        row->TgItem2d::setY(static_cast<float>(i)*m_lineHeight);
+        row->setVisible(true);
+    }
+    m_invalidLineStart = SIZE_MAX;
+    m_invalidLineEnd = 0;
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::invalidateLines
+ *
+ * marks lines that must be laid out again
+ *
+ * \param lineStart first changed line
+ * \param lineEnd last changed line, SIZE_MAX if all lines after lineStart are changed
+ */
+void TgTextDocumentPrivate::invalidateLines(size_t lineStart, size_t lineEnd)
+{
+    if (lineStart < m_invalidLineStart) {
+        m_invalidLineStart = lineStart;
+    }
+    if (lineEnd > m_invalidLineEnd) {
+        m_invalidLineEnd = lineEnd;
+    }
+}
+
+/*! \brief TgTextDocumentPrivate::onVerticalSliderPositionChanged
+ * this is callback from vertical slider, when it's position is changed
+ * \param position new position
+ */
+void TgTextDocumentPrivate::onVerticalSliderPositionChanged(uint64_t position)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (m_previousVerticalSliderPosition == position) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_previousVerticalSliderPosition = position;
+    m_firstVisibleLine = static_cast<size_t>(position);
+    m_updateRequired = true;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setMouseScrollMove
+ *
+ * when mouse scroll move happens on text document, this is called
+ *
+ * \param y mouse scroll position move (y)
+ */
+void TgTextDocumentPrivate::setMouseScrollMove(int64_t y)
+{
+    TG_FUNCTION_BEGIN();
+    int64_t value = y*static_cast<int64_t>(m_multiplier);
+    if (value && m_verticalSlider.getVisible()) {
+        if (value > 0) {
+            if (m_verticalSlider.getSliderCurrentPosition() <= static_cast<uint64_t>(value)) {
+                m_verticalSlider.setSliderCurrentPosition(0);
+            } else {
+                m_verticalSlider.setSliderCurrentPosition(m_verticalSlider.getSliderCurrentPosition() - static_cast<uint64_t>(value));
+            }
+        } else {
+            value = -1*value;
+            uint64_t newValue = m_verticalSlider.getSliderCurrentPosition() + static_cast<uint64_t>(value);
+            if (m_verticalSlider.getSliderMaxPosition() < newValue) {
+                newValue = m_verticalSlider.getSliderMaxPosition();
+            }
+            m_verticalSlider.setSliderCurrentPosition(newValue);
+        }
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::setMouseScrollMultiplier
+ *
+ * set scroll move multiplier (lines)
+ * default: 1
+ * if scroll move is 1, and multiplier is 3, then scroll move is 3 lines
+ * \param multiplier
+ */
+void TgTextDocumentPrivate::setMouseScrollMultiplier(uint32_t multiplier)
+{
+    m_multiplier = multiplier;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getMouseScrollMultiplier
+ *
+ * get scroll move multiplier
+ *
+ * \return multiplier
+ */
+uint32_t TgTextDocumentPrivate::getMouseScrollMultiplier()
+{
+    return m_multiplier;
+}
+
+/*!
+ * \brief TgTextDocumentPrivate::getLineBreakCount
+ *
+ * \param text utf8 text
+ * \return number of '\n' in text
+ */
+size_t TgTextDocumentPrivate::getLineBreakCount(const char *text)
+{
+    size_t ret = 0;
+    for (;*text;text++) {
+        if (*text == '\n') {
+            ret++;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,80 @@
+/*!
+ * \file
+ * \brief file tg_text_document_private.h
+ *
+ * it holds general TgTextDocumentPrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TEXT_DOCUMENT_PRIVATE_H
+#define TG_TEXT_DOCUMENT_PRIVATE_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <string>
+#include "../../tg_rectangle.h"
+#include "../../tg_slider.h"
+#include "../../tg_textfield.h"
+#include "tg_text_piece_table.h"
+class TgTextDocument;
+
+class TgTextDocumentPrivate
+{
+public:
+    TgTextDocumentPrivate(TgTextDocument *currentItem, const char *fontFile, float fontSize, uint8_t r, uint8_t g, uint8_t b);
+    ~TgTextDocumentPrivate();
+
+    void setText(const char *text);
+    void appendText(const char *text);
+    bool insertText(size_t line, size_t column, const char *text);
+    bool removeText(size_t line, size_t column, size_t characterCount);
+    std::string getText();
+    std::string getLine(size_t line);
+    size_t getLineCount();
+
+    void setFirstVisibleLine(size_t line);
+    size_t getFirstVisibleLine();
+    size_t getVisibleLineCount();
+
+    bool getUpdateRequired();
+    void updateVisibleLines(bool positionChanged);
+    void setMouseScrollMove(int64_t y);
+    void setMouseScrollMultiplier(uint32_t multiplier);
+    uint32_t getMouseScrollMultiplier();
+
+private:
+    std::mutex m_mutex;
+    TgTextDocument *m_currentItem;
+    TgRectangle m_backgroundVerticalSlider;
+    TgSlider m_verticalSlider;
+
+    TgTextPieceTable m_pieceTable;
+    std::vector<TgTextfield *>m_listRow;        /*!< line is shown in row: m_listRow[line % m_listRow.size()] */
+    std::vector<size_t>m_listRowLine;           /*!< line that row (same index) has laid out, SIZE_MAX if none */
+    size_t m_invalidLineStart;                  /*!< rows from this line to m_invalidLineEnd must set their text again */
+    size_t m_invalidLineEnd;
+
+    std::string m_fontFile;
+    float m_fontSize;
+    uint8_t m_textColorR;
+    uint8_t m_textColorG;
+    uint8_t m_textColorB;
+    float m_lineHeight;
+    size_t m_firstVisibleLine;
+    size_t m_visibleLineCount;
+    bool m_updateRequired;
+    uint64_t m_previousVerticalSliderPosition;
+    uint32_t m_multiplier;
+
+    void invalidateLines(size_t lineStart, size_t lineEnd);
+    void setRowCount(size_t rowCount, float rowWidth);
+    void setRowTexts();
+    void onVerticalSliderPositionChanged(uint64_t position);
+    static size_t getLineBreakCount(const char *text);
+};
+
+#endif // TG_TEXT_DOCUMENT_PRIVATE_H
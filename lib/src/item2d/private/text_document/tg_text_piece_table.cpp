@@ -0,0 +1,413 @@
+/*!
+ * \file
+ * \brief file tg_text_piece_table.cpp
+ *
+ * piece table for (utf8) text document, original text is never
+ * copied or moved on edits, inserted text is appended into add buffer
+ * and the document is list of pieces pointing to these two buffers
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_text_piece_table.h"
+#include <algorithm>
+#include "../../../global/tg_global_log.h"
+
+TgTextPieceTable::TgTextPieceTable() :
+    m_length(0)
+{
+}
+
+/*!
+ * \brief TgTextPieceTable::setText
+ *
+ * replaces the whole document, add buffer is cleared
+ *
+ * \param text utf8 text
+ */
+void TgTextPieceTable::setText(const std::string &text)
+{
+    TG_FUNCTION_BEGIN();
+    m_original = text;
+    m_add.clear();
+    m_listOriginalLineBreak.clear();
+    m_listAddLineBreak.clear();
+    m_listPiece.clear();
+    addLineBreaks(m_original, 0, m_listOriginalLineBreak);
+    if (!m_original.empty()) {
+        m_listPiece.push_back({false, 0, m_original.size(), m_listOriginalLineBreak.size()});
+    }
+    m_length = m_original.size();
+    updatePieceIndex();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextPieceTable::getText
+ *
+ * \return whole document as utf8 text
+ */
+std::string TgTextPieceTable::getText() const
+{
+    std::string ret;
+    ret.reserve(m_length);
+    for (size_t i=0;i<m_listPiece.size();i++) {
+        ret.append(getBuffer(m_listPiece[i]), m_listPiece[i].m_start, m_listPiece[i].m_length);
+    }
+    return ret;
+}
+
+/*!
+ * \brief TgTextPieceTable::getLength
+ *
+ * \return length of document in bytes
+ */
+size_t TgTextPieceTable::getLength() const
+{
+    return m_length;
+}
+
+/*!
+ * \brief TgTextPieceTable::getLineCount
+ *
+ * \return number of lines, empty document has one (empty) line
+ */
+size_t TgTextPieceTable::getLineCount() const
+{
+    if (m_listPiece.empty()) {
+        return 1;
+    }
+    return m_listPieceLineBreak.back() + m_listPiece.back().m_lineBreakCount + 1;
+}
+
+/*!
+ * \brief TgTextPieceTable::getLine
+ *
+ * \param line line index (0 is first line)
+ * \return utf8 text of the line without '\n',
+ * empty string if line does not exist
+ */
+std::string TgTextPieceTable::getLine(size_t line) const
+{
+    std::string ret;
+    const size_t lineCount = getLineCount();
+    if (line >= lineCount) {
+        return ret;
+    }
+    size_t start = getLineStart(line);
+    size_t end = (line+1 < lineCount) ? getLineStart(line+1)-1 : m_length;
+    if (start >= end) {
+        return ret;
+    }
+    ret.reserve(end-start);
+    size_t i, pieceStart, pieceEnd, copyStart, copyEnd;
+    for (i=findPiece(start);i<m_listPiece.size();i++) {
+        pieceStart = m_listPieceOffset[i];
+        if (pieceStart >= end) {
+            break;
+        }
+        pieceEnd = pieceStart + m_listPiece[i].m_length;
+        copyStart = std::max(start, pieceStart);
+        copyEnd = std::min(end, pieceEnd);
+        ret.append(getBuffer(m_listPiece[i]), m_listPiece[i].m_start + copyStart - pieceStart, copyEnd - copyStart);
+    }
+    return ret;
+}
+
+/*!
+ * \brief TgTextPieceTable::getOffset
+ *
+ * converts line and column into document byte offset
+ *
+ * \param line line index (0 is first line)
+ * \param column character (not byte) index in line,
+ * this can be equal to number of characters in line
+ * \param offset [out] byte offset
+ * \return true if line and column are valid
+ */
+bool TgTextPieceTable::getOffset(size_t line, size_t column, size_t &offset) const
+{
+    const size_t lineCount = getLineCount();
+    if (line >= lineCount) {
+        return false;
+    }
+    size_t start = getLineStart(line);
+    size_t end = (line+1 < lineCount) ? getLineStart(line+1)-1 : m_length;
+    if (column > getCharacterCount(start, end)) {
+        return false;
+    }
+    offset = getOffsetAfterCharacters(start, column);
+    return true;
+}
+
+/*!
+ * \brief TgTextPieceTable::getCharacterCount
+ *
+ * \param start start byte offset
+ * \param end end byte offset
+ * \return number of (utf8) characters between start and end
+ */
+size_t TgTextPieceTable::getCharacterCount(size_t start, size_t end) const
+{
+    size_t i, inner, innerEnd, count = 0;
+    for (i=findPiece(start);i<m_listPiece.size() && m_listPieceOffset[i]<end;i++) {
+        const std::string &buffer = getBuffer(m_listPiece[i]);
+        inner = start > m_listPieceOffset[i] ? start - m_listPieceOffset[i] : 0;
+        innerEnd = std::min(m_listPiece[i].m_length, end - m_listPieceOffset[i]);
+        for (;inner<innerEnd;inner++) {
+            if ((static_cast<unsigned char>(buffer[m_listPiece[i].m_start+inner]) & 0xC0) != 0x80) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/*!
+ * \brief TgTextPieceTable::getOffsetAfterCharacters
+ *
+ * \param offset start byte offset
+ * \param characterCount number of (utf8) characters to skip
+ * \return byte offset after characterCount characters,
+ * or length of document if document ends before
+ */
+size_t TgTextPieceTable::getOffsetAfterCharacters(size_t offset, size_t characterCount) const
+{
+    if (offset >= m_length) {
+        return m_length;
+    }
+    size_t i, inner, count = 0;
+    unsigned char c;
+    for (i=findPiece(offset);i<m_listPiece.size();i++) {
+        const std::string &buffer = getBuffer(m_listPiece[i]);
+        for (inner=offset-m_listPieceOffset[i];inner<m_listPiece[i].m_length;inner++) {
+            c = static_cast<unsigned char>(buffer[m_listPiece[i].m_start+inner]);
+            if ((c & 0xC0) != 0x80) {
+                if (count == characterCount) {
+                    return offset;
+                }
+                count++;
+            }
+            offset++;
+        }
+    }
+    return m_length;
+}
+
+/*!
+ * \brief TgTextPieceTable::insert
+ *
+ * inserts text, text is appended into add buffer and only
+ * the piece on offset is split
+ *
+ * \param offset byte offset where text is inserted
+ * \param text utf8 text
+ */
+void TgTextPieceTable::insert(size_t offset, const std::string &text)
+{
+    TG_FUNCTION_BEGIN();
+    if (text.empty()) {
+        TG_FUNCTION_END();
+        return;
+    }
+    if (offset > m_length) {
+        offset = m_length;
+    }
+    const size_t addStart = m_add.size();
+    const size_t lineBreakCountBefore = m_listAddLineBreak.size();
+    addLineBreaks(text, addStart, m_listAddLineBreak);
+    m_add += text;
+    TgTextPiece piece = {true, addStart, text.size(), m_listAddLineBreak.size() - lineBreakCountBefore};
+
+    if (m_listPiece.empty()) {
+        m_listPiece.push_back(piece);
+    } else {
+        size_t i = findPiece(offset);
+        size_t inner = offset - m_listPieceOffset[i];
+        TgTextPiece &current = m_listPiece[i];
+        if (inner == 0) {
+            TgTextPiece *prev = i > 0 ? &m_listPiece[i-1] : nullptr;
+            if (prev && prev->m_addBuffer && prev->m_start + prev->m_length == addStart) {
+                // continuous typing, grow the previous piece
+                prev->m_length += piece.m_length;
+                prev->m_lineBreakCount += piece.m_lineBreakCount;
+            } else {
+                m_listPiece.insert(m_listPiece.begin() + static_cast<std::ptrdiff_t>(i), piece);
+            }
+        } else if (inner == current.m_length) {
+            if (current.m_addBuffer && current.m_start + current.m_length == addStart) {
+                current.m_length += piece.m_length;
+                current.m_lineBreakCount += piece.m_lineBreakCount;
+            } else {
+                m_listPiece.insert(m_listPiece.begin() + static_cast<std::ptrdiff_t>(i+1), piece);
+            }
+        } else {
+            TgTextPiece right = {current.m_addBuffer, current.m_start + inner, current.m_length - inner, 0};
+            right.m_lineBreakCount = getLineBreakCount(right.m_addBuffer, right.m_start, right.m_length);
+            current.m_length = inner;
+            current.m_lineBreakCount -= right.m_lineBreakCount;
+            m_listPiece.insert(m_listPiece.begin() + static_cast<std::ptrdiff_t>(i+1), {piece, right});
+        }
+    }
+    m_length += text.size();
+    updatePieceIndex();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextPieceTable::remove
+ *
+ * removes text, buffers are not changed, only pieces
+ *
+ * \param offset byte offset where remove starts
+ * \param length number of bytes to remove
+ */
+void TgTextPieceTable::remove(size_t offset, size_t length)
+{
+    TG_FUNCTION_BEGIN();
+    if (offset >= m_length || length == 0) {
+        TG_FUNCTION_END();
+        return;
+    }
+    if (length > m_length - offset) {
+        length = m_length - offset;
+    }
+    const size_t end = offset + length;
+    std::vector<TgTextPiece> listPiece;
+    listPiece.reserve(m_listPiece.size()+1);
+    size_t i, pieceStart, pieceEnd;
+    for (i=0;i<m_listPiece.size();i++) {
+        const TgTextPiece &piece = m_listPiece[i];
+        pieceStart = m_listPieceOffset[i];
+        pieceEnd = pieceStart + piece.m_length;
+        if (pieceEnd <= offset || pieceStart >= end) {
+            listPiece.push_back(piece);
+            continue;
+        }
+        if (pieceStart < offset) {
+            TgTextPiece left = {piece.m_addBuffer, piece.m_start, offset - pieceStart, 0};
+            left.m_lineBreakCount = getLineBreakCount(left.m_addBuffer, left.m_start, left.m_length);
+            listPiece.push_back(left);
+        }
+        if (pieceEnd > end) {
+            TgTextPiece right = {piece.m_addBuffer, piece.m_start + (end - pieceStart), pieceEnd - end, 0};
+            right.m_lineBreakCount = getLineBreakCount(right.m_addBuffer, right.m_start, right.m_length);
+            listPiece.push_back(right);
+        }
+    }
+    m_listPiece.swap(listPiece);
+    m_length -= length;
+    updatePieceIndex();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextPieceTable::getBuffer
+ *
+ * \param piece
+ * \return buffer where piece points to
+ */
+const std::string &TgTextPieceTable::getBuffer(const TgTextPiece &piece) const
+{
+    return piece.m_addBuffer ? m_add : m_original;
+}
+
+/*!
+ * \brief TgTextPieceTable::getLineBreaks
+ *
+ * \param piece
+ * \return line break offsets of buffer where piece points to
+ */
+const std::vector<size_t> &TgTextPieceTable::getLineBreaks(const TgTextPiece &piece) const
+{
+    return piece.m_addBuffer ? m_listAddLineBreak : m_listOriginalLineBreak;
+}
+
+/*!
+ * \brief TgTextPieceTable::getLineBreakCount
+ *
+ * \param addBuffer true for add buffer, false for original buffer
+ * \param start start byte offset in buffer
+ * \param length length in bytes
+ * \return number of '\n' in buffer area
+ */
+size_t TgTextPieceTable::getLineBreakCount(bool addBuffer, size_t start, size_t length) const
+{
+    const std::vector<size_t> &listLineBreak = addBuffer ? m_listAddLineBreak : m_listOriginalLineBreak;
+    return static_cast<size_t>(std::lower_bound(listLineBreak.begin(), listLineBreak.end(), start+length)
+                               - std::lower_bound(listLineBreak.begin(), listLineBreak.end(), start));
+}
+
+/*!
+ * \brief TgTextPieceTable::getLineStart
+ *
+ * \param line line index (0 is first line), must be less than line count
+ * \return byte offset where line starts
+ */
+size_t TgTextPieceTable::getLineStart(size_t line) const
+{
+    if (line == 0 || m_listPiece.empty()) {
+        return 0;
+    }
+    // last piece that has less than "line" line breaks before it, contains the line break
+    std::vector<size_t>::const_iterator it = std::upper_bound(m_listPieceLineBreak.begin(), m_listPieceLineBreak.end(), line-1);
+    size_t i = static_cast<size_t>(it - m_listPieceLineBreak.begin()) - 1;
+    const TgTextPiece &piece = m_listPiece[i];
+    const std::vector<size_t> &listLineBreak = getLineBreaks(piece);
+    size_t first = static_cast<size_t>(std::lower_bound(listLineBreak.begin(), listLineBreak.end(), piece.m_start) - listLineBreak.begin());
+    size_t lineBreak = listLineBreak[first + line - m_listPieceLineBreak[i] - 1];
+    return m_listPieceOffset[i] + lineBreak - piece.m_start + 1;
+}
+
+/*!
+ * \brief TgTextPieceTable::findPiece
+ *
+ * \param offset document byte offset
+ * \return index of piece that contains the offset,
+ * if offset is end of document, last piece is returned
+ */
+size_t TgTextPieceTable::findPiece(size_t offset) const
+{
+    if (m_listPiece.empty()) {
+        return 0;
+    }
+    std::vector<size_t>::const_iterator it = std::upper_bound(m_listPieceOffset.begin(), m_listPieceOffset.end(), offset);
+    return static_cast<size_t>(it - m_listPieceOffset.begin()) - 1;
+}
+
+/*!
+ * \brief TgTextPieceTable::updatePieceIndex
+ *
+ * updates piece offsets and line break counts before pieces,
+ * these are used for binary search of offset and line
+ */
+void TgTextPieceTable::updatePieceIndex()
+{
+    m_listPieceOffset.resize(m_listPiece.size());
+    m_listPieceLineBreak.resize(m_listPiece.size());
+    size_t offset = 0, lineBreak = 0;
+    for (size_t i=0;i<m_listPiece.size();i++) {
+        m_listPieceOffset[i] = offset;
+        m_listPieceLineBreak[i] = lineBreak;
+        offset += m_listPiece[i].m_length;
+        lineBreak += m_listPiece[i].m_lineBreakCount;
+    }
+}
+
+/*!
+ * \brief TgTextPieceTable::addLineBreaks
+ *
+ * \param text text that is going to be added into buffer
+ * \param bufferStart byte offset of text in buffer
+ * \param listLineBreak [out] line break offsets are added into this
+ */
+void TgTextPieceTable::addLineBreaks(const std::string &text, size_t bufferStart, std::vector<size_t> &listLineBreak)
+{
+    size_t pos = text.find('\n');
+    while (pos != std::string::npos) {
+        listLineBreak.push_back(bufferStart + pos);
+        pos = text.find('\n', pos+1);
+    }
+}
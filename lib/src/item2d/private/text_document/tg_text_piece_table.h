@@ -0,0 +1,70 @@
+/*!
+ * \file
+ * \brief file tg_text_piece_table.h
+ *
+ * piece table for (utf8) text document, original text is never
+ * copied or moved on edits, inserted text is appended into add buffer
+ * and the document is list of pieces pointing to these two buffers
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TEXT_PIECE_TABLE_H
+#define TG_TEXT_PIECE_TABLE_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+/*!
+ * \brief TgTextPiece
+ * single piece of the document
+ */
+struct TgTextPiece
+{
+    bool m_addBuffer;           /*!< true if piece points to add buffer, false if to original buffer */
+    size_t m_start;             /*!< start byte offset in buffer */
+    size_t m_length;            /*!< length of piece in bytes */
+    size_t m_lineBreakCount;    /*!< number of '\n' in this piece */
+};
+
+class TgTextPieceTable
+{
+public:
+    explicit TgTextPieceTable();
+
+    void setText(const std::string &text);
+    std::string getText() const;
+    size_t getLength() const;
+    size_t getLineCount() const;
+    std::string getLine(size_t line) const;
+    bool getOffset(size_t line, size_t column, size_t &offset) const;
+    size_t getOffsetAfterCharacters(size_t offset, size_t characterCount) const;
+    size_t getCharacterCount(size_t start, size_t end) const;
+
+    void insert(size_t offset, const std::string &text);
+    void remove(size_t offset, size_t length);
+
+private:
+    std::string m_original;
+    std::string m_add;
+    std::vector<size_t>m_listOriginalLineBreak;     /*!< sorted byte offsets of '\n' in m_original */
+    std::vector<size_t>m_listAddLineBreak;          /*!< sorted byte offsets of '\n' in m_add */
+    std::vector<TgTextPiece>m_listPiece;
+    std::vector<size_t>m_listPieceOffset;           /*!< document byte offset where piece (same index) starts */
+    std::vector<size_t>m_listPieceLineBreak;        /*!< number of '\n' before piece (same index) */
+    size_t m_length;
+
+    const std::string &getBuffer(const TgTextPiece &piece) const;
+    const std::vector<size_t> &getLineBreaks(const TgTextPiece &piece) const;
+    size_t getLineBreakCount(bool addBuffer, size_t start, size_t length) const;
+    size_t getLineStart(size_t line) const;
+    size_t findPiece(size_t offset) const;
+    void updatePieceIndex();
+
+    static void addLineBreaks(const std::string &text, size_t bufferStart, std::vector<size_t> &listLineBreak);
+};
+
+#endif // TG_TEXT_PIECE_TABLE_H
@@ -26,7 +26,8 @@ TgImagePartPrivate::TgImagePartPrivate(TgItem2d *currentItem, const char *imageF
     m_imageCrop3Left(0), m_imageCrop3Right(0),
     m_leftArea3Size(0), m_rightArea3Size(0),
     m_imageCrop3Top(0), m_imageCrop3Bottom(0),
-    m_topArea3Size(0), m_bottomArea3Size(0)
+    m_topArea3Size(0), m_bottomArea3Size(0),
+    f_imageLoaded(nullptr)
 {
     TG_FUNCTION_BEGIN();
     m_imageAsset.m_textureIndex = 0;
@@ -38,6 +39,7 @@ TgImagePartPrivate::TgImagePartPrivate(TgItem2d *currentItem, const char *imageF
 TgImagePartPrivate::~TgImagePartPrivate()
 {
     TG_FUNCTION_BEGIN();
+    TgGlobalApplication::getInstance()->getImageAssets()->releaseImage(m_imageAsset);
     TG_FUNCTION_END();
 }
 
@@ -373,7 +375,8 @@ void TgImagePartPrivate::generateVertices(Vertice vertices[IMAGE_PARTS_VERTICES_
  * \brief TgImagePartPrivate::getTextureIndex
  *
  * gets texture index for this rectangle
- * if texture index is not done before, it tries to create it
+ * if texture index is not done before, it tries to create it,
+ * m_mutex must be locked
  *
  * \return texture index
  */
@@ -393,7 +396,8 @@ GLuint TgImagePartPrivate::getTextureIndex()
  * \brief TgImagePartPrivate::init
  *
  * inits the vertices
- * Generates the vertices
+ * Generates the vertices, texture S/T values are mapped
+ * into image's area in texture (atlas)
  *
  * \return true on success
  */
@@ -402,6 +406,11 @@ bool TgImagePartPrivate::init()
     TG_FUNCTION_BEGIN();
     Vertice vertices[IMAGE_PARTS_VERTICES_MAX_COUNT];
     generateVertices(vertices);
+    const int verticesCount = (m_type == TgImagePartType::TgImagePartType_Part9) ? 9*4 : 3*4;
+    for (int i=0;i<verticesCount;i++) {
+        vertices[i].s = m_imageAsset.getTextureS(vertices[i].s);
+        vertices[i].t = m_imageAsset.getTextureT(vertices[i].t);
+    }
     TG_FUNCTION_END();
     return TgRender::init(vertices, IMAGE_PARTS_VERTICES_MAX_COUNT);
 }
@@ -438,7 +447,12 @@ void TgImagePartPrivate::setTranform(TgItem2d *currentItem)
 bool TgImagePartPrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity)
 {
     TG_FUNCTION_BEGIN();
-    if (!itemPosition->isRenderVisible(windowInfo)) {
+    m_mutex.lock();
+    GLuint textureIndex = getTextureIndex();
+    bool loadPending = m_imageAsset.m_loadPending;
+    m_mutex.unlock();
+    if (!itemPosition->isRenderVisible(windowInfo)
+        || (!textureIndex && loadPending)) {
         TG_FUNCTION_END();
         return false;
     }
@@ -450,14 +464,14 @@ bool TgImagePartPrivate::render(const TgWindowInfo *windowInfo, TgItem2d *curren
     glUniform4f( windowInfo->m_shaderColorIndex, 1, 1, 1, 1);
     glUniform1f( windowInfo->m_shaderOpacityIndex, opacity);
     glUniformMatrix4fv(windowInfo->m_shaderTransformIndex, 1, 0, m_transform.getMatrixTable()->data);
-    glBindTexture(GL_TEXTURE_2D, getTextureIndex());
+    glBindTexture(GL_TEXTURE_2D, textureIndex);
     if (TgImagePartType::TgImagePartType_Part9 == m_type) {
         for (int i=0;i<9;i++) {
-            TgRender::render(getTextureIndex(), i*4, 4);
+            TgRender::render(textureIndex, i*4, 4);
         }
     } else {
         for (int i=0;i<3;i++) {
-            TgRender::render(getTextureIndex(), i*4, 4);
+            TgRender::render(textureIndex, i*4, 4);
         }
     }
     glBindVertexArray(0);
@@ -474,9 +488,17 @@ bool TgImagePartPrivate::render(const TgWindowInfo *windowInfo, TgItem2d *curren
 void TgImagePartPrivate::checkPositionValues(TgItem2d *currentItem)
 {
     TG_FUNCTION_BEGIN();
+    std::function<void(bool)> imageLoaded = nullptr;
+    bool success = false;
+    m_mutex.lock();
     if (!m_initImageAssetDone) {
         getTextureIndex();
-        m_initImageAssetDone = true;
+        if (!m_imageAsset.m_loadPending) {
+            m_initImageAssetDone = true;
+            m_initVerticesDone = false;
+            imageLoaded = f_imageLoaded;
+            success = m_imageAsset.m_textureIndex != 0;
+        }
     }
 
     if (!m_initVerticesDone || currentItem->getPositionChanged()) {
@@ -484,6 +506,11 @@ void TgImagePartPrivate::checkPositionValues(TgItem2d *currentItem)
         setTranform(currentItem);
         m_initVerticesDone = true;
     }
+    m_mutex.unlock();
+    // callback can set new image
+    if (imageLoaded) {
+        imageLoaded(success);
+    }
     TG_FUNCTION_END();
 }
 
@@ -498,13 +525,75 @@ void TgImagePartPrivate::checkPositionValues(TgItem2d *currentItem)
 bool TgImagePartPrivate::setImage(const char *filename)
 {
     TG_FUNCTION_BEGIN();
+    m_mutex.lock();
     if (m_imageAsset.m_filename.compare(filename) == 0) {
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return false;
     }
+    TgGlobalApplication::getInstance()->getImageAssets()->releaseImage(m_imageAsset);
     m_imageAsset.m_textureIndex = 0;
     m_imageAsset.m_filename = filename;
+    m_imageAsset.m_loadPending = false;
+    m_imageAsset.m_loadFailed = false;
     m_initImageAssetDone = false;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
     TG_FUNCTION_END();
     return true;
 }
+
+/*!
+ * \brief TgImagePartPrivate::setAsyncLoad
+ *
+ * \param asyncLoad if true, image is decoded on the worker thread
+ */
+void TgImagePartPrivate::setAsyncLoad(bool asyncLoad)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_imageAsset.m_asyncLoad = asyncLoad;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePartPrivate::getAsyncLoad
+ *
+ * \return true, if image is decoded on the worker thread
+ */
+bool TgImagePartPrivate::getAsyncLoad() const
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool ret = m_imageAsset.m_asyncLoad;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgImagePartPrivate::connectOnImageLoaded
+ *
+ * \param imageLoaded callback function, called on render thread when image is loaded
+ */
+void TgImagePartPrivate::connectOnImageLoaded(std::function<void(bool)> imageLoaded)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    f_imageLoaded = imageLoaded;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePartPrivate::disconnectOnImageLoaded
+ */
+void TgImagePartPrivate::disconnectOnImageLoaded()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    f_imageLoaded = nullptr;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
@@ -15,6 +15,8 @@
 #include "../../math/tg_matrix4x4.h"
 #include "../tg_image_part.h"
 #include "../../render/tg_render.h"
+#include <functional>
+#include <mutex>
 
 class TgItem2d;
 struct TgWindowInfo;
@@ -45,6 +47,10 @@ public:
     void checkPositionValues(TgItem2d *currentItem);
 
     bool setImage(const char *filename);
+    void setAsyncLoad(bool asyncLoad);
+    bool getAsyncLoad() const;
+    void connectOnImageLoaded(std::function<void(bool)> imageLoaded);
+    void disconnectOnImageLoaded();
 private:
     enum VerticeIndexPositionParts9
     {
@@ -74,6 +80,8 @@ private:
 
     float m_imageCrop3Top, m_imageCrop3Bottom;
     float m_topArea3Size, m_bottomArea3Size;
+    std::function<void(bool)> f_imageLoaded;
+    mutable std::mutex m_mutex;     /*!< image asset, set by user thread and loaded on render thread */
 
     void generateVertices(Vertice vertices[IMAGE_PARTS_VERTICES_MAX_COUNT]);
     void generateVertices3LeftToRight(Vertice vertices[IMAGE_PARTS_VERTICES_MAX_COUNT]);
@@ -10,6 +10,8 @@
  */
 
 #include "tg_image_private.h"
+#include <algorithm>
+#include <cstdint>
 #include "../../global/tg_global_application.h"
 #include "../../global/tg_global_log.h"
 #include "../tg_item2d.h"
@@ -25,7 +27,12 @@ TgImagePrivate::TgImagePrivate(const char *filename) :
     m_bottomRightS(1), m_bottomRightT(1),
     m_bottomLeftS(0), m_bottomLeftT(1),
     m_initVerticesDone(false),
-    m_initImageAssetDone(false)
+    m_initImageAssetDone(false),
+    f_imageLoaded(nullptr),
+    m_pixelAccessRequested(false),
+    m_dirtyRowStart(UINT32_MAX),
+    m_dirtyRowEnd(0),
+    m_mipmapsChanged(false)
 {
     TG_FUNCTION_BEGIN();
     m_imageAsset.m_textureIndex = 0;
@@ -37,14 +44,41 @@ TgImagePrivate::TgImagePrivate(const char *filename) :
 TgImagePrivate::~TgImagePrivate()
 {
     TG_FUNCTION_BEGIN();
+    releaseImageAsset();
     TG_FUNCTION_END();
 }
 
+/*!
+ * \brief TgImagePrivate::releaseImageAsset
+ *
+ * releases image from TgImageAssets, or deletes generated image data
+ * that is not yet given to TgImageAssets (texture is not yet generated)
+ */
+void TgImagePrivate::releaseImageAsset()
+{
+    if (m_imageAsset.m_textureIndex) {
+        TgGlobalApplication::getInstance()->getImageAssets()->releaseImage(m_imageAsset);
+        if (m_imageAsset.m_type == TgImageType::GeneratedImage) {
+            // image data is owned and deleted by TgImageAssets
+            m_imageAsset.m_imageData.m_generatedImage.m_imageData = nullptr;
+        }
+        m_imageAsset.m_textureIndex = 0;
+        return;
+    }
+    if (m_imageAsset.m_type == TgImageType::GeneratedImage
+        && !m_imageAsset.m_textureIndex
+        && m_imageAsset.m_imageData.m_generatedImage.m_imageData) {
+        delete[] m_imageAsset.m_imageData.m_generatedImage.m_imageData;
+        m_imageAsset.m_imageData.m_generatedImage.m_imageData = nullptr;
+    }
+}
+
 /*!
  * \brief TgImagePrivate::getTextureIndex
  *
  * gets texture index for this rectangle
- * if texture index is not done before, it tries to create it
+ * if texture index is not done before, it tries to create it,
+ * m_mutex must be locked
  *
  * \return texture index
  */
@@ -74,6 +108,10 @@ bool TgImagePrivate::init()
     TG_FUNCTION_BEGIN();
     Vertice vertices[4];
     generateVertices(vertices);
+    for (int i=0;i<4;i++) {
+        vertices[i].s = m_imageAsset.getTextureS(vertices[i].s);
+        vertices[i].t = m_imageAsset.getTextureT(vertices[i].t);
+    }
     TG_FUNCTION_END();
     return TgRender::init(vertices, 4);
 }
@@ -84,6 +122,8 @@ bool TgImagePrivate::init()
  * set texture ST values
  *
  * All values must be <= 1.0f (or at least should be)
+ * values are relative to the image, also when image is packed
+ * into shared atlas texture
  *
  * \param topLeftS topleft S
  * \param topLeftT topleft T
@@ -176,7 +216,12 @@ void TgImagePrivate::setTranform(TgItem2d *currentItem)
 bool TgImagePrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity)
 {
     TG_FUNCTION_BEGIN();
-    if (!itemPosition->isRenderVisible(windowInfo)) {
+    m_mutex.lock();
+    GLuint textureIndex = getTextureIndex();
+    bool loadPending = m_imageAsset.m_loadPending;
+    m_mutex.unlock();
+    if (!itemPosition->isRenderVisible(windowInfo)
+        || (!textureIndex && loadPending)) {
         TG_FUNCTION_END();
         return false;
     }
@@ -188,7 +233,7 @@ bool TgImagePrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentIte
     glUniform4f( windowInfo->m_shaderColorIndex, 1, 1, 1, 1);
     glUniform1f( windowInfo->m_shaderOpacityIndex, opacity);
     glUniformMatrix4fv(windowInfo->m_shaderTransformIndex, 1, 0, m_transform.getMatrixTable()->data);
-    TgRender::render(getTextureIndex());
+    TgRender::render(textureIndex);
     TG_FUNCTION_END();
     return true;
 }
@@ -202,38 +247,82 @@ bool TgImagePrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentIte
 void TgImagePrivate::checkPositionValues(TgItem2d *currentItem)
 {
     TG_FUNCTION_BEGIN();
+    std::function<void(bool)> imageLoaded = nullptr;
+    bool success = false;
+    // setImage() and setMipmaps() release the asset while it's locked
+    m_mutex.lock();
     if (!m_initImageAssetDone) {
         getTextureIndex();
-        m_initImageAssetDone = true;
+        if (!m_imageAsset.m_loadPending) {
+            m_initImageAssetDone = true;
+            m_initVerticesDone = false;
+            imageLoaded = f_imageLoaded;
+            success = m_imageAsset.m_textureIndex != 0;
+        }
+    }
+    m_mutex.unlock();
+    // callback can set new image
+    if (imageLoaded) {
+        imageLoaded(success);
     }
 
+    m_mutex.lock();
     if (!m_initVerticesDone || currentItem->getPositionChanged()) {
         init();
         setTranform(currentItem);
         m_initVerticesDone = true;
     }
-    m_mutex.lock();
-    if (!m_listPixelChange.empty()) {
+    if ((!m_listPixelChange.empty() || m_pixelAccessRequested || m_dirtyRowStart < m_dirtyRowEnd)
+        && !m_imageAsset.m_loadPending && m_imageAsset.m_textureIndex) {
         if (m_imageAsset.m_type == TgImageType::LoadedImage) {
             if (TgGlobalApplication::getInstance()->getImageAssets()->convertLoadedImageToGeneratedImage(m_imageAsset) == 0) {
                 m_mutex.unlock();
                 TG_FUNCTION_END();
                 return;
             }
+            // generated image has own texture, image was possibly in atlas
+            init();
         }
+        m_pixelAccessRequested = false;
+        if (m_dirtyRowStart < m_dirtyRowEnd && m_imageAsset.m_type == TgImageType::GeneratedImage) {
+            m_pixelBuffer.upload(m_imageAsset.m_textureIndex,
+                                 m_imageAsset.m_imageData.m_generatedImage.m_imageData,
+                                 m_imageAsset.m_imageData.m_generatedImage.m_width,
+                                 static_cast<int>(m_dirtyRowStart),
+                                 static_cast<int>(m_dirtyRowEnd - m_dirtyRowStart));
+            m_mipmapsChanged |= m_imageAsset.m_mipmaps;
+            m_dirtyRowStart = UINT32_MAX;
+            m_dirtyRowEnd = 0;
+        }
+    }
+    if (!m_listPixelChange.empty() && m_imageAsset.m_type == TgImageType::GeneratedImage
+        && m_imageAsset.m_textureIndex) {
+        // only bounding box of changed pixels is uploaded
+        uint32_t minX = UINT32_MAX, minY = UINT32_MAX, maxX = 0, maxY = 0;
         for (const TgImagePrivatePixelChange &pixel : m_listPixelChange) {
             TgImageDraw::setColor(m_imageAsset.m_imageData.m_generatedImage.m_imageData,
                            m_imageAsset.m_imageData.m_generatedImage.m_width,
                            m_imageAsset.m_imageData.m_generatedImage.m_height,
                            pixel.m_x, pixel.m_y,
                            pixel.m_r, pixel.m_g, pixel.m_b, pixel.m_a);
+            minX = std::min(minX, pixel.m_x);
+            minY = std::min(minY, pixel.m_y);
+            maxX = std::max(maxX, pixel.m_x);
+            maxY = std::max(maxY, pixel.m_y);
         }
         TgGlobalApplication::getInstance()->getImageAssets()->modifyTexture(
             m_imageAsset.m_imageData.m_generatedImage.m_imageData,
             m_imageAsset.m_imageData.m_generatedImage.m_width,
             m_imageAsset.m_imageData.m_generatedImage.m_height,
-            m_imageAsset.m_textureIndex);
+            m_imageAsset.m_textureIndex,
+            static_cast<int>(minX), static_cast<int>(minY),
+            static_cast<int>(maxX - minX + 1), static_cast<int>(maxY - minY + 1));
         m_listPixelChange.clear();
+        m_mipmapsChanged |= m_imageAsset.m_mipmaps;
+    }
+    if (m_mipmapsChanged && m_imageAsset.m_type == TgImageType::GeneratedImage) {
+        TgGlobalApplication::getInstance()->getImageAssets()->updateMipmaps(m_imageAsset);
+        m_mipmapsChanged = false;
     }
     m_mutex.unlock();
     TG_FUNCTION_END();
@@ -249,14 +338,113 @@ void TgImagePrivate::checkPositionValues(TgItem2d *currentItem)
 void TgImagePrivate::setImage(const char *filename)
 {
     TG_FUNCTION_BEGIN();
+    m_mutex.lock();
     if (m_imageAsset.m_filename.compare(filename) == 0) {
+        m_mutex.unlock();
         TG_FUNCTION_END();
         return;
     }
+    releaseImageAsset();
     m_imageAsset.m_textureIndex = 0;
     m_imageAsset.m_type = TgImageType::LoadedImage;
     m_imageAsset.m_filename = filename;
+    m_imageAsset.m_loadPending = false;
+    m_imageAsset.m_loadFailed = false;
+    m_initImageAssetDone = false;
+    m_listPixelChange.clear();
+    m_pixelAccessRequested = false;
+    m_dirtyRowStart = UINT32_MAX;
+    m_dirtyRowEnd = 0;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePrivate::setImage
+ *
+ * sets image as empty (transparent) generated image,
+ * pixels are set with setPixel() or lockPixels()
+ *
+ * \param imageWidth width of image
+ * \param imageHeight height of image
+ * \return false if width or height is 0
+ */
+bool TgImagePrivate::setImage(uint32_t imageWidth, uint32_t imageHeight)
+{
+    TG_FUNCTION_BEGIN();
+    if (!imageWidth || !imageHeight) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    m_mutex.lock();
+    releaseImageAsset();
+    m_imageAsset.m_textureIndex = 0;
+    m_imageAsset.m_type = TgImageType::GeneratedImage;
+    m_imageAsset.m_filename.clear();
+    m_imageAsset.m_loadPending = false;
+    m_imageAsset.m_loadFailed = false;
+    m_imageAsset.m_imageData.m_generatedImage.m_width = static_cast<int>(imageWidth);
+    m_imageAsset.m_imageData.m_generatedImage.m_height = static_cast<int>(imageHeight);
+    m_imageAsset.m_imageData.m_generatedImage.m_imageData = new uint8_t[static_cast<size_t>(imageWidth)*imageHeight*4]();
     m_initImageAssetDone = false;
+    m_listPixelChange.clear();
+    m_pixelAccessRequested = false;
+    m_dirtyRowStart = UINT32_MAX;
+    m_dirtyRowEnd = 0;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgImagePrivate::lockPixels
+ *
+ * locks image's RGBA data for direct modification,
+ * on success unlockPixels() must be called after modifications
+ *
+ * \return image data (RGBA, row is getImageWidth()*4 bytes),
+ * nullptr if image is not (yet) available for pixel access.
+ * Loaded image is converted for pixel access on next render
+ */
+uint8_t *TgImagePrivate::lockPixels()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (m_imageAsset.m_type == TgImageType::GeneratedImage
+        && m_imageAsset.m_imageData.m_generatedImage.m_imageData) {
+        TG_FUNCTION_END();
+        return m_imageAsset.m_imageData.m_generatedImage.m_imageData;
+    }
+    if (m_imageAsset.m_type == TgImageType::LoadedImage) {
+        m_pixelAccessRequested = true;
+    }
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+    return nullptr;
+}
+
+/*!
+ * \brief TgImagePrivate::unlockPixels
+ *
+ * unlocks image data locked with lockPixels(), modified
+ * rows are uploaded into texture on next render
+ *
+ * \param rowStart first modified row
+ * \param rowCount count of modified rows
+ */
+void TgImagePrivate::unlockPixels(uint32_t rowStart, uint32_t rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    const uint32_t height = static_cast<uint32_t>(m_imageAsset.m_imageData.m_generatedImage.m_height);
+    if (rowStart < height && rowCount) {
+        uint32_t rowEnd = (rowCount > height - rowStart) ? height : rowStart + rowCount;
+        m_dirtyRowStart = std::min(m_dirtyRowStart, rowStart);
+        m_dirtyRowEnd = std::max(m_dirtyRowEnd, rowEnd);
+    }
+    m_mutex.unlock();
     TgGlobalWaitRenderer::getInstance()->release();
     TG_FUNCTION_END();
 }
@@ -372,3 +560,102 @@ uint32_t TgImagePrivate::getImageHeight()
     TG_FUNCTION_END();
     return 0;
 }
+
+/*!
+ * \brief TgImagePrivate::setAsyncLoad
+ *
+ * \param asyncLoad if true, image is decoded on the worker thread
+ */
+void TgImagePrivate::setAsyncLoad(bool asyncLoad)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_imageAsset.m_asyncLoad = asyncLoad;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePrivate::getAsyncLoad
+ *
+ * \return true, if image is decoded on the worker thread
+ */
+bool TgImagePrivate::getAsyncLoad()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool ret = m_imageAsset.m_asyncLoad;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgImagePrivate::setMipmaps
+ *
+ * \param mipmaps if true, image's texture has mip levels
+ */
+void TgImagePrivate::setMipmaps(bool mipmaps)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (m_imageAsset.m_mipmaps == mipmaps) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    if (m_imageAsset.m_type == TgImageType::LoadedImage) {
+        // image with and without mip levels are different images in TgImageAssets
+        releaseImageAsset();
+        m_imageAsset.m_loadPending = false;
+        m_imageAsset.m_loadFailed = false;
+        m_initImageAssetDone = false;
+    } else {
+        m_mipmapsChanged = true;
+    }
+    m_imageAsset.m_mipmaps = mipmaps;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePrivate::getMipmaps
+ *
+ * \return true, if image's texture has mip levels
+ */
+bool TgImagePrivate::getMipmaps()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool ret = m_imageAsset.m_mipmaps;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgImagePrivate::connectOnImageLoaded
+ *
+ * \param imageLoaded callback function, called on render thread when image is loaded
+ */
+void TgImagePrivate::connectOnImageLoaded(std::function<void(bool)> imageLoaded)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    f_imageLoaded = imageLoaded;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePrivate::disconnectOnImageLoaded
+ */
+void TgImagePrivate::disconnectOnImageLoaded()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    f_imageLoaded = nullptr;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
@@ -13,11 +13,13 @@
 #define TG_IMAGE_PRIVATE_H
 
 #include "../../image/tg_image_assets.h"
+#include "../../image/tg_image_pixel_buffer.h"
 #include "../../math/tg_matrix4x4.h"
 #include "../../render/tg_render.h"
 #include "../../global/private/tg_global_defines.h"
 #include <string>
 #include <mutex>
+#include <functional>
 
 class TgItem2d;
 struct TgWindowInfo;
@@ -44,9 +46,18 @@ public:
                       float bottomRightS, float bottomRightT,
                       float bottomLeftS, float bottomLeftT);
     void setImage(const char *filename);
+    bool setImage(uint32_t imageWidth, uint32_t imageHeight);
+    uint8_t *lockPixels();
+    void unlockPixels(uint32_t rowStart, uint32_t rowCount);
     bool setPixel(uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a);
     uint32_t getImageWidth();
     uint32_t getImageHeight();
+    void setAsyncLoad(bool asyncLoad);
+    bool getAsyncLoad();
+    void setMipmaps(bool mipmaps);
+    bool getMipmaps();
+    void connectOnImageLoaded(std::function<void(bool)> imageLoaded);
+    void disconnectOnImageLoaded();
 
 private:
     float m_topLeftS, m_topLeftT;
@@ -62,8 +73,16 @@ private:
     bool m_initImageAssetDone;
 
     TgMatrix4x4 m_transform;
+    std::function<void(bool)> f_imageLoaded;
+
+    TgImagePixelBuffer m_pixelBuffer;
+    bool m_pixelAccessRequested;    /*!< loaded image must be converted to generated image for lockPixels() */
+    uint32_t m_dirtyRowStart;       /*!< rows m_dirtyRowStart - m_dirtyRowEnd-1 are modified with lockPixels() */
+    uint32_t m_dirtyRowEnd;
+    bool m_mipmapsChanged;          /*!< mip levels of generated image's texture must be enabled/disabled */
 
     bool init();
+    void releaseImageAsset();
     void setTranform(TgItem2d *currentItem);
     GLuint getTextureIndex();
     void generateVertices(Vertice vertices[4]);
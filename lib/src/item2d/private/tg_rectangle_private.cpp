@@ -41,6 +41,7 @@ TgRectanglePrivate::TgRectanglePrivate(const unsigned char r, const unsigned cha
 TgRectanglePrivate::~TgRectanglePrivate()
 {
     TG_FUNCTION_BEGIN();
+    TgGlobalApplication::getInstance()->getImageAssets()->releaseImage(m_imageAsset);
     TG_FUNCTION_END();
 }
 
@@ -119,6 +120,11 @@ bool TgRectanglePrivate::init()
     vertices[3].s = 1;
     vertices[3].t = 1;
 
+    for (int i=0;i<4;i++) {
+        vertices[i].s = m_imageAsset.getTextureS(vertices[i].s);
+        vertices[i].t = m_imageAsset.getTextureT(vertices[i].t);
+    }
+
     TG_FUNCTION_END();
     return TgRender::init(vertices, 4);
 }
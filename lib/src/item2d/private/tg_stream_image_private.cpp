@@ -0,0 +1,508 @@
+/*!
+ * \file
+ * \brief file tg_stream_image_private.cpp
+ *
+ * it holds general TgStreamImagePrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_stream_image_private.h"
+#include <cstring>
+#include "../../global/tg_global_log.h"
+#include "../../shader/tg_shader_2d.h"
+#include "../tg_item2d.h"
+#include "../../window/tg_mainwindow_private.h"
+#include "../../global/private/tg_global_wait_renderer.h"
+#include "item2d/tg_item2d_position.h"
+
+TgStreamImagePrivate::TgStreamImagePrivate() :
+    m_framePending(false),
+    m_totalLatencyUs(0),
+    m_pixelBuffer(TG_STREAM_IMAGE_PIXEL_BUFFER_COUNT),
+    m_textureFormat(TgStreamImageFormat::StreamImageFormatRGBA),
+    m_textureWidth(0),
+    m_textureHeight(0),
+    m_initVerticesDone(false)
+{
+    TG_FUNCTION_BEGIN();
+    for (size_t i=0;i<TG_STREAM_IMAGE_PLANE_MAX_COUNT;i++) {
+        m_textureIndex[i] = 0;
+    }
+    TG_FUNCTION_END();
+}
+
+TgStreamImagePrivate::~TgStreamImagePrivate()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (m_framePending && m_pendingFrame.f_release) {
+        m_pendingFrame.f_release();
+    }
+    m_framePending = false;
+    m_mutex.unlock();
+    deleteTextures();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImagePrivate::pushFrame
+ *
+ * sets frame waiting for upload, if earlier frame is still waiting,
+ * it is dropped and released
+ *
+ * \param frame frame to show
+ * \return false if frame is not valid
+ */
+bool TgStreamImagePrivate::pushFrame(const TgStreamImageFrame &frame)
+{
+    TG_FUNCTION_BEGIN();
+    if (!isFrameValid(frame)) {
+        TG_WARNING_LOG("Invalid stream frame", frame.m_width, "x", frame.m_height);
+        TG_FUNCTION_END();
+        return false;
+    }
+    std::function<void()> releaseDropped = nullptr;
+    m_mutex.lock();
+    if (m_framePending) {
+        releaseDropped = m_pendingFrame.f_release;
+        m_statistics.m_droppedFrameCount++;
+    }
+    m_pendingFrame = frame;
+    m_pendingFrameTime = std::chrono::steady_clock::now();
+    m_framePending = true;
+    m_statistics.m_receivedFrameCount++;
+    m_mutex.unlock();
+    if (releaseDropped) {
+        releaseDropped();
+    }
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgStreamImagePrivate::getStatistics
+ *
+ * \return frame counters and latencies
+ */
+TgStreamImageStatistics TgStreamImagePrivate::getStatistics()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    TgStreamImageStatistics ret = m_statistics;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgStreamImagePrivate::resetStatistics
+ */
+void TgStreamImagePrivate::resetStatistics()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_statistics = TgStreamImageStatistics();
+    m_totalLatencyUs = 0;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImagePrivate::uploadPendingFrame
+ *
+ * copies the pending frame planes into next pixel buffer object
+ * of the ring, uploads textures from it and releases the frame
+ */
+void TgStreamImagePrivate::uploadPendingFrame()
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    if (!m_framePending) {
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
+    }
+    TgStreamImageFrame frame = m_pendingFrame;
+    std::chrono::steady_clock::time_point frameTime = m_pendingFrameTime;
+    m_pendingFrame.f_release = nullptr;
+    m_framePending = false;
+    m_mutex.unlock();
+
+    if (m_textureFormat != frame.m_format
+        || m_textureWidth != frame.m_width
+        || m_textureHeight != frame.m_height
+        || !m_textureIndex[0]) {
+        generateTextures(frame.m_format, frame.m_width, frame.m_height);
+    }
+
+    size_t plane, row;
+    const size_t planeCount = getPlaneCount(frame.m_format);
+    uint32_t planeWidth[TG_STREAM_IMAGE_PLANE_MAX_COUNT], planeHeight[TG_STREAM_IMAGE_PLANE_MAX_COUNT], bytesPerPixel[TG_STREAM_IMAGE_PLANE_MAX_COUNT];
+    size_t planeOffset[TG_STREAM_IMAGE_PLANE_MAX_COUNT];
+    size_t size = 0;
+    for (plane=0;plane<planeCount;plane++) {
+        getPlaneSize(frame.m_format, plane, frame.m_width, frame.m_height, planeWidth[plane], planeHeight[plane], bytesPerPixel[plane]);
+        planeOffset[plane] = size;
+        size += static_cast<size_t>(planeWidth[plane])*bytesPerPixel[plane]*planeHeight[plane];
+    }
+
+    unsigned char *buffer = m_textureIndex[0] ? m_pixelBuffer.beginUpload(size) : nullptr;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (plane=0;plane<planeCount && m_textureIndex[0];plane++) {
+        const size_t rowSize = static_cast<size_t>(planeWidth[plane])*bytesPerPixel[plane];
+        const size_t stride = frame.m_stride[plane] ? frame.m_stride[plane] : rowSize;
+        GLint internalFormat;
+        GLenum pixelFormat;
+        getPlaneTextureFormat(frame.m_format, plane, internalFormat, pixelFormat);
+        glBindTexture(GL_TEXTURE_2D, m_textureIndex[plane]);
+        if (buffer) {
+            if (stride == rowSize) {
+                memcpy(buffer + planeOffset[plane], frame.m_plane[plane], rowSize*planeHeight[plane]);
+            } else {
+                for (row=0;row<planeHeight[plane];row++) {
+                    memcpy(buffer + planeOffset[plane] + row*rowSize, frame.m_plane[plane] + row*stride, rowSize);
+                }
+            }
+            continue;
+        }
+        // pixel buffer is not available, upload straight from frame
+        for (row=0;row<planeHeight[plane];row++) {
+            if (stride == rowSize) {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                                static_cast<GLsizei>(planeWidth[plane]), static_cast<GLsizei>(planeHeight[plane]),
+                                pixelFormat, GL_UNSIGNED_BYTE, frame.m_plane[plane]);
+                break;
+            }
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(row),
+                            static_cast<GLsizei>(planeWidth[plane]), 1,
+                            pixelFormat, GL_UNSIGNED_BYTE, frame.m_plane[plane] + row*stride);
+        }
+    }
+    if (buffer) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        for (plane=0;plane<planeCount;plane++) {
+            GLint internalFormat;
+            GLenum pixelFormat;
+            getPlaneTextureFormat(frame.m_format, plane, internalFormat, pixelFormat);
+            glBindTexture(GL_TEXTURE_2D, m_textureIndex[plane]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                            static_cast<GLsizei>(planeWidth[plane]), static_cast<GLsizei>(planeHeight[plane]),
+                            pixelFormat, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(planeOffset[plane]));
+        }
+        m_pixelBuffer.endUpload();
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // frame buffers are not needed anymore, data is in pixel buffer or texture
+    if (frame.f_release) {
+        frame.f_release();
+    }
+
+    uint64_t latency = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                                 std::chrono::steady_clock::now() - frameTime).count());
+    m_mutex.lock();
+    m_statistics.m_shownFrameCount++;
+    m_statistics.m_lastLatencyUs = latency;
+    if (latency > m_statistics.m_maxLatencyUs) {
+        m_statistics.m_maxLatencyUs = latency;
+    }
+    m_totalLatencyUs += latency;
+    m_statistics.m_averageLatencyUs = m_totalLatencyUs/m_statistics.m_shownFrameCount;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImagePrivate::generateTextures
+ *
+ * (re)creates texture for each plane of the format
+ *
+ * \param format frame format
+ * \param width frame width
+ * \param height frame height
+ * \return true on success
+ */
+bool TgStreamImagePrivate::generateTextures(TgStreamImageFormat format, uint32_t width, uint32_t height)
+{
+    TG_FUNCTION_BEGIN();
+    deleteTextures();
+    const size_t planeCount = getPlaneCount(format);
+    uint32_t planeWidth, planeHeight, bytesPerPixel;
+    GLint internalFormat;
+    GLenum pixelFormat;
+    glGenTextures(static_cast<GLsizei>(planeCount), m_textureIndex);
+    for (size_t plane=0;plane<planeCount;plane++) {
+        if (!m_textureIndex[plane]) {
+            TG_ERROR_LOG("Failed to create stream texture");
+            deleteTextures();
+            TG_FUNCTION_END();
+            return false;
+        }
+        getPlaneSize(format, plane, width, height, planeWidth, planeHeight, bytesPerPixel);
+        getPlaneTextureFormat(format, plane, internalFormat, pixelFormat);
+        glBindTexture(GL_TEXTURE_2D, m_textureIndex[plane]);
+        // frames are usually scaled, so they are filtered
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat,
+                     static_cast<GLsizei>(planeWidth), static_cast<GLsizei>(planeHeight),
+                     0, pixelFormat, GL_UNSIGNED_BYTE, nullptr);
+    }
+    m_textureFormat = format;
+    m_textureWidth = width;
+    m_textureHeight = height;
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgStreamImagePrivate::deleteTextures
+ */
+void TgStreamImagePrivate::deleteTextures()
+{
+    for (size_t i=0;i<TG_STREAM_IMAGE_PLANE_MAX_COUNT;i++) {
+        if (m_textureIndex[i]) {
+            glDeleteTextures(1, &m_textureIndex[i]);
+            m_textureIndex[i] = 0;
+        }
+    }
+    m_textureWidth = 0;
+    m_textureHeight = 0;
+}
+
+/*!
+ * \brief TgStreamImagePrivate::isFrameValid
+ *
+ * \param frame
+ * \return true if frame has size and all planes of the format
+ */
+bool TgStreamImagePrivate::isFrameValid(const TgStreamImageFrame &frame)
+{
+    if (!frame.m_width || !frame.m_height) {
+        return false;
+    }
+    const size_t planeCount = getPlaneCount(frame.m_format);
+    uint32_t planeWidth, planeHeight, bytesPerPixel;
+    for (size_t plane=0;plane<planeCount;plane++) {
+        getPlaneSize(frame.m_format, plane, frame.m_width, frame.m_height, planeWidth, planeHeight, bytesPerPixel);
+        if (!frame.m_plane[plane]
+            || (frame.m_stride[plane] && frame.m_stride[plane] < planeWidth*bytesPerPixel)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief TgStreamImagePrivate::getPlaneCount
+ *
+ * \param format
+ * \return count of planes (textures) in format
+ */
+size_t TgStreamImagePrivate::getPlaneCount(TgStreamImageFormat format)
+{
+    switch (format) {
+        case TgStreamImageFormat::StreamImageFormatNV12:
+            return 2;
+        case TgStreamImageFormat::StreamImageFormatI420:
+            return 3;
+        case TgStreamImageFormat::StreamImageFormatRGBA:
+        default:
+            return 1;
+    }
+}
+
+/*!
+ * \brief TgStreamImagePrivate::getPlaneSize
+ *
+ * gets size of the plane, chroma planes of YUV formats are half size (rounded up)
+ *
+ * \param format
+ * \param plane plane index
+ * \param width frame width
+ * \param height frame height
+ * \param planeWidth [out] width of plane in pixels
+ * \param planeHeight [out] height of plane in pixels
+ * \param bytesPerPixel [out] bytes per pixel of plane
+ */
+void TgStreamImagePrivate::getPlaneSize(TgStreamImageFormat format, size_t plane, uint32_t width, uint32_t height,
+                                        uint32_t &planeWidth, uint32_t &planeHeight, uint32_t &bytesPerPixel)
+{
+    planeWidth = width;
+    planeHeight = height;
+    switch (format) {
+        case TgStreamImageFormat::StreamImageFormatNV12:
+            bytesPerPixel = plane ? 2 : 1;
+            break;
+        case TgStreamImageFormat::StreamImageFormatI420:
+            bytesPerPixel = 1;
+            break;
+        case TgStreamImageFormat::StreamImageFormatRGBA:
+        default:
+            bytesPerPixel = 4;
+            return;
+    }
+    if (plane) {
+        planeWidth = (width + 1)/2;
+        planeHeight = (height + 1)/2;
+    }
+}
+
+/*!
+ * \brief TgStreamImagePrivate::getPlaneTextureFormat
+ *
+ * \param format
+ * \param plane plane index
+ * \param internalFormat [out] internal format of the texture
+ * \param pixelFormat [out] pixel format of the plane data
+ */
+void TgStreamImagePrivate::getPlaneTextureFormat(TgStreamImageFormat format, size_t plane, GLint &internalFormat, GLenum &pixelFormat)
+{
+    switch (format) {
+        case TgStreamImageFormat::StreamImageFormatNV12:
+            internalFormat = plane ? GL_RG8 : GL_R8;
+            pixelFormat = plane ? GL_RG : GL_RED;
+            break;
+        case TgStreamImageFormat::StreamImageFormatI420:
+            internalFormat = GL_R8;
+            pixelFormat = GL_RED;
+            break;
+        case TgStreamImageFormat::StreamImageFormatRGBA:
+        default:
+            internalFormat = GL_RGBA;
+            pixelFormat = GL_RGBA;
+            break;
+    }
+}
+
+/*!
+ * \brief TgStreamImagePrivate::init
+ *
+ * inits the vertices
+ *
+ * \return true on success
+ */
+bool TgStreamImagePrivate::init()
+{
+    TG_FUNCTION_BEGIN();
+    Vertice vertices[4];
+
+    vertices[0].x = 0;
+    vertices[0].y = 0;
+    vertices[0].s = 0;
+    vertices[0].t = 0;
+
+    vertices[1].x = 10;
+    vertices[1].y = 0;
+    vertices[1].s = 1;
+    vertices[1].t = 0;
+
+    vertices[2].x = 0;
+    vertices[2].y = 10;
+    vertices[2].s = 0;
+    vertices[2].t = 1;
+
+    vertices[3].x = 10;
+    vertices[3].y = 10;
+    vertices[3].s = 1;
+    vertices[3].t = 1;
+
+    TG_FUNCTION_END();
+    return TgRender::init(vertices, 4);
+}
+
+/*!
+ * \brief TgStreamImagePrivate::setTranform
+ *
+ * set transform matrix 4x4
+ * \param currentItem
+ */
+void TgStreamImagePrivate::setTranform(TgItem2d *currentItem)
+{
+    TG_FUNCTION_BEGIN();
+    if (!currentItem->getPositionChanged()) {
+        TG_FUNCTION_END();
+        return;
+    }
+    TgMatrix4x4 position;
+    TgMatrix4x4 scale;
+    position.setTransform(currentItem->getXonWindow(), currentItem->getYonWindow());
+    scale.setScale(currentItem->getWidth()/10.0f, currentItem->getHeight()/10.0f);
+    m_transform.mul(scale.getMatrixTable(), position.getMatrixTable());
+    currentItem->setPositionChanged(false);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImagePrivate::checkPositionValues
+ *
+ * uploads the newest frame and checks position values before rendering starts
+ * \param currentItem
+ */
+void TgStreamImagePrivate::checkPositionValues(TgItem2d *currentItem)
+{
+    TG_FUNCTION_BEGIN();
+    uploadPendingFrame();
+    if (!m_initVerticesDone) {
+        init();
+        m_initVerticesDone = true;
+    }
+    setTranform(currentItem);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImagePrivate::render
+ *
+ * Renders the latest frame, YUV frames are converted to RGB in shader
+ * \param windowInfo
+ * \param currentItem
+ * \param itemPosition
+ * \param opacity opacity
+ * \return true if item was rendered, false if
+ * item was not render because it was outside or invisible or no frame is uploaded yet
+ */
+bool TgStreamImagePrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity)
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_textureIndex[0] || !itemPosition->isRenderVisible(windowInfo)) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    glUniform4f(windowInfo->m_maxRenderValues,
+                currentItem->getXminOnVisible(), currentItem->getYminOnVisible(),
+                currentItem->getXmaxOnVisible(windowInfo),
+                currentItem->getYmaxOnVisible(windowInfo));
+    glUniform1f( windowInfo->m_shaderOpacityIndex, opacity);
+    glUniform4f( windowInfo->m_shaderColorIndex, 1, 1, 1, 1);
+    glUniformMatrix4fv(windowInfo->m_shaderTransformIndex, 1, 0, m_transform.getMatrixTable()->data);
+    switch (m_textureFormat) {
+        case TgStreamImageFormat::StreamImageFormatNV12:
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_textureIndex[1]);
+            glUniform1i(windowInfo->m_shaderRenderTypeIndex, ShaderRenderType2d::RenderTypeYuvNv12);
+            break;
+        case TgStreamImageFormat::StreamImageFormatI420:
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_textureIndex[1]);
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, m_textureIndex[2]);
+            glUniform1i(windowInfo->m_shaderRenderTypeIndex, ShaderRenderType2d::RenderTypeYuvI420);
+            break;
+        case TgStreamImageFormat::StreamImageFormatRGBA:
+        default:
+            break;
+    }
+    TgRender::render(static_cast<int>(m_textureIndex[0]));
+    if (m_textureFormat != TgStreamImageFormat::StreamImageFormatRGBA) {
+        glUniform1i(windowInfo->m_shaderRenderTypeIndex, ShaderRenderType2d::RenderTypeTexture);
+    }
+    TG_FUNCTION_END();
+    return true;
+}
@@ -0,0 +1,71 @@
+/*!
+ * \file
+ * \brief file tg_stream_image_private.h
+ *
+ * it holds general TgStreamImagePrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_STREAM_IMAGE_PRIVATE_H
+#define TG_STREAM_IMAGE_PRIVATE_H
+
+#include <mutex>
+#include <chrono>
+#include "../tg_stream_image.h"
+#include "../../image/tg_image_pixel_buffer.h"
+#include "../../math/tg_matrix4x4.h"
+#include "../../render/tg_render.h"
+
+#define TG_STREAM_IMAGE_PLANE_MAX_COUNT 3
+#define TG_STREAM_IMAGE_PIXEL_BUFFER_COUNT 3
+
+class TgItem2d;
+struct TgWindowInfo;
+class TgItem2dPosition;
+
+class TgStreamImagePrivate : protected TgRender
+{
+public:
+    explicit TgStreamImagePrivate();
+    ~TgStreamImagePrivate();
+    bool render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity);
+    void checkPositionValues(TgItem2d *currentItem);
+
+    bool pushFrame(const TgStreamImageFrame &frame);
+    TgStreamImageStatistics getStatistics();
+    void resetStatistics();
+
+private:
+    std::mutex m_mutex;
+    TgStreamImageFrame m_pendingFrame;                              /*!< newest frame waiting for upload, m_mutex must be locked */
+    bool m_framePending;
+    std::chrono::steady_clock::time_point m_pendingFrameTime;
+    TgStreamImageStatistics m_statistics;
+    uint64_t m_totalLatencyUs;
+
+    TgImagePixelBuffer m_pixelBuffer;
+    GLuint m_textureIndex[TG_STREAM_IMAGE_PLANE_MAX_COUNT];
+    TgStreamImageFormat m_textureFormat;
+    uint32_t m_textureWidth;
+    uint32_t m_textureHeight;
+
+    bool m_initVerticesDone;
+    TgMatrix4x4 m_transform;
+
+    bool init();
+    void setTranform(TgItem2d *currentItem);
+    void uploadPendingFrame();
+    bool generateTextures(TgStreamImageFormat format, uint32_t width, uint32_t height);
+    void deleteTextures();
+
+    static bool isFrameValid(const TgStreamImageFrame &frame);
+    static size_t getPlaneCount(TgStreamImageFormat format);
+    static void getPlaneSize(TgStreamImageFormat format, size_t plane, uint32_t width, uint32_t height,
+                             uint32_t &planeWidth, uint32_t &planeHeight, uint32_t &bytesPerPixel);
+    static void getPlaneTextureFormat(TgStreamImageFormat format, size_t plane, GLint &internalFormat, GLenum &pixelFormat);
+};
+
+#endif // TG_STREAM_IMAGE_PRIVATE_H
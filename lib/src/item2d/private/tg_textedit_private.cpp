@@ -451,13 +451,10 @@ TgEventResult TgTexteditPrivate::handleEvent(TgEventData *eventData)
         }
         if (eventData->m_event.m_keyEvent.m_pressReleaseKey == TgPressReleaseKey::PressReleaseKey_NormalKey
             && eventData->m_event.m_keyEvent.m_key != 0) {
-            std::vector<std::string> listFontFileNames;
             std::string fontFile = m_textField.m_private->getFontFile();
-            TgFontDefault::getFontFileNames(fontFile,
-                                         TgGlobalApplication::getInstance()->getFontDefault()->getListFont(),
-                                         listFontFileNames);
-            if (TgGlobalApplication::getInstance()->getFontCharactersCache()->getFontIndexForCharacter(eventData->m_event.m_keyEvent.m_key,
-                fontFile, listFontFileNames) != -1) {
+            std::shared_ptr<const TgFontChain> fontChain = TgFontDefault::getMainFontChain(fontFile);
+            if (TgFontCharactersCache::getFontIndexForCharacter(eventData->m_event.m_keyEvent.m_key, 0,
+                                                                TgFontCharactersCache::getFontCharacters(*fontChain)) != -1) {
                 listAddCharacter.push_back(eventData->m_event.m_keyEvent.m_key);
                 if (m_selectedTextSize >= 0) {
                     m_textField.m_private->editText(listAddCharacter, static_cast<size_t>(m_cursorPosition), static_cast<size_t>(m_selectedTextSize));
@@ -11,6 +11,7 @@
 
 #include "tg_textfield_private.h"
 #include <cmath>
+#include <algorithm>
 #include <string.h>
 #include <float.h>
 #include "../../global/tg_global_application.h"
@@ -23,13 +24,14 @@
 #include "../../window/tg_mainwindow_private.h"
 #include "../../global/private/tg_global_wait_renderer.h"
 #include "item2d/tg_item2d_position.h"
-#include "../../font/text/tg_text_parse_utf8.h"
+#include "../../font/text/tg_text_transcode_utf8.h"
 
 TgTextfieldPrivate::TgTextfieldPrivate(TgItem2d *currentItem,
                                        const char *text, const char *fontFile, float fontSize,
                                        uint8_t r, uint8_t g, uint8_t b) :
     m_currentItem(currentItem),
     m_fontText(nullptr),
+    m_fontTextShared(false),
     m_r(r),
     m_g(g),
     m_b(b),
@@ -40,7 +42,16 @@ TgTextfieldPrivate::TgTextfieldPrivate(TgItem2d *currentItem,
     m_wordWrap(TgTextFieldWordWrap::WordWrapBounded),
     m_allowBreakLineGoOverMaxLine(false),
     m_alignHorizontal(TgTextfieldHorizontalAlign::AlignLeft),
-    m_alignVertical(TgTextfieldVerticalAlign::AlignTop)
+    m_alignVertical(TgTextfieldVerticalAlign::AlignTop),
+    m_asyncTextPreparation(false),
+    m_listTextChanged(false),
+    m_useFontTextCache(true),
+    m_editStartIndex(SIZE_MAX),
+    m_verticesStartIndex(SIZE_MAX),
+    m_verticesX(0),
+    m_verticesY(0),
+    m_verticesWidth(0),
+    m_verticesAlignHorizontal(TgTextfieldHorizontalAlign::AlignLeft)
 {
     if (strlen(text) > 0) {
         TgTextFieldText t;
@@ -61,27 +72,186 @@ TgTextfieldPrivate::TgTextfieldPrivate(TgItem2d *currentItem,
 TgTextfieldPrivate::~TgTextfieldPrivate()
 {
     TG_FUNCTION_BEGIN();
-    m_listTransform.clear();
+    cancelTextPreparation();
+    m_listVertice.clear();
+    m_listDrawRun.clear();
+    releaseFontText();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::setSharedFontText
+ *
+ * sets m_fontText from the font text cache, so items with
+ * same text (and layout values) share the glyph positions
+ *
+ * \param width width of the text area
+ */
+void TgTextfieldPrivate::setSharedFontText(float width)
+{
+    // get new text before releasing the previous one, so text is not re-generated if it's same
+    TgFontText *fontText = TgGlobalApplication::getInstance()->getFontTextCache()->getFontText(m_listText, m_fontFile, m_fontSize,
+                                                                                                m_maxLineCount, width, m_wordWrap,
+                                                                                                m_allowBreakLineGoOverMaxLine);
+    releaseFontText();
+    m_fontText = fontText;
+    m_fontTextShared = fontText != nullptr;
+    m_previousTextWidthCalc = width;
+    m_editStartIndex = SIZE_MAX;
+    m_verticesStartIndex = SIZE_MAX;
+}
+
+/*!
+ * \brief TgTextfieldPrivate::generateFontText
+ *
+ * generates m_fontText that is only for this text field,
+ * so it can be edited with editText()
+ *
+ * \param width width of the text area
+ */
+void TgTextfieldPrivate::generateFontText(float width)
+{
+    releaseFontText();
+    m_fontText = TgFontTextGenerator::generateFontTextInfo(m_listText, m_fontFile.c_str());
     if (m_fontText) {
-        delete m_fontText;
+        m_fontText->generateFontTextInfoGlyphs(m_fontSize, false);
+        TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, width, m_wordWrap, m_allowBreakLineGoOverMaxLine);
     }
-    TG_FUNCTION_END();
+    m_previousTextWidthCalc = width;
+    m_editStartIndex = SIZE_MAX;
+    m_verticesStartIndex = SIZE_MAX;
+}
+
+/*!
+ * \brief TgTextfieldPrivate::relayoutFontText
+ *
+ * re-generates character positions of m_fontText for
+ * current width of the item
+ */
+void TgTextfieldPrivate::relayoutFontText()
+{
+    if (m_fontTextShared) {
+        setSharedFontText(m_currentItem->getWidth());
+        return;
+    }
+    TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
+    m_previousTextWidthCalc = m_currentItem->getWidth();
+    m_editStartIndex = SIZE_MAX;
+    m_verticesStartIndex = SIZE_MAX;
 }
 
 /*!
- * \brief TgTextfieldPrivate::generateTransform
+ * \brief TgTextfieldPrivate::relayoutEditedText
  *
- * generate transform position
+ * positions characters of edited m_fontText again, starting
+ * from the line where the first edit was done
+ */
+void TgTextfieldPrivate::relayoutEditedText()
+{
+    if (m_editStartIndex == SIZE_MAX) {
+        return;
+    }
+    if (m_fontText && !m_fontTextShared) {
+        size_t layoutStartIndex = 0;
+        TgFontTextLineStart lineStart;
+        if (m_fontText->getLineStart(m_editStartIndex, lineStart)) {
+            layoutStartIndex = lineStart.m_characterIndex;
+            // word wrap may move the characters after previous space to next line
+            if (lineStart.m_previousSpaceIndex != SIZE_MAX && lineStart.m_previousSpaceIndex + 1 < layoutStartIndex) {
+                layoutStartIndex = lineStart.m_previousSpaceIndex + 1;
+            }
+        }
+        TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, m_previousTextWidthCalc, m_wordWrap,
+                                                               m_allowBreakLineGoOverMaxLine, m_editStartIndex);
+        if (m_verticesStartIndex == SIZE_MAX || m_verticesStartIndex > layoutStartIndex) {
+            m_verticesStartIndex = layoutStartIndex;
+        }
+    }
+    m_editStartIndex = SIZE_MAX;
+}
+
+/*!
+ * \brief TgTextfieldPrivate::updateListText
  *
+ * re-generates m_listText (utf8) from the edited m_listCharacter
  */
-void TgTextfieldPrivate::generateTransform(TgItem2d *currentItem)
+void TgTextfieldPrivate::updateListText()
 {
     size_t i;
+    m_mutex.lock();
+    if (!m_listTextChanged) {
+        m_mutex.unlock();
+        return;
+    }
+    m_listTextChanged = false;
+    m_listText.clear();
+    if (!m_listCharacter.empty()) {
+        // each run of same color is converted to utf8 at once
+        TgTextFieldText t;
+        std::vector<uint32_t> listRun;
+        size_t runStart = 0;
+        for (i=1;i<=m_listCharacter.size();i++) {
+            if (i < m_listCharacter.size()
+                && m_listCharacter.at(runStart).m_r == m_listCharacter.at(i).m_r
+                && m_listCharacter.at(runStart).m_g == m_listCharacter.at(i).m_g
+                && m_listCharacter.at(runStart).m_b == m_listCharacter.at(i).m_b) {
+                continue;
+            }
+            t.m_textColorR = m_listCharacter.at(runStart).m_r;
+            t.m_textColorG = m_listCharacter.at(runStart).m_g;
+            t.m_textColorB = m_listCharacter.at(runStart).m_b;
+            listRun.resize(i-runStart);
+            for (size_t j=runStart;j<i;j++) {
+                listRun[j-runStart] = m_listCharacter.at(j).m_character;
+            }
+            t.m_text.clear();
+            TgTextTranscodeUtf8::addUtf32ToUtf8Text(listRun.data(), listRun.size(), t.m_text);
+            m_listText.push_back(t);
+            runStart = i;
+        }
+    }
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::releaseFontText
+ *
+ * releases (or deletes) m_fontText
+ */
+void TgTextfieldPrivate::releaseFontText()
+{
+    if (!m_fontText) {
+        return;
+    }
+    if (m_fontTextShared) {
+        TgGlobalApplication::getInstance()->getFontTextCache()->releaseFontText(m_fontText);
+    } else {
+        m_fontText->clearCacheValues(true);
+        delete m_fontText;
+    }
+    m_fontText = nullptr;
+    m_fontTextShared = false;
+    // draw runs point to font infos of the released text
+    m_listDrawRun.clear();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::generateVertices
+ *
+ * generates vertices of all characters (on window position) into
+ * single vertex buffer, only characters from m_verticesStartIndex
+ * are generated again if position of the text is not changed
+ *
+ */
+void TgTextfieldPrivate::generateVertices(TgItem2d *currentItem)
+{
+    size_t i, startIndex = m_verticesStartIndex;
     float x = 0, y = 0;
-    m_listTransform.resize( m_fontText->getCharacterCount() );
+    m_verticesStartIndex = SIZE_MAX;
     if (!m_fontText) {
         return;
     }
+    m_listVertice.resize( m_fontText->getCharacterCount()*6 );
 
     switch (m_alignVertical) {
         case TgTextfieldVerticalAlign::AlignTop:
@@ -97,8 +267,21 @@ void TgTextfieldPrivate::generateTransform(TgItem2d *currentItem)
     }
 
     y = std::roundf(y);
-    for (i=0;i<m_fontText->getCharacterCount();i++) {
+    // only edited lines are changed, if the position of the text is same
+    if (startIndex == SIZE_MAX
+        || std::fabs(m_verticesY - y) > std::numeric_limits<float>::epsilon()
+        || std::fabs(m_verticesX - currentItem->getXonWindow()) > std::numeric_limits<float>::epsilon()
+        || std::fabs(m_verticesWidth - currentItem->getWidth()) > std::numeric_limits<float>::epsilon()
+        || m_verticesAlignHorizontal != m_alignHorizontal) {
+        startIndex = 0;
+    }
+    m_verticesX = currentItem->getXonWindow();
+    m_verticesY = y;
+    m_verticesWidth = currentItem->getWidth();
+    m_verticesAlignHorizontal = m_alignHorizontal;
+    for (i=startIndex;i<m_fontText->getCharacterCount();i++) {
         if (m_fontText->getCharacter(i)->m_character == '\n') {
+            memset(&m_listVertice[i*6], 0, sizeof(VerticeColor)*6);
             continue;
         }
 
@@ -115,7 +298,35 @@ void TgTextfieldPrivate::generateTransform(TgItem2d *currentItem)
                 break;
         }
         x = std::roundf(x);
-        m_listTransform[i].setTransform(m_fontText->getCharacter(i)->positionLeftX+x, y+static_cast<float>(m_fontText->getCharacter(i)->m_lineNumber)*m_fontText->getLineHeight());
+        TgFontGlyphCache::getCharacterVertices(m_fontText, i, m_fontText->getCharacter(i)->positionLeftX+x,
+                                               y+static_cast<float>(m_fontText->getCharacter(i)->m_lineNumber)*m_fontText->getLineHeight(),
+                                               &m_listVertice[i*6]);
+    }
+    m_renderText.update(m_listVertice, std::min(startIndex, m_fontText->getCharacterCount())*6);
+    generateDrawRuns();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::generateDrawRuns
+ *
+ * generates list of continuous characters that are drawn
+ * from same glyph texture, so each of them is single draw call
+ * (usually whole text is one draw call)
+ */
+void TgTextfieldPrivate::generateDrawRuns()
+{
+    size_t i;
+    m_listDrawRun.clear();
+    for (i=0;i<m_fontText->getCharacterCount();i++) {
+        const TgFontInfo *info = m_fontText->getFontInfo(i);
+        if (!info) {
+            // characters without font have zero size vertices, they can be drawn in any run
+            continue;
+        }
+        if (m_listDrawRun.empty() || m_listDrawRun.back().m_fontInfo != info) {
+            m_listDrawRun.push_back({info, i*6, 0});
+        }
+        m_listDrawRun.back().m_verticesCount = (i+1)*6 - m_listDrawRun.back().m_startIndex;
     }
 }
 
@@ -151,6 +362,7 @@ void TgTextfieldPrivate::setText(const std::vector<TgTextFieldText> &listText, T
 {
     TG_FUNCTION_BEGIN();
     m_mutex.lock();
+    updateListText();
     if (isEqualText(listText)) {
         if (isEqualTextColor(listText)) {
             m_mutex.unlock();
@@ -163,7 +375,11 @@ void TgTextfieldPrivate::setText(const std::vector<TgTextFieldText> &listText, T
             m_listText[i].m_textColorG = listText.at(i).m_textColorG;
             m_listText[i].m_textColorB = listText.at(i).m_textColorB;
         }
-        if (TgFontTextGenerator::changeTextColor(listText, m_fontText)) {
+        if (m_fontText && !m_fontTextShared
+            && TgFontTextGenerator::changeTextColor(listText, m_fontText)) {
+            // color is in the vertices
+            m_verticesStartIndex = SIZE_MAX;
+            currentItem->setPositionChanged(true);
             m_mutex.unlock();
             TG_FUNCTION_END();
             return;
@@ -171,6 +387,7 @@ void TgTextfieldPrivate::setText(const std::vector<TgTextFieldText> &listText, T
     }
 
     m_listText = std::move(listText);
+    m_listTextChanged = false;
     TgFontTextGenerator::getCharacters(m_listText, m_listCharacter);
     m_initDone = false;
     currentItem->setPositionChanged(true);
@@ -186,8 +403,17 @@ void TgTextfieldPrivate::setText(const std::vector<TgTextFieldText> &listText, T
 std::string TgTextfieldPrivate::getText() const
 {
     std::string ret;
+    size_t i;
     m_mutex.lock();
-    ret = TgFontTextGenerator::generateSingleLineText(m_listText);
+    if (m_listTextChanged) {
+        std::vector<uint32_t> listCharacter(m_listCharacter.size());
+        for (i=0;i<m_listCharacter.size();i++) {
+            listCharacter[i] = m_listCharacter.at(i).m_character;
+        }
+        TgTextTranscodeUtf8::addUtf32ToUtf8Text(listCharacter.data(), listCharacter.size(), ret);
+    } else {
+        ret = TgFontTextGenerator::generateSingleLineText(m_listText);
+    }
     m_mutex.unlock();
     return ret;
 }
@@ -201,6 +427,7 @@ std::string TgTextfieldPrivate::getText() const
  */
 bool TgTextfieldPrivate::isEqualText(const std::vector<TgTextFieldText> &listText)
 {
+    updateListText();
     if (m_listText.size() != listText.size()) {
         return false;
     }
@@ -222,6 +449,7 @@ bool TgTextfieldPrivate::isEqualText(const std::vector<TgTextFieldText> &listTex
  */
 bool TgTextfieldPrivate::isEqualTextColor(const std::vector<TgTextFieldText> &listText)
 {
+    updateListText();
     if (m_listText.size() != listText.size()) {
         return false;
     }
@@ -250,30 +478,52 @@ void TgTextfieldPrivate::checkPositionValues()
     TG_FUNCTION_BEGIN();
     m_mutex.lock();
     if (!m_initDone) {
-        if (m_fontText) {
-            delete m_fontText;
+        updateListText();
+        if (m_asyncTextPreparation) {
+            startTextPreparation();
+        } else {
+            cancelTextPreparation();
+            if (m_useFontTextCache) {
+                setSharedFontText(m_currentItem->getWidth());
+            } else {
+                generateFontText(m_currentItem->getWidth());
+            }
         }
-        m_fontText = TgFontTextGenerator::generateFontTextInfo(m_listText, m_fontFile.c_str());
-        m_fontText->generateFontTextInfoGlyphs(m_fontSize, false);
-        TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
-        m_previousTextWidthCalc = m_currentItem->getWidth();
+    } else {
+        relayoutEditedText();
+    }
+    if (m_preparation && takePreparedText()) {
+        m_currentItem->setPositionChanged(true);
+    }
+    if (!m_fontText) {
+        // previous text is not yet prepared (async)
+        m_initDone = true;
+        m_mutex.unlock();
+        TG_FUNCTION_END();
+        return;
     }
     if (m_currentItem->getPositionChanged()) {
         if (m_fontText
             && std::fabs(m_previousTextWidthCalc - m_currentItem->getWidth()) > std::numeric_limits<double>::epsilon()) {
-            TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
-            m_previousTextWidthCalc = m_currentItem->getWidth();
+            relayoutFontText();
+        }
+        if (!m_fontText) {
+            m_initDone = true;
+            m_mutex.unlock();
+            TG_FUNCTION_END();
+            return;
         }
-        generateTransform(m_currentItem);
+        generateVertices(m_currentItem);
         m_currentItem->setAddMinMaxHeightOnVisible(
             m_fontText->getVisibleTopY(),
             m_fontText->getVisibleBottomY());
         m_currentItem->setPositionChanged(false);
     } else if (m_fontText
                && std::fabs(m_previousTextWidthCalc - m_currentItem->getWidth()) > std::numeric_limits<double>::epsilon()) {
-        TgCharacterPositions::generateTextCharacterPositioning(m_fontText, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
-        m_previousTextWidthCalc = m_currentItem->getWidth();
-        generateTransform(m_currentItem);
+        relayoutFontText();
+        if (m_fontText) {
+            generateVertices(m_currentItem);
+        }
     }
     m_initDone = true;
     m_mutex.unlock();
@@ -309,9 +559,14 @@ bool TgTextfieldPrivate::render(const TgWindowInfo *windowInfo, TgItem2d *curren
                 currentItem->getXmaxOnVisible(windowInfo),
                 currentItem->getYmaxOnVisible(windowInfo));
     glUniform1f( windowInfo->m_shaderOpacityIndex, opacity);
+    // vertices are on window position and they have the character color
+    glUniformMatrix4fv(windowInfo->m_shaderTransformIndex, 1, 0, m_transform.getMatrixTable()->data);
+    glUniform4f(windowInfo->m_shaderColorIndex, 1, 1, 1, 1);
 
-    TgGlobalApplication::getInstance()->getFontGlyphCache()->render(m_fontText, windowInfo->m_shaderTransformIndex,
-        windowInfo->m_shaderColorIndex, m_listTransform);
+    std::vector<TgTextfieldDrawRun>::const_iterator it;
+    for (it=m_listDrawRun.begin();it!=m_listDrawRun.end();it++) {
+        m_renderText.render(it->m_fontInfo->m_textureImage, it->m_startIndex, it->m_verticesCount);
+    }
 
     glUniform1i( windowInfo->m_shaderRenderTypeIndex, 0);
     TG_FUNCTION_END();
@@ -440,7 +695,11 @@ size_t TgTextfieldPrivate::getCharacterCount()
  */
 size_t TgTextfieldPrivate::getTextCharacterIndex(float x)
 {
-    return TgGlobalApplication::getInstance()->getFontGlyphCache()->getTextCharacterIndex(m_fontText, x);
+    m_mutex.lock();
+    relayoutEditedText();
+    size_t ret = TgGlobalApplication::getInstance()->getFontGlyphCache()->getTextCharacterIndex(m_fontText, x);
+    m_mutex.unlock();
+    return ret;
 }
 
 /*!
@@ -473,7 +732,10 @@ uint32_t TgTextfieldPrivate::getCharacterByIndex(size_t index)
  */
 void TgTextfieldPrivate::getTextPosition(const size_t cursorPosition, float &positionX)
 {
+    m_mutex.lock();
+    relayoutEditedText();
     TgGlobalApplication::getInstance()->getFontGlyphCache()->getTextPosition(m_fontText, cursorPosition, positionX);
+    m_mutex.unlock();
 }
 
 /*!
@@ -501,11 +763,13 @@ float TgTextfieldPrivate::getTextWidth()
     TG_FUNCTION_BEGIN();
     float ret = 0;
     m_mutex.lock();
-    if (m_initDone) {
+    relayoutEditedText();
+    if (m_initDone && !m_preparation) {
         if (m_fontText) {
             ret = m_fontText->getTextWidth();
         }
     } else {
+        updateListText();
         float textHeight;
         float allDrawTextHeight;
         TgFontMath::getFontWidthHeightCacheWithoutRender(m_listText, m_fontSize, m_fontFile, ret, textHeight, allDrawTextHeight, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
@@ -525,11 +789,13 @@ float TgTextfieldPrivate::getTextHeight()
     TG_FUNCTION_BEGIN();
     float ret = 0;
     m_mutex.lock();
-    if (m_initDone) {
+    relayoutEditedText();
+    if (m_initDone && !m_preparation) {
         if (m_fontText) {
             ret = m_fontText->getFontHeight();
         }
     } else {
+        updateListText();
         float textWidth;
         float allDrawTextHeight;
         TgFontMath::getFontWidthHeightCacheWithoutRender(m_listText, m_fontSize, m_fontFile, textWidth, ret, allDrawTextHeight, m_maxLineCount, m_currentItem->getWidth(), m_wordWrap, m_allowBreakLineGoOverMaxLine);
@@ -549,11 +815,13 @@ float TgTextfieldPrivate::getAllDrawTextHeight()
     TG_FUNCTION_BEGIN();
     float ret = 0;
     m_mutex.lock();
-    if (m_initDone && m_previousTextWidthCalc >= 0) {
+    relayoutEditedText();
+    if (m_initDone && !m_preparation && m_previousTextWidthCalc >= 0) {
         if (m_fontText) {
             ret = m_fontText->getAllDrawTextHeight();
         }
     } else {
+        updateListText();
         float textWidth;
         float textHeight;
         TgFontMath::getFontWidthHeightCacheWithoutRender(m_listText, m_fontSize, m_fontFile, textWidth, textHeight, ret, m_maxLineCount,
@@ -594,8 +862,13 @@ void TgTextfieldPrivate::getColor(uint8_t &r, uint8_t &g, uint8_t &b)
 void TgTextfieldPrivate::editText(std::vector<uint32_t>&listAddCharacter, const size_t startCharacterIndex, const size_t characterCountToRemove)
 {
     m_mutex.lock();
+    if (startCharacterIndex + characterCountToRemove > m_listCharacter.size()) {
+        m_mutex.unlock();
+        return;
+    }
     if (characterCountToRemove) {
-        m_listCharacter.erase(m_listCharacter.begin()+startCharacterIndex, m_listCharacter.begin()+(startCharacterIndex+characterCountToRemove));
+        m_listCharacter.erase(m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex),
+                              m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex+characterCountToRemove));
     }
 
     size_t i;
@@ -615,49 +888,27 @@ void TgTextfieldPrivate::editText(std::vector<uint32_t>&listAddCharacter, const
          ? m_listCharacter.at(startCharacterIndex-1).m_b
          : m_listCharacter.at(startCharacterIndex).m_b;
 
-    TgTextCharacter c;
+    std::vector<TgTextCharacter> listAdd(listAddCharacter.size());
     for (i=0;i<listAddCharacter.size();i++) {
-        c.m_character = listAddCharacter.at(i);
-        c.m_r = r;
-        c.m_g = g;
-        c.m_b = b;
-        if (m_listCharacter.size() <= startCharacterIndex+i) {
-            m_listCharacter.push_back(c);
-        } else {
-            m_listCharacter.insert(m_listCharacter.begin()+(startCharacterIndex+i), c);
-        }
+        listAdd[i].m_character = listAddCharacter.at(i);
+        listAdd[i].m_r = r;
+        listAdd[i].m_g = g;
+        listAdd[i].m_b = b;
     }
+    m_listCharacter.insert(m_listCharacter.begin()+static_cast<int64_t>(startCharacterIndex), listAdd.begin(), listAdd.end());
+    // utf8 text is generated only when it's needed
+    m_listTextChanged = true;
 
-    m_listText.clear();
-    if (!m_listCharacter.empty()) {
-        TgTextFieldText t;
-        char utf8Character[5];
-        t.m_textColorR = m_listCharacter.at(0).m_r;
-        t.m_textColorG = m_listCharacter.at(0).m_g;
-        t.m_textColorB = m_listCharacter.at(0).m_b;
-        TgTextParseUtf8::generateCharactedIndexToUtf8(m_listCharacter.at(0).m_character, utf8Character);
-        t.m_text = utf8Character;
-
-        for (i=1;i<m_listCharacter.size();i++) {
-            if (t.m_textColorR == m_listCharacter.at(i).m_r
-                && t.m_textColorG == m_listCharacter.at(i).m_g
-                && t.m_textColorB == m_listCharacter.at(i).m_b) {
-                TgTextParseUtf8::generateCharactedIndexToUtf8(m_listCharacter.at(i).m_character, utf8Character);
-                t.m_text += utf8Character;
-                continue;
-            }
-            m_listText.push_back(t);
-            t.m_textColorR = m_listCharacter.at(i).m_r;
-            t.m_textColorG = m_listCharacter.at(i).m_g;
-            t.m_textColorB = m_listCharacter.at(i).m_b;
-            TgTextParseUtf8::generateCharactedIndexToUtf8(m_listCharacter.at(i).m_character, utf8Character);
-            t.m_text = utf8Character;
+    if (m_initDone && m_fontText && !m_fontTextShared && !m_preparation
+        && m_fontText->editCharacters(startCharacterIndex, characterCountToRemove, listAddCharacter, r, g, b)) {
+        // glyphs are re-used, only characters from the edited line are positioned again
+        if (m_editStartIndex > startCharacterIndex) {
+            m_editStartIndex = startCharacterIndex;
         }
-        m_listText.push_back(t);
-        TgFontTextGenerator::getCharacters(m_listText, m_listCharacter);
+    } else {
+        m_useFontTextCache = false;
+        m_initDone = false;
     }
-
-    m_initDone = false;
     m_currentItem->setPositionChanged(true);
     m_mutex.unlock();
 }
@@ -741,4 +992,168 @@ bool TgTextfieldPrivate::getAllowBreakLineGoOverMaxLine() const
     m_mutex.unlock();
     TG_FUNCTION_END();
     return ret;
-}
\ No newline at end of file
+}
+
+/*!
+ * \brief TgTextfieldPrivate::setAsyncTextPreparation
+ *
+ * \param asyncTextPreparation if true, text shaping and layout is done on
+ * the worker thread, and previous text is shown until the new text is ready
+ */
+void TgTextfieldPrivate::setAsyncTextPreparation(bool asyncTextPreparation)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_asyncTextPreparation = asyncTextPreparation;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::getAsyncTextPreparation
+ *
+ * \return true if text shaping and layout is done on the worker thread
+ */
+bool TgTextfieldPrivate::getAsyncTextPreparation() const
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    bool ret = m_asyncTextPreparation;
+    m_mutex.unlock();
+    TG_FUNCTION_END();
+    return ret;
+}
+
+/*!
+ * \brief TgTextfieldPrivate::startTextPreparation
+ *
+ * starts preparing current text on the worker thread,
+ * previous preparation is cancelled
+ */
+void TgTextfieldPrivate::startTextPreparation()
+{
+    TG_FUNCTION_BEGIN();
+    cancelTextPreparation();
+    m_preparation = std::make_shared<TgTextfieldPreparation>();
+    m_preparation->m_listText = m_listText;
+    m_preparation->m_fontFile = m_fontFile;
+    m_preparation->m_fontSize = m_fontSize;
+    m_preparation->m_maxLineCount = m_maxLineCount;
+    m_preparation->m_width = m_currentItem->getWidth();
+    m_preparation->m_wordWrap = m_wordWrap;
+    m_preparation->m_allowBreakLineGoOverMaxLine = m_allowBreakLineGoOverMaxLine;
+    std::shared_ptr<TgTextfieldPreparation> preparation = m_preparation;
+    TgGlobalApplication::getInstance()->getThreadPool()->addJob([preparation]() {
+        prepareText(preparation);
+    });
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::cancelTextPreparation
+ *
+ * cancels text preparation (if there is one),
+ * the result is deleted when preparation is done
+ */
+void TgTextfieldPrivate::cancelTextPreparation()
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_preparation) {
+        TG_FUNCTION_END();
+        return;
+    }
+    TgFontText *fontText = nullptr;
+    m_preparation->m_mutex.lock();
+    m_preparation->m_cancelled = true;
+    fontText = m_preparation->m_fontText;
+    m_preparation->m_fontText = nullptr;
+    m_preparation->m_mutex.unlock();
+    if (fontText) {
+        fontText->clearCacheValues(true);
+        delete fontText;
+    }
+    m_preparation.reset();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextfieldPrivate::takePreparedText
+ *
+ * if text preparation is ready, replaces current text with prepared text
+ * and uploads it's glyph textures (must be called on OpenGL thread)
+ *
+ * \return true if text was replaced
+ */
+bool TgTextfieldPrivate::takePreparedText()
+{
+    TG_FUNCTION_BEGIN();
+    m_preparation->m_mutex.lock();
+    if (!m_preparation->m_ready) {
+        m_preparation->m_mutex.unlock();
+        TG_FUNCTION_END();
+        return false;
+    }
+    TgFontText *fontText = m_preparation->m_fontText;
+    m_preparation->m_fontText = nullptr;
+    m_preparation->m_mutex.unlock();
+
+    releaseFontText();
+    m_fontText = fontText;
+    if (m_fontText) {
+        TgGlobalApplication::getInstance()->getFontGlyphCache()->uploadPreparedCache(m_fontText);
+    }
+    m_previousTextWidthCalc = m_preparation->m_width;
+    m_editStartIndex = SIZE_MAX;
+    m_verticesStartIndex = SIZE_MAX;
+    if (m_preparation->m_maxLineCount != m_maxLineCount
+        || m_preparation->m_wordWrap != m_wordWrap
+        || m_preparation->m_allowBreakLineGoOverMaxLine != m_allowBreakLineGoOverMaxLine) {
+        // layout values are changed during the preparation
+        m_previousTextWidthCalc = -1.0f;
+    }
+    m_preparation.reset();
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgTextfieldPrivate::prepareText
+ *
+ * prepares the text (shaping, glyphs and layout) on the worker thread
+ *
+ * \param preparation
+ */
+void TgTextfieldPrivate::prepareText(std::shared_ptr<TgTextfieldPreparation> preparation)
+{
+    TG_FUNCTION_BEGIN();
+    preparation->m_mutex.lock();
+    bool cancelled = preparation->m_cancelled;
+    preparation->m_mutex.unlock();
+    if (cancelled) {
+        TG_FUNCTION_END();
+        return;
+    }
+
+    TgFontText *fontText = TgFontTextGenerator::generateFontTextInfo(preparation->m_listText, preparation->m_fontFile.c_str());
+    if (fontText) {
+        fontText->prepareFontTextInfoGlyphs(preparation->m_fontSize);
+        TgCharacterPositions::generateTextCharacterPositioning(fontText, preparation->m_maxLineCount, preparation->m_width,
+                                                               preparation->m_wordWrap, preparation->m_allowBreakLineGoOverMaxLine);
+    }
+
+    preparation->m_mutex.lock();
+    if (preparation->m_cancelled) {
+        preparation->m_mutex.unlock();
+        if (fontText) {
+            fontText->clearCacheValues(true);
+            delete fontText;
+        }
+        TG_FUNCTION_END();
+        return;
+    }
+    preparation->m_fontText = fontText;
+    preparation->m_ready = true;
+    preparation->m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
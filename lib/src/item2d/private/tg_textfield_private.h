@@ -14,17 +14,52 @@
 
 #include "../../image/tg_image_assets.h"
 #include "../../math/tg_matrix4x4.h"
+#include "../../render/tg_render_text.h"
 #include "../../font/tg_character_positions.h"
 #include <string>
 #include <mutex>
+#include <memory>
 #include "../tg_textfield.h"
 #include "../../font/tg_font_text_generator.h"
 
 struct TgFontText;
+struct TgFontInfo;
 class TgItem2d;
 struct TgWindowInfo;
 class TgItem2dPosition;
 
+/*!
+ * \brief TgTextfieldDrawRun
+ * continuous characters (vertices) that are drawn from same glyph texture
+ */
+struct TgTextfieldDrawRun
+{
+    const TgFontInfo *m_fontInfo;
+    size_t m_startIndex;        /*!< first vertex */
+    size_t m_verticesCount;
+};
+
+/*!
+ * \brief TgTextfieldPreparation
+ * text shaping and layout that is done on the worker thread,
+ * shared between the text field and the worker thread job
+ */
+struct TgTextfieldPreparation
+{
+    std::vector<TgTextFieldText> m_listText;
+    std::string m_fontFile;
+    float m_fontSize;
+    uint32_t m_maxLineCount;
+    float m_width;
+    TgTextFieldWordWrap m_wordWrap;
+    bool m_allowBreakLineGoOverMaxLine;
+
+    std::mutex m_mutex;
+    bool m_ready = false;                   /*!< m_fontText is prepared */
+    bool m_cancelled = false;               /*!< text field does not need the result anymore */
+    TgFontText *m_fontText = nullptr;
+};
+
 class TgTextfieldPrivate
 {
 public:
@@ -59,10 +94,13 @@ public:
     void setAllowBreakLineGoOverMaxLine(bool allowBreakLineGoOverMaxLine);
     bool getAllowBreakLineGoOverMaxLine() const;
     void getColor(uint8_t &r, uint8_t &g, uint8_t &b);
+    void setAsyncTextPreparation(bool asyncTextPreparation);
+    bool getAsyncTextPreparation() const;
 
 private:
     TgItem2d *m_currentItem;
     TgFontText *m_fontText;
+    bool m_fontTextShared;                  /*!< m_fontText is from TgFontTextCache (must not be modified) */
     uint8_t m_r, m_g, m_b;
     std::vector<TgTextFieldText> m_listText;
     std::string m_fontFile;
@@ -73,12 +111,35 @@ private:
     bool m_allowBreakLineGoOverMaxLine;
     float m_previousTextWidthCalc;
     std::vector<TgTextCharacter> m_listCharacter;
-    std::vector<TgMatrix4x4>m_listTransform;
+    std::vector<VerticeColor>m_listVertice;     /*!< 6 vertices for each character, on window position */
+    std::vector<TgTextfieldDrawRun>m_listDrawRun;
+    TgRenderText m_renderText;
+    TgMatrix4x4 m_transform;
     TgTextfieldHorizontalAlign m_alignHorizontal;
     TgTextfieldVerticalAlign m_alignVertical;
     mutable std::recursive_mutex m_mutex;
+    bool m_asyncTextPreparation;
+    std::shared_ptr<TgTextfieldPreparation> m_preparation;
+    bool m_listTextChanged;                 /*!< m_listCharacter is edited, m_listText must be re-generated */
+    bool m_useFontTextCache;                /*!< false when text is edited, edited text is not shared */
+    size_t m_editStartIndex;                /*!< characters are positioned again from this index, SIZE_MAX == no edits */
+    size_t m_verticesStartIndex;            /*!< vertices are generated again from this character index, SIZE_MAX == all */
+    float m_verticesX, m_verticesY, m_verticesWidth;
+    TgTextfieldHorizontalAlign m_verticesAlignHorizontal;
+
+    void generateVertices(TgItem2d *currentItem);
+    void generateDrawRuns();
+    void setSharedFontText(float width);
+    void generateFontText(float width);
+    void relayoutFontText();
+    void relayoutEditedText();
+    void updateListText();
+    void releaseFontText();
+    void startTextPreparation();
+    void cancelTextPreparation();
+    bool takePreparedText();
 
-    void generateTransform(TgItem2d *currentItem);
+    static void prepareText(std::shared_ptr<TgTextfieldPreparation> preparation);
 };
 
 #endif // TG_TEXTFIELD_PRIVATE_H
@@ -0,0 +1,672 @@
+/*!
+ * \file
+ * \brief file tg_tiled_image_private.cpp
+ *
+ * it holds general TgTiledImagePrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_tiled_image_private.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../../global/tg_global_log.h"
+#include "../../global/tg_global_application.h"
+#include "../../global/private/tg_global_wait_renderer.h"
+#include "../tg_item2d.h"
+#include "../../window/tg_mainwindow_private.h"
+#include "item2d/tg_item2d_position.h"
+
+TgTiledImageSource::~TgTiledImageSource()
+{
+    for (size_t i=0;i<m_listLoadedTile.size();i++) {
+        delete[] m_listLoadedTile[i].m_imageData;
+    }
+}
+
+TgTiledImagePrivate::TgTiledImagePrivate(const char *filename) :
+    m_filename(filename ? filename : ""),
+    m_tileCacheDirectoryMaxSize(TG_IMAGE_TILE_PYRAMID_DEFAULT_CACHE_MAX_SIZE),
+    m_zoom(1),
+    m_viewX(0),
+    m_viewY(0),
+    m_tileCacheSize(TG_TILED_IMAGE_DEFAULT_TILE_CACHE_SIZE),
+    m_imageWidth(0),
+    m_imageHeight(0),
+    m_openRequired(!m_filename.empty()),
+    f_imageLoaded(nullptr),
+    m_sourceReady(false),
+    m_frame(0)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgTiledImagePrivate::~TgTiledImagePrivate()
+{
+    TG_FUNCTION_BEGIN();
+    deleteTiles();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setImage
+ *
+ * \param filename full filepath of the png image
+ */
+void TgTiledImagePrivate::setImage(const char *filename)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_filename = filename ? filename : "";
+    m_openRequired = true;
+    m_imageWidth = 0;
+    m_imageHeight = 0;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getImageWidth
+ *
+ * \return width of the image, 0 if image is not loaded (yet)
+ */
+uint32_t TgTiledImagePrivate::getImageWidth()
+{
+    m_mutex.lock();
+    uint32_t ret = m_imageWidth;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getImageHeight
+ *
+ * \return height of the image, 0 if image is not loaded (yet)
+ */
+uint32_t TgTiledImagePrivate::getImageHeight()
+{
+    m_mutex.lock();
+    uint32_t ret = m_imageHeight;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setZoom
+ *
+ * \param zoom zoom, values <= 0 are ignored
+ */
+void TgTiledImagePrivate::setZoom(float zoom)
+{
+    TG_FUNCTION_BEGIN();
+    if (!(zoom > 0)) {
+        TG_WARNING_LOG("Invalid zoom: ", zoom);
+        TG_FUNCTION_END();
+        return;
+    }
+    m_mutex.lock();
+    m_zoom = zoom;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getZoom
+ *
+ * \return zoom
+ */
+float TgTiledImagePrivate::getZoom()
+{
+    m_mutex.lock();
+    float ret = m_zoom;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setViewPosition
+ *
+ * \param x x position on image that is shown on item's left
+ * \param y y position on image that is shown on item's top
+ */
+void TgTiledImagePrivate::setViewPosition(float x, float y)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    m_viewX = x;
+    m_viewY = y;
+    m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getViewPositionX
+ *
+ * \return x position on image that is shown on item's left
+ */
+float TgTiledImagePrivate::getViewPositionX()
+{
+    m_mutex.lock();
+    float ret = m_viewX;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getViewPositionY
+ *
+ * \return y position on image that is shown on item's top
+ */
+float TgTiledImagePrivate::getViewPositionY()
+{
+    m_mutex.lock();
+    float ret = m_viewY;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setTileCacheSize
+ *
+ * \param tileCount maximum number of tile textures
+ */
+void TgTiledImagePrivate::setTileCacheSize(uint32_t tileCount)
+{
+    m_mutex.lock();
+    m_tileCacheSize = tileCount;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getTileCacheSize
+ *
+ * \return maximum number of tile textures
+ */
+uint32_t TgTiledImagePrivate::getTileCacheSize()
+{
+    m_mutex.lock();
+    uint32_t ret = m_tileCacheSize;
+    m_mutex.unlock();
+    return ret;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setTileCacheDirectory
+ *
+ * \param directory full path of the directory, empty (or nullptr) == default directory
+ */
+void TgTiledImagePrivate::setTileCacheDirectory(const char *directory)
+{
+    m_mutex.lock();
+    m_tileCacheDirectory = directory ? directory : "";
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::setTileCacheDirectoryMaxSize
+ *
+ * \param maxSize max size (bytes) of the tile files in tile cache directory
+ */
+void TgTiledImagePrivate::setTileCacheDirectoryMaxSize(uint64_t maxSize)
+{
+    m_mutex.lock();
+    m_tileCacheDirectoryMaxSize = maxSize;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::connectOnImageLoaded
+ *
+ * \param imageLoaded callback
+ */
+void TgTiledImagePrivate::connectOnImageLoaded(std::function<void(bool success)> imageLoaded)
+{
+    m_mutex.lock();
+    f_imageLoaded = imageLoaded;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::disconnectOnImageLoaded
+ */
+void TgTiledImagePrivate::disconnectOnImageLoaded()
+{
+    m_mutex.lock();
+    f_imageLoaded = nullptr;
+    m_mutex.unlock();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::openSource
+ *
+ * drops tiles of the previous image and starts opening
+ * (and splitting into tiles if required) the image on background thread,
+ * splitting can take long time, so it's not done on worker threads
+ *
+ * \param filename full filepath of the png image
+ * \param tileCacheDirectory directory of tile pyramid files
+ * \param tileCacheDirectoryMaxSize max size (bytes) of the tile pyramid files
+ */
+void TgTiledImagePrivate::openSource(const std::string &filename, const std::string &tileCacheDirectory, uint64_t tileCacheDirectoryMaxSize)
+{
+    TG_FUNCTION_BEGIN();
+    deleteTiles();
+    m_listPendingTile.clear();
+    m_sourceReady = false;
+    m_source.reset();
+    if (filename.empty()) {
+        TG_FUNCTION_END();
+        return;
+    }
+    std::shared_ptr<TgTiledImageSource> source = std::make_shared<TgTiledImageSource>();
+    m_source = source;
+    TgGlobalApplication::getInstance()->getThreadPool()->addBackgroundJob([source, filename, tileCacheDirectory, tileCacheDirectoryMaxSize]() {
+        bool succeeded = source->m_pyramid.open(filename, tileCacheDirectory, tileCacheDirectoryMaxSize);
+        source->m_mutex.lock();
+        source->m_opened = true;
+        source->m_openSucceeded = succeeded;
+        source->m_mutex.unlock();
+        TgGlobalWaitRenderer::getInstance()->release();
+    });
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::checkSourceOpened
+ *
+ * checks if the worker thread has opened the image,
+ * and calls image loaded callback when it's opened
+ */
+void TgTiledImagePrivate::checkSourceOpened()
+{
+    if (!m_source || m_sourceReady) {
+        return;
+    }
+    m_source->m_mutex.lock();
+    bool opened = m_source->m_opened;
+    bool succeeded = m_source->m_openSucceeded;
+    m_source->m_mutex.unlock();
+    if (!opened) {
+        return;
+    }
+    m_mutex.lock();
+    if (succeeded) {
+        m_imageWidth = m_source->m_pyramid.getWidth();
+        m_imageHeight = m_source->m_pyramid.getHeight();
+    }
+    std::function<void(bool success)> imageLoaded = f_imageLoaded;
+    m_mutex.unlock();
+    m_sourceReady = succeeded;
+    if (!succeeded) {
+        m_source.reset();
+    }
+    if (imageLoaded) {
+        imageLoaded(succeeded);
+    }
+}
+
+/*!
+ * \brief TgTiledImagePrivate::loadTile
+ *
+ * reads the tile from the tile pyramid on worker thread,
+ * tile is not read if it's not visible anymore
+ *
+ * \param source tile pyramid
+ * \param level mip level
+ * \param tileX tile column
+ * \param tileY tile row
+ */
+void TgTiledImagePrivate::loadTile(const std::shared_ptr<TgTiledImageSource> &source, uint32_t level, uint32_t tileX, uint32_t tileY)
+{
+    TgTiledImageTileData tileData;
+    tileData.m_key = getTileKey(level, tileX, tileY);
+    tileData.m_width = 0;
+    tileData.m_height = 0;
+    tileData.m_imageData = nullptr;
+    source->m_mutex.lock();
+    bool wanted = source->m_listWantedTile.find(tileData.m_key) != source->m_listWantedTile.end();
+    source->m_mutex.unlock();
+    if (wanted) {
+        const unsigned char *tile = source->m_pyramid.getTile(level, tileX, tileY, tileData.m_width, tileData.m_height);
+        if (tile) {
+            // copying reads the tile from the disk here, not on render thread
+            size_t size = static_cast<size_t>(tileData.m_width)*tileData.m_height*4;
+            tileData.m_imageData = new unsigned char[size];
+            memcpy(tileData.m_imageData, tile, size);
+        }
+    }
+    source->m_mutex.lock();
+    source->m_listLoadedTile.push_back(tileData);
+    source->m_mutex.unlock();
+    TgGlobalWaitRenderer::getInstance()->release();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::uploadLoadedTiles
+ *
+ * uploads tiles read on worker thread as textures
+ */
+void TgTiledImagePrivate::uploadLoadedTiles()
+{
+    if (!m_source) {
+        return;
+    }
+    size_t i;
+    std::vector<TgTiledImageTileData> listLoadedTile;
+    m_source->m_mutex.lock();
+    listLoadedTile.swap(m_source->m_listLoadedTile);
+    m_source->m_mutex.unlock();
+    for (i=0;i<listLoadedTile.size();i++) {
+        TgTiledImageTileData &tileData = listLoadedTile[i];
+        m_listPendingTile.erase(tileData.m_key);
+        if (!tileData.m_imageData) {
+            continue;
+        }
+        TgTiledImageTile tile;
+        glGenTextures(1, &tile.m_textureIndex);
+        if (!tile.m_textureIndex) {
+            TG_ERROR_LOG("Failed to create tile texture");
+            delete[] tileData.m_imageData;
+            continue;
+        }
+        glBindTexture(GL_TEXTURE_2D, tile.m_textureIndex);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, static_cast<GLsizei>(tileData.m_width), static_cast<GLsizei>(tileData.m_height),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, tileData.m_imageData);
+        delete[] tileData.m_imageData;
+        tile.m_lastUsedFrame = m_frame;
+        m_listTile[tileData.m_key] = tile;
+    }
+}
+
+/*!
+ * \brief TgTiledImagePrivate::getTileKey
+ *
+ * \param level mip level
+ * \param tileX tile column
+ * \param tileY tile row
+ * \return key of the tile
+ */
+uint64_t TgTiledImagePrivate::getTileKey(uint32_t level, uint32_t tileX, uint32_t tileY)
+{
+    return static_cast<uint64_t>(level) << 48
+        | static_cast<uint64_t>(tileY & 0xFFFFFF) << 24
+        | static_cast<uint64_t>(tileX & 0xFFFFFF);
+}
+
+/*!
+ * \brief TgTiledImagePrivate::requestTile
+ *
+ * starts reading the tile on worker thread, if it's not loaded or being read
+ *
+ * \param level mip level
+ * \param tileX tile column
+ * \param tileY tile row
+ */
+void TgTiledImagePrivate::requestTile(uint32_t level, uint32_t tileX, uint32_t tileY)
+{
+    uint64_t key = getTileKey(level, tileX, tileY);
+    if (m_listTile.find(key) != m_listTile.end()
+        || !m_listPendingTile.insert(key).second) {
+        return;
+    }
+    std::shared_ptr<TgTiledImageSource> source = m_source;
+    TgGlobalApplication::getInstance()->getThreadPool()->addJob([source, level, tileX, tileY]() {
+        loadTile(source, level, tileX, tileY);
+    });
+}
+
+/*!
+ * \brief TgTiledImagePrivate::addTile
+ *
+ * adds image area of the tile for rendering, if tile is not loaded
+ * then same area is taken from the closest loaded lower resolution tile
+ *
+ * \param level mip level
+ * \param tileX tile column
+ * \param tileY tile row
+ * \param imageLeft left of tile's area on image
+ * \param imageTop top of tile's area on image
+ * \param imageRight right of tile's area on image
+ * \param imageBottom bottom of tile's area on image
+ * \param zoom zoom
+ * \param viewX x position on image that is shown on item's left
+ * \param viewY y position on image that is shown on item's top
+ * \return true if area was added, false if no level has it loaded
+ */
+bool TgTiledImagePrivate::addTile(uint32_t level, uint32_t tileX, uint32_t tileY, float imageLeft, float imageTop, float imageRight, float imageBottom,
+                                  float zoom, float viewX, float viewY)
+{
+    const TgImageTilePyramid &pyramid = m_source->m_pyramid;
+    const float imageWidth = static_cast<float>(pyramid.getWidth());
+    const float imageHeight = static_cast<float>(pyramid.getHeight());
+    for (uint32_t parentLevel=level;parentLevel<pyramid.getLevelCount();parentLevel++) {
+        const uint32_t parentTileX = tileX >> (parentLevel - level);
+        const uint32_t parentTileY = tileY >> (parentLevel - level);
+        std::unordered_map<uint64_t, TgTiledImageTile>::iterator it = m_listTile.find(getTileKey(parentLevel, parentTileX, parentTileY));
+        if (it == m_listTile.end()) {
+            continue;
+        }
+        it->second.m_lastUsedFrame = m_frame;
+        const float tileImageSize = static_cast<float>(static_cast<uint64_t>(TG_IMAGE_TILE_SIZE) << parentLevel);
+        const float parentLeft = static_cast<float>(parentTileX)*tileImageSize;
+        const float parentTop = static_cast<float>(parentTileY)*tileImageSize;
+        const float parentWidth = std::min(imageWidth, parentLeft + tileImageSize) - parentLeft;
+        const float parentHeight = std::min(imageHeight, parentTop + tileImageSize) - parentTop;
+        Vertice vertices[4];
+        vertices[0].x = (imageLeft - viewX)*zoom;
+        vertices[0].y = (imageTop - viewY)*zoom;
+        vertices[0].s = (imageLeft - parentLeft)/parentWidth;
+        vertices[0].t = (imageTop - parentTop)/parentHeight;
+        vertices[1].x = (imageRight - viewX)*zoom;
+        vertices[1].y = vertices[0].y;
+        vertices[1].s = (imageRight - parentLeft)/parentWidth;
+        vertices[1].t = vertices[0].t;
+        vertices[2].x = vertices[0].x;
+        vertices[2].y = (imageBottom - viewY)*zoom;
+        vertices[2].s = vertices[0].s;
+        vertices[2].t = (imageBottom - parentTop)/parentHeight;
+        vertices[3].x = vertices[1].x;
+        vertices[3].y = vertices[2].y;
+        vertices[3].s = vertices[1].s;
+        vertices[3].t = vertices[2].t;
+        m_listVertice.insert(m_listVertice.end(), vertices, vertices + 4);
+        m_listRenderTexture.push_back(it->second.m_textureIndex);
+        return true;
+    }
+    return false;
+}
+
+/*!
+ * \brief TgTiledImagePrivate::updateVisibleTiles
+ *
+ * selects mip level by zoom, so that level's pixel is not larger than
+ * screen pixel, and generates vertices of visible tiles of that level.
+ * Tiles that are not loaded are requested
+ *
+ * \param currentItem
+ * \param zoom zoom
+ * \param viewX x position on image that is shown on item's left
+ * \param viewY y position on image that is shown on item's top
+ */
+void TgTiledImagePrivate::updateVisibleTiles(TgItem2d *currentItem, float zoom, float viewX, float viewY)
+{
+    const TgImageTilePyramid &pyramid = m_source->m_pyramid;
+    const uint32_t topLevel = pyramid.getLevelCount() - 1;
+    uint32_t level = 0, tileX, tileY;
+    std::unordered_set<uint64_t> listWantedTile;
+    m_listVertice.clear();
+    m_listRenderTexture.clear();
+
+    while (level < topLevel && zoom*static_cast<float>(1u << (level + 1)) <= 1.0f) {
+        level++;
+    }
+    const float imageWidth = static_cast<float>(pyramid.getWidth());
+    const float imageHeight = static_cast<float>(pyramid.getHeight());
+    const float left = std::max(0.0f, viewX);
+    const float top = std::max(0.0f, viewY);
+    const float right = std::min(imageWidth, viewX + currentItem->getWidth()/zoom);
+    const float bottom = std::min(imageHeight, viewY + currentItem->getHeight()/zoom);
+
+    // whole image as single tile is always kept, it's shown until better tiles are loaded
+    listWantedTile.insert(getTileKey(topLevel, 0, 0));
+    requestTile(topLevel, 0, 0);
+    if (right > left && bottom > top) {
+        const float tileImageSize = static_cast<float>(static_cast<uint64_t>(TG_IMAGE_TILE_SIZE) << level);
+        const uint32_t tileX0 = static_cast<uint32_t>(left/tileImageSize);
+        const uint32_t tileY0 = static_cast<uint32_t>(top/tileImageSize);
+        const uint32_t tileX1 = std::min(pyramid.getTileCountX(level), static_cast<uint32_t>(std::ceil(right/tileImageSize)));
+        const uint32_t tileY1 = std::min(pyramid.getTileCountY(level), static_cast<uint32_t>(std::ceil(bottom/tileImageSize)));
+        for (tileY=tileY0;tileY<tileY1;tileY++) {
+            for (tileX=tileX0;tileX<tileX1;tileX++) {
+                const float imageLeft = static_cast<float>(tileX)*tileImageSize;
+                const float imageTop = static_cast<float>(tileY)*tileImageSize;
+                listWantedTile.insert(getTileKey(level, tileX, tileY));
+                requestTile(level, tileX, tileY);
+                addTile(level, tileX, tileY, imageLeft, imageTop,
+                        std::min(imageWidth, imageLeft + tileImageSize), std::min(imageHeight, imageTop + tileImageSize),
+                        zoom, viewX, viewY);
+            }
+        }
+    }
+    m_source->m_mutex.lock();
+    m_source->m_listWantedTile.swap(listWantedTile);
+    m_source->m_mutex.unlock();
+
+    if (!m_listVertice.empty()) {
+        TgRender::init(m_listVertice.data(), static_cast<int>(m_listVertice.size()));
+    }
+}
+
+/*!
+ * \brief TgTiledImagePrivate::evictTiles
+ *
+ * deletes least recently shown tile textures, until
+ * there are at most tileCacheSize tiles. Tiles shown on
+ * this frame and the top level tile are never deleted,
+ * top level tile is shown while other tiles are loaded
+ *
+ * \param tileCacheSize maximum number of tile textures
+ */
+void TgTiledImagePrivate::evictTiles(uint32_t tileCacheSize)
+{
+    if (m_listTile.size() <= tileCacheSize) {
+        return;
+    }
+    const uint64_t topTileKey = getTileKey(m_source->m_pyramid.getLevelCount()-1, 0, 0);
+    std::vector<std::pair<uint64_t, uint64_t>> listUnusedTile;
+    std::unordered_map<uint64_t, TgTiledImageTile>::iterator it;
+    for (it=m_listTile.begin();it!=m_listTile.end();it++) {
+        if (it->second.m_lastUsedFrame != m_frame && it->first != topTileKey) {
+            listUnusedTile.push_back(std::make_pair(it->second.m_lastUsedFrame, it->first));
+        }
+    }
+    std::sort(listUnusedTile.begin(), listUnusedTile.end());
+    for (size_t i=0;i<listUnusedTile.size() && m_listTile.size() > tileCacheSize;i++) {
+        it = m_listTile.find(listUnusedTile[i].second);
+        glDeleteTextures(1, &it->second.m_textureIndex);
+        m_listTile.erase(it);
+    }
+}
+
+/*!
+ * \brief TgTiledImagePrivate::deleteTiles
+ *
+ * deletes all tile textures
+ */
+void TgTiledImagePrivate::deleteTiles()
+{
+    std::unordered_map<uint64_t, TgTiledImageTile>::iterator it;
+    for (it=m_listTile.begin();it!=m_listTile.end();it++) {
+        glDeleteTextures(1, &it->second.m_textureIndex);
+    }
+    m_listTile.clear();
+    m_listVertice.clear();
+    m_listRenderTexture.clear();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::checkPositionValues
+ *
+ * uploads tiles read on worker thread and updates
+ * visible tiles before rendering starts
+ *
+ * \param currentItem
+ */
+void TgTiledImagePrivate::checkPositionValues(TgItem2d *currentItem)
+{
+    TG_FUNCTION_BEGIN();
+    m_mutex.lock();
+    const bool openRequired = m_openRequired;
+    const std::string filename = m_filename;
+    const std::string tileCacheDirectory = m_tileCacheDirectory;
+    const uint64_t tileCacheDirectoryMaxSize = m_tileCacheDirectoryMaxSize;
+    const float zoom = m_zoom;
+    const float viewX = m_viewX;
+    const float viewY = m_viewY;
+    const uint32_t tileCacheSize = m_tileCacheSize;
+    m_openRequired = false;
+    m_mutex.unlock();
+
+    if (openRequired) {
+        openSource(filename, tileCacheDirectory, tileCacheDirectoryMaxSize);
+    }
+    checkSourceOpened();
+    uploadLoadedTiles();
+    if (!m_sourceReady) {
+        m_listVertice.clear();
+        m_listRenderTexture.clear();
+        TG_FUNCTION_END();
+        return;
+    }
+    m_frame++;
+    updateVisibleTiles(currentItem, zoom, viewX, viewY);
+    evictTiles(tileCacheSize);
+    if (currentItem->getPositionChanged()) {
+        m_transform.setTransform(currentItem->getXonWindow(), currentItem->getYonWindow());
+        currentItem->setPositionChanged(false);
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImagePrivate::render
+ *
+ * Renders the visible tiles, tiles are clipped to the item area
+ * \param windowInfo
+ * \param currentItem
+ * \param itemPosition
+ * \param opacity opacity
+ * \return true if item was rendered, false if
+ * item was not render because it was outside or invisible or no tile is loaded yet
+ */
+bool TgTiledImagePrivate::render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity)
+{
+    TG_FUNCTION_BEGIN();
+    if (m_listRenderTexture.empty() || !itemPosition->isRenderVisible(windowInfo)) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    glUniform4f(windowInfo->m_maxRenderValues,
+                currentItem->getXminOnVisible(), currentItem->getYminOnVisible(),
+                std::min(currentItem->getXmaxOnVisible(windowInfo), currentItem->getXonWindow() + currentItem->getWidth()),
+                std::min(currentItem->getYmaxOnVisible(windowInfo), currentItem->getYonWindow() + currentItem->getHeight()));
+    glUniform1f( windowInfo->m_shaderOpacityIndex, opacity);
+    glUniform4f( windowInfo->m_shaderColorIndex, 1, 1, 1, 1);
+    glUniformMatrix4fv(windowInfo->m_shaderTransformIndex, 1, 0, m_transform.getMatrixTable()->data);
+    for (size_t i=0;i<m_listRenderTexture.size();i++) {
+        TgRender::render(static_cast<int>(m_listRenderTexture[i]), static_cast<int>(i*4), 4);
+    }
+    TG_FUNCTION_END();
+    return true;
+}
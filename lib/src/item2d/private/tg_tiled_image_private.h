@@ -0,0 +1,132 @@
+/*!
+ * \file
+ * \brief file tg_tiled_image_private.h
+ *
+ * it holds general TgTiledImagePrivate class
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TILED_IMAGE_PRIVATE_H
+#define TG_TILED_IMAGE_PRIVATE_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include "../../image/tg_image_tile_pyramid.h"
+#include "../../math/tg_matrix4x4.h"
+#include "../../render/tg_render.h"
+
+#define TG_TILED_IMAGE_DEFAULT_TILE_CACHE_SIZE 256
+
+class TgItem2d;
+struct TgWindowInfo;
+class TgItem2dPosition;
+
+/*!
+ * \brief TgTiledImageTileData
+ * tile read on the worker thread, waiting for the texture upload
+ */
+struct TgTiledImageTileData
+{
+    uint64_t m_key;
+    uint32_t m_width;
+    uint32_t m_height;
+    unsigned char *m_imageData;     /*!< RGBA, nullptr if tile was not needed anymore or reading failed */
+};
+
+/*!
+ * \brief TgTiledImageSource
+ * tile pyramid of the image, it's shared with worker
+ * thread jobs, so jobs can end after the image is changed
+ */
+struct TgTiledImageSource
+{
+    TgImageTilePyramid m_pyramid;                       /*!< not modified after m_opened */
+    std::mutex m_mutex;
+    bool m_opened = false;
+    bool m_openSucceeded = false;
+    std::unordered_set<uint64_t>m_listWantedTile;       /*!< tiles of current view, other tiles are not read */
+    std::vector<TgTiledImageTileData>m_listLoadedTile;
+
+    ~TgTiledImageSource();
+};
+
+/*!
+ * \brief TgTiledImageTile
+ * tile uploaded as texture
+ */
+struct TgTiledImageTile
+{
+    GLuint m_textureIndex;
+    uint64_t m_lastUsedFrame;
+};
+
+class TgTiledImagePrivate : protected TgRender
+{
+public:
+    explicit TgTiledImagePrivate(const char *filename);
+    ~TgTiledImagePrivate();
+    bool render(const TgWindowInfo *windowInfo, TgItem2d *currentItem, TgItem2dPosition *itemPosition, float opacity);
+    void checkPositionValues(TgItem2d *currentItem);
+
+    void setImage(const char *filename);
+    uint32_t getImageWidth();
+    uint32_t getImageHeight();
+    void setZoom(float zoom);
+    float getZoom();
+    void setViewPosition(float x, float y);
+    float getViewPositionX();
+    float getViewPositionY();
+    void setTileCacheSize(uint32_t tileCount);
+    uint32_t getTileCacheSize();
+    void setTileCacheDirectory(const char *directory);
+    void setTileCacheDirectoryMaxSize(uint64_t maxSize);
+    void connectOnImageLoaded(std::function<void(bool success)> imageLoaded);
+    void disconnectOnImageLoaded();
+
+private:
+    std::mutex m_mutex;
+    std::string m_filename;
+    std::string m_tileCacheDirectory;
+    uint64_t m_tileCacheDirectoryMaxSize;
+    float m_zoom;
+    float m_viewX;
+    float m_viewY;
+    uint32_t m_tileCacheSize;
+    uint32_t m_imageWidth;
+    uint32_t m_imageHeight;
+    bool m_openRequired;                                /*!< image is changed, it's opened on render thread */
+    std::function<void(bool success)> f_imageLoaded;
+
+    // these are used only on render thread
+    std::shared_ptr<TgTiledImageSource> m_source;
+    bool m_sourceReady;
+    std::unordered_map<uint64_t, TgTiledImageTile>m_listTile;
+    std::unordered_set<uint64_t>m_listPendingTile;      /*!< tiles that are read on worker thread */
+    uint64_t m_frame;
+    std::vector<Vertice>m_listVertice;                  /*!< 4 vertices per tile */
+    std::vector<GLuint>m_listRenderTexture;             /*!< texture of each 4 vertices */
+    TgMatrix4x4 m_transform;
+
+    void openSource(const std::string &filename, const std::string &tileCacheDirectory, uint64_t tileCacheDirectoryMaxSize);
+    void checkSourceOpened();
+    void uploadLoadedTiles();
+    void updateVisibleTiles(TgItem2d *currentItem, float zoom, float viewX, float viewY);
+    bool addTile(uint32_t level, uint32_t tileX, uint32_t tileY, float imageLeft, float imageTop, float imageRight, float imageBottom,
+                 float zoom, float viewX, float viewY);
+    void requestTile(uint32_t level, uint32_t tileX, uint32_t tileY);
+    void evictTiles(uint32_t tileCacheSize);
+    void deleteTiles();
+
+    static uint64_t getTileKey(uint32_t level, uint32_t tileX, uint32_t tileY);
+    static void loadTile(const std::shared_ptr<TgTiledImageSource> &source, uint32_t level, uint32_t tileX, uint32_t tileY);
+};
+
+#endif // TG_TILED_IMAGE_PRIVATE_H
@@ -61,7 +61,8 @@ void TgGridView::setColumCount(size_t column)
 
 /*! \brief TgGridView::getCell
  *
- * get pointer of cell item
+ * get pointer of cell item, item is created for the cell
+ * when this is called first time for the cell
  *
  * \param column
  * \param row
@@ -75,6 +76,123 @@ TgGridViewCell *TgGridView::getCell(size_t column, size_t row)
     return m_private->getCell(column, row);
 }
 
+/*! \brief TgGridView::setCellText
+ *
+ * sets cell's text without creating item for the cell
+ *
+ * \param column
+ * \param row
+ * \param text
+ */
+void TgGridView::setCellText(size_t column, size_t row, const char *text)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setCellText(column, row, text);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridView::getCellText
+ * \param column
+ * \param row
+ * \return text of the cell
+ */
+std::string TgGridView::getCellText(size_t column, size_t row)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getCellText(column, row);
+}
+
+/*! \brief TgGridView::setCellBackground
+ *
+ * sets cell's background color without creating item for the cell
+ *
+ * \param column
+ * \param row
+ * \param r red
+ * \param g green
+ * \param b blue
+ * \param a alpha
+ */
+void TgGridView::setCellBackground(size_t column, size_t row, const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char a)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setCellBackground(column, row, r, g, b, a);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridView::setColumnWidth
+ * \param column
+ * \param width new width of the column
+ */
+void TgGridView::setColumnWidth(size_t column, float width)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setColumnWidth(column, width);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridView::getColumnWidth
+ * \param column
+ * \return width of the column
+ */
+float TgGridView::getColumnWidth(size_t column)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getColumnWidth(column);
+}
+
+/*! \brief TgGridView::setRowHeight
+ * \param row
+ * \param height new height of the row
+ */
+void TgGridView::setRowHeight(size_t row, float height)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setRowHeight(row, height);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridView::getRowHeight
+ * \param row
+ * \return height of the row
+ */
+float TgGridView::getRowHeight(size_t row)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getRowHeight(row);
+}
+
+/*! \brief TgGridView::setModel
+ *
+ * sets data model, column and row count are taken from the model
+ * and text and background of visible cells are asked from the model,
+ * so data does not need to be copied to the cells.
+ * setCellText() and setCellBackground() are ignored when model is set.
+ * Model is not owned by gridview, it must exist until it is removed
+ * with setModel(nullptr), model's detach() is called or gridview is deleted
+ *
+ * \param model model, or nullptr to remove the model
+ */
+void TgGridView::setModel(TgGridViewModel *model)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setModel(model);
+    TG_FUNCTION_END();
+}
+
+/*! \brief TgGridView::getModel
+ * \return current model, nullptr if model is not set
+ */
+TgGridViewModel *TgGridView::getModel()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getModel();
+}
+
 /*!
  * \brief TgGridView::checkPositionValues
  *
@@ -87,6 +205,7 @@ void TgGridView::checkPositionValues()
         m_private->setSliderVisibilityAndPosition();
         TgItem2d::m_private->setPositionChanged(false);
     }
+    m_private->checkVisibleCells();
     TgItem2d::checkPositionValues();
     TG_FUNCTION_END();
 }
@@ -15,13 +15,18 @@
 #include "../global/tg_global_macros.h"
 #include "tg_item2d.h"
 #include <cstddef>
+#include <string>
 
 class TgGridViewPrivate;
 class TgGridViewCell;
+class TgGridViewModel;
 
 /*!
  * \brief TgGridView
- * gridview class
+ * gridview class, only visible cells are drawn with cell items,
+ * so count of rows and columns can be large. getCell() creates own
+ * item for the cell, for large grids setCellText() and setCellBackground()
+ * or setModel() should be used instead, they don't create item for the cell
  */
 class TG_MAINWINDOW_EXPORT TgGridView : public TgItem2d
 {
@@ -34,6 +39,15 @@ public:
     void setRowCount(size_t row);
     void setColumCount(size_t column);
     TgGridViewCell *getCell(size_t column, size_t row);
+    void setCellText(size_t column, size_t row, const char *text);
+    std::string getCellText(size_t column, size_t row);
+    void setCellBackground(size_t column, size_t row, const unsigned char r = 255, const unsigned char g = 255, const unsigned char b = 255, const unsigned char a = 255);
+    void setColumnWidth(size_t column, float width);
+    float getColumnWidth(size_t column);
+    void setRowHeight(size_t row, float height);
+    float getRowHeight(size_t row);
+    void setModel(TgGridViewModel *model);
+    TgGridViewModel *getModel();
     void setMouseScrollMultiplier(uint32_t multiplier);
     uint32_t getMouseScrollMultiplier();
 
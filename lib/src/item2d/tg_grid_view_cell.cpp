@@ -79,7 +79,9 @@ void TgGridViewCell::setBackground(const unsigned char r, const unsigned char g,
 /*!
  * \brief TgGridViewCell::setWidth
  *
- * set width type for item
+ * set width type for item, with SizeFollowTextSize the column width follows
+ * the widest text of the column (texts set with TgGridView::setCellText() are included,
+ * texts of TgGridViewModel are not)
  * \param type
  */
 void TgGridViewCell::setWidthType(TgGridViewCellSizeType type)
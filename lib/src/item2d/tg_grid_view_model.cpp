@@ -0,0 +1,103 @@
+/*!
+ * \file
+ * \brief file tg_grid_view_model.cpp
+ *
+ * Data model for gridview, gridview asks the text and background
+ * from the model only for the visible cells
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_grid_view_model.h"
+#include "../global/tg_global_log.h"
+#include "private/grid_view/tg_grid_view_model_private.h"
+
+TgGridViewModel::TgGridViewModel() :
+    m_private(new TgGridViewModelPrivate())
+{
+}
+
+TgGridViewModel::~TgGridViewModel()
+{
+    TG_FUNCTION_BEGIN();
+    if (m_private) {
+        delete m_private;
+        m_private = nullptr;
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgGridViewModel::getCellBackground
+ *
+ * gets background color of the cell, default implementation
+ * returns false, so cell is drawn with default background
+ *
+ * \param column
+ * \param row
+ * \param r [out] red
+ * \param g [out] green
+ * \param b [out] blue
+ * \param a [out] alpha
+ * \return true if cell has own background color
+ */
+bool TgGridViewModel::getCellBackground(size_t column, size_t row, unsigned char &r, unsigned char &g, unsigned char &b, unsigned char &a)
+{
+    (void)column;
+    (void)row;
+    (void)r;
+    (void)g;
+    (void)b;
+    (void)a;
+    return false;
+}
+
+/*!
+ * \brief TgGridViewModel::notifyCellsChanged
+ *
+ * tells gridviews that text or background of cells are changed,
+ * can be called from any thread. Gridview updates only the visible cells
+ * of the range, and several changes before next render are updated together
+ *
+ * \param column first changed column
+ * \param row first changed row
+ * \param columnCount count of changed columns
+ * \param rowCount count of changed rows
+ */
+void TgGridViewModel::notifyCellsChanged(size_t column, size_t row, size_t columnCount, size_t rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->notifyCellsChanged(column, row, columnCount, rowCount);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgGridViewModel::notifySizeChanged
+ *
+ * tells gridviews that column or row count is changed, can be called
+ * from any thread. Gridviews get new counts and update all visible cells
+ * before next render
+ */
+void TgGridViewModel::notifySizeChanged()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->notifySizeChanged();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgGridViewModel::detach
+ *
+ * removes the model from all gridviews that use it, inherited
+ * class must call this in its destructor, so gridviews never ask
+ * data from partly destroyed model. This waits until gridviews
+ * are not asking the data from the model
+ */
+void TgGridViewModel::detach()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->detach();
+    TG_FUNCTION_END();
+}
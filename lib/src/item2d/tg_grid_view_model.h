@@ -0,0 +1,60 @@
+/*!
+ * \file
+ * \brief file tg_grid_view_model.h
+ *
+ * Data model for gridview, gridview asks the text and background
+ * from the model only for the visible cells
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_GRID_VIEW_MODEL_H
+#define TG_GRID_VIEW_MODEL_H
+
+#include "../global/tg_global_macros.h"
+#include <cstddef>
+#include <string>
+
+class TgGridViewModelPrivate;
+
+/*!
+ * \brief TgGridViewModel
+ * gridview data model class, application inherits this class
+ * and gives it to the gridview with TgGridView::setModel()
+ *
+ * getColumnCount(), getRowCount(), getCellText() and getCellBackground()
+ * are called on render thread when the cell becomes visible or when visible
+ * cell is changed, so application's data must be protected if it is changed
+ * on other thread. Gridview does not hold its own lock while it asks the model,
+ * so notifyCellsChanged() and notifySizeChanged() can be called while holding
+ * the application's lock. Changes of the cells are told with notifyCellsChanged(),
+ * changes of cells that are not visible are ignored, and changes
+ * of visible cells are updated once before next render
+ *
+ * Inherited class must call detach() in its destructor, because
+ * gridviews must not ask data from partly destroyed model
+ */
+class TG_MAINWINDOW_EXPORT TgGridViewModel
+{
+public:
+    TgGridViewModel();
+    virtual ~TgGridViewModel();
+
+    virtual size_t getColumnCount() = 0;
+    virtual size_t getRowCount() = 0;
+    virtual std::string getCellText(size_t column, size_t row) = 0;
+    virtual bool getCellBackground(size_t column, size_t row, unsigned char &r, unsigned char &g, unsigned char &b, unsigned char &a);
+
+    void notifyCellsChanged(size_t column, size_t row, size_t columnCount = 1, size_t rowCount = 1);
+    void notifySizeChanged();
+    void detach();
+
+private:
+    TgGridViewModelPrivate *m_private;
+
+    friend class TgGridViewPrivate;
+};
+
+#endif // TG_GRID_VIEW_MODEL_H
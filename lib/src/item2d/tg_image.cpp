@@ -65,6 +65,8 @@ TgImage::~TgImage()
  * set texture ST values
  *
  * All values must be <= 1.0f (or at least should be)
+ * values are relative to the image, also when image is packed
+ * into shared atlas texture
  *
  * \param topLeftS topleft S
  * \param topLeftT topleft T
@@ -102,6 +104,73 @@ void TgImage::setImage(const char *filename)
     TG_FUNCTION_END();
 }
 
+/*!
+ * \brief TgImage::setImage
+ *
+ * sets image as empty (transparent) image of size imageWidth x imageHeight,
+ * pixels are drawn with setPixel() or lockPixels()/unlockPixels()
+ *
+ * \param imageWidth width of image
+ * \param imageHeight height of image
+ * \return false if imageWidth or imageHeight is 0
+ */
+bool TgImage::setImage(uint32_t imageWidth, uint32_t imageHeight)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->setImage(imageWidth, imageHeight);
+}
+
+/*!
+ * \brief TgImage::lockPixels
+ *
+ * gives direct access to image's RGBA data, use this instead of setPixel()
+ * when lot of pixels are changed (for example whole frame).
+ * Data is locked until unlockPixels() is called, and only modified
+ * rows (unlockPixels(rowStart, rowCount)) are uploaded on next render
+ *
+ * Image loaded from file is prepared for pixel access on next render,
+ * until that this returns nullptr
+ *
+ * \return image data (RGBA, getImageWidth()*getImageHeight()*4 bytes),
+ * or nullptr if image is not available for pixel access,
+ * unlockPixels() must not be called if nullptr is returned
+ */
+uint8_t *TgImage::lockPixels()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->lockPixels();
+}
+
+/*!
+ * \brief TgImage::unlockPixels
+ *
+ * unlocks image data locked with lockPixels(), all rows are uploaded on next render
+ */
+void TgImage::unlockPixels()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->unlockPixels(0, UINT32_MAX);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImage::unlockPixels
+ *
+ * unlocks image data locked with lockPixels(), rows
+ * rowStart - rowStart+rowCount-1 are uploaded on next render
+ *
+ * \param rowStart first modified row
+ * \param rowCount count of modified rows
+ */
+void TgImage::unlockPixels(uint32_t rowStart, uint32_t rowCount)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->unlockPixels(rowStart, rowCount);
+    TG_FUNCTION_END();
+}
+
 /*!
  * \brief TgImage::render
  *
@@ -178,4 +247,95 @@ uint32_t TgImage::getImageHeight()
     TG_FUNCTION_BEGIN();
     TG_FUNCTION_END();
     return m_private->getImageHeight();
-}
\ No newline at end of file
+}
+
+/*!
+ * \brief TgImage::setAsyncLoad
+ *
+ * sets image loading mode, if true, png image is decoded on the worker
+ * thread and item is not drawn until the image is ready, so rendering
+ * does not need to wait the image decoding
+ *
+ * default value: false
+ *
+ * \param asyncLoad
+ */
+void TgImage::setAsyncLoad(bool asyncLoad)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setAsyncLoad(asyncLoad);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImage::getAsyncLoad
+ *
+ * \return true, if image is decoded on the worker thread
+ */
+bool TgImage::getAsyncLoad() const
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getAsyncLoad();
+}
+
+/*!
+ * \brief TgImage::setMipmaps
+ *
+ * sets if image's texture has mip levels, image that is drawn smaller
+ * than its size (for example thumbnail) is then drawn with trilinear
+ * filtering, so it does not alias and it uses less texture bandwidth.
+ * Image with mip levels is never packed into shared atlas texture,
+ * and it uses about one third more texture memory.
+ * Changing this for loaded image reloads the image
+ *
+ * default value: false
+ *
+ * \param mipmaps
+ */
+void TgImage::setMipmaps(bool mipmaps)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setMipmaps(mipmaps);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImage::getMipmaps
+ *
+ * \return true, if image's texture has mip levels
+ */
+bool TgImage::getMipmaps() const
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getMipmaps();
+}
+
+/*!
+ * \brief TgImage::connectOnImageLoaded
+ *
+ * connects callback to function for on image loaded,
+ * callback is called on render thread when the image (set by constructor or
+ * setImage()) is loaded, success is false if the image could not be loaded
+ *
+ * \param imageLoaded callback function
+ */
+void TgImage::connectOnImageLoaded(std::function<void(bool success)> imageLoaded)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->connectOnImageLoaded(imageLoaded);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImage::disconnectOnImageLoaded
+ *
+ * disconnects callback to function for on image loaded
+ */
+void TgImage::disconnectOnImageLoaded()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->disconnectOnImageLoaded();
+    TG_FUNCTION_END();
+}
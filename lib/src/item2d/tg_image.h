@@ -12,6 +12,7 @@
 #ifndef TG_IMAGE_H
 #define TG_IMAGE_H
 
+#include <functional>
 #include "tg_item2d.h"
 #include "../global/tg_global_macros.h"
 
@@ -33,9 +34,19 @@ public:
                       float bottomRightS, float bottomRightT,
                       float bottomLeftS, float bottomLeftT);
     void setImage(const char *filename);
+    bool setImage(uint32_t imageWidth, uint32_t imageHeight);
+    uint8_t *lockPixels();
+    void unlockPixels();
+    void unlockPixels(uint32_t rowStart, uint32_t rowCount);
     bool setPixel(uint32_t x, uint32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
     uint32_t getImageWidth();
     uint32_t getImageHeight();
+    void setAsyncLoad(bool asyncLoad);
+    bool getAsyncLoad() const;
+    void setMipmaps(bool mipmaps);
+    bool getMipmaps() const;
+    void connectOnImageLoaded(std::function<void(bool success)> imageLoaded);
+    void disconnectOnImageLoaded();
 
 protected:
     virtual bool render(const TgWindowInfo *windowInfo, float parentOpacity) override;
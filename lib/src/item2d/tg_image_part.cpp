@@ -330,3 +330,60 @@ bool TgImagePart::setImage(const char *imageFileName)
     return m_private->setImage(imageFileName);
 }
 
+/*!
+ * \brief TgImagePart::setAsyncLoad
+ *
+ * sets image loading mode, if true, png image is decoded on the worker
+ * thread and item is not drawn until the image is ready, so rendering
+ * does not need to wait the image decoding
+ *
+ * default value: false
+ *
+ * \param asyncLoad
+ */
+void TgImagePart::setAsyncLoad(bool asyncLoad)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setAsyncLoad(asyncLoad);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePart::getAsyncLoad
+ *
+ * \return true, if image is decoded on the worker thread
+ */
+bool TgImagePart::getAsyncLoad() const
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getAsyncLoad();
+}
+
+/*!
+ * \brief TgImagePart::connectOnImageLoaded
+ *
+ * connects callback to function for on image loaded,
+ * callback is called on render thread when the image (set by constructor or
+ * setImage()) is loaded, success is false if the image could not be loaded
+ *
+ * \param imageLoaded callback function
+ */
+void TgImagePart::connectOnImageLoaded(std::function<void(bool success)> imageLoaded)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->connectOnImageLoaded(imageLoaded);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgImagePart::disconnectOnImageLoaded
+ *
+ * disconnects callback to function for on image loaded
+ */
+void TgImagePart::disconnectOnImageLoaded()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->disconnectOnImageLoaded();
+    TG_FUNCTION_END();
+}
@@ -21,6 +21,7 @@
 #ifndef TG_IMAGE_PART_H
 #define TG_IMAGE_PART_H
 
+#include <functional>
 #include "tg_item2d.h"
 #include "../global/tg_global_macros.h"
 
@@ -72,6 +73,10 @@ public:
     void setType(TgImagePartType type);
 
     bool setImage(const char *imageFileName);
+    void setAsyncLoad(bool asyncLoad);
+    bool getAsyncLoad() const;
+    void connectOnImageLoaded(std::function<void(bool success)> imageLoaded);
+    void disconnectOnImageLoaded();
 
 private:
     TgImagePartPrivate *m_private;
@@ -211,10 +211,13 @@ private:
     friend class TgGridView;
     friend class TgGridViewCell;
     friend class TgGridViewPrivate;
+    friend class TgTextDocument;
     friend class TgComboBoxPrivate;
     friend class TgImage;
     friend class TgImagePart;
     friend class TgRectangle;
+    friend class TgStreamImage;
+    friend class TgTiledImage;
     friend class TgTextfield;
     friend class TgSlider;
     friend class TgSliderPrivate;
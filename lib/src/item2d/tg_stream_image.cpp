@@ -0,0 +1,135 @@
+/*!
+ * \file
+ * \brief file tg_stream_image.cpp
+ *
+ * Draws streamed frames (video, camera)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_stream_image.h"
+#include "../global/tg_global_log.h"
+#include "private/tg_stream_image_private.h"
+#include "private/item2d/tg_item2d_private.h"
+
+/*!
+ * \brief TgStreamImage::TgStreamImage
+ *
+ * constructor to use AnchorFollowParentSize
+ *
+ * \param parent item's parent
+ */
+TgStreamImage::TgStreamImage(TgItem2d *parent) :
+    TgItem2d(parent),
+    m_private(new TgStreamImagePrivate())
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImage::TgStreamImage
+ *
+ * constructor to use AnchorRelativeToParent
+ *
+ * \param parent item's parent
+ * \param x item's relative position x (of parent)
+ * \param y item's relative position x (of parent)
+ * \param width item's width
+ * \param height item's height
+ */
+TgStreamImage::TgStreamImage(TgItem2d *parent, float x, float y, float width, float height) :
+    TgItem2d(parent, x, y, width, height),
+    m_private(new TgStreamImagePrivate())
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgStreamImage::~TgStreamImage()
+{
+    TG_FUNCTION_BEGIN();
+    if (m_private) {
+        delete m_private;
+        m_private = nullptr;
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImage::pushFrame
+ *
+ * gives new frame to show, frame buffers are not copied here,
+ * they are copied into pixel buffer object on next render and
+ * frame.f_release is called after that. If previous frame
+ * is not uploaded yet, it is dropped (and released).
+ * This can be called from any thread
+ *
+ * \param frame frame to show
+ * \return false if frame is not valid (and it is not released)
+ */
+bool TgStreamImage::pushFrame(const TgStreamImageFrame &frame)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->pushFrame(frame);
+}
+
+/*!
+ * \brief TgStreamImage::getStatistics
+ *
+ * \return frame counters and latencies
+ */
+TgStreamImageStatistics TgStreamImage::getStatistics()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getStatistics();
+}
+
+/*!
+ * \brief TgStreamImage::resetStatistics
+ *
+ * sets frame counters and latencies to 0
+ */
+void TgStreamImage::resetStatistics()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->resetStatistics();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgStreamImage::render
+ *
+ * Renders the latest frame
+ * \param windowInfo
+ * \return true if item was rendered, false if
+ * item was not render because it was outside or invisible
+ */
+bool TgStreamImage::render(const TgWindowInfo *windowInfo, float parentOpacity)
+{
+    TG_FUNCTION_BEGIN();
+    if (!getVisible()) {
+        return false;
+    }
+    TG_FUNCTION_END();
+    return m_private->render(windowInfo, this, reinterpret_cast<TgItem2d *>(this)->m_private, parentOpacity*getOpacity());
+}
+
+/*!
+ * \brief TgStreamImage::checkPositionValues
+ *
+ * Checks position values before rendering starts
+ */
+void TgStreamImage::checkPositionValues()
+{
+    TG_FUNCTION_BEGIN();
+    if (!getVisible()) {
+        return;
+    }
+    m_private->checkPositionValues(this);
+    TG_FUNCTION_END();
+}
@@ -0,0 +1,87 @@
+/*!
+ * \file
+ * \brief file tg_stream_image.h
+ *
+ * Draws streamed frames (video, camera)
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_STREAM_IMAGE_H
+#define TG_STREAM_IMAGE_H
+
+#include <cstdint>
+#include <functional>
+#include "tg_item2d.h"
+#include "../global/tg_global_macros.h"
+
+class TgStreamImagePrivate;
+struct TgWindowInfo;
+
+/*!
+ * \brief TgStreamImageFormat
+ * pixel format of the frame
+ */
+enum TgStreamImageFormat
+{
+    StreamImageFormatRGBA = 0,      /*!< m_plane[0] RGBA */
+    StreamImageFormatNV12,          /*!< m_plane[0] Y, m_plane[1] interleaved UV (half width and height) */
+    StreamImageFormatI420,          /*!< m_plane[0] Y, m_plane[1] U, m_plane[2] V (half width and height) */
+};
+
+/*!
+ * \brief TgStreamImageFrame
+ * frame given to TgStreamImage::pushFrame(), buffers are owned by the producer
+ * and they must stay valid until f_release is called
+ */
+struct TgStreamImageFrame
+{
+    TgStreamImageFormat m_format = StreamImageFormatRGBA;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    const uint8_t *m_plane[3] = { nullptr, nullptr, nullptr };
+    uint32_t m_stride[3] = { 0, 0, 0 };     /*!< bytes per row of the plane, 0 if rows are tightly packed */
+    std::function<void()> f_release;        /*!< called when frame buffers are not used anymore, can be nullptr */
+};
+
+/*!
+ * \brief TgStreamImageStatistics
+ * frame counters of TgStreamImage
+ */
+struct TgStreamImageStatistics
+{
+    uint64_t m_receivedFrameCount = 0;      /*!< frames given with pushFrame() */
+    uint64_t m_shownFrameCount = 0;         /*!< frames uploaded into texture */
+    uint64_t m_droppedFrameCount = 0;       /*!< frames replaced by newer frame before they were uploaded */
+    uint64_t m_lastLatencyUs = 0;           /*!< time from pushFrame() to texture upload of latest shown frame */
+    uint64_t m_averageLatencyUs = 0;
+    uint64_t m_maxLatencyUs = 0;
+};
+
+/*!
+ * \brief TgStreamImage
+ * draws latest frame given by producer, only the newest frame
+ * is uploaded on render, older frames waiting for upload are dropped
+ */
+class TG_MAINWINDOW_EXPORT TgStreamImage : public TgItem2d
+{
+public:
+    explicit TgStreamImage(TgItem2d *parent);
+    explicit TgStreamImage(TgItem2d *parent, float x, float y, float width, float height);
+    ~TgStreamImage();
+
+    bool pushFrame(const TgStreamImageFrame &frame);
+    TgStreamImageStatistics getStatistics();
+    void resetStatistics();
+
+protected:
+    virtual bool render(const TgWindowInfo *windowInfo, float parentOpacity) override;
+    virtual void checkPositionValues() override;
+
+private:
+    TgStreamImagePrivate *m_private;
+};
+
+#endif // TG_STREAM_IMAGE_H
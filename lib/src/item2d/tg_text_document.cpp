@@ -0,0 +1,220 @@
+/*!
+ * \file
+ * \brief file tg_text_document.cpp
+ *
+ * Multi-line text document view, only visible lines
+ * are laid out and rendered
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_text_document.h"
+#include "../global/tg_global_log.h"
+#include "private/text_document/tg_text_document_private.h"
+#include "private/item2d/tg_item2d_private.h"
+
+TgTextDocument::TgTextDocument(TgItem2d *parent, const char *fontFile, float fontSize, uint8_t r, uint8_t g, uint8_t b) :
+    TgItem2d(parent),
+    m_private(new TgTextDocumentPrivate(this, fontFile, fontSize, r, g, b))
+{
+}
+
+TgTextDocument::TgTextDocument(TgItem2d *parent, float x, float y, float width, float height, const char *fontFile, float fontSize, uint8_t r, uint8_t g, uint8_t b) :
+    TgItem2d(parent, x, y, width, height),
+    m_private(new TgTextDocumentPrivate(this, fontFile, fontSize, r, g, b))
+{
+}
+
+TgTextDocument::~TgTextDocument()
+{
+    if (m_private) {
+        delete m_private;
+    }
+}
+
+/*!
+ * \brief TgTextDocument::setText
+ *
+ * replaces the whole text of document
+ *
+ * \param text utf8 text, lines are separated with '\n'
+ */
+void TgTextDocument::setText(const char *text)
+{
+    m_private->setText(text);
+}
+
+/*!
+ * \brief TgTextDocument::appendText
+ *
+ * adds text to end of document
+ *
+ * \param text utf8 text
+ */
+void TgTextDocument::appendText(const char *text)
+{
+    m_private->appendText(text);
+}
+
+/*!
+ * \brief TgTextDocument::insertText
+ *
+ * inserts text into document
+ *
+ * \param line line index (0 is first line)
+ * \param column character index in line (can be line's character count)
+ * \param text utf8 text
+ * \return true if line and column were valid
+ */
+bool TgTextDocument::insertText(size_t line, size_t column, const char *text)
+{
+    return m_private->insertText(line, column, text);
+}
+
+/*!
+ * \brief TgTextDocument::removeText
+ *
+ * removes text from document, line break is
+ * counted as one character
+ *
+ * \param line line index (0 is first line)
+ * \param column character index in line
+ * \param characterCount number of characters to remove
+ * \return true if line and column were valid
+ */
+bool TgTextDocument::removeText(size_t line, size_t column, size_t characterCount)
+{
+    return m_private->removeText(line, column, characterCount);
+}
+
+/*!
+ * \brief TgTextDocument::getText
+ *
+ * \return whole document as utf8 text
+ */
+std::string TgTextDocument::getText()
+{
+    return m_private->getText();
+}
+
+/*!
+ * \brief TgTextDocument::getLine
+ *
+ * \param line line index (0 is first line)
+ * \return utf8 text of the line (without line break)
+ */
+std::string TgTextDocument::getLine(size_t line)
+{
+    return m_private->getLine(line);
+}
+
+/*!
+ * \brief TgTextDocument::getLineCount
+ *
+ * \return number of lines in document
+ */
+size_t TgTextDocument::getLineCount()
+{
+    return m_private->getLineCount();
+}
+
+/*!
+ * \brief TgTextDocument::setFirstVisibleLine
+ *
+ * scrolls the document so that line is top most line
+ *
+ * \param line line index (0 is first line)
+ */
+void TgTextDocument::setFirstVisibleLine(size_t line)
+{
+    m_private->setFirstVisibleLine(line);
+}
+
+/*!
+ * \brief TgTextDocument::getFirstVisibleLine
+ *
+ * \return line index of top most line
+ */
+size_t TgTextDocument::getFirstVisibleLine()
+{
+    return m_private->getFirstVisibleLine();
+}
+
+/*!
+ * \brief TgTextDocument::getVisibleLineCount
+ *
+ * \return number of lines that fully fit into view
+ */
+size_t TgTextDocument::getVisibleLineCount()
+{
+    return m_private->getVisibleLineCount();
+}
+
+/*!
+ * \brief TgTextDocument::checkPositionValues
+ *
+ * Checks position values before rendering starts
+ */
+void TgTextDocument::checkPositionValues()
+{
+    TG_FUNCTION_BEGIN();
+    bool positionChanged = TgItem2d::m_private->getPositionChanged();
+    if (positionChanged || m_private->getUpdateRequired()) {
+        m_private->updateVisibleLines(positionChanged);
+        TgItem2d::m_private->setPositionChanged(false);
+    }
+    TgItem2d::checkPositionValues();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextDocument::handleEvent
+ *
+ * handles the event
+ *
+ * \param eventData
+ * \param windowInfo
+ * \return if event result is completed
+ */
+TgEventResult TgTextDocument::handleEvent(TgEventData *eventData, const TgWindowInfo *windowInfo)
+{
+    TG_FUNCTION_BEGIN();
+    if (eventData->m_type == TgEventType::EventTypeMouseScrollMove
+        && getVisible()
+        && TgItem2d::m_private->isCursorOnItem(eventData->m_event.m_mouseEvent.m_x, eventData->m_event.m_mouseEvent.m_y, windowInfo)) {
+        if (getEnabled()) {
+            m_private->setMouseScrollMove(static_cast<int64_t>(eventData->m_event.m_mouseEvent.m_scroll_move_y));
+        }
+        TG_FUNCTION_END();
+        return TgEventResult::EventResultCompleted;
+    }
+    TG_FUNCTION_END();
+    return TgItem2d::handleEvent(eventData, windowInfo);
+}
+
+/*!
+ * \brief TgTextDocument::setMouseScrollMultiplier
+ *
+ * set scroll move multiplier (lines)
+ * default: 1
+ * if scroll move is 1, and multiplier is 3, then scroll move is 3 lines
+ * \param multiplier
+ */
+void TgTextDocument::setMouseScrollMultiplier(uint32_t multiplier)
+{
+    m_private->setMouseScrollMultiplier(multiplier);
+}
+
+/*!
+ * \brief TgTextDocument::getMouseScrollMultiplier
+ *
+ * get scroll move multiplier
+ *
+ * \return multiplier
+ */
+uint32_t TgTextDocument::getMouseScrollMultiplier()
+{
+    return m_private->getMouseScrollMultiplier();
+}
@@ -0,0 +1,58 @@
+/*!
+ * \file
+ * \brief file tg_text_document.h
+ *
+ * Multi-line text document view, only visible lines
+ * are laid out and rendered
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TEXT_DOCUMENT_H
+#define TG_TEXT_DOCUMENT_H
+
+#include "../global/tg_global_macros.h"
+#include "tg_item2d.h"
+#include <cstddef>
+#include <string>
+
+class TgTextDocumentPrivate;
+
+/*!
+ * \brief TgTextDocument
+ * multi-line text document view, text is stored in piece table
+ * and each visible line is drawn as own (single line) textfield
+ */
+class TG_MAINWINDOW_EXPORT TgTextDocument : public TgItem2d
+{
+public:
+    explicit TgTextDocument(TgItem2d *parent, const char *fontFile, float fontSize, uint8_t r = 255, uint8_t g = 255, uint8_t b = 255);
+    explicit TgTextDocument(TgItem2d *parent, float x, float y, float width, float height, const char *fontFile, float fontSize, uint8_t r = 255, uint8_t g = 255, uint8_t b = 255);
+    ~TgTextDocument();
+
+    void setText(const char *text);
+    void appendText(const char *text);
+    bool insertText(size_t line, size_t column, const char *text);
+    bool removeText(size_t line, size_t column, size_t characterCount);
+    std::string getText();
+    std::string getLine(size_t line);
+    size_t getLineCount();
+
+    void setFirstVisibleLine(size_t line);
+    size_t getFirstVisibleLine();
+    size_t getVisibleLineCount();
+
+    void setMouseScrollMultiplier(uint32_t multiplier);
+    uint32_t getMouseScrollMultiplier();
+
+protected:
+    virtual void checkPositionValues() override;
+    virtual TgEventResult handleEvent(TgEventData *eventData, const TgWindowInfo *windowInfo) override;
+
+private:
+    TgTextDocumentPrivate *m_private;
+};
+
+#endif // TG_TEXT_DOCUMENT_H
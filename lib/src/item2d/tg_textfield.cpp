@@ -399,3 +399,34 @@ void TgTextfield::getColor(uint8_t &r, uint8_t &g, uint8_t &b)
     m_private->getColor(r, g, b);
     TG_FUNCTION_END();
 }
+
+/*!
+ * \brief TgTextfield::setAsyncTextPreparation
+ *
+ * sets text preparation mode, if true, text shaping, glyph rasterization
+ * and layout are done on the worker thread when text changes, and text field
+ * shows the previous text until the new text is ready, so rendering
+ * does not need to wait large texts
+ *
+ * default value: false
+ *
+ * \param asyncTextPreparation
+ */
+void TgTextfield::setAsyncTextPreparation(bool asyncTextPreparation)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setAsyncTextPreparation(asyncTextPreparation);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTextfield::getAsyncTextPreparation
+ *
+ * \return true, if text is prepared on the worker thread
+ */
+bool TgTextfield::getAsyncTextPreparation() const
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getAsyncTextPreparation();
+}
@@ -51,6 +51,8 @@ public:
     void setAllowBreakLineGoOverMaxLine(bool allowBreakLineGoOverMaxLine);
     bool getAllowBreakLineGoOverMaxLine() const;
     void getColor(uint8_t &r, uint8_t &g, uint8_t &b);
+    void setAsyncTextPreparation(bool asyncTextPreparation);
+    bool getAsyncTextPreparation() const;
 
 protected:
     virtual bool render(const TgWindowInfo *windowInfo, float parentOpacity) override;
@@ -0,0 +1,292 @@
+/*!
+ * \file
+ * \brief file tg_tiled_image.cpp
+ *
+ * Shows giant image as tiles
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_tiled_image.h"
+#include "../global/tg_global_log.h"
+#include "private/tg_tiled_image_private.h"
+#include "private/item2d/tg_item2d_private.h"
+
+/*!
+ * \brief TgTiledImage::TgTiledImage
+ *
+ * constructor to use AnchorFollowParentSize
+ *
+ * \param parent item's parent
+ * \param filename full filepath of the png image
+ */
+TgTiledImage::TgTiledImage(TgItem2d *parent, const char *filename) :
+    TgItem2d(parent),
+    m_private(new TgTiledImagePrivate(filename))
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::TgTiledImage
+ *
+ * constructor to use AnchorRelativeToParent
+ *
+ * \param parent item's parent
+ * \param x item's relative position x (of parent)
+ * \param y item's relative position x (of parent)
+ * \param width item's width
+ * \param height item's height
+ * \param filename full filepath of the png image
+ */
+TgTiledImage::TgTiledImage(TgItem2d *parent, float x, float y, float width, float height, const char *filename) :
+    TgItem2d(parent, x, y, width, height),
+    m_private(new TgTiledImagePrivate(filename))
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgTiledImage::~TgTiledImage()
+{
+    TG_FUNCTION_BEGIN();
+    if (m_private) {
+        delete m_private;
+        m_private = nullptr;
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::setImage
+ *
+ * set image's filename, if image is not split into tiles
+ * before, it's done on worker thread
+ *
+ * \param filename full filepath of the png image
+ */
+void TgTiledImage::setImage(const char *filename)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setImage(filename);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::getImageWidth
+ *
+ * \return width of the image, 0 if image is not loaded (yet)
+ */
+uint32_t TgTiledImage::getImageWidth()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getImageWidth();
+}
+
+/*!
+ * \brief TgTiledImage::getImageHeight
+ *
+ * \return height of the image, 0 if image is not loaded (yet)
+ */
+uint32_t TgTiledImage::getImageHeight()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getImageHeight();
+}
+
+/*!
+ * \brief TgTiledImage::setZoom
+ *
+ * set zoom, 1 == one image pixel is one screen pixel,
+ * 0.5 == image is shown as half size
+ * default value: 1
+ *
+ * \param zoom zoom, must be > 0
+ */
+void TgTiledImage::setZoom(float zoom)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setZoom(zoom);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::getZoom
+ *
+ * \return zoom
+ */
+float TgTiledImage::getZoom()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getZoom();
+}
+
+/*!
+ * \brief TgTiledImage::setViewPosition
+ *
+ * set image position (image pixels) that is shown on item's top left corner
+ * default value: 0, 0
+ *
+ * \param x x position on image
+ * \param y y position on image
+ */
+void TgTiledImage::setViewPosition(float x, float y)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setViewPosition(x, y);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::getViewPositionX
+ *
+ * \return x position on image that is shown on item's left
+ */
+float TgTiledImage::getViewPositionX()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getViewPositionX();
+}
+
+/*!
+ * \brief TgTiledImage::getViewPositionY
+ *
+ * \return y position on image that is shown on item's top
+ */
+float TgTiledImage::getViewPositionY()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getViewPositionY();
+}
+
+/*!
+ * \brief TgTiledImage::setTileCacheSize
+ *
+ * set maximum number of tile textures that are kept,
+ * least recently shown tiles are deleted first (single tile is 256KB)
+ * default value: 256
+ *
+ * \param tileCount number of tiles
+ */
+void TgTiledImage::setTileCacheSize(uint32_t tileCount)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setTileCacheSize(tileCount);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::getTileCacheSize
+ *
+ * \return maximum number of tile textures
+ */
+uint32_t TgTiledImage::getTileCacheSize()
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+    return m_private->getTileCacheSize();
+}
+
+/*!
+ * \brief TgTiledImage::setTileCacheDirectory
+ *
+ * set directory where images are split into tiles, this
+ * must be set before setImage(), tiles of each image take
+ * about 1.3 x (width x height x 4) bytes of disk
+ * default is $PRJ_TG_UI_LIB_TILE_CACHE_DIR, $XDG_CACHE_HOME/prj-tg-ui-lib/tiles
+ * (or $HOME/.cache/prj-tg-ui-lib/tiles)
+ *
+ * \param directory full path of the directory
+ */
+void TgTiledImage::setTileCacheDirectory(const char *directory)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setTileCacheDirectory(directory);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::setTileCacheDirectoryMaxSize
+ *
+ * set maximum size of the tile files in tile cache directory,
+ * least recently used files are removed first, tile file of
+ * the current image is never removed, this must be set before setImage()
+ * default value: 8GB
+ *
+ * \param maxSize max size in bytes
+ */
+void TgTiledImage::setTileCacheDirectoryMaxSize(uint64_t maxSize)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->setTileCacheDirectoryMaxSize(maxSize);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::connectOnImageLoaded
+ *
+ * connects callback that is called (on render thread) when image is
+ * split into tiles (or tiles are found from the tile cache directory)
+ *
+ * \param imageLoaded callback, success is false if image could not be loaded
+ */
+void TgTiledImage::connectOnImageLoaded(std::function<void(bool success)> imageLoaded)
+{
+    TG_FUNCTION_BEGIN();
+    m_private->connectOnImageLoaded(imageLoaded);
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::disconnectOnImageLoaded
+ */
+void TgTiledImage::disconnectOnImageLoaded()
+{
+    TG_FUNCTION_BEGIN();
+    m_private->disconnectOnImageLoaded();
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgTiledImage::render
+ *
+ * Renders the visible tiles
+ * \param windowInfo
+ * \param parentOpacity parent's opacity
+ * \return true if item was rendered, false if
+ * item was not render because it was outside or invisible
+ */
+bool TgTiledImage::render(const TgWindowInfo *windowInfo, float parentOpacity)
+{
+    TG_FUNCTION_BEGIN();
+    if (!getVisible()) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    TG_FUNCTION_END();
+    return m_private->render(windowInfo, this, reinterpret_cast<TgItem2d *>(this)->m_private, parentOpacity*getOpacity());
+}
+
+/*!
+ * \brief TgTiledImage::checkPositionValues
+ *
+ * uploads loaded tiles and requests tiles of the view
+ */
+void TgTiledImage::checkPositionValues()
+{
+    TG_FUNCTION_BEGIN();
+    if (!getVisible()) {
+        TG_FUNCTION_END();
+        return;
+    }
+    m_private->checkPositionValues(this);
+    TG_FUNCTION_END();
+}
@@ -0,0 +1,64 @@
+/*!
+ * \file
+ * \brief file tg_tiled_image.h
+ *
+ * Shows giant image as tiles
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_TILED_IMAGE_H
+#define TG_TILED_IMAGE_H
+
+#include <functional>
+#include <cstdint>
+#include "tg_item2d.h"
+#include "../global/tg_global_macros.h"
+
+class TgTiledImagePrivate;
+struct TgWindowInfo;
+
+/*!
+ * \brief TgTiledImage
+ * image that can be larger than the maximum texture size
+ * (maps, scans, schematics). Png is split once into 256x256 tiles
+ * on several mip levels into tile cache directory, and only tiles
+ * that are visible with current zoom are loaded (on worker threads)
+ * and kept as textures
+ */
+class TG_MAINWINDOW_EXPORT TgTiledImage : public TgItem2d
+{
+public:
+    explicit TgTiledImage(TgItem2d *parent, const char *filename);
+    explicit TgTiledImage(TgItem2d *parent, float x, float y, float width, float height, const char *filename);
+    ~TgTiledImage();
+
+    void setImage(const char *filename);
+    uint32_t getImageWidth();
+    uint32_t getImageHeight();
+
+    void setZoom(float zoom);
+    float getZoom();
+    void setViewPosition(float x, float y);
+    float getViewPositionX();
+    float getViewPositionY();
+
+    void setTileCacheSize(uint32_t tileCount);
+    uint32_t getTileCacheSize();
+    void setTileCacheDirectory(const char *directory);
+    void setTileCacheDirectoryMaxSize(uint64_t maxSize);
+
+    void connectOnImageLoaded(std::function<void(bool success)> imageLoaded);
+    void disconnectOnImageLoaded();
+
+protected:
+    virtual bool render(const TgWindowInfo *windowInfo, float parentOpacity) override;
+    virtual void checkPositionValues() override;
+
+private:
+    TgTiledImagePrivate *m_private;
+};
+
+#endif // TG_TILED_IMAGE_H
@@ -17,7 +17,8 @@
 TgRender::TgRender() :
     m_vertexArrayObject(0),
     m_vertexBufferObject(0),
-    m_verticesCount(0)
+    m_verticesCount(0),
+    m_bufferVerticesCount(0)
 {
     TG_FUNCTION_BEGIN();
     TG_FUNCTION_END();
@@ -68,6 +69,7 @@ bool TgRender::init(Vertice *vertices, int verticesCount, bool staticDraw)
     glEnableVertexAttribArray(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribTextCoord]);
     glBindVertexArray(0);
     m_verticesCount = verticesCount;
+    m_bufferVerticesCount = verticesCount;
     TG_FUNCTION_END();
     return true;
 }
@@ -75,7 +77,8 @@ bool TgRender::init(Vertice *vertices, int verticesCount, bool staticDraw)
 /*!
  * \brief TgRender::reInit
  *
- * re-inits the vertices
+ * re-inits the vertices, buffer is grown if
+ * vertices don't fit into it
  *
  * \param vertices pointer to vertices[]
  * \param verticesCount vertices count
@@ -84,7 +87,12 @@ bool TgRender::init(Vertice *vertices, int verticesCount, bool staticDraw)
 bool TgRender::reInit(Vertice *vertices, int verticesCount)
 {
     glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertice)*verticesCount, vertices);
+    if (verticesCount > m_bufferVerticesCount) {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Vertice)*verticesCount, vertices, GL_DYNAMIC_DRAW);
+        m_bufferVerticesCount = verticesCount;
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertice)*verticesCount, vertices);
+    }
     m_verticesCount = verticesCount;
     return true;
 }
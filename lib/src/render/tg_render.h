@@ -31,6 +31,7 @@ private:
     GLuint m_vertexArrayObject;
     GLuint m_vertexBufferObject;
     int m_verticesCount;
+    int m_bufferVerticesCount;      /*!< number of vertices that fit into m_vertexBufferObject */
 
     bool reInit(Vertice *vertices, int verticesCount);
 };
@@ -0,0 +1,132 @@
+/*!
+ * \file
+ * \brief file tg_render_text.cpp
+ *
+ * Handles the rendering of the text, all characters
+ * of the text are in single (interleaved) vertex buffer
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include "tg_render_text.h"
+#include "../global/tg_global_log.h"
+#include "../shader/tg_shader_2d.h"
+
+TgRenderText::TgRenderText() :
+    m_vertexArrayObject(0),
+    m_vertexBufferObject(0),
+    m_bufferVerticesCount(0)
+{
+    TG_FUNCTION_BEGIN();
+    TG_FUNCTION_END();
+}
+
+TgRenderText::~TgRenderText()
+{
+    TG_FUNCTION_BEGIN();
+    if (m_vertexArrayObject) {
+        glDeleteVertexArrays(1, &m_vertexArrayObject);
+    }
+    if (m_vertexBufferObject) {
+        glDeleteBuffers(1, &m_vertexBufferObject);
+    }
+    TG_FUNCTION_END();
+}
+
+/*!
+ * \brief TgRenderText::init
+ *
+ * creates vertex array and vertex buffer objects
+ * (position, texture coordinate and color interleaved)
+ *
+ * \return true on success
+ */
+bool TgRenderText::init()
+{
+    TG_FUNCTION_BEGIN();
+    glGenVertexArrays(1, &m_vertexArrayObject);
+    glGenBuffers(1, &m_vertexBufferObject);
+    if (!m_vertexArrayObject || !m_vertexBufferObject) {
+        TG_ERROR_LOG("Creating text vertex buffer failed");
+        TG_FUNCTION_END();
+        return false;
+    }
+    glBindVertexArray(m_vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
+
+    glVertexAttribPointer(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribPosition], 2, GL_FLOAT, GL_FALSE, sizeof(VerticeColor), reinterpret_cast<void*>(offsetof(VerticeColor, x)));
+    glEnableVertexAttribArray(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribPosition]);
+    glVertexAttribPointer(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribTextCoord], 2, GL_FLOAT, GL_FALSE, sizeof(VerticeColor), reinterpret_cast<void*>(offsetof(VerticeColor, s)));
+    glEnableVertexAttribArray(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribTextCoord]);
+    glVertexAttribPointer(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribColor], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VerticeColor), reinterpret_cast<void*>(offsetof(VerticeColor, r)));
+    glEnableVertexAttribArray(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribColor]);
+    glBindVertexArray(0);
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgRenderText::update
+ *
+ * uploads the vertices into vertex buffer, if the buffer is large enough
+ * only vertices from startIndex are uploaded. Buffer capacity grows
+ * geometrically, so typing does not re-allocate the buffer on every character
+ *
+ * \param listVertice all vertices of the text
+ * \param startIndex vertices before this index are not changed
+ * \return true on success
+ */
+bool TgRenderText::update(const std::vector<VerticeColor> &listVertice, size_t startIndex)
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_vertexBufferObject && !init()) {
+        TG_FUNCTION_END();
+        return false;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferObject);
+    if (listVertice.size() > m_bufferVerticesCount) {
+        m_bufferVerticesCount = m_bufferVerticesCount*2 > TG_RENDER_TEXT_MIN_BUFFER_VERTICES ? m_bufferVerticesCount*2 : TG_RENDER_TEXT_MIN_BUFFER_VERTICES;
+        if (m_bufferVerticesCount < listVertice.size()) {
+            m_bufferVerticesCount = listVertice.size();
+        }
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(VerticeColor)*m_bufferVerticesCount), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(VerticeColor)*listVertice.size()), listVertice.data());
+    } else if (startIndex < listVertice.size()) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(VerticeColor)*startIndex),
+                        static_cast<GLsizeiptr>(sizeof(VerticeColor)*(listVertice.size() - startIndex)), listVertice.data() + startIndex);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    TG_FUNCTION_END();
+    return true;
+}
+
+/*!
+ * \brief TgRenderText::render
+ *
+ * renders vertices (triangles) of the text
+ *
+ * \param textureIndex glyph texture
+ * \param startIndex first vertex to render
+ * \param verticesCount number of vertices to render
+ */
+void TgRenderText::render(GLuint textureIndex, size_t startIndex, size_t verticesCount) const
+{
+    TG_FUNCTION_BEGIN();
+    if (!m_vertexArrayObject || !verticesCount) {
+        TG_FUNCTION_END();
+        return;
+    }
+    glBindVertexArray(m_vertexArrayObject);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_TEXTURE_2D);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textureIndex);
+    glDrawArrays(GL_TRIANGLES, static_cast<GLint>(startIndex), static_cast<GLsizei>(verticesCount));
+    glBindVertexArray(0);
+    // current color value can be undefined after drawing with color array
+    glVertexAttrib4f(TgShader2d::m_shaderAttributeIndex[ShaderAttributes2d::AttribColor], 1, 1, 1, 1);
+    TG_FUNCTION_END();
+}
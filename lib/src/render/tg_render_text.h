@@ -0,0 +1,45 @@
+/*!
+ * \file
+ * \brief file tg_render_text.h
+ *
+ * Handles the rendering of the text, all characters
+ * of the text are in single (interleaved) vertex buffer
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#ifndef TG_RENDER_TEXT_H
+#define TG_RENDER_TEXT_H
+
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include <vector>
+#include <cstddef>
+#include "../global/private/tg_global_defines.h"
+
+/*!
+ * \brief TG_RENDER_TEXT_MIN_BUFFER_VERTICES
+ * minimum capacity (vertices) of the text vertex buffer,
+ * 16 characters (6 vertices each)
+ */
+#define TG_RENDER_TEXT_MIN_BUFFER_VERTICES      (16*6)
+
+class TgRenderText
+{
+public:
+    explicit TgRenderText();
+    ~TgRenderText();
+    bool update(const std::vector<VerticeColor> &listVertice, size_t startIndex);
+    void render(GLuint textureIndex, size_t startIndex, size_t verticesCount) const;
+
+private:
+    GLuint m_vertexArrayObject;
+    GLuint m_vertexBufferObject;
+    size_t m_bufferVerticesCount;       /*!< capacity of the vertex buffer */
+
+    bool init();
+};
+
+#endif // TG_RENDER_TEXT_H
@@ -13,7 +13,7 @@
 #include <stdio.h>
 #include "../global/tg_global_log.h"
 
-GLuint TgShader2d::m_shaderAttributeIndex[2] = {0,0};
+GLuint TgShader2d::m_shaderAttributeIndex[3] = {0,0,0};
 
 /*!
  * \brief TgShader2d::m_vertShader
@@ -22,14 +22,17 @@ GLuint TgShader2d::m_shaderAttributeIndex[2] = {0,0};
  */
 const char *TgShader2d::m_vertShader = "attribute vec2 vertex;" \
         "attribute vec2 tex_coord;" \
+        "attribute vec4 vertex_color;" \
         "uniform mat4 model;" \
         "uniform mat4 view;" \
         "uniform mat4 projection;" \
         "uniform mat4 vertex_transform;" \
         "varying vec4 currentPosition;" \
+        "varying vec4 currentColor;" \
         "void main()" \
         "{" \
         "    gl_TexCoord[0].xy       = tex_coord.xy;" \
+        "    currentColor            = vertex_color;" \
         "    currentPosition         = vertex_transform*vec4(vertex, 1.0f, 1.0f);" \
         "    gl_Position             = projection*(view*(model*vertex_transform*vec4(vertex, 1.0f, 1.0f)));" \
         "}";
@@ -42,7 +45,10 @@ const char *TgShader2d::m_fragShader = "" \
         "uniform int render_type;" \
         "uniform vec4 color;" \
         "uniform sampler2D texture;" \
+        "uniform sampler2D texture_u;" \
+        "uniform sampler2D texture_v;" \
         "varying vec4 currentPosition;" \
+        "varying vec4 currentColor;" \
         "uniform vec4 maxRenderValues;" \
         "uniform float opacity;" \
         "void main()" \
@@ -55,10 +61,22 @@ const char *TgShader2d::m_fragShader = "" \
         "           discard;" \
         "       }" \
         "       gl_FragColor = texture2D(texture, gl_TexCoord[0].xy);" \
-        "       gl_FragColor.a = gl_FragColor.b*color.w*opacity;"
-        "       gl_FragColor.r = gl_FragColor.r*color.x;"
-        "       gl_FragColor.g = gl_FragColor.g*color.y;"
-        "       gl_FragColor.b = gl_FragColor.b*color.z;"
+        "       gl_FragColor.a = gl_FragColor.b*color.w*currentColor.w*opacity;"
+        "       gl_FragColor.r = gl_FragColor.r*color.x*currentColor.x;"
+        "       gl_FragColor.g = gl_FragColor.g*color.y*currentColor.y;"
+        "       gl_FragColor.b = gl_FragColor.b*color.z*currentColor.z;"
+        "    } else if (render_type == 2 || render_type == 3) {" \
+        "       float y = 1.1643*(texture2D(texture, gl_TexCoord[0].xy).r - 0.0625);" \
+        "       vec2 uv;" \
+        "       if (render_type == 2) {" \
+        "           uv = texture2D(texture_u, gl_TexCoord[0].xy).rg - 0.5;" \
+        "       } else {" \
+        "           uv = vec2(texture2D(texture_u, gl_TexCoord[0].xy).r, texture2D(texture_v, gl_TexCoord[0].xy).r) - 0.5;" \
+        "       }" \
+        "       gl_FragColor.r = (y + 1.5958*uv.y)*color.x;" \
+        "       gl_FragColor.g = (y - 0.39173*uv.x - 0.8129*uv.y)*color.y;" \
+        "       gl_FragColor.b = (y + 2.017*uv.x)*color.z;" \
+        "       gl_FragColor.a = color.w*opacity;" \
         "    } else {" \
         "       gl_FragColor = texture2D(texture, gl_TexCoord[0].xy);" \
         "       gl_FragColor.r = gl_FragColor.r*color.x;"
@@ -137,6 +155,9 @@ int TgShader2d::init()
     m_generalShader = shaderHandle;
     m_shaderAttributeIndex[ShaderAttributes2d::AttribPosition] = glGetAttribLocation(shaderHandle, "vertex");
     m_shaderAttributeIndex[ShaderAttributes2d::AttribTextCoord] = glGetAttribLocation(shaderHandle, "tex_coord");
+    m_shaderAttributeIndex[ShaderAttributes2d::AttribColor] = glGetAttribLocation(shaderHandle, "vertex_color");
+    // items without color array use this value
+    glVertexAttrib4f(m_shaderAttributeIndex[ShaderAttributes2d::AttribColor], 1, 1, 1, 1);
     return 0;
 }
 
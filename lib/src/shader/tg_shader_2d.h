@@ -15,10 +15,23 @@
 #include <GL/glew.h>
 #include <GL/gl.h>
 
+/*!
+ * \brief ShaderRenderType2d
+ * values of fragment shader's render_type
+ */
+enum ShaderRenderType2d
+{
+    RenderTypeTexture = 0,          /*!< RGBA texture */
+    RenderTypeText = 1,             /*!< font glyph texture */
+    RenderTypeYuvNv12 = 2,          /*!< Y texture (texture), interleaved UV texture (texture_u) */
+    RenderTypeYuvI420 = 3,          /*!< Y texture (texture), U texture (texture_u), V texture (texture_v) */
+};
+
 enum ShaderAttributes2d
 {
     AttribPosition = 0,
     AttribTextCoord,
+    AttribColor,
 };
 
 class TgShader2d
@@ -31,7 +44,7 @@ public:
 
     GLuint generalShader();
 
-    static GLuint m_shaderAttributeIndex[2];
+    static GLuint m_shaderAttributeIndex[3];
 private:
     static const char *m_vertShader;
     static const char *m_fragShader;
@@ -16,6 +16,7 @@
 #include "../item2d/private/item2d/tg_item2d_private.h"
 #include "../global/private/tg_global_deleter.h"
 #include "../global/private/tg_global_tooltip.h"
+#include "../font/cache/tg_font_glyph_cache.h"
 
 /*!
  * \brief TgMainWindow::TgMainWindow
@@ -93,6 +94,9 @@ bool TgMainWindow::render(const TgWindowInfo *, float)
     if (TgGlobalDeleter::getInstance()->removeItems()) {
         m_mainwindowPrivate->hideList();
     }
+    TgGlobalApplication::getInstance()->getFontGlyphCache()->uploadPendingCache();
+    TgGlobalApplication::getInstance()->getImageAssets()->releasePendingImages();
+    TgGlobalApplication::getInstance()->getImageAssets()->uploadDecodedImages();
     customBeforeRender();
     m_mainwindowPrivate->checkPositionValuesChildrenWindowMenu(m_mainwindowPrivate->getWindowInfo());
     checkPositionValuesChildren(m_mainwindowPrivate->getWindowInfo());
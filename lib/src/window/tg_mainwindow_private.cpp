@@ -284,6 +284,9 @@ bool TgMainWindowPrivate::setup2DShaderToUniforms()
     TG_FUNCTION_BEGIN();
     glUseProgram(m_shader2d.generalShader() );
     glUniform1i(glGetUniformLocation(m_shader2d.generalShader(), "texture" ), 0);
+    // YUV planes of TgStreamImage
+    glUniform1i(glGetUniformLocation(m_shader2d.generalShader(), "texture_u" ), 1);
+    glUniform1i(glGetUniformLocation(m_shader2d.generalShader(), "texture_v" ), 2);
     glUniformMatrix4fv( glGetUniformLocation(m_shader2d.generalShader(), "model" ), 1, 0, m_model.getMatrixTable()->data);
     glUniformMatrix4fv( glGetUniformLocation(m_shader2d.generalShader(), "view" ), 1, 0, m_view.getMatrixTable()->data);
     glUniformMatrix4fv( glGetUniformLocation(m_shader2d.generalShader(), "projection" ), 1, 0, m_projection.getMatrixTable()->data);
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <prj-ttf-reader.h>
+#include "../../../../lib/src/global/tg_global_application.h"
+#include "../../../../lib/src/global/private/tg_global_thread_pool.h"
+
+#define BENCHMARK_ACCURACY_VALUE 5
+
+/*!
+ * \brief BenchmarkFont
+ * one font file and font size, and its generated glyphs
+ */
+struct BenchmarkFont
+{
+    std::string m_fontFile;
+    float m_fontSize;
+    prj_ttf_reader_data_t *m_data = nullptr;
+};
+
+static std::vector<uint32_t> generateCharacters()
+{
+    uint32_t i;
+    std::vector<uint32_t> ret;
+    for (i=32;i<127;i++) {
+        ret.push_back(i);
+    }
+    for (i=160;i<256;i++) {
+        ret.push_back(i);
+    }
+    return ret;
+}
+
+static void clearFonts(std::vector<BenchmarkFont> &listFont)
+{
+    for (size_t i=0;i<listFont.size();i++) {
+        if (listFont[i].m_data) {
+            prj_ttf_reader_clear_data(&listFont[i].m_data);
+        }
+    }
+}
+
+static bool generateFont(BenchmarkFont &font, const std::vector<uint32_t> &listCharacter)
+{
+    font.m_data = prj_ttf_reader_init_data();
+    if (!font.m_data) {
+        return false;
+    }
+    return prj_ttf_reader_generate_glyphs_list_characters(listCharacter.data(), static_cast<uint32_t>(listCharacter.size()),
+                                                          font.m_fontFile.c_str(), font.m_fontSize, BENCHMARK_ACCURACY_VALUE, font.m_data) == 0;
+}
+
+/*!
+ * \brief isSameData
+ *
+ * \param data0
+ * \param data1
+ * \return true if both have identical atlas image and glyph data
+ */
+static bool isSameData(const prj_ttf_reader_data_t *data0, const prj_ttf_reader_data_t *data1)
+{
+    if (data0->image.width != data1->image.width
+        || data0->image.height != data1->image.height
+        || data0->list_data_count != data1->list_data_count) {
+        return false;
+    }
+    if (memcmp(data0->image.data, data1->image.data, static_cast<size_t>(data0->image.width)*static_cast<size_t>(data0->image.height)) != 0) {
+        return false;
+    }
+    return memcmp(data0->list_data, data1->list_data, sizeof(prj_ttf_reader_glyph_data_t)*data0->list_data_count) == 0;
+}
+
+/*!
+ * \brief runBenchmark
+ *
+ * \param iterationCount number of measured runs
+ * \param job generates all fonts on each run, returns false if fails
+ * \return milliseconds per run, or negative if job fails
+ */
+static double runBenchmark(uint32_t iterationCount, const std::function<bool()> &job)
+{
+    uint32_t i;
+    double ret = 0;
+    for (i=0;i<iterationCount;i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool success = job();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        if (!success) {
+            return -1;
+        }
+        ret += static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count())/1000.0;
+    }
+    return ret/iterationCount;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+    size_t i2, i3;
+    uint32_t iterationCount = 5;
+    const float listFontSize[] = { 12, 14, 17, 20, 24, 28, 32, 40 };
+    std::vector<std::string> listFontFile;
+    if (argc > 1) {
+        iterationCount = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+        if (!iterationCount) {
+            std::cout << "usage: " << argv[0] << " [iteration count] [font file...]" << std::endl;
+            return 1;
+        }
+    }
+    for (i=2;i<argc;i++) {
+        listFontFile.push_back(argv[i]);
+    }
+    if (listFontFile.empty()) {
+        listFontFile.push_back(BENCHMARK_FONT_FILE);
+    }
+
+    const std::vector<uint32_t> listCharacter = generateCharacters();
+    std::vector<BenchmarkFont> listFontSerial, listFontParallel;
+    for (i2=0;i2<listFontFile.size();i2++) {
+        for (i3=0;i3<sizeof(listFontSize)/sizeof(listFontSize[0]);i3++) {
+            BenchmarkFont font;
+            font.m_fontFile = listFontFile[i2];
+            font.m_fontSize = listFontSize[i3];
+            listFontSerial.push_back(font);
+        }
+    }
+    listFontParallel = listFontSerial;
+    TgGlobalThreadPool *threadPool = TgGlobalApplication::getInstance()->getThreadPool();
+
+    double serial = runBenchmark(iterationCount, [&]() {
+        clearFonts(listFontSerial);
+        for (size_t index=0;index<listFontSerial.size();index++) {
+            if (!generateFont(listFontSerial[index], listCharacter)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    double parallel = runBenchmark(iterationCount, [&]() {
+        std::vector<std::future<void>> listJob;
+        std::vector<char> listSuccess(listFontParallel.size(), 0);
+        uint64_t jobGroup = threadPool->createJobGroup();
+        clearFonts(listFontParallel);
+        for (size_t index=0;index<listFontParallel.size();index++) {
+            listJob.push_back(threadPool->addJob([&, index]() {
+                listSuccess[index] = generateFont(listFontParallel[index], listCharacter) ? 1 : 0;
+            }, jobGroup));
+        }
+        threadPool->waitJobs(listJob, jobGroup);
+        return std::find(listSuccess.begin(), listSuccess.end(), 0) == listSuccess.end();
+    });
+    if (serial < 0 || parallel < 0) {
+        std::cout << "Glyph generation failed" << std::endl;
+        clearFonts(listFontSerial);
+        clearFonts(listFontParallel);
+        return 1;
+    }
+    for (i2=0;i2<listFontSerial.size();i2++) {
+        if (!isSameData(listFontSerial[i2].m_data, listFontParallel[i2].m_data)) {
+            std::cout << "Glyphs generated in parallel differ, font: " << listFontSerial[i2].m_fontFile
+                      << " size: " << listFontSerial[i2].m_fontSize << std::endl;
+            clearFonts(listFontSerial);
+            clearFonts(listFontParallel);
+            return 1;
+        }
+    }
+
+    std::cout << "fonts: " << listFontSerial.size() << ", characters per font: " << listCharacter.size()
+              << ", worker threads: " << threadPool->getThreadCount() << std::endl;
+    std::cout << std::left << std::setw(16) << "one thread"
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << serial << " ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "parallel"
+              << std::right << std::setw(12) << parallel << " ms" << std::endl;
+    std::cout << std::left << std::setw(16) << "speedup"
+              << std::right << std::setw(12) << serial/parallel << std::endl;
+    clearFonts(listFontSerial);
+    clearFonts(listFontParallel);
+    return 0;
+}
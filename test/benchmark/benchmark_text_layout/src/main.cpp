@@ -0,0 +1,287 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <string>
+#include <vector>
+#include <functional>
+#include "../../../../lib/src/global/tg_global_application.h"
+#include "../../../../lib/src/font/tg_font_text_generator.h"
+#include "../../../../lib/src/font/tg_font_text.h"
+#include "../../../../lib/src/font/tg_character_positions.h"
+#include "../../../../lib/src/font/tg_font_default.h"
+#include "../../../../lib/src/font/text/tg_text_transcode_utf8.h"
+
+#define BENCHMARK_FONT_SIZE 17.0f
+#define BENCHMARK_MAX_LINE_WIDTH 240.0f
+#define BENCHMARK_RESIZE_COUNT 3
+
+static std::atomic<uint64_t> s_allocationCount(0);
+
+void *operator new(size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *ret = std::malloc(size ? size : 1);
+    if (!ret) {
+        throw std::bad_alloc();
+    }
+    return ret;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+struct BenchmarkCorpus
+{
+    std::string m_name;
+    std::vector<std::string> m_listText;
+    size_t m_characterCount = 0;
+};
+
+static std::vector<BenchmarkCorpus> generateCorpora()
+{
+    size_t i;
+    std::vector<BenchmarkCorpus> ret(3);
+    const char *listLabel[] = { "OK", "Cancel", "Apply", "File", "Edit", "View", "Help", "Save as...",
+                                "Preferences", "Open recent", "Close window", "Quit", "Undo", "Redo",
+                                "Width: 1920", "Height: 1080", "Volume 85%", "12:45", "Search", "Settings" };
+    const std::string sentence = "The quick brown fox jumps over the lazy dog, while five boxing wizards jump quickly. ";
+    const std::string mixed = "Hello Καλημέρα Привет שלום مرحبا 你好 こんにちは 안녕하세요 Grüße ";
+
+    ret[0].m_name = "labels";
+    for (i=0;i<sizeof(listLabel)/sizeof(listLabel[0]);i++) {
+        ret[0].m_listText.push_back(listLabel[i]);
+    }
+
+    ret[1].m_name = "paragraphs";
+    for (i=0;i<8;i++) {
+        std::string paragraph;
+        for (size_t i2=0;i2<24;i2++) {
+            paragraph += sentence;
+            if (i2 % 8 == 7) {
+                paragraph += "\n";
+            }
+        }
+        ret[1].m_listText.push_back(paragraph);
+    }
+
+    ret[2].m_name = "mixed-script";
+    for (i=0;i<16;i++) {
+        std::string text;
+        for (size_t i2=0;i2<=i%4;i2++) {
+            text += mixed;
+        }
+        ret[2].m_listText.push_back(text);
+    }
+
+    for (i=0;i<ret.size();i++) {
+        for (size_t i2=0;i2<ret[i].m_listText.size();i2++) {
+            std::vector<uint32_t> listCharacter;
+            TgTextTranscodeUtf8::addUtf8ToUtf32List(ret[i].m_listText[i2], listCharacter);
+            ret[i].m_characterCount += listCharacter.size();
+        }
+    }
+    return ret;
+}
+
+/*!
+ * \brief runBenchmark
+ *
+ * runs the job once to warm up caches, then iterationCount times
+ * and prints time and allocations per operation (for example
+ * per text or per edit) and per character, so stages can be compared
+ * between corpora that have different text lengths
+ *
+ * \param corpus corpus that job handles on each run
+ * \param stage name of the stage
+ * \param operation name of the operation
+ * \param operationCount number of operations that job does on each run
+ * \param characterCount number of characters that job handles on each run
+ * \param iterationCount number of measured runs
+ * \param job handles all texts of the corpus
+ */
+static void runBenchmark(const BenchmarkCorpus &corpus, const std::string &stage, const char *operation, size_t operationCount,
+                         size_t characterCount, uint32_t iterationCount, const std::function<void()> &job)
+{
+    uint32_t i;
+    job();
+    uint64_t allocationStart = s_allocationCount.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (i=0;i<iterationCount;i++) {
+        job();
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    uint64_t allocationCount = s_allocationCount.load(std::memory_order_relaxed) - allocationStart;
+    double count = static_cast<double>(operationCount) * iterationCount;
+    double characters = static_cast<double>(characterCount ? characterCount : 1) * iterationCount;
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+
+    std::cout << std::left << std::setw(14) << corpus.m_name
+              << std::setw(44) << stage
+              << std::setw(8) << operation
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << ns/count
+              << std::setw(12) << static_cast<double>(allocationCount)/count
+              << std::setw(12) << ns/characters
+              << std::setprecision(4)
+              << std::setw(14) << static_cast<double>(allocationCount)/characters << std::endl;
+}
+
+static const char *getWordWrapName(TgTextFieldWordWrap wordWrap)
+{
+    switch (wordWrap) {
+        case TgTextFieldWordWrap::WordWrapBounded:
+            return "WordWrapBounded";
+        case TgTextFieldWordWrap::WordWrapOff:
+            return "WordWrapOff";
+        case TgTextFieldWordWrap::WordWrapOn:
+        default:
+            return "WordWrapOn";
+    }
+}
+
+static void benchmarkCorpus(const BenchmarkCorpus &corpus, const std::shared_ptr<const TgFontChain> &fontChain, uint32_t iterationCount)
+{
+    size_t i, i2;
+    std::vector<std::vector<TgTextFieldText>> listText(corpus.m_listText.size(), std::vector<TgTextFieldText>(1));
+    std::vector<std::vector<TgFontTextCharacterInfo>> listCharacter(corpus.m_listText.size());
+    std::vector<std::vector<TgFontInfoData *>> listFontInfo(corpus.m_listText.size());
+    const TgTextFieldWordWrap listWordWrap[] = { TgTextFieldWordWrap::WordWrapBounded,
+                                                 TgTextFieldWordWrap::WordWrapOff,
+                                                 TgTextFieldWordWrap::WordWrapOn };
+    for (i=0;i<corpus.m_listText.size();i++) {
+        listText[i][0].m_text = corpus.m_listText[i];
+    }
+    std::cout << corpus.m_name << ": " << corpus.m_listText.size() << " texts, "
+              << corpus.m_characterCount << " characters" << std::endl;
+
+    runBenchmark(corpus, "TgFontTextGenerator::getCharacters", "text", listText.size(), corpus.m_characterCount, iterationCount, [&]() {
+        std::vector<uint32_t> listUtf32;
+        for (size_t index=0;index<listText.size();index++) {
+            listUtf32.clear();
+            TgFontTextGenerator::getCharacters(listText[index], listUtf32);
+        }
+    });
+
+    runBenchmark(corpus, "TgFontTextGenerator::generateCharacterList", "text", listText.size(), corpus.m_characterCount, iterationCount, [&]() {
+        for (size_t index=0;index<listText.size();index++) {
+            listCharacter[index] = TgFontTextGenerator::generateCharacterList(listText[index], *fontChain);
+        }
+    });
+
+    // first run generates the glyphs into the cache, measured runs use the cache
+    runBenchmark(corpus, "TgFontText::generateFontTextInfoGlyphsData", "text", listText.size(), corpus.m_characterCount, iterationCount, [&]() {
+        for (size_t index=0;index<listCharacter.size();index++) {
+            listFontInfo[index].clear();
+            TgFontText::generateFontTextInfoGlyphsData(BENCHMARK_FONT_SIZE, listCharacter[index], listFontInfo[index], *fontChain);
+            for (size_t infoIndex=0;infoIndex<listFontInfo[index].size();infoIndex++) {
+                TgGlobalApplication::getInstance()->getFontGlyphCacheData()->addCache(listFontInfo[index][infoIndex]);
+            }
+        }
+    });
+
+    for (i=0;i<sizeof(listWordWrap)/sizeof(listWordWrap[0]);i++) {
+        TgTextFieldWordWrap wordWrap = listWordWrap[i];
+        runBenchmark(corpus, std::string("calculateTextWidthHeight ") + getWordWrapName(wordWrap), "text", listText.size(), corpus.m_characterCount, iterationCount, [&]() {
+            float width, height, allDrawTextHeight;
+            for (size_t index=0;index<listCharacter.size();index++) {
+                TgCharacterPositions::calculateTextWidthHeight(listFontInfo[index], listCharacter[index], 0,
+                                                               wordWrap == TgTextFieldWordWrap::WordWrapOff ? 0 : BENCHMARK_MAX_LINE_WIDTH,
+                                                               wordWrap, false, width, height, allDrawTextHeight);
+            }
+        });
+    }
+
+    // edit is same as typing one character into middle of the text, and removing it
+    std::vector<TgFontText *> listFontText(listText.size(), nullptr);
+    for (i=0;i<listText.size();i++) {
+        listFontText[i] = TgFontTextGenerator::generateFontTextInfo(listText[i], fontChain);
+        listFontText[i]->prepareFontTextInfoGlyphs(BENCHMARK_FONT_SIZE);
+        TgCharacterPositions::generateTextCharacterPositioning(listFontText[i], 0, BENCHMARK_MAX_LINE_WIDTH, TgTextFieldWordWrap::WordWrapOn, false);
+    }
+    // resize re-wraps the text with other width, glyphs are looked up only once per text
+    runBenchmark(corpus, "generateTextCharacterPositioning resize", "resize", listFontText.size()*BENCHMARK_RESIZE_COUNT,
+                 corpus.m_characterCount*BENCHMARK_RESIZE_COUNT, iterationCount, [&]() {
+        for (size_t index=0;index<listFontText.size();index++) {
+            for (uint32_t resize=0;resize<BENCHMARK_RESIZE_COUNT;resize++) {
+                TgCharacterPositions::generateTextCharacterPositioning(listFontText[index], 0,
+                                                                       BENCHMARK_MAX_LINE_WIDTH*static_cast<float>(resize+BENCHMARK_RESIZE_COUNT)/static_cast<float>(BENCHMARK_RESIZE_COUNT*2),
+                                                                       TgTextFieldWordWrap::WordWrapOn, false);
+            }
+        }
+    });
+    // each text is edited twice (insert and remove), and each edit handles the characters of the text
+    runBenchmark(corpus, "editText", "edit", listFontText.size()*2, corpus.m_characterCount*2, iterationCount, [&]() {
+        const std::vector<uint32_t> listAddCharacter(1, 'a');
+        const std::vector<uint32_t> listEmpty;
+        for (size_t index=0;index<listFontText.size();index++) {
+            TgFontText *fontText = listFontText[index];
+            size_t editIndex = fontText->getCharacterCount()/2;
+            if (!fontText->editCharacters(editIndex, 0, listAddCharacter, 0, 0, 0)) {
+                fontText->prepareFontTextInfoGlyphs(BENCHMARK_FONT_SIZE);
+            }
+            TgCharacterPositions::generateTextCharacterPositioning(fontText, 0, BENCHMARK_MAX_LINE_WIDTH, TgTextFieldWordWrap::WordWrapOn, false, editIndex);
+            fontText->editCharacters(editIndex, 1, listEmpty, 0, 0, 0);
+            TgCharacterPositions::generateTextCharacterPositioning(fontText, 0, BENCHMARK_MAX_LINE_WIDTH, TgTextFieldWordWrap::WordWrapOn, false, editIndex);
+        }
+    });
+    for (i2=0;i2<listFontText.size();i2++) {
+        delete listFontText[i2];
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+    uint32_t iterationCount = 20;
+    if (argc > 1) {
+        iterationCount = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+        if (!iterationCount) {
+            std::cout << "usage: " << argv[0] << " [iteration count] [fallback font file...]" << std::endl;
+            return 1;
+        }
+    }
+    for (i=2;i<argc;i++) {
+        TgGlobalApplication::getInstance()->getFontDefault()->setFont(argv[i]);
+    }
+
+    std::shared_ptr<const TgFontChain> fontChain = TgFontDefault::getMainFontChain(BENCHMARK_FONT_FILE);
+    std::vector<BenchmarkCorpus> listCorpus = generateCorpora();
+
+    std::cout << std::left << std::setw(14) << "corpus"
+              << std::setw(44) << "stage"
+              << std::setw(8) << "op"
+              << std::right << std::setw(14) << "ns/op"
+              << std::setw(12) << "allocs/op"
+              << std::setw(12) << "ns/char"
+              << std::setw(14) << "allocs/char" << std::endl;
+    for (size_t index=0;index<listCorpus.size();index++) {
+        benchmarkCorpus(listCorpus[index], fontChain, iterationCount);
+    }
+    return 0;
+}
@@ -88,6 +88,62 @@ void MainWindow::addMouseStateChange(const MouseStateChange &change)
     m_listMouseStateChange.push_back(change);
 }
 
+#define MODEL_COLUMN_COUNT      3
+#define MODEL_ROW_COUNT         1000
+
+GridViewModel::GridViewModel() :
+    m_rowCount(MODEL_ROW_COUNT)
+{
+    for (size_t y = 0; y < MODEL_ROW_COUNT; y++) {
+        for (size_t x = 0; x < MODEL_COLUMN_COUNT; x++) {
+            m_listText.push_back("model " + std::to_string(x) + " " + std::to_string(y));
+        }
+    }
+}
+
+GridViewModel::~GridViewModel()
+{
+    detach();
+}
+
+size_t GridViewModel::getColumnCount()
+{
+    return MODEL_COLUMN_COUNT;
+}
+
+size_t GridViewModel::getRowCount()
+{
+    m_mutex.lock();
+    size_t ret = m_rowCount;
+    m_mutex.unlock();
+    return ret;
+}
+
+std::string GridViewModel::getCellText(size_t column, size_t row)
+{
+    m_mutex.lock();
+    std::string ret = m_listText.at(row*MODEL_COLUMN_COUNT + column);
+    m_mutex.unlock();
+    return ret;
+}
+
+void GridViewModel::setCellText(size_t column, size_t row, const std::string &text)
+{
+    m_mutex.lock();
+    m_listText.at(row*MODEL_COLUMN_COUNT + column) = text;
+    // notify is called while model's own lock is locked
+    notifyCellsChanged(column, row);
+    m_mutex.unlock();
+}
+
+void GridViewModel::setRowCount(size_t row)
+{
+    m_mutex.lock();
+    m_rowCount = row;
+    m_mutex.unlock();
+    notifySizeChanged();
+}
+
 MouseStateChange::MouseStateChange(size_t index, HoverVisibleChangeState state)
 {
     m_index = index;
@@ -280,6 +336,99 @@ bool MainWindow::setMakeStep(int index)
             return false;
         }
         break;
+    case 30:
+        // large grid, cells are drawn by pooled cell items
+        m_gridview.setColumCount(3);
+        m_gridview.setRowCount(100000);
+        for (size_t y = 0; y < m_gridview.getRowCount(); y++) {
+            m_gridview.setCellText(0, y, std::string("row " + std::to_string(y)).c_str());
+            m_gridview.setCellText(1, y, std::string(std::to_string(y) + "/1").c_str());
+            if (y % 2) {
+                m_gridview.setCellBackground(2, y, 200, 255, 200, 255);
+            }
+        }
+        m_gridview.setColumnWidth(2, 150);
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
+    case 31:
+        if (m_gridview.getRowCount() != 100000
+            || m_gridview.getCellText(0, 99999) != "row 99999"
+            || m_gridview.getCellText(1, 50000) != "50000/1"
+            || static_cast<int>(m_gridview.getColumnWidth(2)) != 150) {
+            std::cout << "Case 31, large grid is incorrect\n";
+            return false;
+        }
+        break;
+    case 32:
+        // cells are changed while pooled cell items are recycled for other rows
+        m_gridview.setCellText(1, 99999, "last");
+        m_gridview.setCellText(1, 0, "first");
+        m_gridview.setCellBackground(1, 99998, 255, 200, 200, 255);
+        m_gridview.setColumnWidth(1, 120);
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
+    case 33:
+        if (m_gridview.getCellText(1, 99999) != "last"
+            || m_gridview.getCellText(1, 0) != "first"
+            || m_gridview.getCellText(1, 99998) != "99998/1"
+            || static_cast<int>(m_gridview.getColumnWidth(1)) != 120) {
+            std::cout << "Case 33, large grid is incorrect after scrolling\n";
+            return false;
+        }
+        break;
+    case 34: {
+            // column follows also the texts of cells without own cell item
+            m_gridview.getCell(0, 0)->setWidthType(TgGridViewCellSizeType::TgGridViewCellSize_FixedSize);
+            m_gridview.getCell(0, 0)->setWidthType(TgGridViewCellSizeType::TgGridViewCellSize_SizeFollowTextSize);
+            float width = m_gridview.getColumnWidth(0);
+            m_gridview.setCellText(0, 70000, "this text is wider than any other text of the column");
+            m_gridview.getCell(0, 0)->setWidthType(TgGridViewCellSizeType::TgGridViewCellSize_FixedSize);
+            m_gridview.getCell(0, 0)->setWidthType(TgGridViewCellSizeType::TgGridViewCellSize_SizeFollowTextSize);
+            if (m_gridview.getColumnWidth(0) <= width + 100) {
+                std::cout << "Case 34, column width does not follow text: " << width << " " << m_gridview.getColumnWidth(0) << "\n";
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        }
+        break;
+    case 35:
+        // text of cells are taken from the model
+        m_gridview.setModel(&m_model);
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
+    case 36:
+        if (m_gridview.getColumCount() != 3
+            || m_gridview.getRowCount() != 1000
+            || m_gridview.getCell(0, 0)->getText() != "model 0 0"
+            || m_gridview.getCellText(1, 500) != "model 1 500") {
+            std::cout << "Case 36, grid with model is incorrect\n";
+            return false;
+        }
+        // visible and not visible cells are changed
+        m_model.setCellText(0, 0, "changed 0 0");
+        m_model.setCellText(1, 900, "changed 1 900");
+        m_gridview.setCellText(0, 1, "ignored");
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
+    case 37:
+        if (m_gridview.getCell(0, 0)->getText() != "changed 0 0"
+            || m_gridview.getCellText(1, 900) != "changed 1 900"
+            || m_gridview.getCellText(0, 1) != "model 0 1") {
+            std::cout << "Case 37, changed cells of the model are incorrect\n";
+            return false;
+        }
+        m_model.setRowCount(500);
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
+    case 38:
+        if (m_gridview.getRowCount() != 500
+            || m_gridview.getColumCount() != 3) {
+            std::cout << "Case 38, size of the model is incorrect " << m_gridview.getRowCount() << "\n";
+            return false;
+        }
+        m_gridview.setModel(nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        break;
     default:
         break;
     }
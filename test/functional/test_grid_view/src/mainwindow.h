@@ -7,6 +7,7 @@
 #include <item2d/tg_grid_view_cell.h>
 #include <item2d/tg_button.h>
 #include <item2d/tg_rectangle.h>
+#include <item2d/tg_grid_view_model.h>
 
 
 class TgTextedit;
@@ -34,6 +35,25 @@ struct MouseStateChange {
     bool m_area;
 };
 
+class GridViewModel : public TgGridViewModel
+{
+public:
+    GridViewModel();
+    ~GridViewModel();
+
+    size_t getColumnCount() override;
+    size_t getRowCount() override;
+    std::string getCellText(size_t column, size_t row) override;
+
+    void setCellText(size_t column, size_t row, const std::string &text);
+    void setRowCount(size_t row);
+
+private:
+    std::mutex m_mutex;
+    size_t m_rowCount;
+    std::vector<std::string> m_listText;
+};
+
 class MainWindow : public TgMainWindow
 {
 public:
@@ -55,6 +75,7 @@ private:
     std::mutex m_mutex;
     TgRectangle m_background;
     TgGridView m_gridview;
+    GridViewModel m_model;
 
     std::vector<MouseStateChange> m_listMouseStateChange;
     void onMenuItem0Clicked(TgMouseType button, float x, float y, const void *id);
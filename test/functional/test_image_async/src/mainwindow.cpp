@@ -0,0 +1,118 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <application/tg_application.h>
+
+#define TEST_IMAGE_FILE         "/tmp/functional_test_image_async.png"
+#define TEST_SOURCE_IMAGE_FILE  IMAGES_DIR "/button/prj-tg-ui-lib-button-disabled.png"
+#define TEST_OTHER_IMAGE_FILE   IMAGES_DIR "/button/prj-tg-ui-lib-button-down-not-selected.png"
+
+MainWindow::MainWindow(int width, int height, TgApplication *application) :
+    TgMainWindow(width, height, "Image async test", width-200, height-200, width+200, height+200),
+    m_application(application),
+    m_background(this, 255, 255, 255),
+    m_image(&m_background, 20, 20, 100, 50, TEST_OTHER_IMAGE_FILE),
+    m_imagePart(&m_background, 20, 100, 100, 50, TEST_OTHER_IMAGE_FILE),
+    m_imageLoadedCount(0),
+    m_imagePartLoadedCount(0),
+    m_imageSuccess(false),
+    m_imagePartSuccess(false)
+{
+    m_image.setAsyncLoad(true);
+    m_imagePart.setAsyncLoad(true);
+}
+
+MainWindow::~MainWindow()
+{
+    remove(TEST_IMAGE_FILE);
+}
+
+/*!
+ * \brief MainWindow::copyFile
+ *
+ * \param sourceFilename
+ * \param targetFilename
+ * \return true if file is copied
+ */
+bool MainWindow::copyFile(const char *sourceFilename, const char *targetFilename)
+{
+    std::ifstream source(sourceFilename, std::ios::binary);
+    std::ofstream target(targetFilename, std::ios::binary);
+    if (!source.is_open() || !target.is_open()) {
+        std::cout << "Could not copy file: " << sourceFilename << std::endl;
+        return false;
+    }
+    target << source.rdbuf();
+    return true;
+}
+
+/*!
+ * \brief MainWindow::waitImageLoaded
+ *
+ * waits until on image loaded callbacks of both images
+ * are called count times
+ *
+ * \param count
+ * \param success expected result of the latest callbacks
+ * \return true if callbacks were called and results are success
+ */
+bool MainWindow::waitImageLoaded(int count, bool success)
+{
+    for (size_t i=0;i<500 && (m_imageLoadedCount < count || m_imagePartLoadedCount < count);i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (m_imageLoadedCount != count || m_imagePartLoadedCount != count) {
+        std::cout << "Incorrect image loaded count: " << m_imageLoadedCount << " " << m_imagePartLoadedCount << ", expected: " << count << std::endl;
+        return false;
+    }
+    if (m_imageSuccess != success || m_imagePartSuccess != success) {
+        std::cout << "Incorrect image loaded result: " << m_imageSuccess << " " << m_imagePartSuccess << ", expected: " << success << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MainWindow::setMakeStep(int index)
+{
+    switch (index)
+    {
+    case 1:
+        // missing file fails to load
+        remove(TEST_IMAGE_FILE);
+        m_image.connectOnImageLoaded([&](bool success) {
+            m_imageSuccess = success;
+            m_imageLoadedCount++;
+        });
+        m_imagePart.connectOnImageLoaded([&](bool success) {
+            m_imagePartSuccess = success;
+            m_imagePartLoadedCount++;
+        });
+        m_image.setImage(TEST_IMAGE_FILE);
+        m_imagePart.setImage(TEST_IMAGE_FILE);
+        break;
+    case 2:
+        return waitImageLoaded(1, false);
+    case 3:
+        if (!copyFile(TEST_SOURCE_IMAGE_FILE, TEST_IMAGE_FILE)) {
+            return false;
+        }
+        m_image.setImage(TEST_OTHER_IMAGE_FILE);
+        m_imagePart.setImage(TEST_OTHER_IMAGE_FILE);
+        break;
+    case 4:
+        return waitImageLoaded(2, true);
+    case 5:
+        // failed file is loaded again, when it's set again
+        m_image.setImage(TEST_IMAGE_FILE);
+        m_imagePart.setImage(TEST_IMAGE_FILE);
+        break;
+    case 6:
+        return waitImageLoaded(3, true);
+    default:
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <atomic>
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_image.h>
+#include <item2d/tg_image_part.h>
+
+class TgApplication;
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height, TgApplication *application);
+    ~MainWindow();
+
+    bool setMakeStep(int index);
+
+private:
+    TgApplication *m_application;
+    TgRectangle m_background;
+    TgImage m_image;
+    TgImagePart m_imagePart;
+    std::atomic<int> m_imageLoadedCount;
+    std::atomic<int> m_imagePartLoadedCount;
+    std::atomic<bool> m_imageSuccess;
+    std::atomic<bool> m_imagePartSuccess;
+
+    bool waitImageLoaded(int count, bool success);
+    static bool copyFile(const char *sourceFilename, const char *targetFilename);
+};
+
+#endif
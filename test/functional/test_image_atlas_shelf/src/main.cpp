@@ -0,0 +1,87 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include "../../../../lib/src/image/tg_image_atlas_shelf.h"
+
+static void removeEndOfLineMarks(std::string &text)
+{
+    while (1) {
+        if (text.empty()) {
+            break;
+        }
+        if (text.back() == '\n' || text.back() == '\r') {
+            text.resize(text.size()-1);
+            continue;
+        }
+        break;
+    }
+}
+
+/*!
+ * \brief main
+ * \param argc
+ * \param argv
+ * \return
+ */
+int main(int argc , char *argv[])
+{
+    std::ifstream ordersFile(ORDERS_FILE);
+    if (!ordersFile.is_open()) {
+        std::cout << "Orders file is missing\n";
+        return 1;
+    }
+    std::unique_ptr<TgImageAtlasShelf> shelf;
+    std::string line;
+    int32_t lineIndex = 0;
+    while (std::getline(ordersFile, line)) {
+        lineIndex++;
+        removeEndOfLineMarks(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.compare(0, strlen("Page: "), "Page: ") == 0) {
+            shelf.reset(new TgImageAtlasShelf(std::stoi(line.substr(strlen("Page: ")))));
+            continue;
+        }
+        if (!shelf) {
+            std::cout << "Page is missing, Line: " << lineIndex << std::endl;
+            return 1;
+        }
+        if (line.compare(0, strlen("Reserve: "), "Reserve: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Reserve: ")));
+            int width, height, expectedX, expectedY, x = -1, y = -1;
+            if (!(stream >> width >> height >> expectedX >> expectedY)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            if (!shelf->reserveArea(width, height, x, y)) {
+                std::cout << "Area was not reserved, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            if (x != expectedX || y != expectedY) {
+                std::cout << "Incorrect position " << x << " " << y << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Full: "), "Full: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Full: ")));
+            int width, height, x, y;
+            if (!(stream >> width >> height)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            if (shelf->reserveArea(width, height, x, y)) {
+                std::cout << "Area was reserved on full page, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        std::cout << "Incorrect line: " << line << "\n";
+        return 1;
+    }
+    std::cout << "All tests OK\n";
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include "functional_test_image.h"
+#include "tg_image_load.h"
+
+/*! 256x256 image, it's too large for atlas */
+#define TEST_IMAGE_FILE             IMAGES_DIR "/button/prj-tg-ui-lib-button-normal-selected.png"
+#define TEST_IMAGE_SIZE             256
+/*! image is drawn 1/4 of its size, so mip level 2 is drawn */
+#define TEST_SCALE                  4
+#define TEST_DRAW_SIZE              (TEST_IMAGE_SIZE/TEST_SCALE)
+#define TEST_IMAGE_X                20
+#define TEST_IMAGE_MIPMAPS_X        120
+#define TEST_IMAGE_MIPMAPS_SHARED_X 220
+#define TEST_IMAGE_Y                20
+/*! mip levels are generated by OpenGL driver, so they can be bit different than box filter */
+#define TEST_MAX_DIFFERENCE         8
+
+MainWindow::MainWindow(int width, int height, TgApplication *application) :
+    TgMainWindow(width, height, "Image mipmaps test", width-200, height-200, width+200, height+200),
+    m_application(application),
+    m_background(this, 255, 255, 255),
+    m_image(&m_background, TEST_IMAGE_X, TEST_IMAGE_Y, TEST_DRAW_SIZE, TEST_DRAW_SIZE, TEST_IMAGE_FILE),
+    m_imageMipmaps(&m_background, TEST_IMAGE_MIPMAPS_X, TEST_IMAGE_Y, TEST_DRAW_SIZE, TEST_DRAW_SIZE, TEST_IMAGE_FILE),
+    m_imageMipmapsShared(&m_background, TEST_IMAGE_MIPMAPS_SHARED_X, TEST_IMAGE_Y, TEST_DRAW_SIZE, TEST_DRAW_SIZE, TEST_IMAGE_FILE)
+{
+    // invisible images are not loaded, so they are added into cache one by one
+    m_image.setVisible(false);
+    m_imageMipmaps.setMipmaps(true);
+    m_imageMipmaps.setVisible(false);
+    m_imageMipmapsShared.setMipmaps(true);
+    m_imageMipmapsShared.setVisible(false);
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+/*!
+ * \brief MainWindow::waitImageLoaded
+ *
+ * \param image
+ * \return true if image is loaded
+ */
+bool MainWindow::waitImageLoaded(TgImage *image)
+{
+    for (size_t i=0;i<500 && !image->getImageWidth();i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (image->getImageWidth() != TEST_IMAGE_SIZE) {
+        std::cout << "Image is not loaded" << std::endl;
+        return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return true;
+}
+
+/*!
+ * \brief MainWindow::isCacheChanged
+ *
+ * compares image cache statistics with the previous statistics
+ *
+ * \param imageCountChange expected count of new images in cache
+ * \param missCountChange expected count of new misses
+ * \param hitCountChange expected count of new hits
+ * \return true if statistics are changed as expected
+ */
+bool MainWindow::isCacheChanged(size_t imageCountChange, uint64_t missCountChange, uint64_t hitCountChange)
+{
+    TgImageCacheStatistics statistics = m_application->getImageCacheStatistics();
+    bool ret = statistics.m_imageCount == m_statistics.m_imageCount + imageCountChange
+            && statistics.m_missCount == m_statistics.m_missCount + missCountChange
+            && statistics.m_hitCount == m_statistics.m_hitCount + hitCountChange;
+    if (!ret) {
+        std::cout << "Incorrect image cache, images: " << m_statistics.m_imageCount << " -> " << statistics.m_imageCount
+                  << " misses: " << m_statistics.m_missCount << " -> " << statistics.m_missCount
+                  << " hits: " << m_statistics.m_hitCount << " -> " << statistics.m_hitCount << std::endl;
+    }
+    m_statistics = statistics;
+    return ret;
+}
+
+/*!
+ * \brief MainWindow::isDownscaledImageRendered
+ *
+ * compares drawn image with the reference, that is generated by
+ * box filtering TEST_SCALE x TEST_SCALE pixels of the png (same as mip level),
+ * and blending it on the white background
+ *
+ * \param x x position of the image on window
+ * \param y y position of the image on window
+ * \return true if drawn image is same as the reference
+ */
+bool MainWindow::isDownscaledImageRendered(int x, int y)
+{
+    int width = 0, height = 0;
+    unsigned char *pngData = TgImageLoad::loadPng(TEST_IMAGE_FILE, width, height);
+    if (!pngData || width != TEST_IMAGE_SIZE || height != TEST_IMAGE_SIZE) {
+        std::cout << "Failed to load image: " << TEST_IMAGE_FILE << std::endl;
+        delete[] pngData;
+        return false;
+    }
+    std::vector<uint8_t> reference(TEST_DRAW_SIZE*TEST_DRAW_SIZE*4);
+    int i, j, c, sx, sy;
+    for (j=0;j<TEST_DRAW_SIZE;j++) {
+        for (i=0;i<TEST_DRAW_SIZE;i++) {
+            float sum[4] = { 0, 0, 0, 0 };
+            for (sy=j*TEST_SCALE;sy<(j+1)*TEST_SCALE;sy++) {
+                for (sx=i*TEST_SCALE;sx<(i+1)*TEST_SCALE;sx++) {
+                    for (c=0;c<4;c++) {
+                        sum[c] += static_cast<float>(pngData[(sy*width + sx)*4 + c]);
+                    }
+                }
+            }
+            const float alpha = sum[3]/(TEST_SCALE*TEST_SCALE*255.0f);
+            for (c=0;c<3;c++) {
+                const float color = sum[c]/(TEST_SCALE*TEST_SCALE);
+                reference[static_cast<size_t>((j*TEST_DRAW_SIZE + i)*4 + c)] = static_cast<uint8_t>(color*alpha + 255.0f*(1.0f - alpha) + 0.5f);
+            }
+            reference[static_cast<size_t>((j*TEST_DRAW_SIZE + i)*4 + 3)] = 255;
+        }
+    }
+    delete[] pngData;
+    return FunctionalTestImage::isAreaToEqual(this, reference.data(), x, y, TEST_DRAW_SIZE, TEST_DRAW_SIZE, 1, TEST_MAX_DIFFERENCE);
+}
+
+bool MainWindow::setMakeStep(int index)
+{
+    switch (index)
+    {
+    case 1:
+        m_statistics = m_application->getImageCacheStatistics();
+        m_image.setVisible(true);
+        break;
+    case 2:
+        return waitImageLoaded(&m_image) && isCacheChanged(1, 1, 0);
+    case 3:
+        // same file with mip levels is own image in cache
+        m_imageMipmaps.setVisible(true);
+        break;
+    case 4:
+        return waitImageLoaded(&m_imageMipmaps) && isCacheChanged(1, 1, 0);
+    case 5:
+        // same file with mip levels again is found from cache
+        m_imageMipmapsShared.setVisible(true);
+        break;
+    case 6:
+        return waitImageLoaded(&m_imageMipmapsShared) && isCacheChanged(0, 0, 1);
+    case 7:
+        return isDownscaledImageRendered(TEST_IMAGE_MIPMAPS_X, TEST_IMAGE_Y)
+                && isDownscaledImageRendered(TEST_IMAGE_MIPMAPS_SHARED_X, TEST_IMAGE_Y);
+    default:
+        break;
+    }
+    return true;
+}
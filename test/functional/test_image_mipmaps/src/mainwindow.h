@@ -0,0 +1,32 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <vector>
+#include <cstdint>
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_image.h>
+#include <application/tg_application.h>
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height, TgApplication *application);
+    ~MainWindow();
+
+    bool setMakeStep(int index);
+
+private:
+    TgApplication *m_application;
+    TgRectangle m_background;
+    TgImage m_image;
+    TgImage m_imageMipmaps;
+    TgImage m_imageMipmapsShared;
+    TgImageCacheStatistics m_statistics;
+
+    bool waitImageLoaded(TgImage *image);
+    bool isCacheChanged(size_t imageCountChange, uint64_t missCountChange, uint64_t hitCountChange);
+    bool isDownscaledImageRendered(int x, int y);
+};
+
+#endif
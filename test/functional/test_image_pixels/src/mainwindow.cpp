@@ -0,0 +1,280 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <application/tg_application.h>
+#include "functional_test_image.h"
+#include "tg_image_load.h"
+
+#define TEST_GENERATED_X            20
+#define TEST_GENERATED_Y            20
+#define TEST_GENERATED_WIDTH        64
+#define TEST_GENERATED_HEIGHT       32
+#define TEST_BLOCK_SIZE             8
+
+/*! small image, so it's packed into atlas when it's loaded */
+#define TEST_LOADED_X               120
+#define TEST_LOADED_Y               20
+#define TEST_LOADED_SIZE            64
+#define TEST_LOADED_IMAGE_FILE      IMAGES_DIR "/tooltip/prj-tg-ui-lib-tooltip-background.png"
+
+#define TEST_GENERATED_PIXEL_X      20
+#define TEST_GENERATED_PIXEL_Y      120
+#define TEST_GENERATED_PIXEL_SIZE   32
+/*! other item of same small image, it's not converted by lockPixels(), so it's in atlas when setPixel() is called */
+#define TEST_LOADED_PIXEL_X         120
+#define TEST_LOADED_PIXEL_Y         120
+/*! size of the area of pixels that are set with setPixel() */
+#define TEST_PIXEL_AREA_SIZE        4
+
+MainWindow::MainWindow(int width, int height, TgApplication *application) :
+    TgMainWindow(width, height, "Image pixels test", width-200, height-200, width+200, height+200),
+    m_application(application),
+    m_background(this, 255, 255, 255),
+    m_generatedImage(&m_background, TEST_GENERATED_X, TEST_GENERATED_Y, TEST_GENERATED_WIDTH, TEST_GENERATED_HEIGHT, ""),
+    m_loadedImage(&m_background, TEST_LOADED_X, TEST_LOADED_Y, TEST_LOADED_SIZE, TEST_LOADED_SIZE, TEST_LOADED_IMAGE_FILE),
+    m_generatedImagePixel(&m_background, TEST_GENERATED_PIXEL_X, TEST_GENERATED_PIXEL_Y, TEST_GENERATED_PIXEL_SIZE, TEST_GENERATED_PIXEL_SIZE, ""),
+    m_loadedImagePixel(&m_background, TEST_LOADED_PIXEL_X, TEST_LOADED_PIXEL_Y, TEST_LOADED_SIZE, TEST_LOADED_SIZE, TEST_LOADED_IMAGE_FILE)
+{
+    m_generatedImage.setImage(TEST_GENERATED_WIDTH, TEST_GENERATED_HEIGHT);
+    m_generatedImagePixel.setImage(TEST_GENERATED_PIXEL_SIZE, TEST_GENERATED_PIXEL_SIZE);
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+/*!
+ * \brief MainWindow::writeRows
+ *
+ * writes blocks of colors into rows
+ *
+ * \param pixels RGBA data
+ * \param width width of image
+ * \param rowStart first row to write
+ * \param rowCount count of rows to write
+ * \param colorOffset different offset for each write
+ */
+void MainWindow::writeRows(uint8_t *pixels, uint32_t width, uint32_t rowStart, uint32_t rowCount, uint8_t colorOffset)
+{
+    uint32_t x, y;
+    for (y=rowStart;y<rowStart+rowCount;y++) {
+        for (x=0;x<width;x++) {
+            const uint32_t blockX = x/TEST_BLOCK_SIZE;
+            const uint32_t blockY = y/TEST_BLOCK_SIZE;
+            uint8_t *pixel = pixels + (static_cast<size_t>(y)*width + x)*4;
+            pixel[0] = static_cast<uint8_t>((blockX*30 + colorOffset*7) % 256);
+            pixel[1] = static_cast<uint8_t>((blockY*60 + colorOffset*3) % 256);
+            pixel[2] = static_cast<uint8_t>(((blockX + blockY)%2) ? 220 : 20);
+            pixel[3] = 255;
+        }
+    }
+}
+
+/*!
+ * \brief MainWindow::waitLockPixels
+ *
+ * waits until loaded image is converted for pixel access
+ *
+ * \param image
+ * \param pixels [out] locked pixels, unlockPixels() must be called
+ * \return true if pixels are locked
+ */
+bool MainWindow::waitLockPixels(TgImage *image, uint8_t **pixels)
+{
+    *pixels = image->lockPixels();
+    for (size_t i=0;i<500 && !*pixels;i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        *pixels = image->lockPixels();
+    }
+    if (!*pixels) {
+        std::cout << "Image is not converted for pixel access" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief MainWindow::waitImageLoaded
+ *
+ * waits until image is loaded on render, so it has size for setPixel()
+ *
+ * \param image
+ * \return true if image is loaded
+ */
+bool MainWindow::waitImageLoaded(TgImage *image)
+{
+    for (size_t i=0;i<500 && !image->getImageWidth();i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!image->getImageWidth()) {
+        std::cout << "Image is not loaded" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief MainWindow::setPixels
+ *
+ * sets each pixel of TEST_PIXEL_AREA_SIZE x TEST_PIXEL_AREA_SIZE area with
+ * setPixel() (different color for each pixel), and same pixels into expected image
+ *
+ * \param image
+ * \param expectedImage [in/out] RGBA data of image
+ * \param x x of the area in image
+ * \param y y of the area in image
+ * \param colorOffset different offset for each area
+ * \return true if all pixels were set
+ */
+bool MainWindow::setPixels(TgImage *image, std::vector<uint8_t> &expectedImage, uint32_t x, uint32_t y, uint8_t colorOffset)
+{
+    const uint32_t width = image->getImageWidth();
+    uint32_t i, j;
+    for (j=y;j<y+TEST_PIXEL_AREA_SIZE;j++) {
+        for (i=x;i<x+TEST_PIXEL_AREA_SIZE;i++) {
+            uint8_t *pixel = expectedImage.data() + (static_cast<size_t>(j)*width + i)*4;
+            pixel[0] = static_cast<uint8_t>(colorOffset + i*40);
+            pixel[1] = static_cast<uint8_t>(colorOffset + j*20);
+            pixel[2] = static_cast<uint8_t>(255 - colorOffset);
+            pixel[3] = 255;
+            if (!image->setPixel(i, j, pixel[0], pixel[1], pixel[2])) {
+                std::cout << "Set pixel failed: " << i << "/" << j << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief MainWindow::isImageRendered
+ *
+ * waits that modified rows are uploaded and drawn, and compares
+ * drawn image with expected image
+ *
+ * \param image
+ * \param expectedImage RGBA data of image
+ * \param x x position of the image on window
+ * \param y y position of the image on window
+ * \return true if drawn image is same as expected image
+ */
+bool MainWindow::isImageRendered(TgImage *image, const std::vector<uint8_t> &expectedImage, int x, int y)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const int width = static_cast<int>(image->getImageWidth());
+    const int height = static_cast<int>(image->getImageHeight());
+    if (expectedImage.size() != static_cast<size_t>(width*height*4)) {
+        std::cout << "Incorrect image size: " << width << "x" << height << std::endl;
+        return false;
+    }
+    return FunctionalTestImage::isAreaToEqual(this, expectedImage.data(), x, y, width, height, 1, 1);
+}
+
+bool MainWindow::setMakeStep(int index)
+{
+    uint8_t *pixels;
+    switch (index)
+    {
+    case 1:
+        // all rows of generated image
+        pixels = m_generatedImage.lockPixels();
+        if (!pixels) {
+            std::cout << "Generated image is not available for pixel access" << std::endl;
+            return false;
+        }
+        m_expectedGeneratedImage.assign(TEST_GENERATED_WIDTH*TEST_GENERATED_HEIGHT*4, 0);
+        writeRows(pixels, TEST_GENERATED_WIDTH, 0, TEST_GENERATED_HEIGHT, 0);
+        writeRows(m_expectedGeneratedImage.data(), TEST_GENERATED_WIDTH, 0, TEST_GENERATED_HEIGHT, 0);
+        m_generatedImage.unlockPixels();
+        break;
+    case 2:
+        return isImageRendered(&m_generatedImage, m_expectedGeneratedImage, TEST_GENERATED_X, TEST_GENERATED_Y);
+    case 3:
+        // only modified rows are uploaded
+        pixels = m_generatedImage.lockPixels();
+        if (!pixels) {
+            std::cout << "Generated image is not available for pixel access" << std::endl;
+            return false;
+        }
+        writeRows(pixels, TEST_GENERATED_WIDTH, TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 5);
+        writeRows(m_expectedGeneratedImage.data(), TEST_GENERATED_WIDTH, TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, 5);
+        m_generatedImage.unlockPixels(TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+        break;
+    case 4:
+        return isImageRendered(&m_generatedImage, m_expectedGeneratedImage, TEST_GENERATED_X, TEST_GENERATED_Y);
+    case 5:
+    {
+        // loaded image is not available for pixel access until it's converted on render
+        if (m_loadedImage.lockPixels()) {
+            std::cout << "Loaded image is available for pixel access before it's converted" << std::endl;
+            m_loadedImage.unlockPixels(0, 0);
+            return false;
+        }
+        int width = 0, height = 0;
+        unsigned char *pngData = TgImageLoad::loadPng(TEST_LOADED_IMAGE_FILE, width, height);
+        if (!pngData || width != TEST_LOADED_SIZE || height != TEST_LOADED_SIZE) {
+            std::cout << "Failed to load image: " << TEST_LOADED_IMAGE_FILE << std::endl;
+            delete[] pngData;
+            return false;
+        }
+        m_expectedLoadedImage.assign(pngData, pngData + width*height*4);
+        delete[] pngData;
+        break;
+    }
+    case 6:
+        // top half of the converted image is written, bottom half stays as loaded
+        if (!waitLockPixels(&m_loadedImage, &pixels)) {
+            return false;
+        }
+        if (memcmp(pixels, m_expectedLoadedImage.data(), m_expectedLoadedImage.size()) != 0) {
+            std::cout << "Converted image data is not same as loaded image" << std::endl;
+            m_loadedImage.unlockPixels(0, 0);
+            return false;
+        }
+        writeRows(pixels, TEST_LOADED_SIZE, 0, TEST_LOADED_SIZE/2, 9);
+        writeRows(m_expectedLoadedImage.data(), TEST_LOADED_SIZE, 0, TEST_LOADED_SIZE/2, 9);
+        m_loadedImage.unlockPixels(0, TEST_LOADED_SIZE/2);
+        break;
+    case 7:
+        return isImageRendered(&m_loadedImage, m_expectedLoadedImage, TEST_LOADED_X, TEST_LOADED_Y);
+    case 8:
+        // pixels of transparent generated image, white background is drawn under the other pixels
+        m_expectedGeneratedImagePixel.assign(TEST_GENERATED_PIXEL_SIZE*TEST_GENERATED_PIXEL_SIZE*4, 255);
+        return setPixels(&m_generatedImagePixel, m_expectedGeneratedImagePixel, 3, 5, 0);
+    case 9:
+        return isImageRendered(&m_generatedImagePixel, m_expectedGeneratedImagePixel, TEST_GENERATED_PIXEL_X, TEST_GENERATED_PIXEL_Y);
+    case 10:
+        // only area of the changed pixels is uploaded, earlier pixels stay
+        return setPixels(&m_generatedImagePixel, m_expectedGeneratedImagePixel, 20, 24, 100);
+    case 11:
+        return isImageRendered(&m_generatedImagePixel, m_expectedGeneratedImagePixel, TEST_GENERATED_PIXEL_X, TEST_GENERATED_PIXEL_Y);
+    case 12:
+    {
+        // loaded image is in atlas, it's converted to generated image (copy of loaded data) on render
+        if (!waitImageLoaded(&m_loadedImagePixel)) {
+            return false;
+        }
+        int width = 0, height = 0;
+        unsigned char *pngData = TgImageLoad::loadPng(TEST_LOADED_IMAGE_FILE, width, height);
+        if (!pngData || width != TEST_LOADED_SIZE || height != TEST_LOADED_SIZE) {
+            std::cout << "Failed to load image: " << TEST_LOADED_IMAGE_FILE << std::endl;
+            delete[] pngData;
+            return false;
+        }
+        m_expectedLoadedImagePixel.assign(pngData, pngData + width*height*4);
+        delete[] pngData;
+        return setPixels(&m_loadedImagePixel, m_expectedLoadedImagePixel, 30, 40, 50);
+    }
+    case 13:
+        return isImageRendered(&m_loadedImagePixel, m_expectedLoadedImagePixel, TEST_LOADED_PIXEL_X, TEST_LOADED_PIXEL_Y);
+    case 14:
+        return setPixels(&m_loadedImagePixel, m_expectedLoadedImagePixel, 0, TEST_LOADED_SIZE - TEST_PIXEL_AREA_SIZE, 150);
+    case 15:
+        return isImageRendered(&m_loadedImagePixel, m_expectedLoadedImagePixel, TEST_LOADED_PIXEL_X, TEST_LOADED_PIXEL_Y);
+    default:
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <vector>
+#include <cstdint>
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_image.h>
+
+class TgApplication;
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height, TgApplication *application);
+    ~MainWindow();
+
+    bool setMakeStep(int index);
+
+private:
+    TgApplication *m_application;
+    TgRectangle m_background;
+    TgImage m_generatedImage;
+    TgImage m_loadedImage;
+    TgImage m_generatedImagePixel;
+    TgImage m_loadedImagePixel;
+    std::vector<uint8_t> m_expectedGeneratedImage;
+    std::vector<uint8_t> m_expectedLoadedImage;
+    std::vector<uint8_t> m_expectedGeneratedImagePixel;
+    std::vector<uint8_t> m_expectedLoadedImagePixel;
+
+    bool waitLockPixels(TgImage *image, uint8_t **pixels);
+    bool waitImageLoaded(TgImage *image);
+    bool setPixels(TgImage *image, std::vector<uint8_t> &expectedImage, uint32_t x, uint32_t y, uint8_t colorOffset);
+    bool isImageRendered(TgImage *image, const std::vector<uint8_t> &expectedImage, int x, int y);
+
+    static void writeRows(uint8_t *pixels, uint32_t width, uint32_t rowStart, uint32_t rowCount, uint8_t colorOffset);
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../../../../lib/src/image/tg_image_texture_file.h"
+
+#define TEST_TEXTURE_FILE       "/tmp/functional_test_image_texture_file.tgtex"
+
+/*!
+ * \brief TestImage
+ * RGBA pixels of one level of the test image
+ */
+struct TestImage
+{
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<unsigned char> m_data;
+};
+
+static void removeEndOfLineMarks(std::string &text)
+{
+    while (1) {
+        if (text.empty()) {
+            break;
+        }
+        if (text.back() == '\n' || text.back() == '\r') {
+            text.resize(text.size()-1);
+            continue;
+        }
+        break;
+    }
+}
+
+/*!
+ * \brief generateImage
+ *
+ * \param width
+ * \param height
+ * \return test image
+ */
+static TestImage generateImage(uint32_t width, uint32_t height)
+{
+    TestImage ret;
+    uint32_t x, y;
+    ret.m_width = width;
+    ret.m_height = height;
+    ret.m_data.resize(static_cast<size_t>(width)*height*4);
+    for (y=0;y<height;y++) {
+        for (x=0;x<width;x++) {
+            unsigned char *pixel = ret.m_data.data() + (static_cast<size_t>(y)*width + x)*4;
+            pixel[0] = static_cast<unsigned char>(x*37 + y*5);
+            pixel[1] = static_cast<unsigned char>(y*53);
+            pixel[2] = static_cast<unsigned char>((x*y*29) ^ 0x5a);
+            pixel[3] = static_cast<unsigned char>(255 - x*11);
+        }
+    }
+    return ret;
+}
+
+/*!
+ * \brief downsampleImage
+ *
+ * \param image
+ * \return next mip level of the image, 2x2 pixels are averaged into one
+ * pixel, odd last row and column are left out (size is at least 1x1)
+ */
+static TestImage downsampleImage(const TestImage &image)
+{
+    TestImage ret;
+    uint32_t x, y, c;
+    ret.m_width = std::max<uint32_t>(1, image.m_width/2);
+    ret.m_height = std::max<uint32_t>(1, image.m_height/2);
+    ret.m_data.resize(static_cast<size_t>(ret.m_width)*ret.m_height*4);
+    for (y=0;y<ret.m_height;y++) {
+        const uint32_t y0 = y*2, y1 = std::min(y*2 + 1, image.m_height - 1);
+        for (x=0;x<ret.m_width;x++) {
+            const uint32_t x0 = x*2, x1 = std::min(x*2 + 1, image.m_width - 1);
+            for (c=0;c<4;c++) {
+                ret.m_data[(static_cast<size_t>(y)*ret.m_width + x)*4 + c] = static_cast<unsigned char>(
+                    (image.m_data[(static_cast<size_t>(y0)*image.m_width + x0)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y0)*image.m_width + x1)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y1)*image.m_width + x0)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y1)*image.m_width + x1)*4 + c] + 2)/4);
+            }
+        }
+    }
+    return ret;
+}
+
+/*!
+ * \brief checkLevels
+ *
+ * \param textureFile
+ * \param image level 0 of the test image
+ * \return true if all levels have correct pixels
+ */
+static bool checkLevels(const TgImageTextureFile &textureFile, const TestImage &image)
+{
+    uint32_t level, levelWidth, levelHeight;
+    size_t byteCount = 0;
+    TestImage levelImage = image;
+    for (level=0;level<textureFile.getLevelCount();level++) {
+        const unsigned char *levelData = textureFile.getLevel(level, levelWidth, levelHeight);
+        if (!levelData || levelWidth != levelImage.m_width || levelHeight != levelImage.m_height) {
+            std::cout << "Incorrect size of level " << level << std::endl;
+            return false;
+        }
+        if (memcmp(levelData, levelImage.m_data.data(), levelImage.m_data.size()) != 0) {
+            std::cout << "Incorrect pixels in level " << level << std::endl;
+            return false;
+        }
+        byteCount += levelImage.m_data.size();
+        levelImage = downsampleImage(levelImage);
+    }
+    if (textureFile.getLevel(textureFile.getLevelCount(), levelWidth, levelHeight)) {
+        std::cout << "Level after the last level exists" << std::endl;
+        return false;
+    }
+    if (textureFile.getByteCount() != byteCount) {
+        std::cout << "Incorrect byte count: " << textureFile.getByteCount() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief main
+ * \param argc
+ * \param argv
+ * \return
+ */
+int main(int argc , char *argv[])
+{
+    std::ifstream ordersFile(ORDERS_FILE);
+    if (!ordersFile.is_open()) {
+        std::cout << "Orders file is missing\n";
+        return 1;
+    }
+    TgImageTextureFile textureFile;
+    TestImage image;
+    std::string line;
+    int32_t lineIndex = 0;
+    while (std::getline(ordersFile, line)) {
+        lineIndex++;
+        removeEndOfLineMarks(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.compare(0, strlen("Write: "), "Write: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Write: ")));
+            uint32_t width, height;
+            int mipmaps;
+            if (!(stream >> width >> height >> mipmaps)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            // file is replaced, so mapping of the previous file is closed first
+            textureFile.close();
+            image = generateImage(width, height);
+            if (!TgImageTextureFile::write(TEST_TEXTURE_FILE, image.m_data.data(), width, height, mipmaps != 0)) {
+                std::cout << "Texture file could not be written, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "Open") {
+            if (!textureFile.open(TEST_TEXTURE_FILE)) {
+                std::cout << "Texture file could not be opened, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "OpenFails") {
+            if (textureFile.open(TEST_TEXTURE_FILE) || textureFile.getLevelCount() != 0) {
+                std::cout << "Invalid texture file was opened, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Size: "), "Size: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Size: ")));
+            uint32_t width, height, levelCount;
+            if (!(stream >> width >> height >> levelCount)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            if (textureFile.getWidth() != width || textureFile.getHeight() != height || textureFile.getLevelCount() != levelCount) {
+                std::cout << "Incorrect size: " << textureFile.getWidth() << " " << textureFile.getHeight()
+                          << " " << textureFile.getLevelCount() << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Level: "), "Level: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Level: ")));
+            uint32_t level, width, height, levelWidth = 0, levelHeight = 0;
+            if (!(stream >> level >> width >> height)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            if (!textureFile.getLevel(level, levelWidth, levelHeight) || levelWidth != width || levelHeight != height) {
+                std::cout << "Incorrect level size: " << levelWidth << " " << levelHeight << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "Levels") {
+            if (!checkLevels(textureFile, image)) {
+                std::cout << "Incorrect levels, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Truncate: "), "Truncate: ") == 0) {
+            struct stat fileStat;
+            if (stat(TEST_TEXTURE_FILE, &fileStat) != 0
+                || truncate(TEST_TEXTURE_FILE, fileStat.st_size - std::stoi(line.substr(strlen("Truncate: ")))) != 0) {
+                std::cout << "Texture file could not be truncated, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        std::cout << "Incorrect line: " << line << "\n";
+        return 1;
+    }
+    textureFile.close();
+    unlink(TEST_TEXTURE_FILE);
+    std::cout << "All tests OK\n";
+    return 0;
+}
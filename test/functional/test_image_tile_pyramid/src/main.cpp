@@ -0,0 +1,416 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <png.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../../../../lib/src/image/tg_image_tile_pyramid.h"
+
+#define TEST_DIRECTORY          "/tmp/functional_test_image_tile_pyramid"
+#define TEST_CACHE_DIRECTORY    TEST_DIRECTORY "/cache"
+
+/*!
+ * \brief TestImage
+ * RGBA pixels of one level of the test image
+ */
+struct TestImage
+{
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<unsigned char> m_data;
+};
+
+static void removeEndOfLineMarks(std::string &text)
+{
+    while (1) {
+        if (text.empty()) {
+            break;
+        }
+        if (text.back() == '\n' || text.back() == '\r') {
+            text.resize(text.size()-1);
+            continue;
+        }
+        break;
+    }
+}
+
+/*!
+ * \brief removeDirectory
+ *
+ * removes files of the directory and the directory
+ *
+ * \param directory
+ */
+static void removeDirectory(const std::string &directory)
+{
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) {
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        if (entry->d_type == DT_DIR) {
+            removeDirectory(directory + "/" + name);
+        } else {
+            unlink((directory + "/" + name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+/*!
+ * \brief getFileCount
+ *
+ * \param directory
+ * \param fileSuffix
+ * \return number of files that end with fileSuffix
+ */
+static size_t getFileCount(const std::string &directory, const std::string &fileSuffix)
+{
+    size_t ret = 0;
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) {
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() > fileSuffix.size()
+            && name.compare(name.size() - fileSuffix.size(), fileSuffix.size(), fileSuffix) == 0) {
+            ret++;
+        }
+    }
+    closedir(dir);
+    return ret;
+}
+
+/*!
+ * \brief getFileList
+ *
+ * \param directory
+ * \param fileSuffix
+ * \return name and inode of each file that ends with fileSuffix, sorted by name
+ */
+static std::vector<std::pair<std::string, ino_t>> getFileList(const std::string &directory, const std::string &fileSuffix)
+{
+    std::vector<std::pair<std::string, ino_t>> ret;
+    DIR *dir = opendir(directory.c_str());
+    if (!dir) {
+        return ret;
+    }
+    struct dirent *entry;
+    struct stat st;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() > fileSuffix.size()
+            && name.compare(name.size() - fileSuffix.size(), fileSuffix.size(), fileSuffix) == 0
+            && stat((directory + "/" + name).c_str(), &st) == 0) {
+            ret.push_back(std::make_pair(name, st.st_ino));
+        }
+    }
+    closedir(dir);
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+/*!
+ * \brief generateImage
+ *
+ * \param width
+ * \param height
+ * \param version version of the image, each version has different pixels
+ * \return test image
+ */
+static TestImage generateImage(uint32_t width, uint32_t height, uint32_t version)
+{
+    TestImage ret;
+    uint32_t x, y;
+    ret.m_width = width;
+    ret.m_height = height;
+    ret.m_data.resize(static_cast<size_t>(width)*height*4);
+    for (y=0;y<height;y++) {
+        for (x=0;x<width;x++) {
+            unsigned char *pixel = ret.m_data.data() + (static_cast<size_t>(y)*width + x)*4;
+            pixel[0] = static_cast<unsigned char>(x*7 + y + version);
+            pixel[1] = static_cast<unsigned char>(y*3 + version*11);
+            pixel[2] = static_cast<unsigned char>(x ^ y);
+            pixel[3] = static_cast<unsigned char>(128 + (x & 127));
+        }
+    }
+    return ret;
+}
+
+/*!
+ * \brief downsampleImage
+ *
+ * \param image
+ * \return next level of the image, 2x2 pixels are averaged into one pixel
+ * and pixels of the last odd column and row are used twice
+ */
+static TestImage downsampleImage(const TestImage &image)
+{
+    TestImage ret;
+    uint32_t x, y, c;
+    ret.m_width = (image.m_width + 1)/2;
+    ret.m_height = (image.m_height + 1)/2;
+    ret.m_data.resize(static_cast<size_t>(ret.m_width)*ret.m_height*4);
+    for (y=0;y<ret.m_height;y++) {
+        const uint32_t y0 = y*2, y1 = std::min(y*2 + 1, image.m_height - 1);
+        for (x=0;x<ret.m_width;x++) {
+            const uint32_t x0 = x*2, x1 = std::min(x*2 + 1, image.m_width - 1);
+            for (c=0;c<4;c++) {
+                ret.m_data[(static_cast<size_t>(y)*ret.m_width + x)*4 + c] = static_cast<unsigned char>(
+                    (image.m_data[(static_cast<size_t>(y0)*image.m_width + x0)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y0)*image.m_width + x1)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y1)*image.m_width + x0)*4 + c]
+                     + image.m_data[(static_cast<size_t>(y1)*image.m_width + x1)*4 + c] + 2)/4);
+            }
+        }
+    }
+    return ret;
+}
+
+/*!
+ * \brief writePng
+ *
+ * \param filename
+ * \param image
+ * \return true if png is written
+ */
+static bool writePng(const std::string &filename, const TestImage &image)
+{
+    uint32_t y;
+    FILE *fp = fopen(filename.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info || setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        fclose(fp);
+        return false;
+    }
+    png_init_io(png, fp);
+    png_set_IHDR(png, info, image.m_width, image.m_height, 8, PNG_COLOR_TYPE_RGBA,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (y=0;y<image.m_height;y++) {
+        png_write_row(png, image.m_data.data() + static_cast<size_t>(y)*image.m_width*4);
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return fclose(fp) == 0;
+}
+
+/*!
+ * \brief checkTiles
+ *
+ * \param pyramid
+ * \param image level 0 of the test image
+ * \return true if all tiles of all levels have correct pixels
+ */
+static bool checkTiles(const TgImageTilePyramid &pyramid, const TestImage &image)
+{
+    uint32_t level, tileX, tileY, y, tileWidth, tileHeight;
+    TestImage levelImage = image;
+    for (level=0;level<pyramid.getLevelCount();level++) {
+        if (pyramid.getLevelWidth(level) != levelImage.m_width
+            || pyramid.getLevelHeight(level) != levelImage.m_height) {
+            std::cout << "Incorrect size of level " << level << std::endl;
+            return false;
+        }
+        for (tileY=0;tileY<pyramid.getTileCountY(level);tileY++) {
+            for (tileX=0;tileX<pyramid.getTileCountX(level);tileX++) {
+                const unsigned char *tile = pyramid.getTile(level, tileX, tileY, tileWidth, tileHeight);
+                if (!tile) {
+                    std::cout << "Tile is missing " << level << " " << tileX << " " << tileY << std::endl;
+                    return false;
+                }
+                for (y=0;y<tileHeight;y++) {
+                    const size_t imageOffset = ((static_cast<size_t>(tileY)*TG_IMAGE_TILE_SIZE + y)*levelImage.m_width
+                                                + static_cast<size_t>(tileX)*TG_IMAGE_TILE_SIZE)*4;
+                    if (memcmp(tile + static_cast<size_t>(y)*tileWidth*4, levelImage.m_data.data() + imageOffset,
+                               static_cast<size_t>(tileWidth)*4) != 0) {
+                        std::cout << "Incorrect pixels in tile " << level << " " << tileX << " " << tileY << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+        levelImage = downsampleImage(levelImage);
+    }
+    uint32_t topTileWidth, topTileHeight;
+    if (pyramid.getTile(pyramid.getLevelCount()-1, 1, 0, topTileWidth, topTileHeight)
+        || pyramid.getTile(pyramid.getLevelCount(), 0, 0, topTileWidth, topTileHeight)) {
+        std::cout << "Tile outside of the image exists" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief main
+ * \param argc
+ * \param argv
+ * \return
+ */
+int main(int argc , char *argv[])
+{
+    std::ifstream ordersFile(ORDERS_FILE);
+    if (!ordersFile.is_open()) {
+        std::cout << "Orders file is missing\n";
+        return 1;
+    }
+    removeDirectory(TEST_DIRECTORY);
+    if (mkdir(TEST_DIRECTORY, 0755) != 0) {
+        std::cout << "Test directory could not be created\n";
+        return 1;
+    }
+    TgImageTilePyramid pyramid;
+    std::vector<std::pair<std::string, TestImage>> listImage;
+    TestImage openedImage;
+    std::vector<std::pair<std::string, ino_t>> listSavedCacheFile;
+    uint64_t cacheMaxSize = TG_IMAGE_TILE_PYRAMID_DEFAULT_CACHE_MAX_SIZE;
+    uint32_t version = 0;
+    std::string line;
+    int32_t lineIndex = 0;
+    while (std::getline(ordersFile, line)) {
+        lineIndex++;
+        removeEndOfLineMarks(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.compare(0, strlen("Image: "), "Image: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Image: ")));
+            std::string name;
+            uint32_t width, height;
+            if (!(stream >> name >> width >> height)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            version++;
+            TestImage image = generateImage(width, height, version);
+            std::string filename = std::string(TEST_DIRECTORY) + "/" + name + ".png";
+            // each version has different modified time, even if they are written on same second
+            struct timespec times[2];
+            times[0].tv_sec = times[1].tv_sec = 1000000000 + version;
+            times[0].tv_nsec = times[1].tv_nsec = 0;
+            if (!writePng(filename, image) || utimensat(AT_FDCWD, filename.c_str(), times, 0) != 0) {
+                std::cout << "Png could not be written, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            size_t i;
+            for (i=0;i<listImage.size() && listImage[i].first != name;i++) {
+            }
+            if (i == listImage.size()) {
+                listImage.push_back(std::make_pair(name, image));
+            } else {
+                listImage[i].second = image;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Open: "), "Open: ") == 0) {
+            std::string name = line.substr(strlen("Open: "));
+            size_t i;
+            for (i=0;i<listImage.size() && listImage[i].first != name;i++) {
+            }
+            if (i == listImage.size()
+                || !pyramid.open(std::string(TEST_DIRECTORY) + "/" + name + ".png", TEST_CACHE_DIRECTORY, cacheMaxSize)) {
+                std::cout << "Tile pyramid could not be opened, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            openedImage = listImage[i].second;
+            continue;
+        }
+        if (line.compare(0, strlen("Size: "), "Size: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Size: ")));
+            uint32_t width, height, levelCount;
+            if (!(stream >> width >> height >> levelCount)) {
+                std::cout << "Incorrect line: " << line << "\n";
+                return 1;
+            }
+            if (pyramid.getWidth() != width || pyramid.getHeight() != height || pyramid.getLevelCount() != levelCount) {
+                std::cout << "Incorrect size: " << pyramid.getWidth() << " " << pyramid.getHeight()
+                          << " " << pyramid.getLevelCount() << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "Tiles") {
+            if (!checkTiles(pyramid, openedImage)) {
+                std::cout << "Incorrect tiles, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("CacheMaxSize: "), "CacheMaxSize: ") == 0) {
+            cacheMaxSize = std::stoull(line.substr(strlen("CacheMaxSize: ")));
+            continue;
+        }
+        if (line.compare(0, strlen("CacheFiles: "), "CacheFiles: ") == 0) {
+            size_t count = getFileCount(TEST_CACHE_DIRECTORY, ".tgtiles");
+            if (count != std::stoul(line.substr(strlen("CacheFiles: ")))) {
+                std::cout << "Incorrect cache file count: " << count << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "OrphanTmpFile") {
+            std::string filename = std::string(TEST_CACHE_DIRECTORY) + "/orphan.tgtiles.1.tmp";
+            std::ofstream tmpFile(filename);
+            tmpFile << "orphan";
+            tmpFile.close();
+            struct timespec times[2];
+            times[0].tv_sec = times[1].tv_sec = time(nullptr) - 2*3600;
+            times[0].tv_nsec = times[1].tv_nsec = 0;
+            if (utimensat(AT_FDCWD, filename.c_str(), times, 0) != 0) {
+                std::cout << "Temporary file could not be written, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("TmpFiles: "), "TmpFiles: ") == 0) {
+            size_t count = getFileCount(TEST_CACHE_DIRECTORY, ".tmp");
+            if (count != std::stoul(line.substr(strlen("TmpFiles: ")))) {
+                std::cout << "Incorrect temporary file count: " << count << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line == "SaveCacheFiles") {
+            listSavedCacheFile = getFileList(TEST_CACHE_DIRECTORY, ".tgtiles");
+            continue;
+        }
+        if (line == "SameCacheFiles") {
+            // built file is renamed from temporary file, so it would have other inode
+            if (getFileList(TEST_CACHE_DIRECTORY, ".tgtiles") != listSavedCacheFile) {
+                std::cout << "Cache files are changed, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Sleep: "), "Sleep: ") == 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(std::stoi(line.substr(strlen("Sleep: ")))));
+            continue;
+        }
+        std::cout << "Incorrect line: " << line << "\n";
+        return 1;
+    }
+    pyramid.close();
+    removeDirectory(TEST_DIRECTORY);
+    std::cout << "All tests OK\n";
+    return 0;
+}
@@ -0,0 +1,384 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <application/tg_application.h>
+#include "functional_test_image.h"
+
+#define TEST_RGBA_X                 20
+#define TEST_RGBA_Y                 20
+#define TEST_RGBA_WIDTH             64
+#define TEST_RGBA_HEIGHT            32
+#define TEST_RGBA_ROW_PADDING       36
+#define TEST_BLOCK_SIZE             8
+
+/*! odd size, so chroma planes are rounded up (33x17) */
+#define TEST_YUV_X                  20
+#define TEST_YUV_Y                  100
+#define TEST_YUV_WIDTH              65
+#define TEST_YUV_HEIGHT             33
+
+#define TEST_Y                      150
+#define TEST_U                      90
+#define TEST_V                      200
+/*! chroma of the last (rounded up) column and row of the chroma planes */
+#define TEST_EDGE_U                 200
+#define TEST_EDGE_V                 60
+/*! value of the bytes after the rows, they must not be drawn */
+#define TEST_PADDING                255
+
+#define TEST_FRAME_INDEX_RGBA       0
+#define TEST_FRAME_INDEX_BURST      1
+#define TEST_FRAME_INDEX_NV12       (TEST_FRAME_INDEX_BURST + TEST_BURST_FRAME_COUNT)
+#define TEST_FRAME_INDEX_I420       (TEST_FRAME_INDEX_NV12 + 1)
+#define TEST_FRAME_INDEX_DELETE     (TEST_FRAME_INDEX_I420 + 1)
+
+MainWindow::MainWindow(int width, int height, TgApplication *application) :
+    TgMainWindow(width, height, "Stream image test", width-200, height-200, width+200, height+200),
+    m_application(application),
+    m_background(this, 255, 255, 255),
+    m_streamImage(&m_background, TEST_RGBA_X, TEST_RGBA_Y, TEST_RGBA_WIDTH, TEST_RGBA_HEIGHT),
+    m_streamImageYuv(&m_background, TEST_YUV_X, TEST_YUV_Y, TEST_YUV_WIDTH, TEST_YUV_HEIGHT)
+{
+    for (size_t i=0;i<TEST_FRAME_COUNT;i++) {
+        m_releaseCount[i] = 0;
+    }
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+/*!
+ * \brief MainWindow::getBlockColor
+ *
+ * \param x x of pixel
+ * \param y y of pixel
+ * \param colorOffset different offset for each frame
+ * \param r [out]
+ * \param g [out]
+ * \param b [out]
+ */
+void MainWindow::getBlockColor(uint32_t x, uint32_t y, uint8_t colorOffset, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    const uint32_t blockX = x/TEST_BLOCK_SIZE;
+    const uint32_t blockY = y/TEST_BLOCK_SIZE;
+    r = static_cast<uint8_t>((blockX*30 + colorOffset*7) % 256);
+    g = static_cast<uint8_t>((blockY*60 + colorOffset*3) % 256);
+    b = static_cast<uint8_t>(((blockX + blockY)%2) ? 220 : 20);
+}
+
+/*!
+ * \brief MainWindow::getYuvColor
+ *
+ * converts yuv to rgb same way as the shader does
+ *
+ * \param y
+ * \param u
+ * \param v
+ * \param r [out]
+ * \param g [out]
+ * \param b [out]
+ */
+void MainWindow::getYuvColor(uint8_t y, uint8_t u, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    const float yf = 1.1643f*(static_cast<float>(y)/255.0f - 0.0625f);
+    const float uf = static_cast<float>(u)/255.0f - 0.5f;
+    const float vf = static_cast<float>(v)/255.0f - 0.5f;
+    const float rgb[3] = { yf + 1.5958f*vf, yf - 0.39173f*uf - 0.8129f*vf, yf + 2.017f*uf };
+    uint8_t *ret[3] = { &r, &g, &b };
+    for (size_t i=0;i<3;i++) {
+        *ret[i] = static_cast<uint8_t>(std::lround(std::fmin(std::fmax(rgb[i], 0.0f), 1.0f)*255.0f));
+    }
+}
+
+/*!
+ * \brief MainWindow::generateRgbaFrame
+ *
+ * generates RGBA frame of color blocks, and expected (tightly packed) image of it
+ *
+ * \param frameIndex index of frame, frame buffer and release counter
+ * \param width
+ * \param height
+ * \param stride bytes per row, 0 if rows are tightly packed, padding bytes are TEST_PADDING
+ * \param colorOffset different offset for each frame
+ * \return frame
+ */
+TgStreamImageFrame MainWindow::generateRgbaFrame(size_t frameIndex, uint32_t width, uint32_t height, uint32_t stride, uint8_t colorOffset)
+{
+    const size_t rowSize = static_cast<size_t>(width)*4;
+    const size_t frameStride = stride ? stride : rowSize;
+    uint32_t x, y;
+    m_listFrameData[frameIndex].assign(frameStride*height, TEST_PADDING);
+    m_expectedImage.assign(rowSize*height, 255);
+    for (y=0;y<height;y++) {
+        for (x=0;x<width;x++) {
+            uint8_t *pixel = m_listFrameData[frameIndex].data() + y*frameStride + x*4;
+            getBlockColor(x, y, colorOffset, pixel[0], pixel[1], pixel[2]);
+            pixel[3] = 255;
+            memcpy(m_expectedImage.data() + y*rowSize + x*4, pixel, 4);
+        }
+    }
+    TgStreamImageFrame frame;
+    frame.m_format = TgStreamImageFormat::StreamImageFormatRGBA;
+    frame.m_width = width;
+    frame.m_height = height;
+    frame.m_plane[0] = m_listFrameData[frameIndex].data();
+    frame.m_stride[0] = stride;
+    frame.f_release = [this, frameIndex]() {
+        m_releaseCount[frameIndex]++;
+    };
+    return frame;
+}
+
+/*!
+ * \brief MainWindow::generateYuvFrame
+ *
+ * generates NV12 or I420 frame, planes follow each other in one buffer and
+ * each plane has only its own size (chroma planes are rounded up), so incorrect
+ * plane size would draw bytes of the next plane
+ *
+ * \param frameIndex index of frame, frame buffer and release counter
+ * \param format StreamImageFormatNV12 or StreamImageFormatI420
+ * \param width
+ * \param height
+ * \param stride bytes per row of each plane, 0 if rows are tightly packed
+ * \return frame
+ */
+TgStreamImageFrame MainWindow::generateYuvFrame(size_t frameIndex, TgStreamImageFormat format, uint32_t width, uint32_t height, const uint32_t stride[3])
+{
+    const size_t planeCount = format == TgStreamImageFormat::StreamImageFormatNV12 ? 2 : 3;
+    const uint32_t chromaWidth = (width + 1)/2;
+    const uint32_t chromaHeight = (height + 1)/2;
+    size_t plane, planeOffset[3], planeStride[3], planeHeight[3];
+    size_t size = 0;
+    uint32_t x, y;
+    for (plane=0;plane<planeCount;plane++) {
+        const size_t rowSize = plane ? static_cast<size_t>(chromaWidth)*(planeCount == 2 ? 2 : 1) : width;
+        planeStride[plane] = stride[plane] ? stride[plane] : rowSize;
+        planeHeight[plane] = plane ? chromaHeight : height;
+        planeOffset[plane] = size;
+        size += planeStride[plane]*planeHeight[plane];
+    }
+    m_listFrameData[frameIndex].assign(size, TEST_PADDING);
+    uint8_t *data = m_listFrameData[frameIndex].data();
+    for (y=0;y<height;y++) {
+        for (x=0;x<width;x++) {
+            data[planeOffset[0] + y*planeStride[0] + x] = TEST_Y;
+        }
+    }
+    for (y=0;y<chromaHeight;y++) {
+        for (x=0;x<chromaWidth;x++) {
+            const bool edge = x == chromaWidth-1 || y == chromaHeight-1;
+            const uint8_t u = edge ? TEST_EDGE_U : TEST_U;
+            const uint8_t v = edge ? TEST_EDGE_V : TEST_V;
+            if (planeCount == 2) {
+                data[planeOffset[1] + y*planeStride[1] + x*2] = u;
+                data[planeOffset[1] + y*planeStride[1] + x*2 + 1] = v;
+            } else {
+                data[planeOffset[1] + y*planeStride[1] + x] = u;
+                data[planeOffset[2] + y*planeStride[2] + x] = v;
+            }
+        }
+    }
+    TgStreamImageFrame frame;
+    frame.m_format = format;
+    frame.m_width = width;
+    frame.m_height = height;
+    for (plane=0;plane<planeCount;plane++) {
+        frame.m_plane[plane] = data + planeOffset[plane];
+        frame.m_stride[plane] = stride[plane];
+    }
+    frame.f_release = [this, frameIndex]() {
+        m_releaseCount[frameIndex]++;
+    };
+    return frame;
+}
+
+/*!
+ * \brief MainWindow::waitFrames
+ *
+ * waits until frameCount frames are received, and all of them are
+ * either shown or dropped (none is waiting for upload)
+ *
+ * \param streamImage
+ * \param frameCount
+ * \return true if frames are handled
+ */
+bool MainWindow::waitFrames(TgStreamImage *streamImage, uint64_t frameCount)
+{
+    TgStreamImageStatistics statistics = streamImage->getStatistics();
+    for (size_t i=0;i<500 && statistics.m_shownFrameCount + statistics.m_droppedFrameCount < frameCount;i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        statistics = streamImage->getStatistics();
+    }
+    if (statistics.m_receivedFrameCount != frameCount
+        || statistics.m_shownFrameCount + statistics.m_droppedFrameCount != frameCount) {
+        std::cout << "Incorrect frame count: received " << statistics.m_receivedFrameCount
+                  << " shown " << statistics.m_shownFrameCount << " dropped " << statistics.m_droppedFrameCount
+                  << ", expected: " << frameCount << std::endl;
+        return false;
+    }
+    // texture is uploaded before rendering, wait that frame is on the window
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return true;
+}
+
+/*!
+ * \brief MainWindow::isReleasedOnce
+ *
+ * \param firstFrameIndex
+ * \param lastFrameIndex
+ * \return true if f_release of each frame is called exactly once
+ */
+bool MainWindow::isReleasedOnce(size_t firstFrameIndex, size_t lastFrameIndex)
+{
+    for (size_t i=firstFrameIndex;i<=lastFrameIndex;i++) {
+        if (m_releaseCount[i] != 1) {
+            std::cout << "Incorrect release count of frame " << i << ": " << m_releaseCount[i] << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief MainWindow::isYuvRendered
+ *
+ * checks that YUV frame is drawn with the main chroma, and the bottom right
+ * pixel with the chroma of the last (rounded up) column and row of chroma planes
+ *
+ * \param format
+ * \return true if YUV frame is drawn correctly
+ */
+bool MainWindow::isYuvRendered(TgStreamImageFormat format)
+{
+    // chroma of the right and bottom edge is filtered with the main chroma, so they are not compared
+    const int width = TEST_YUV_WIDTH - 4;
+    const int height = TEST_YUV_HEIGHT - 4;
+    uint8_t r, g, b;
+    getYuvColor(TEST_Y, TEST_U, TEST_V, r, g, b);
+    m_expectedImage.resize(static_cast<size_t>(width*height*4));
+    for (size_t i=0;i<static_cast<size_t>(width*height);i++) {
+        m_expectedImage[i*4] = r;
+        m_expectedImage[i*4+1] = g;
+        m_expectedImage[i*4+2] = b;
+        m_expectedImage[i*4+3] = 255;
+    }
+    if (!FunctionalTestImage::isAreaToEqual(this, m_expectedImage.data(), TEST_YUV_X, TEST_YUV_Y, width, height, 1, 3)) {
+        std::cout << "Incorrect YUV frame, format: " << format << std::endl;
+        return false;
+    }
+    getYuvColor(TEST_Y, TEST_EDGE_U, TEST_EDGE_V, m_expectedImage[0], m_expectedImage[1], m_expectedImage[2]);
+    if (!FunctionalTestImage::isAreaToEqual(this, m_expectedImage.data(),
+                                            TEST_YUV_X + TEST_YUV_WIDTH - 1, TEST_YUV_Y + TEST_YUV_HEIGHT - 1, 1, 1, 1, 3)) {
+        std::cout << "Incorrect last chroma pixel of YUV frame, format: " << format << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MainWindow::setMakeStep(int index)
+{
+    switch (index)
+    {
+    case 1:
+        // rows have padding, so they are repacked before upload
+        if (!m_streamImage.pushFrame(generateRgbaFrame(TEST_FRAME_INDEX_RGBA, TEST_RGBA_WIDTH, TEST_RGBA_HEIGHT,
+                                                       TEST_RGBA_WIDTH*4 + TEST_RGBA_ROW_PADDING, 0))) {
+            std::cout << "RGBA frame is not accepted" << std::endl;
+            return false;
+        }
+        break;
+    case 2:
+        if (!waitFrames(&m_streamImage, 1) || !isReleasedOnce(TEST_FRAME_INDEX_RGBA, TEST_FRAME_INDEX_RGBA)) {
+            return false;
+        }
+        return FunctionalTestImage::isAreaToEqual(this, m_expectedImage.data(), TEST_RGBA_X, TEST_RGBA_Y,
+                                                  TEST_RGBA_WIDTH, TEST_RGBA_HEIGHT, TEST_BLOCK_SIZE, 1);
+    case 3:
+        // frames are pushed faster than they can be rendered
+        m_streamImage.resetStatistics();
+        for (size_t i=0;i<TEST_BURST_FRAME_COUNT;i++) {
+            if (!m_streamImage.pushFrame(generateRgbaFrame(TEST_FRAME_INDEX_BURST + i, TEST_RGBA_WIDTH, TEST_RGBA_HEIGHT,
+                                                           0, static_cast<uint8_t>(i + 1)))) {
+                std::cout << "RGBA frame is not accepted" << std::endl;
+                return false;
+            }
+        }
+        break;
+    case 4:
+    {
+        if (!waitFrames(&m_streamImage, TEST_BURST_FRAME_COUNT)
+            || !isReleasedOnce(TEST_FRAME_INDEX_BURST, TEST_FRAME_INDEX_BURST + TEST_BURST_FRAME_COUNT - 1)) {
+            return false;
+        }
+        TgStreamImageStatistics statistics = m_streamImage.getStatistics();
+        if (!statistics.m_droppedFrameCount || !statistics.m_shownFrameCount) {
+            std::cout << "Incorrect dropped frame count: " << statistics.m_droppedFrameCount
+                      << " shown: " << statistics.m_shownFrameCount << std::endl;
+            return false;
+        }
+        // newest frame is shown (m_expectedImage is from the last generated frame)
+        return FunctionalTestImage::isAreaToEqual(this, m_expectedImage.data(), TEST_RGBA_X, TEST_RGBA_Y,
+                                                  TEST_RGBA_WIDTH, TEST_RGBA_HEIGHT, TEST_BLOCK_SIZE, 1);
+    }
+    case 5:
+    {
+        // padding after luma rows, chroma rows are tightly packed
+        const uint32_t stride[3] = { TEST_YUV_WIDTH + 3, 0, 0 };
+        if (!m_streamImageYuv.pushFrame(generateYuvFrame(TEST_FRAME_INDEX_NV12, TgStreamImageFormat::StreamImageFormatNV12,
+                                                         TEST_YUV_WIDTH, TEST_YUV_HEIGHT, stride))) {
+            std::cout << "NV12 frame is not accepted" << std::endl;
+            return false;
+        }
+        break;
+    }
+    case 6:
+        return waitFrames(&m_streamImageYuv, 1)
+                && isReleasedOnce(TEST_FRAME_INDEX_NV12, TEST_FRAME_INDEX_NV12)
+                && isYuvRendered(TgStreamImageFormat::StreamImageFormatNV12);
+    case 7:
+    {
+        // padding after U rows
+        const uint32_t stride[3] = { 0, (TEST_YUV_WIDTH + 1)/2 + 5, 0 };
+        if (!m_streamImageYuv.pushFrame(generateYuvFrame(TEST_FRAME_INDEX_I420, TgStreamImageFormat::StreamImageFormatI420,
+                                                         TEST_YUV_WIDTH, TEST_YUV_HEIGHT, stride))) {
+            std::cout << "I420 frame is not accepted" << std::endl;
+            return false;
+        }
+        break;
+    }
+    case 8:
+        return waitFrames(&m_streamImageYuv, 2)
+                && isReleasedOnce(TEST_FRAME_INDEX_I420, TEST_FRAME_INDEX_I420)
+                && isYuvRendered(TgStreamImageFormat::StreamImageFormatI420);
+    case 9:
+    {
+        // stream image without parent is never rendered, so frame is waiting for upload when it's deleted
+        TgStreamImage *streamImage = new TgStreamImage(nullptr, 0, 0, 4, 4);
+        streamImage->pushFrame(generateRgbaFrame(TEST_FRAME_INDEX_DELETE, 4, 4, 0, 0));
+        streamImage->pushFrame(generateRgbaFrame(TEST_FRAME_INDEX_DELETE + 1, 4, 4, 0, 0));
+        TgStreamImageStatistics statistics = streamImage->getStatistics();
+        if (statistics.m_receivedFrameCount != 2 || statistics.m_droppedFrameCount != 1 || statistics.m_shownFrameCount
+            || m_releaseCount[TEST_FRAME_INDEX_DELETE] != 1 || m_releaseCount[TEST_FRAME_INDEX_DELETE + 1] != 0) {
+            std::cout << "Incorrect frames before delete, dropped: " << statistics.m_droppedFrameCount
+                      << " release counts: " << m_releaseCount[TEST_FRAME_INDEX_DELETE]
+                      << " " << m_releaseCount[TEST_FRAME_INDEX_DELETE + 1] << std::endl;
+            delete streamImage;
+            return false;
+        }
+        delete streamImage;
+        return isReleasedOnce(TEST_FRAME_INDEX_DELETE, TEST_FRAME_INDEX_DELETE + 1);
+    }
+    case 10:
+        // nothing is released again later
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return isReleasedOnce(0, TEST_FRAME_INDEX_DELETE + 1);
+    default:
+        break;
+    }
+    return true;
+}
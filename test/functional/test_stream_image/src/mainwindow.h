@@ -0,0 +1,43 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_stream_image.h>
+
+class TgApplication;
+
+#define TEST_FRAME_COUNT            40
+#define TEST_BURST_FRAME_COUNT      30
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height, TgApplication *application);
+    ~MainWindow();
+
+    bool setMakeStep(int index);
+
+private:
+    TgApplication *m_application;
+    std::vector<uint8_t> m_listFrameData[TEST_FRAME_COUNT];             /*!< frame buffers, they are valid until the window is deleted */
+    std::atomic<int> m_releaseCount[TEST_FRAME_COUNT];
+    std::vector<uint8_t> m_expectedImage;
+    TgRectangle m_background;
+    TgStreamImage m_streamImage;
+    TgStreamImage m_streamImageYuv;
+
+    TgStreamImageFrame generateRgbaFrame(size_t frameIndex, uint32_t width, uint32_t height, uint32_t stride, uint8_t colorOffset);
+    TgStreamImageFrame generateYuvFrame(size_t frameIndex, TgStreamImageFormat format, uint32_t width, uint32_t height, const uint32_t stride[3]);
+    bool waitFrames(TgStreamImage *streamImage, uint64_t frameCount);
+    bool isReleasedOnce(size_t firstFrameIndex, size_t lastFrameIndex);
+    bool isYuvRendered(TgStreamImageFormat format);
+
+    static void getBlockColor(uint32_t x, uint32_t y, uint8_t colorOffset, uint8_t &r, uint8_t &g, uint8_t &b);
+    static void getYuvColor(uint8_t y, uint8_t u, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b);
+};
+
+#endif
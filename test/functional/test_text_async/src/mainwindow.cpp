@@ -0,0 +1,83 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <application/tg_application.h>
+
+MainWindow::MainWindow(int width, int height, TgApplication *application) :
+    TgMainWindow(width, height, "Text async test", width-200, height-200, width+200, height+200),
+    m_application(application),
+    m_background(this, 255, 255, 255),
+    m_textfield0(&m_background, 20, 20, 300, 30, "", "", 21, 0, 0, 0),
+    m_textfield1(&m_background, 20, 60, 300, 30, "", "", 21, 0, 0, 0),
+    m_textfield2(&m_background, 20, 100, 300, 30, "", "", 21, 0, 0, 0),
+    m_textfield3(&m_background, 20, 140, 300, 30, "", "", 21, 0, 0, 0),
+    m_listTextfield { &m_textfield0, &m_textfield1, &m_textfield2, &m_textfield3 },
+    m_fontGlyphCacheCount(0)
+{
+    for (size_t i=0;i<TEXT_ASYNC_TEXTFIELD_COUNT;i++) {
+        m_listTextfield[i]->setAsyncTextPreparation(true);
+    }
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+/*!
+ * \brief MainWindow::waitFontGlyphCacheCount
+ *
+ * waits until glyph cache has at least count fonts, and
+ * then some more time, so all prepared texts are uploaded
+ *
+ * \param count
+ * \return true if glyph cache has exactly count fonts
+ */
+bool MainWindow::waitFontGlyphCacheCount(size_t count)
+{
+    for (size_t i=0;i<500 && m_application->getFontGlyphCacheCount() < count;i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (m_application->getFontGlyphCacheCount() != count) {
+        std::cout << "Incorrect font glyph cache count: " << m_application->getFontGlyphCacheCount() << ", expected: " << count << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MainWindow::setMakeStep(int index)
+{
+    size_t i;
+    switch (index)
+    {
+    case 1:
+        // same text is prepared by several worker threads at the same time
+        m_fontGlyphCacheCount = m_application->getFontGlyphCacheCount();
+        for (i=0;i<TEXT_ASYNC_TEXTFIELD_COUNT;i++) {
+            m_listTextfield[i]->setText("Same text on worker threads");
+        }
+        break;
+    case 2:
+        return waitFontGlyphCacheCount(m_fontGlyphCacheCount + 1);
+    case 3:
+        // characters are already in cache
+        for (i=0;i<TEXT_ASYNC_TEXTFIELD_COUNT;i++) {
+            m_listTextfield[i]->setText("Same text");
+        }
+        break;
+    case 4:
+        return waitFontGlyphCacheCount(m_fontGlyphCacheCount + 1);
+    case 5:
+        m_fontGlyphCacheCount = m_application->getFontGlyphCacheCount();
+        for (i=0;i<TEXT_ASYNC_TEXTFIELD_COUNT;i++) {
+            m_listTextfield[i]->setText(i % 2 ? "XYZ 123" : "Q#!");
+        }
+        break;
+    case 6:
+        return waitFontGlyphCacheCount(m_fontGlyphCacheCount + 2);
+    default:
+        break;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_textfield.h>
+
+#define TEXT_ASYNC_TEXTFIELD_COUNT  4
+
+class TgApplication;
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height, TgApplication *application);
+    ~MainWindow();
+
+    bool setMakeStep(int index);
+
+private:
+    TgApplication *m_application;
+    TgRectangle m_background;
+    TgTextfield m_textfield0;
+    TgTextfield m_textfield1;
+    TgTextfield m_textfield2;
+    TgTextfield m_textfield3;
+    TgTextfield *m_listTextfield[TEXT_ASYNC_TEXTFIELD_COUNT];
+    size_t m_fontGlyphCacheCount;
+
+    bool waitFontGlyphCacheCount(size_t count);
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "../../../../lib/src/item2d/private/text_document/tg_text_piece_table.h"
+
+/*!
+ * \brief TestEdit
+ * done edit, so it can be undone
+ */
+struct TestEdit
+{
+    size_t m_offset;
+    std::string m_insertedText;
+    std::string m_removedText;
+};
+
+static void removeEndOfLineMarks(std::string &text)
+{
+    while (1) {
+        if (text.empty()) {
+            break;
+        }
+        if (text.back() == '\n' || text.back() == '\r') {
+            text.resize(text.size()-1);
+            continue;
+        }
+        break;
+    }
+}
+
+static std::string getText(const std::string &text)
+{
+    std::string ret;
+    size_t i;
+    for (i=0;i<text.size();i++) {
+        if (text[i] == '\\' && i+1 < text.size() && text[i+1] == 'n') {
+            ret.push_back('\n');
+            i++;
+            continue;
+        }
+        ret.push_back(text[i]);
+    }
+    return ret;
+}
+
+static std::string getValue(const std::string &line, const char *name)
+{
+    std::string ret = line.substr(strlen(name));
+    if (!ret.empty() && ret.front() == ' ') {
+        ret.erase(0, 1);
+    }
+    return getText(ret);
+}
+
+static int checkLines(const TgTextPieceTable &pieceTable, int32_t lineIndex)
+{
+    std::string text = pieceTable.getText();
+    std::string line;
+    size_t i, lineCount = 1;
+    for (i=0;i<text.size();i++) {
+        if (text[i] == '\n') {
+            if (pieceTable.getLine(lineCount-1) != line) {
+                std::cout << "Incorrect line " << lineCount-1 << ", Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            line.clear();
+            lineCount++;
+            continue;
+        }
+        line.push_back(text[i]);
+    }
+    if (pieceTable.getLine(lineCount-1) != line) {
+        std::cout << "Incorrect last line, Line: " << lineIndex << std::endl;
+        return 1;
+    }
+    if (pieceTable.getLineCount() != lineCount || pieceTable.getLength() != text.size()) {
+        std::cout << "Incorrect line count or length, Line: " << lineIndex << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+ * \brief main
+ * \param argc
+ * \param argv
+ * \return
+ */
+int main(int argc , char *argv[])
+{
+    std::ifstream ordersFile(ORDERS_FILE);
+    if (!ordersFile.is_open()) {
+        std::cout << "Orders file is missing\n";
+        return 1;
+    }
+    TgTextPieceTable pieceTable;
+    std::vector<TestEdit> listEdit;
+    std::string line;
+    int32_t lineIndex = 0;
+    while (std::getline(ordersFile, line)) {
+        lineIndex++;
+        removeEndOfLineMarks(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.compare(0, strlen("SetText:"), "SetText:") == 0) {
+            pieceTable.setText(getValue(line, "SetText:"));
+            listEdit.clear();
+            continue;
+        }
+        if (line.compare(0, strlen("Insert: "), "Insert: ") == 0
+            || line.compare(0, strlen("Remove: "), "Remove: ") == 0) {
+            std::stringstream stream(line.substr(strlen("Insert: ")));
+            size_t textLine, column;
+            TestEdit edit;
+            if (!(stream >> textLine >> column)
+                || !pieceTable.getOffset(textLine, column, edit.m_offset)) {
+                std::cout << "Incorrect position, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            if (line.front() == 'I') {
+                std::string text;
+                stream.get();
+                std::getline(stream, text);
+                edit.m_insertedText = getText(text);
+                pieceTable.insert(edit.m_offset, edit.m_insertedText);
+            } else {
+                size_t characterCount;
+                stream >> characterCount;
+                size_t end = pieceTable.getOffsetAfterCharacters(edit.m_offset, characterCount);
+                edit.m_removedText = pieceTable.getText().substr(edit.m_offset, end - edit.m_offset);
+                pieceTable.remove(edit.m_offset, end - edit.m_offset);
+            }
+            listEdit.push_back(edit);
+            if (checkLines(pieceTable, lineIndex)) {
+                return 1;
+            }
+            continue;
+        }
+        if (line == "Undo") {
+            if (listEdit.empty()) {
+                std::cout << "Nothing to undo, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            const TestEdit &edit = listEdit.back();
+            if (!edit.m_insertedText.empty()) {
+                pieceTable.remove(edit.m_offset, edit.m_insertedText.size());
+            }
+            if (!edit.m_removedText.empty()) {
+                pieceTable.insert(edit.m_offset, edit.m_removedText);
+            }
+            listEdit.pop_back();
+            if (checkLines(pieceTable, lineIndex)) {
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Text:"), "Text:") == 0) {
+            if (pieceTable.getText() != getValue(line, "Text:")) {
+                std::cout << "Incorrect text, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("LineCount: "), "LineCount: ") == 0) {
+            if (pieceTable.getLineCount() != std::stoul(line.substr(strlen("LineCount: ")))) {
+                std::cout << "Incorrect line count, Line: " << lineIndex << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        std::cout << "Incorrect line: " << line << "\n";
+        return 1;
+    }
+    std::cout << "All tests OK\n";
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "../../../../lib/src/font/text/tg_text_transcode_utf8.h"
+
+static void removeEndOfLineMarks(std::string &text)
+{
+    while (1) {
+        if (text.empty()) {
+            break;
+        }
+        if (text.back() == '\n' || text.back() == '\r') {
+            text.resize(text.size()-1);
+            continue;
+        }
+        break;
+    }
+}
+
+static std::vector<uint32_t> getHexValues(const std::string &text)
+{
+    std::vector<uint32_t> ret;
+    std::stringstream stream(text);
+    uint32_t value;
+    while (stream >> std::hex >> value) {
+        ret.push_back(value);
+    }
+    return ret;
+}
+
+static int checkResult(const std::string &text, bool valid, const std::vector<uint32_t> &listExpected, int32_t lineIndex)
+{
+    std::vector<uint32_t> listCharacter;
+    if (TgTextTranscodeUtf8::addUtf8ToUtf32List(text, listCharacter) != valid) {
+        std::cout << "Incorrect validation result, Line: " << lineIndex << std::endl;
+        return 1;
+    }
+    if (!valid) {
+        if (!listCharacter.empty()) {
+            std::cout << "Characters added from invalid text, Line: " << lineIndex << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (listCharacter != listExpected) {
+        std::cout << "Incorrect characters, Line: " << lineIndex << std::endl;
+        return 1;
+    }
+    std::string utf8;
+    TgTextTranscodeUtf8::addUtf32ToUtf8Text(listCharacter.data(), listCharacter.size(), utf8);
+    if (utf8 != text) {
+        std::cout << "Incorrect utf8 text from characters, Line: " << lineIndex << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+ * \brief main
+ * \param argc
+ * \param argv
+ * \return
+ */
+int main(int argc , char *argv[])
+{
+    std::ifstream ordersFile(ORDERS_FILE);
+    if (!ordersFile.is_open()) {
+        std::cout << "Orders file is missing\n";
+        return 1;
+    }
+    std::string line;
+    std::vector<uint32_t> listBytes;
+    size_t repeat = 1, i;
+    int32_t lineIndex = 0;
+    while (std::getline(ordersFile, line)) {
+        lineIndex++;
+        removeEndOfLineMarks(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        if (line.compare(0, strlen("Bytes: "), "Bytes: ") == 0) {
+            listBytes = getHexValues(line.substr(strlen("Bytes: ")));
+            continue;
+        }
+        if (line.compare(0, strlen("Repeat: "), "Repeat: ") == 0) {
+            repeat = std::stoul(line.substr(strlen("Repeat: ")));
+            continue;
+        }
+        std::string text;
+        for (i=0;i<listBytes.size()*repeat;i++) {
+            text.push_back(static_cast<char>(listBytes[i%listBytes.size()]));
+        }
+        if (line.compare(0, strlen("Result: Invalid"), "Result: Invalid") == 0) {
+            if (checkResult(text, false, std::vector<uint32_t>(), lineIndex)) {
+                return 1;
+            }
+            continue;
+        }
+        if (line.compare(0, strlen("Characters: "), "Characters: ") == 0) {
+            std::vector<uint32_t> listCharacter = getHexValues(line.substr(strlen("Characters: ")));
+            std::vector<uint32_t> listExpected;
+            for (i=0;i<repeat;i++) {
+                listExpected.insert(listExpected.end(), listCharacter.begin(), listCharacter.end());
+            }
+            if (checkResult(text, true, listExpected, lineIndex)) {
+                return 1;
+            }
+            continue;
+        }
+        std::cout << "Incorrect line: " << line << "\n";
+        return 1;
+    }
+    std::cout << "All tests OK\n";
+    return 0;
+}
@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <iostream>
 #include <application/tg_application.h>
 #include "mainwindow.h"
 
@@ -27,6 +28,23 @@ int main(int argc , char *argv[])
     static TgApplication m_application;
     m_application.setFont("/usr/share/fonts/truetype/samyak-fonts/Samyak-Gujarati.ttf", 1);
     m_application.setFont("/usr/share/fonts/truetype/droid/DroidSansFallbackFull.ttf", 2);
+    m_application.preloadFont(m_application.getDefaultFont(), {17, 21, 24}, {{0x20, 0x7E}, {0xA0, 0xFF}},
+                              [](size_t preloadedCount, size_t totalCount) {
+        // called on the worker thread
+        std::cout << "Font preloaded " << preloadedCount << "/" << totalCount << "\n";
+    });
+    std::vector<TgTextMeasureRequest> listMeasure(3);
+    listMeasure[0].m_text = "Short label";
+    listMeasure[1].m_text = "Longer label that is wrapped to several lines";
+    listMeasure[1].m_maxLineWidth = 120;
+    listMeasure[1].m_wordWrap = TgTextFieldWordWrap::WordWrapOn;
+    listMeasure[2].m_text = "Line 1\nLine 2";
+    listMeasure[2].m_fontSize = 24;
+    std::vector<TgTextMeasureResult> listResult = m_application.measureTexts(listMeasure);
+    for (size_t i=0;i<listResult.size();i++) {
+        std::cout << "Text " << i << " measured: " << listResult[i].m_valid << " width " << listResult[i].m_textWidth
+                  << " height " << listResult[i].m_allDrawTextHeight << " lines " << listResult[i].m_lineCount << "\n";
+    }
     static MainWindow m_mainwindow(800,600);
     return m_application.exec();
 }
@@ -8,7 +8,8 @@ MainWindow::MainWindow(int width, int height) :
     m_buttonChangeText(this, 240, 20, 200, 50, "Change text"),
     m_textFieldForTestBottomRight(this, "Bottom ગુજરાતી યુનિકોડ ફોન્ટ સૂચી 未来の文字コ Right", "", 21, 255, 255, 255),
     m_textFieldForTestCenter(this, "Center text", "", 21, 255, 255, 255),
-    m_textEmptyText(this, "", "", 21, 255, 255, 255)
+    m_textEmptyText(this, "", "", 21, 255, 255, 255),
+    m_textFieldAsync(this, 20, 90, 760, 150, "Async text", "", 17, 255, 255, 0)
 {
     m_buttonClose.connectOnMouseClicked( std::bind(&MainWindow::onButtonCloseClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
     m_buttonChangeText.connectOnMouseClicked( std::bind(&MainWindow::onButtonChangeTextClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
@@ -26,6 +27,9 @@ MainWindow::MainWindow(int width, int height) :
     m_textFieldForTestCenter.setHorizontalAlign(TgTextfieldHorizontalAlign::AlignCenterH);
     m_textFieldForTestCenter.setVerticalAlign(TgTextfieldVerticalAlign::AlignCenterV);
 
+    m_textFieldAsync.setAsyncTextPreparation(true);
+    m_textFieldAsync.setMaxLineCount(6);
+    m_textFieldAsync.setWordWrap(TgTextFieldWordWrap::WordWrapOn);
 }
 
 MainWindow::~MainWindow()
@@ -52,6 +56,11 @@ void MainWindow::onButtonChangeTextClick(TgMouseType type, float x, float y, con
 {
     std::cout << "Change text button clicked\n";
     m_centerTextIndex++;
+    std::string asyncText;
+    for (int i=0;i<200;i++) {
+        asyncText += "Async " + std::to_string(m_centerTextIndex) + " ગુજરાતી 未来 ";
+    }
+    m_textFieldAsync.setText(asyncText.c_str());
     std::vector<TgTextFieldText>listText;
     TgTextFieldText t0;
     TgTextFieldText t1;
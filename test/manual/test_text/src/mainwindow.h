@@ -17,6 +17,7 @@ private:
     TgTextfield m_textFieldForTestBottomRight;
     TgTextfield m_textFieldForTestCenter;
     TgTextfield m_textEmptyText;
+    TgTextfield m_textFieldAsync;
 
     void onButtonCloseClick(TgMouseType type, float x, float y, const void *);
     void onButtonChangeTextClick(TgMouseType type, float x, float y, const void *);
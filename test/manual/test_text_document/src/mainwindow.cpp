@@ -0,0 +1,71 @@
+#include "mainwindow.h"
+#include <iostream>
+#include <string>
+
+MainWindow::MainWindow(int width, int height) :
+    TgMainWindow(width, height, "TestApp1", width - 300, height - 300),
+    m_buttonClose(this, 20, 20, 150, 50, "Close button"),
+    m_buttonInsert(this, 180, 20, 100, 50, "Insert"),
+    m_buttonRemove(this, 290, 20, 100, 50, "Remove"),
+    m_buttonAppend(this, 400, 20, 100, 50, "Append"),
+    m_background(this, 20, 80, 700, 480, 40, 40, 40),
+    m_textDocument(&m_background, nullptr, 17)
+{
+    m_buttonClose.connectOnMouseClicked( std::bind(&MainWindow::onButtonCloseClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
+    m_buttonInsert.connectOnMouseClicked( std::bind(&MainWindow::onButtonInsertClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
+    m_buttonRemove.connectOnMouseClicked( std::bind(&MainWindow::onButtonRemoveClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
+    m_buttonAppend.connectOnMouseClicked( std::bind(&MainWindow::onButtonAppendClick, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4) );
+    m_textDocument.setAnchorState(TgItem2dAnchor::AnchorFollowParentSize);
+    m_textDocument.setMouseScrollMultiplier(3);
+
+    std::string text;
+    for (size_t i=0;i<200000;i++) {
+        text += "Line " + std::to_string(i+1) + ": The quick brown fox jumps over the lazy dog\n";
+    }
+    text += "Last line";
+    m_textDocument.setText(text.c_str());
+}
+
+MainWindow::~MainWindow()
+{
+}
+
+/*!
+ * \brief MainWindow::onButtonCloseClick
+ *
+ * callback when button close is clicked
+ */
+void MainWindow::onButtonCloseClick(TgMouseType type, float x, float y, const void *)
+{
+    std::cout << "Closing the application\n";
+    exit();
+}
+
+void MainWindow::onButtonInsertClick(TgMouseType type, float x, float y, const void *)
+{
+    size_t line = m_textDocument.getFirstVisibleLine();
+    m_textDocument.insertText(line, 0, "Inserted line\n");
+    m_textDocument.insertText(line+1, 5, "[edited]");
+    std::cout << "Line count: " << m_textDocument.getLineCount() << "\n";
+}
+
+void MainWindow::onButtonRemoveClick(TgMouseType type, float x, float y, const void *)
+{
+    size_t line = m_textDocument.getFirstVisibleLine();
+    // character count of the line and its line break
+    size_t characterCount = 1;
+    std::string text = m_textDocument.getLine(line);
+    for (size_t i=0;i<text.size();i++) {
+        if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) {
+            characterCount++;
+        }
+    }
+    m_textDocument.removeText(line, 0, characterCount);
+    std::cout << "Line count: " << m_textDocument.getLineCount() << "\n";
+}
+
+void MainWindow::onButtonAppendClick(TgMouseType type, float x, float y, const void *)
+{
+    m_textDocument.appendText("\nAppended line");
+    m_textDocument.setFirstVisibleLine(m_textDocument.getLineCount());
+}
@@ -0,0 +1,29 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <window/tg_mainwindow.h>
+#include <item2d/tg_button.h>
+#include <item2d/tg_rectangle.h>
+#include <item2d/tg_text_document.h>
+
+
+class MainWindow : public TgMainWindow
+{
+public:
+    MainWindow(int width, int height);
+    ~MainWindow();
+private:
+    TgButton m_buttonClose;
+    TgButton m_buttonInsert;
+    TgButton m_buttonRemove;
+    TgButton m_buttonAppend;
+    TgRectangle m_background;
+    TgTextDocument m_textDocument;
+
+    void onButtonCloseClick(TgMouseType type, float x, float y, const void *);
+    void onButtonInsertClick(TgMouseType type, float x, float y, const void *);
+    void onButtonRemoveClick(TgMouseType type, float x, float y, const void *);
+    void onButtonAppendClick(TgMouseType type, float x, float y, const void *);
+};
+
+#endif
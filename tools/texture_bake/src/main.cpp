@@ -0,0 +1,81 @@
+/*!
+ * \file
+ * \brief file main.cpp
+ *
+ * texture bake tool, it writes pre-baked texture files
+ * (.tgtex) of png images
+ *
+ * Copyright of Timo Hannukkala. All rights reserved.
+ *
+ * \author Timo Hannukkala <timohannukkala@hotmail.com>
+ */
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../../../lib/src/image/tg_image_load.h"
+#include "../../../lib/src/image/tg_image_texture_file.h"
+
+static void printUsage(const char *name)
+{
+    std::cout << "usage: " << name << " [--no-mipmaps] file.png..." << std::endl;
+    std::cout << "writes file.tgtex next to each file.png" << std::endl;
+}
+
+/*!
+ * \brief bakeImage
+ *
+ * decodes the png and writes it as texture file
+ *
+ * \param filename png filename
+ * \param mipmaps if true, mip levels are written too
+ * \return true on success
+ */
+static bool bakeImage(const std::string &filename, bool mipmaps)
+{
+    int width = 0, height = 0;
+    unsigned char *imageData = TgImageLoad::loadPng(filename.c_str(), width, height);
+    if (!imageData) {
+        std::cerr << "could not load: " << filename << std::endl;
+        return false;
+    }
+    std::string textureFileName = TgImageTextureFile::getTextureFileName(filename);
+    bool ret = TgImageTextureFile::write(textureFileName, imageData,
+                                         static_cast<uint32_t>(width), static_cast<uint32_t>(height), mipmaps);
+    delete[] imageData;
+    if (!ret) {
+        std::cerr << "could not write: " << textureFileName << std::endl;
+        return false;
+    }
+    std::cout << filename << " -> " << textureFileName << " (" << width << "x" << height << ")" << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+    bool mipmaps = true;
+    std::vector<std::string> listFilename;
+    for (i=1;i<argc;i++) {
+        if (strcmp(argv[i], "--no-mipmaps") == 0) {
+            mipmaps = false;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            listFilename.push_back(argv[i]);
+        }
+    }
+    if (listFilename.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    int ret = 0;
+    for (size_t index=0;index<listFilename.size();index++) {
+        if (!bakeImage(listFilename[index], mipmaps)) {
+            ret = 1;
+        }
+    }
+    return ret;
+}